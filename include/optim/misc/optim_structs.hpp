@@ -117,6 +117,14 @@ struct de_settings_t
 
     size_t check_freq = (size_t)-1;
 
+    // anytime termination (de only): stop if the best objective value has not
+    // improved for n_stall_gen generations (0 = disabled) or if the next
+    // generation, estimated to take as long as the previous one, would end
+    // after the deadline.  The clock is only read between generations.
+
+    size_t n_stall_gen = 0;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
     double par_F = 0.8;
     double par_CR = 0.9;
     
@@ -138,12 +146,19 @@ struct de_settings_t
     Vec_t initial_lb; // this will default to -0.5
     Vec_t initial_ub; // this will default to  0.5
 
-    //
-
     bool return_population_mat = false;
     Mat_t population_mat; // n_pop x n_vals
 };
 
+// buffers of de_batch; pass the same workspace to repeated calls to reuse
+// the memory of the population instead of allocating it in each call
+
+struct de_workspace_t
+{
+    Vec_t objfn_vals, prop_objfn_vals;
+    Mat_t X, X_next, X_prop, X_eval;
+};
+
 // PSO
 
 struct pso_settings_t
@@ -63,6 +63,51 @@ de(Vec_t& init_out_vals,
    void* opt_data, 
    algo_settings_t& settings);
 
+/**
+ * @brief The Differential Evolution (DE) Optimization Algorithm with a batch objective function
+ *
+ * Same as de() but the objective function is called once per generation for the whole population, which allows
+ * vectorising its evaluation across the candidates.
+ *
+ * @param init_out_vals a column vector of initial values, which will be replaced by the solution upon successful completion of the optimization algorithm.
+ * @param opt_batch_objfn the function to be minimized, taking three arguments:
+ *   - \c vals_mat a matrix of inputs (one candidate per row);
+ *   - \c objfn_vals_out a vector to store the values of the objective function for each row of \c vals_mat; and
+ *   - \c opt_data additional data passed to the user-provided function.
+ * @param opt_data additional data passed to the user-provided function.
+ * @param settings parameters controlling the optimization routine.
+ *
+ * @return a boolean value indicating successful completion of the optimization algorithm.
+ */
+
+bool
+de_batch(Vec_t& init_out_vals, 
+         std::function<void (const Mat_t& vals_mat, Vec_t& objfn_vals_out, void* opt_data)> opt_batch_objfn, 
+         void* opt_data, 
+         algo_settings_t& settings);
+
+/**
+ * @brief The Differential Evolution (DE) Optimization Algorithm with a batch objective function
+ *
+ * Same as de_batch() but the matrices of the population are kept in \c workspace, so repeated calls with problems
+ * of the same size do not allocate memory for them.
+ *
+ * @param init_out_vals a column vector of initial values, which will be replaced by the solution upon successful completion of the optimization algorithm.
+ * @param opt_batch_objfn the function to be minimized, see de_batch().
+ * @param opt_data additional data passed to the user-provided function.
+ * @param settings parameters controlling the optimization routine.
+ * @param workspace buffers that are reused across calls.
+ *
+ * @return a boolean value indicating successful completion of the optimization algorithm.
+ */
+
+bool
+de_batch(Vec_t& init_out_vals, 
+         std::function<void (const Mat_t& vals_mat, Vec_t& objfn_vals_out, void* opt_data)> opt_batch_objfn, 
+         void* opt_data, 
+         algo_settings_t& settings,
+         de_workspace_t& workspace);
+
 //
 // internal
 
@@ -72,8 +117,10 @@ namespace internal
 bool
 de_impl(Vec_t& init_out_vals, 
         std::function<double (const Vec_t& vals_inp, Vec_t* grad_out, void* opt_data)> opt_objfn, 
+        std::function<void (const Mat_t& vals_mat, Vec_t& objfn_vals_out, void* opt_data)> opt_batch_objfn, 
         void* opt_data, 
-        algo_settings_t* settings_inp);
+        algo_settings_t* settings_inp,
+        de_workspace_t* workspace = nullptr);
 
 }
 
@@ -84,8 +131,10 @@ bool
 internal::de_impl(
     Vec_t& init_out_vals, 
     std::function<double (const Vec_t& vals_inp, Vec_t* grad_out, void* opt_data)> opt_objfn, 
+    std::function<void (const Mat_t& vals_mat, Vec_t& objfn_vals_out, void* opt_data)> opt_batch_objfn, 
     void* opt_data, 
-    algo_settings_t* settings_inp)
+    algo_settings_t* settings_inp,
+    de_workspace_t* workspace)
 {
     bool success = false;
 
@@ -107,6 +156,8 @@ internal::de_impl(
     const size_t n_pop = settings.de_settings.n_pop;
     const size_t n_gen = settings.de_settings.n_gen;
     const size_t check_freq = settings.de_settings.check_freq;
+    const size_t n_stall_gen = settings.de_settings.n_stall_gen;
+    const std::chrono::steady_clock::time_point deadline = settings.de_settings.deadline;
 
     const uint_t mutation_method = settings.de_settings.mutation_method;
 
@@ -125,10 +176,10 @@ internal::de_impl(
 
     const bool return_population_mat = settings.de_settings.return_population_mat;
 
-    // lambda function for box constraints
-
-    std::function<double (const Vec_t& vals_inp, Vec_t* grad_out, void* box_data)> box_objfn \
-    = [opt_objfn, vals_bound, bounds_type, lower_bounds, upper_bounds] (const Vec_t& vals_inp, Vec_t* grad_out, void* opt_data) \
+    // lambda function for box constraints (not stored in a std::function,
+    // which would allocate memory for the captured objects)
+    auto box_objfn \
+    = [&opt_objfn, vals_bound, &bounds_type, &lower_bounds, &upper_bounds] (const Vec_t& vals_inp, Vec_t* grad_out, void* opt_data) \
     -> double
     {
         if (vals_bound) {
@@ -143,24 +194,85 @@ internal::de_impl(
     //
     // setup
 
-    Vec_t objfn_vals(n_pop);
-    Mat_t X(n_pop,n_vals), X_next(n_pop,n_vals);
+    // the buffers are only reallocated if the size of the problem changed
 
-#ifdef OPTIM_USE_OMP
-    #pragma omp parallel for
-#endif
-    for (size_t i = 0; i < n_pop; ++i) {
-        X_next.row(i) = OPTIM_MATOPS_TRANSPOSE( OPTIM_MATOPS_HADAMARD_PROD( (par_initial_lb + (par_initial_ub - par_initial_lb)), OPTIM_MATOPS_RANDU_VEC(n_vals) ) );
+    de_workspace_t local_workspace;
+    if (!workspace) {
+        workspace = &local_workspace;
+    }
+
+    Vec_t& objfn_vals = workspace->objfn_vals;
+    Vec_t& prop_objfn_vals = workspace->prop_objfn_vals;
+    Mat_t& X = workspace->X;
+    Mat_t& X_next = workspace->X_next;
+    Mat_t& X_prop = workspace->X_prop;
+
+    OPTIM_MATOPS_SET_SIZE(objfn_vals,n_pop,1);
+    OPTIM_MATOPS_SET_SIZE(prop_objfn_vals,n_pop,1);
+    OPTIM_MATOPS_SET_SIZE(X,n_pop,n_vals);
+    OPTIM_MATOPS_SET_SIZE(X_next,n_pop,n_vals);
+    OPTIM_MATOPS_SET_SIZE(X_prop,n_pop,n_vals);
+
+    // candidates without the transformation of the bounds (batch objective only)
+    Mat_t& X_eval = workspace->X_eval;
+    if (opt_batch_objfn && vals_bound) {
+        OPTIM_MATOPS_SET_SIZE(X_eval,n_pop,n_vals);
+    }
 
-        double prop_objfn_val = opt_objfn( OPTIM_MATOPS_TRANSPOSE(X_next.row(i)), nullptr, opt_data);
+    // evaluate the objective function for all rows of a matrix (with the
+    // batch objective if it is set)
 
-        if (!std::isfinite(prop_objfn_val)) {
-            prop_objfn_val = inf;
+    const Mat_t* eval_mat = nullptr;
+    bool eval_transformed = false;
+
+    auto evaluate_row = [&](size_t i)
+    {
+        double objfn_val = eval_transformed ? box_objfn(OPTIM_MATOPS_TRANSPOSE(eval_mat->row(i)), nullptr, opt_data)
+                                            : opt_objfn(OPTIM_MATOPS_TRANSPOSE(eval_mat->row(i)), nullptr, opt_data);
+
+        if (!std::isfinite(objfn_val)) {
+            objfn_val = inf;
         }
-        
-        objfn_vals(i) = prop_objfn_val;
 
-        if (vals_bound) {
+        prop_objfn_vals(i) = objfn_val;
+    };
+
+    auto evaluate_population = [&](const Mat_t& vals_mat, bool transformed)
+    {
+        eval_mat = &vals_mat;
+        eval_transformed = transformed;
+
+        if (opt_batch_objfn) {
+            if (transformed && vals_bound) {
+                for (size_t i = 0; i < n_pop; ++i) {
+                    X_eval.row(i) = OPTIM_MATOPS_TRANSPOSE( inv_transform(OPTIM_MATOPS_TRANSPOSE(vals_mat.row(i)), bounds_type, lower_bounds, upper_bounds) );
+                }
+                opt_batch_objfn(X_eval, prop_objfn_vals, opt_data);
+            } else {
+                opt_batch_objfn(vals_mat, prop_objfn_vals, opt_data);
+            }
+
+            for (size_t i = 0; i < n_pop; ++i) {
+                if (!std::isfinite(prop_objfn_vals(i))) {
+                    prop_objfn_vals(i) = inf;
+                }
+            }
+        } else {
+            for (size_t i = 0; i < n_pop; ++i) {
+                evaluate_row(i);
+            }
+        }
+    };
+
+    for (size_t i = 0; i < n_pop; ++i) {
+        X_next.row(i) = OPTIM_MATOPS_TRANSPOSE( par_initial_lb + OPTIM_MATOPS_HADAMARD_PROD( (par_initial_ub - par_initial_lb), OPTIM_MATOPS_RANDU_VEC(n_vals) ) );
+    }
+
+    evaluate_population(X_next, false);
+    objfn_vals = prop_objfn_vals;
+
+    if (vals_bound) {
+        for (size_t i = 0; i < n_pop; ++i) {
             X_next.row(i) = OPTIM_MATOPS_TRANSPOSE( transform(OPTIM_MATOPS_TRANSPOSE(X_next.row(i)), bounds_type, lower_bounds, upper_bounds) );
         }
     }
@@ -175,19 +287,20 @@ internal::de_impl(
     // begin loop
 
     size_t iter = 0;
+    size_t last_improvement_iter = 0;
     double rel_objfn_change = 2*rel_objfn_change_tol;
 
     while (rel_objfn_change > rel_objfn_change_tol && iter < n_gen + 1) {
         ++iter;
 
+        const std::chrono::steady_clock::time_point gen_start_time = std::chrono::steady_clock::now();
+
         X = X_next;
 
         //
-        // loop over population
+        // mutation and crossover for the whole population (sequentially, so
+        // the random numbers do not depend on the evaluation)
 
-#ifdef OPTIM_USE_OMP
-        #pragma omp parallel for
-#endif
         for (size_t i = 0; i < n_pop; ++i) {
             uint_t c_1, c_2, c_3;
 
@@ -208,32 +321,30 @@ internal::de_impl(
             const size_t j = OPTIM_MATOPS_AS_SCALAR( OPTIM_MATOPS_RANDI_VEC(1, 0, n_vals-1) ); // arma::as_scalar(arma::randi(1, arma::distr_param(0, n_vals-1)));
 
             Vec_t rand_unif = OPTIM_MATOPS_RANDU_VEC(n_vals);
-            RowVec_t X_prop(n_vals);
 
             for (size_t k = 0; k < n_vals; ++k) {
                 if ( rand_unif(k) < par_CR || k == j ) {
                     if ( mutation_method == 1 ) {
-                        X_prop(k) = X(c_3,k) + par_F*(X(c_1,k) - X(c_2,k));
+                        X_prop(i,k) = X(c_3,k) + par_F*(X(c_1,k) - X(c_2,k));
                     } else {
-                        X_prop(k) = best_vec(k) + par_F*(X(c_1,k) - X(c_2,k));
-                        // X_prop(k) = best_sol_running + par_F*(X(c_1,k) - X(c_2,k)); // mutation == 3
+                        X_prop(i,k) = best_vec(k) + par_F*(X(c_1,k) - X(c_2,k));
+                        // X_prop(i,k) = best_sol_running + par_F*(X(c_1,k) - X(c_2,k)); // mutation == 3
                     }
                 } else {
-                    X_prop(k) = X(i,k);
+                    X_prop(i,k) = X(i,k);
                 }
             }
+        }
 
-            //
+        //
+        // evaluation and selection
 
-            double prop_objfn_val = box_objfn(OPTIM_MATOPS_TRANSPOSE(X_prop), nullptr, opt_data);
+        evaluate_population(X_prop, true);
 
-            if (!std::isfinite(prop_objfn_val)) {
-                prop_objfn_val = inf;
-            }
-            
-            if (prop_objfn_val <= objfn_vals(i)) {
-                X_next.row(i) = X_prop;
-                objfn_vals(i) = prop_objfn_val;
+        for (size_t i = 0; i < n_pop; ++i) {
+            if (prop_objfn_vals(i) <= objfn_vals(i)) {
+                X_next.row(i) = X_prop.row(i);
+                objfn_vals(i) = prop_objfn_vals(i);
             } else {
                 X_next.row(i) = X.row(i);
             }
@@ -249,6 +360,7 @@ internal::de_impl(
         if (min_objfn_val < min_objfn_val_running) {
             min_objfn_val_running = min_objfn_val;
             best_sol_running = best_vec;
+            last_improvement_iter = iter;
         }
 
         if (iter % check_freq == 0) {   
@@ -262,6 +374,21 @@ internal::de_impl(
         //
 
         OPTIM_DE_TRACE(iter, rel_objfn_change, min_objfn_val_running, min_objfn_val_check, best_sol_running, X_next);
+
+        //
+        // anytime termination
+
+        if (n_stall_gen > 0 && iter - last_improvement_iter >= n_stall_gen) {
+            break;
+        }
+
+        if (deadline != std::chrono::steady_clock::time_point::max()) {
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+            if (now + (now - gen_start_time) > deadline) {
+                break;
+            }
+        }
     }
 
     //
@@ -282,9 +409,19 @@ internal::de_impl(
         best_sol_running = OPTIM_MATOPS_TRANSPOSE( inv_transform(OPTIM_MATOPS_TRANSPOSE(best_sol_running), bounds_type, lower_bounds, upper_bounds) );
     }
 
-    error_reporting(init_out_vals, OPTIM_MATOPS_TRANSPOSE(best_sol_running), opt_objfn, opt_data, 
-                    success, rel_objfn_change, rel_objfn_change_tol, iter, n_gen, 
-                    conv_failure_switch, settings_inp);
+    if (opt_batch_objfn) {
+        // there is no single-candidate objective function, report the known
+        // value of the best solution instead
+
+        error_reporting(init_out_vals, OPTIM_MATOPS_TRANSPOSE(best_sol_running), 
+                        [min_objfn_val_running] (const Vec_t&, Vec_t*, void*) -> double { return min_objfn_val_running; }, opt_data, 
+                        success, rel_objfn_change, rel_objfn_change_tol, iter, n_gen, 
+                        conv_failure_switch, settings_inp);
+    } else {
+        error_reporting(init_out_vals, OPTIM_MATOPS_TRANSPOSE(best_sol_running), opt_objfn, opt_data, 
+                        success, rel_objfn_change, rel_objfn_change_tol, iter, n_gen, 
+                        conv_failure_switch, settings_inp);
+    }
 
     //
     
@@ -297,7 +434,7 @@ de(Vec_t& init_out_vals,
           std::function<double (const Vec_t& vals_inp, Vec_t* grad_out, void* opt_data)> opt_objfn, 
           void* opt_data)
 {
-    return internal::de_impl(init_out_vals, opt_objfn, opt_data, nullptr);
+    return internal::de_impl(init_out_vals, opt_objfn, nullptr, opt_data, nullptr);
 }
 
 inline
@@ -307,7 +444,28 @@ de(Vec_t& init_out_vals,
           void* opt_data, 
           algo_settings_t& settings)
 {
-    return internal::de_impl(init_out_vals, opt_objfn, opt_data, &settings);
+    return internal::de_impl(init_out_vals, opt_objfn, nullptr, opt_data, &settings);
+}
+
+inline
+bool
+de_batch(Vec_t& init_out_vals, 
+         std::function<void (const Mat_t& vals_mat, Vec_t& objfn_vals_out, void* opt_data)> opt_batch_objfn, 
+         void* opt_data, 
+         algo_settings_t& settings)
+{
+    return internal::de_impl(init_out_vals, nullptr, opt_batch_objfn, opt_data, &settings);
+}
+
+inline
+bool
+de_batch(Vec_t& init_out_vals, 
+         std::function<void (const Mat_t& vals_mat, Vec_t& objfn_vals_out, void* opt_data)> opt_batch_objfn, 
+         void* opt_data, 
+         algo_settings_t& settings,
+         de_workspace_t& workspace)
+{
+    return internal::de_impl(init_out_vals, nullptr, opt_batch_objfn, opt_data, &settings, &workspace);
 }
 
 #endif
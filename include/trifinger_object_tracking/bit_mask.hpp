@@ -0,0 +1,74 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+#include <trifinger_object_tracking/sparse_mask.hpp>
+
+namespace trifinger_object_tracking
+{
+/**
+ * @brief Binary mask with one bit per pixel.
+ *
+ * Only covers the bounding box of the set pixels, so the memory and the time
+ * for counting pixels in a region depend on the size of the segmented
+ * region, not on the size of the image.
+ */
+class BitMask
+{
+public:
+    /**
+     * @brief Set the mask to the given pixels.
+     *
+     * The pixels must be distinct (as e.g. the result of cv::findNonZero).
+     *
+     * The memory is reused, so this does not allocate once the mask has been
+     * large enough before.
+     */
+    void assign(const std::vector<cv::Point> &pixels);
+
+    /**
+     * @brief Set the mask to the pixels of a run-length encoded mask.
+     *
+     * Same as assign() with the pixels of the mask but sets whole words of a
+     * run at once.
+     */
+    void assign(const SparseMask &mask);
+
+    //! @brief Bounding box of the set pixels (empty if there are none).
+    const cv::Rect &get_roi() const
+    {
+        return roi_;
+    }
+
+    //! @brief Number of set pixels.
+    unsigned int get_num_pixels() const
+    {
+        return num_pixels_;
+    }
+
+    /**
+     * @brief Count the set pixels in the columns [col_begin, col_end] of a
+     * row.
+     *
+     * The span may exceed the bounding box, it is clipped.
+     */
+    unsigned int count_in_row(int row, int col_begin, int col_end) const;
+
+private:
+    cv::Rect roi_;
+    unsigned int num_pixels_ = 0;
+    //! Number of 64-bit words per row of the bounding box.
+    size_t words_per_row_ = 0;
+    //! Bits of the bounding box, row by row (bit j of word k of a row is
+    //! column roi_.x + 64 * k + j).
+    std::vector<uint64_t> words_;
+};
+
+}  // namespace trifinger_object_tracking
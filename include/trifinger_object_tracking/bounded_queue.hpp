@@ -0,0 +1,156 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+namespace trifinger_object_tracking
+{
+/**
+ * @brief Thread-safe FIFO queue with a maximum size for passing data between
+ * the stages of a pipeline.
+ *
+ * If the queue is full, pushing drops the oldest element instead of
+ * blocking, so a slow consumer never stalls the producer (e.g. a camera) and
+ * always gets the most recent data.
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+    /**
+     * @param capacity Maximum number of elements in the queue.
+     * @throw std::invalid_argument if capacity is zero.
+     */
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("Capacity must be positive.");
+        }
+    }
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+    /**
+     * @brief Add an element to the end of the queue.
+     *
+     * If the queue is full, the oldest element is dropped.  Elements pushed
+     * after close() are ignored.
+     *
+     * @return True if an element was dropped.
+     */
+    bool push(T element)
+    {
+        bool dropped = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_)
+            {
+                return false;
+            }
+            if (elements_.size() == capacity_)
+            {
+                elements_.pop_front();
+                dropped = true;
+            }
+            elements_.push_back(std::move(element));
+        }
+        not_empty_.notify_one();
+        return dropped;
+    }
+
+    /**
+     * @brief Remove the oldest element, waiting until there is one.
+     *
+     * @return The element or std::nullopt if the queue has been closed and
+     *     is empty.
+     */
+    std::optional<T> pop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !elements_.empty(); });
+        if (elements_.empty())
+        {
+            return std::nullopt;
+        }
+
+        T element = std::move(elements_.front());
+        elements_.pop_front();
+        return element;
+    }
+
+    /**
+     * @brief Remove all elements and return the newest one, waiting until
+     * there is one.
+     *
+     * @param num_discarded If not null, set to the number of older elements
+     *     that were discarded.
+     *
+     * @return The element or std::nullopt if the queue has been closed and
+     *     is empty.
+     */
+    std::optional<T> pop_latest(size_t *num_discarded = nullptr)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !elements_.empty(); });
+        if (elements_.empty())
+        {
+            return std::nullopt;
+        }
+
+        if (num_discarded)
+        {
+            *num_discarded = elements_.size() - 1;
+        }
+        T element = std::move(elements_.back());
+        elements_.clear();
+        return element;
+    }
+
+    /**
+     * @brief Close the queue.
+     *
+     * Wakes up all waiting pop() calls.  Afterwards, push() has no effect
+     * and the elements that are still in the queue can be popped.  Once the
+     * queue is empty, pop() and pop_latest() return std::nullopt immediately
+     * instead of waiting.
+     */
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+    }
+
+    //! @brief Number of elements currently in the queue.
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return elements_.size();
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+private:
+    const size_t capacity_;
+    std::deque<T> elements_;
+    bool closed_ = false;
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+};
+
+}  // namespace trifinger_object_tracking
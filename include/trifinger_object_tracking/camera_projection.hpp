@@ -0,0 +1,122 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <array>
+
+#include <opencv2/opencv.hpp>
+#include <trifinger_cameras/camera_parameters.hpp>
+
+namespace trifinger_object_tracking
+{
+/**
+ * @brief Projection of 3d points into the image of a calibrated camera.
+ *
+ * Uses the same camera model as cv::projectPoints (pinhole camera with radial
+ * and tangential distortion, i.e. distortion coefficients k1, k2, p1, p2[,
+ * k3]) but stores the parameters in fixed-size types, so projecting points
+ * does not allocate any memory.
+ */
+class CameraProjection
+{
+public:
+    CameraProjection() = default;
+
+    /**
+     * @param camera_parameters Calibration of the camera.
+     *
+     * @throw std::invalid_argument if the number of distortion coefficients
+     *     is not 0, 4 or 5.
+     */
+    explicit CameraProjection(
+        const trifinger_cameras::CameraParameters &camera_parameters);
+
+    //! @brief Transformation from world to camera frame.
+    const cv::Affine3f &get_world_to_camera() const
+    {
+        return world_to_camera_;
+    }
+
+    //! @brief Position of the camera centre in the world frame.
+    cv::Vec3f get_camera_position() const
+    {
+        return world_to_camera_.inv().translation();
+    }
+
+    /**
+     * @brief Get the direction of the ray through an image point.
+     *
+     * The distortion is removed iteratively (like cv::undistortPoints), so
+     * this is the inverse of project() up to the depth of the point.
+     *
+     * @param image_point Point in the image.
+     * @return Unit vector in the world frame pointing from the camera centre
+     *     (see get_camera_position()) through the image point.
+     */
+    cv::Vec3f unproject(const cv::Point2f &image_point) const;
+
+    /**
+     * @brief Project a point given in the camera frame.
+     *
+     * Like cv::projectPoints, points with z = 0 are not divided by z.
+     */
+    cv::Point2f project_camera_point(const cv::Vec3f &point) const
+    {
+        const float inv_z = point[2] != 0 ? 1 / point[2] : 1;
+        const float x = point[0] * inv_z;
+        const float y = point[1] * inv_z;
+
+        const float r2 = x * x + y * y;
+        const float radial = 1 + r2 * (k1_ + r2 * (k2_ + r2 * k3_));
+        const float xd = x * radial + 2 * p1_ * x * y + p2_ * (r2 + 2 * x * x);
+        const float yd = y * radial + p1_ * (r2 + 2 * y * y) + 2 * p2_ * x * y;
+
+        return cv::Point2f(fx_ * xd + cx_, fy_ * yd + cy_);
+    }
+
+    //! @brief Project a point given in the world frame.
+    cv::Point2f project(const cv::Vec3f &point) const
+    {
+        return project_camera_point(world_to_camera_ * point);
+    }
+
+    /**
+     * @brief Project points given in homogeneous coordinates in the camera
+     * frame.
+     *
+     * @param points One point per column (the fourth row is ignored).
+     * @param image_points Output of the image points.
+     */
+    template <int N>
+    void project_camera_points(const cv::Matx<float, 4, N> &points,
+                               std::array<cv::Point2f, N> *image_points) const
+    {
+        for (int i = 0; i < N; i++)
+        {
+            (*image_points)[i] = project_camera_point(
+                cv::Vec3f(points(0, i), points(1, i), points(2, i)));
+        }
+    }
+
+    /**
+     * @brief Jacobian of project_camera_point() w.r.t. the point.
+     *
+     * @param point Point in the camera frame (must not have z = 0).
+     */
+    cv::Matx<float, 2, 3> project_camera_point_jacobian(
+        const cv::Vec3f &point) const;
+
+private:
+    //! Transformation from world to camera frame (rotation R, translation t).
+    cv::Affine3f world_to_camera_;
+
+    //! Camera matrix K
+    float fx_ = 1, fy_ = 1, cx_ = 0, cy_ = 0;
+    //! Distortion coefficients (unused ones are zero)
+    float k1_ = 0, k2_ = 0, p1_ = 0, p2_ = 0, k3_ = 0;
+};
+
+}  // namespace trifinger_object_tracking
@@ -0,0 +1,105 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace trifinger_object_tracking
+{
+/**
+ * @brief Precomputed output of the colour classifier for all BGR colours.
+ *
+ * All features of the XGBoost colour classifier (B, G, R, H, S, V) are
+ * functions of the BGR value of a single pixel.  The label of the classifier
+ * can therefore be computed once for each of the 256^3 possible colours, so
+ * that classifying a pixel becomes a single memory lookup.
+ *
+ * The labels in the table are the raw labels of the classifier (0 is
+ * background, 1-6 are the colours, see ColorSegmenter).
+ */
+class ColorLookupTable
+{
+public:
+    //! Number of entries in the table (one per BGR colour).
+    static constexpr size_t TABLE_SIZE = 256 * 256 * 256;
+
+    //! @brief Create an empty table.  Call build() or load() to fill it.
+    ColorLookupTable() = default;
+
+    /**
+     * @brief Fill the table by evaluating the classifier for all colours.
+     *
+     * The work is distributed over all available cores.  This takes in the
+     * order of a few seconds.
+     */
+    void build();
+
+    /**
+     * @brief Load the table from a cache file created with save().
+     *
+     * @param filename Path to the cache file.
+     * @return True if the table was loaded.  False if the file does not
+     *     exist, is corrupt or was created for a different classifier model.
+     */
+    bool load(const std::string &filename);
+
+    /**
+     * @brief Write the table to a cache file.
+     *
+     * @param filename Path to the cache file.
+     * @throw std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string &filename) const;
+
+    //! @brief Check if the table is filled.
+    bool empty() const
+    {
+        return table_.empty();
+    }
+
+    //! @brief Get the classifier label of the given colour.
+    uint8_t get_label(uint8_t b, uint8_t g, uint8_t r) const
+    {
+        return table_[(static_cast<uint32_t>(b) << 16) |
+                      (static_cast<uint32_t>(g) << 8) | r];
+    }
+
+    //! @brief Get the classifier label of the pixel at the given BGR pointer.
+    uint8_t get_label(const uint8_t *bgr) const
+    {
+        return get_label(bgr[0], bgr[1], bgr[2]);
+    }
+
+    /**
+     * @brief Get a table that is shared by all users in the process.
+     *
+     * The table is only built once per process.  If cache_file is set, it is
+     * loaded from there if possible.  Otherwise the table is built (or an
+     * already existing one reused, as all tables are computed from the same
+     * compiled-in model) and written to the cache file.  Calls with the same
+     * cache file return the same instance.
+     *
+     * @param cache_file Path to a cache file.  If empty, no cache is used.
+     */
+    static std::shared_ptr<const ColorLookupTable> get_shared(
+        const std::string &cache_file = "");
+
+private:
+    std::vector<uint8_t> table_;
+
+    /**
+     * @brief Compute a hash of the nodes of the compiled-in classifier model
+     * (see get_compiled_xgb_flat_model()).
+     *
+     * Used to detect cache files that were created for a different model.
+     */
+    static uint64_t compute_model_fingerprint();
+};
+
+}  // namespace trifinger_object_tracking
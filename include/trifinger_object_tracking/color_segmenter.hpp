@@ -4,48 +4,337 @@
 #include <future>
 #include <opencv2/opencv.hpp>
 
+#include <trifinger_object_tracking/color_lookup_table.hpp>
 #include <trifinger_object_tracking/cube_model.hpp>
+#include <trifinger_object_tracking/sparse_mask.hpp>
+#include <trifinger_object_tracking/thread_pool.hpp>
 #include <trifinger_object_tracking/types.hpp>
+#include <trifinger_object_tracking/xgboost_batch_classifier.hpp>
 
 namespace trifinger_object_tracking
 {
 class ColorSegmenter
 {
+public:
+    //! @brief Method used to classify the colour of the pixels.
+    enum class Backend
+    {
+        //! Evaluate the XGBoost classifier for every pixel (in batches, see
+        //! XGBoostBatchClassifier).
+        XGBOOST,
+        //! Look up the precomputed classifier output for the pixel colour
+        //! (same result as XGBOOST but much faster).
+        LOOKUP_TABLE
+    };
+
 private:
     CubeModel cube_model_;
-    cv::Mat image_hsv_, image_bgr_;
+    Backend backend_;
+    std::shared_ptr<const ColorLookupTable> lookup_table_;
+    std::shared_ptr<const XGBoostBatchClassifier> batch_classifier_;
+    //! Copy of the last input image (not blurred).
+    cv::Mat image_bgr_;
+    //! Buffer for the half-resolution BGR image of detect_colors_bayer().
+    cv::Mat bayer_quads_bgr_;
+    //! Region of the last input image that was segmented.
+    cv::Rect roi_;
 
-    //! individual color segment mask
-    std::array<cv::Mat, FaceColor::N_COLORS> masks_;
+    //! Label of each pixel (0 = background, see map_label_to_color_).
+    cv::Mat labels_;
+    //! Number of pixels per label in labels_.
+    std::array<unsigned int, FaceColor::N_COLORS + 1> label_counts_;
+    //! Number of pixels per label on the border of roi_ (only counting sides
+    //! that are not on the image border).
+    std::array<unsigned int, FaceColor::N_COLORS + 1> roi_border_counts_;
+
+    //! Run-length encoded mask of each colour.
+    std::array<SparseMask, FaceColor::N_COLORS> sparse_masks_;
+    //! Dense masks created on demand by get_mask() (empty if not requested
+    //! since the last call of detect_colors()).
+    mutable std::array<cv::Mat, FaceColor::N_COLORS> dense_masks_;
 
     std::vector<FaceColor> dominant_colors_;
 
-    void xgboost_mask();
+    //! Downscaling factor of the coarse classification (1 = disabled).
+    unsigned int coarse_scale_;
+
+    //! Working buffers for processing one band of rows in detect_colors().
+    //! They only hold a few rows at a time and are kept as members so they
+    //! are reused across frames.
+    struct BandWorkspace
+    {
+        //! Blurred BGR and HSV version of the current tile (views into the
+        //! buffers below).
+        cv::Mat tile_bgr, tile_hsv;
+        //! Buffers of the tiles.  Tiles at the image border are smaller, so
+        //! the buffers are only enlarged but never shrunk to avoid
+        //! reallocations.
+        cv::Mat tile_bgr_buffer, tile_hsv_buffer;
+        //! First image column (relative to roi_) contained in tile_bgr.
+        int tile_col_begin = 0;
+        //! Ring buffers with the last three rows of raw and eroded labels
+        //! (views into the buffers, see above).
+        cv::Mat raw_label_rows, eroded_label_rows;
+        cv::Mat raw_label_buffer, eroded_label_buffer;
+        //! Pixel counts of the band (see label_counts_, roi_border_counts_).
+        std::array<unsigned int, FaceColor::N_COLORS + 1> label_counts,
+            roi_border_counts;
+        //! Runs of the rows of the band (in image coordinates).
+        std::array<SparseMask, FaceColor::N_COLORS> sparse_masks;
+    };
+    std::vector<BandWorkspace> band_workspaces_;
+
+    // Buffers of the coarse classification.
+    cv::Mat coarse_bgr_, coarse_hsv_, coarse_labels_, active_blocks_;
+    //! Column ranges (relative to roi_) that need to be classified at full
+    //! resolution.  The spans of coarse row i are
+    //! active_spans_[active_spans_begin_[i]:active_spans_begin_[i + 1]].
+    std::vector<cv::Range> active_spans_;
+    std::vector<int> active_spans_begin_;
+
+    //! Map label index of the xgboost model to color (label 0 = background).
+    static constexpr std::array<FaceColor, FaceColor::N_COLORS>
+        map_label_to_color_ = {
+            FaceColor::BLUE,
+            FaceColor::CYAN,
+            FaceColor::GREEN,
+            FaceColor::MAGENTA,
+            FaceColor::RED,
+            FaceColor::YELLOW,
+        };
+
+    //! Get the label of the given colour in labels_.
+    static uint8_t get_label(FaceColor color);
+
+    //! Minimum number of rows per band when splitting the image for parallel
+    //! processing (each band has some overhead at its borders).
+    static constexpr int MIN_BAND_ROWS = 32;
+
+    /**
+     * @brief Segment the rows [row_begin, row_end) of the ROI.
+     *
+     * Only modifies these rows of labels_ and the workspace, so different
+     * bands can be processed in parallel.
+     */
+    void process_band(const cv::Mat &image_roi,
+                      int row_begin,
+                      int row_end,
+                      BandWorkspace *workspace);
+
+    //! Blur (and convert to HSV) the image region [row_begin, row_end) x
+    //! [col_begin, col_end).
+    void preprocess_tile(const cv::Mat &image_bgr,
+                         int row_begin,
+                         int row_end,
+                         int col_begin,
+                         int col_end,
+                         BandWorkspace *workspace) const;
+
+    //! Classify a downscaled version of the image and determine which parts
+    //! need to be classified at full resolution (see active_spans_).
+    void classify_coarse(const cv::Mat &image_bgr);
+
+    //! Get the coarse row which contains the given image row.
+    int get_coarse_row(int row) const
+    {
+        return row * coarse_labels_.rows / roi_.height;
+    }
+
+    //! Classify pixels with the selected backend.
+    void classify_pixels(const uint8_t *bgr,
+                         const uint8_t *hsv,
+                         int num_pixels,
+                         uint8_t *labels) const;
+
+    //! Allocate the output for an image of the given size and clear it.
+    void reset_output(const cv::Size &image_size);
+
+    //! Classify the columns [col_begin, col_end) (relative to roi_) of one
+    //! row of the current tile of the workspace.
+    void classify_row(const BandWorkspace &workspace,
+                      int tile_row,
+                      int col_begin,
+                      int col_end,
+                      uint8_t *labels) const;
+
+    //! Erode the given row (relative to roi_) of raw labels (result goes to
+    //! the eroded_label_rows of the workspace).
+    void erode_row(int row, BandWorkspace *workspace) const;
+
+    //! Dilate the given row (relative to roi_) of eroded labels and write the
+    //! final results.
+    void finish_row(int row, BandWorkspace *workspace);
+
+    void select_dominant_colors();
 
 public:
-    // constructor
-    ColorSegmenter(const CubeModel &cube_model);
+    /**
+     * @param cube_model Model of the object.
+     * @param backend Method used to classify the pixel colours.
+     * @param lookup_table_cache_file Only used with Backend::LOOKUP_TABLE.
+     *     Path to a file from which the lookup table is loaded.  If the file
+     *     does not exist, the table is built and written to it.  If empty, the
+     *     table is built without using a cache file.
+     * @param coarse_scale If greater than one, segmentation is done
+     *     coarse-to-fine:  The image is first classified at 1/coarse_scale
+     *     resolution (typically 4 or 8) and only blocks that contain or
+     *     neighbour coloured pixels are classified at full resolution.  Very
+     *     small coloured regions may be missed in this mode.
+     * @throw std::invalid_argument if coarse_scale is zero.
+     */
+    ColorSegmenter(const CubeModel &cube_model,
+                   Backend backend = Backend::XGBOOST,
+                   const std::string &lookup_table_cache_file = "",
+                   unsigned int coarse_scale = 1);
+
+    /**
+     * @brief Replace the colour classifier.
+     *
+     * Allows switching to a model loaded at runtime (see
+     * load_xgb_model_dump()) without recompiling.  Must not be called while
+     * detect_colors() is running.
+     *
+     * @param classifier The new classifier.
+     * @throw std::runtime_error if the segmenter does not use the XGBOOST
+     *     backend (the lookup table is always built from the compiled-in
+     *     model).
+     * @throw std::invalid_argument if classifier is null.
+     */
+    void set_classifier(
+        std::shared_ptr<const XGBoostBatchClassifier> classifier);
 
     /**
      * @brief Detect colours in the image and create segmentation masks.
      *
      * After calling this, dominant colours and segmentation masks are provided
-     * by get_dominant_colors() and get_mask().
+     * by get_dominant_colors() and get_sparse_mask() (or get_mask()).
+     *
+     * All steps (median blur, HSV conversion, classification, denoising and
+     * counting of pixels) are done in a single sweep over the image, working
+     * on a few rows at a time to keep the working set in the cache.
      *
      * @param image_bgr
      */
     void detect_colors(const cv::Mat &image_bgr);
 
-    //! @brief Get mask of the specified color.
+    /**
+     * @brief Detect colours only in a region of interest of the image.
+     *
+     * Like detect_colors(const cv::Mat&) but only the pixels inside the ROI
+     * are classified.  Everything outside is considered as background in the
+     * masks.  The ROI is processed as if it was the whole image, i.e. pixels
+     * outside of it are not used for blurring and denoising, so the result
+     * may differ from full-frame segmentation on the outermost pixels of the
+     * ROI.
+     *
+     * @param image_bgr
+     * @param roi Region of interest.  Is clipped to the image.
+     * @param thread_pool If set, the ROI is split into bands of rows which
+     *     are processed in parallel by the pool.
+     */
+    void detect_colors(const cv::Mat &image_bgr,
+                       const cv::Rect &roi,
+                       ThreadPool *thread_pool = nullptr);
+
+    /**
+     * @brief Detect colours in a raw Bayer image at half resolution.
+     *
+     * Instead of demosaicing the image, each 2x2 quad of the Bayer pattern is
+     * taken as one BGR pixel (red and blue of the quad, mean of the two
+     * green values).  The resulting half-resolution image is segmented like
+     * in detect_colors(), i.e. masks, ROI and get_image() refer to the half
+     * resolution.  Use scale_camera_parameters() with scale 0.5 to get the
+     * matching camera parameters.
+     *
+     * @param image_bayer Raw image of type CV_8UC1 with the Bayer pattern
+     *     used by the cameras (cv::COLOR_BayerBG2BGR in OpenCV notation, i.e.
+     *     quads "R G / G B").
+     * @param roi Region of interest in the half-resolution image.
+     * @param thread_pool See detect_colors().
+     * @throw std::invalid_argument if the image has the wrong type.
+     */
+    void detect_colors_bayer(const cv::Mat &image_bayer,
+                             const cv::Rect &roi,
+                             ThreadPool *thread_pool = nullptr);
+
+    //! @brief Get the region of the image that was segmented in the last call.
+    cv::Rect get_roi() const
+    {
+        return roi_;
+    }
+
+    /**
+     * @brief Get number of pixels of the given colour on the ROI border.
+     *
+     * Only considers the sides of the ROI that are not on the image border.
+     * A value greater than zero indicates that the object may extend beyond
+     * the ROI.  Always zero for full-frame segmentation.
+     */
+    unsigned int get_num_roi_border_pixels(FaceColor color) const;
+
+    /**
+     * @brief Get run-length encoded mask of the specified color.
+     *
+     * This is the native output of the segmentation, the reference is valid
+     * until the next call of detect_colors().
+     */
+    const SparseMask &get_sparse_mask(FaceColor color) const
+    {
+        return sparse_masks_[color];
+    }
+
+    /**
+     * @brief Get the label image of the last segmentation.
+     *
+     * Single channel image with label 0 for background and labels 1-6 for
+     * the colours (see get_label_color()).  The reference is valid until the
+     * next call of detect_colors().
+     */
+    const cv::Mat &get_label_image() const
+    {
+        return labels_;
+    }
+
+    //! @brief Get the colour of a non-zero label of get_label_image().
+    static FaceColor get_label_color(uint8_t label)
+    {
+        return map_label_to_color_[label - 1];
+    }
+
+    /**
+     * @brief Get the number of pixels of the given colour.
+     *
+     * Taken from the histogram of the label image that is computed during
+     * the segmentation.
+     */
+    unsigned int get_num_pixels(FaceColor color) const
+    {
+        return label_counts_[get_label(color)];
+    }
+
+    /**
+     * @brief Get mask of the specified color.
+     *
+     * Binary masks are not part of the segmentation output.  The mask is
+     * created from the label image when this is called for the first time
+     * after detect_colors(), so prefer get_sparse_mask() or
+     * get_label_image() in time-critical code.
+     */
     cv::Mat get_mask(FaceColor color) const;
 
     //! @brief Get image visualizing the color segmentation.
     cv::Mat get_segmented_image() const;
 
-    //! @brief Get the original image.
+    /**
+     * @brief Get the median-blurred input image of the last call of
+     * detect_colors(), i.e. the image that is classified.
+     *
+     * The blurred image is not kept by the segmentation, so it is computed
+     * anew by every call.
+     */
     cv::Mat get_image() const;
 
-    std::vector<FaceColor> get_dominant_colors() const;
+    const std::vector<FaceColor> &get_dominant_colors() const;
 };
 
 }  // namespace trifinger_object_tracking
@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <chrono>
+
+#include <trifinger_object_tracking/pose_search_parameters.hpp>
+
+namespace trifinger_object_tracking
+{
+/**
+ * @brief Feedback controller adapting the pose search to a frame period.
+ *
+ * The controller sets an effort in [MIN_EFFORT, 1], which scales the work of
+ * the pose search (num_samples * population_size * num_generations) relative
+ * to the maximum parameters.  After each frame, the measured durations are
+ * used to update smoothed estimates of the time that does not depend on the
+ * effort (image acquisition, segmentation, ...) and of the time of the pose
+ * search per unit of effort.  The effort is then chosen such that a frame is
+ * expected to take TARGET_UTILISATION of the period.
+ *
+ * Missed deadlines are considered worse than a slightly lower accuracy, so
+ * the effort is reduced immediately but increased by at most
+ * MAX_INCREASE_FACTOR per frame.
+ */
+class ComputeBudgetController
+{
+public:
+    //! Fraction of the frame period that is planned to be used.
+    static constexpr double TARGET_UTILISATION = 0.8;
+    //! Lower limit of the effort.
+    static constexpr double MIN_EFFORT = 0.02;
+    //! Maximum factor by which the effort is increased per update.
+    static constexpr double MAX_INCREASE_FACTOR = 1.1;
+    //! Weight of a new measurement in the smoothed duration estimates.
+    static constexpr double SMOOTHING_FACTOR = 0.3;
+
+    //! Lower limits of the individual parameters.
+    static constexpr unsigned int MIN_NUM_SAMPLES = 30;
+    static constexpr unsigned int MIN_POPULATION_SIZE = 10;
+    static constexpr unsigned int MIN_NUM_GENERATIONS = 5;
+
+    /**
+     * @param frame_period The period that is to be held.
+     * @param max_parameters Parameters used at full effort.
+     */
+    explicit ComputeBudgetController(
+        std::chrono::microseconds frame_period,
+        const PoseSearchParameters &max_parameters = PoseSearchParameters());
+
+    /**
+     * @brief Update the effort based on the durations of the last frame.
+     *
+     * @param fixed_duration Computation time of the frame that does not
+     *     depend on the parameters of the pose search.
+     * @param pose_search_duration Computation time of the pose search with
+     *     the parameters returned by get_parameters().
+     */
+    void update(std::chrono::microseconds fixed_duration,
+                std::chrono::microseconds pose_search_duration);
+
+    //! @brief Parameters for the pose search of the next frame.
+    const PoseSearchParameters &get_parameters() const
+    {
+        return parameters_;
+    }
+
+    //! @brief Work of get_parameters() relative to the maximum parameters.
+    double get_effort() const
+    {
+        return effort_;
+    }
+
+private:
+    std::chrono::microseconds frame_period_;
+    PoseSearchParameters max_parameters_;
+    PoseSearchParameters parameters_;
+    //! Effort set by the controller.
+    double requested_effort_ = 1.0;
+    //! Actual effort of parameters_ (differs from the requested one due to
+    //! rounding and the lower limits of the parameters).
+    double effort_ = 1.0;
+
+    bool has_estimates_ = false;
+    //! Smoothed estimates of the fixed duration and of the duration of the
+    //! pose search per unit of effort (in microseconds).
+    double fixed_duration_us_ = 0.0;
+    double pose_search_duration_us_per_effort_ = 0.0;
+
+    //! Set parameters_ and effort_ for the given effort.
+    void set_effort(double effort);
+};
+
+}  // namespace trifinger_object_tracking
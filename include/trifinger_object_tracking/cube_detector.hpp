@@ -5,45 +5,167 @@
  */
 #pragma once
 
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+
 #include <trifinger_object_tracking/color_segmenter.hpp>
 #include <trifinger_object_tracking/cube_model.hpp>
 #include <trifinger_object_tracking/cv_sub_images.hpp>
 #include <trifinger_object_tracking/object_pose.hpp>
 #include <trifinger_object_tracking/pose_detector.hpp>
+#include <trifinger_object_tracking/pose_filter.hpp>
 #include <trifinger_object_tracking/scoped_timer.hpp>
+#include <trifinger_object_tracking/thread_pool.hpp>
 
 namespace trifinger_object_tracking
 {
 /**
  * @brief Detect coloured cube in images from a three-camera setup.
+ *
+ * The detected poses are filtered with a constant-velocity motion model
+ * (PoseFilter).  When ROI tracking is enabled (see
+ * set_roi_tracking_enabled()), its prediction is used to determine where the
+ * object will be in the images and only this region of interest is
+ * segmented.
  */
 class CubeDetector
 {
 public:
     static constexpr unsigned int N_CAMERAS = 3;
 
+    //! If the pose found in the ROIs has a lower confidence, the full images
+    //! are segmented.
+    static constexpr float ROI_MIN_CONFIDENCE = 0.5;
+    //! Padding added on each side of the projected object, relative to the
+    //! size of its bounding box.
+    static constexpr float ROI_RELATIVE_PADDING = 0.3;
+    //! Minimum padding in pixels added on each side of the projected object.
+    static constexpr int ROI_MIN_PADDING = 10;
+    //! The ROI covers the object moved by this many standard deviations of
+    //! the predicted pose.
+    static constexpr float ROI_NUM_STD = 3.0;
+
+    //! Latency budget of the detect_cube* methods meaning "no limit".
+    static constexpr std::chrono::microseconds NO_LATENCY_BUDGET =
+        std::chrono::microseconds::zero();
+
+    //! Computation time of the stages of a detection.
+    struct StageDurations
+    {
+        std::chrono::microseconds segmentation;
+        std::chrono::microseconds pose_estimation;
+    };
+
     /**
      * @param camera_params Calibration parameters of the cameras.
+     * @param segmentation_backend Method used for the colour segmentation.
+     * @param num_threads Number of threads used by detect_cube() (including
+     *     the calling thread).  If zero, the number of hardware threads is
+     *     used.
+     * @param lookup_table_cache_file Cache file of the colour lookup table
+     *     (only used with ColorSegmenter::Backend::LOOKUP_TABLE, see
+     *     ColorSegmenter).  By default, the table is cached next to the
+     *     installed colour model (see get_default_lookup_table_cache_file()).
      */
     CubeDetector(const std::array<trifinger_cameras::CameraParameters,
-                                  N_CAMERAS> &camera_params);
+                                  N_CAMERAS> &camera_params,
+                 ColorSegmenter::Backend segmentation_backend =
+                     ColorSegmenter::Backend::XGBOOST,
+                 unsigned int num_threads = 0,
+                 const std::string &lookup_table_cache_file =
+                     get_default_lookup_table_cache_file());
 
     /**
      * @param camera_param_files Paths to the camera calibration files.
+     * @param segmentation_backend Method used for the colour segmentation.
+     * @param num_threads Number of threads used by detect_cube() (including
+     *     the calling thread).  If zero, the number of hardware threads is
+     *     used.
+     * @param lookup_table_cache_file Cache file of the colour lookup table
+     *     (only used with ColorSegmenter::Backend::LOOKUP_TABLE, see
+     *     ColorSegmenter).  By default, the table is cached next to the
+     *     installed colour model (see get_default_lookup_table_cache_file()).
      */
-    CubeDetector(const std::array<std::string, N_CAMERAS> &camera_param_files);
+    CubeDetector(const std::array<std::string, N_CAMERAS> &camera_param_files,
+                 ColorSegmenter::Backend segmentation_backend =
+                     ColorSegmenter::Backend::XGBOOST,
+                 unsigned int num_threads = 0,
+                 const std::string &lookup_table_cache_file =
+                     get_default_lookup_table_cache_file());
 
+    /**
+     * @brief Get the path of the cache file of the colour lookup table that
+     * is used by default.
+     *
+     * It is located next to the installed dump of the colour model
+     * (share/trifinger_object_tracking/models/).  If the directory is not
+     * writable, the table is built at every start (with a warning).
+     */
+    static std::string get_default_lookup_table_cache_file();
+
+    /**
+     * @brief Same as detect_cube() but without using the thread pool.
+     */
     ObjectPose detect_cube_single_thread(
-        const std::array<cv::Mat, N_CAMERAS> &images);
+        const std::array<cv::Mat, N_CAMERAS> &images,
+        std::chrono::microseconds latency_budget = NO_LATENCY_BUDGET,
+        std::optional<PoseFilter::TimePoint> frame_time = std::nullopt);
 
     /**
      * @brief Detect cube in the given images
      *
+     * The segmentation of the images is split into bands of rows which are
+     * processed in parallel by a persistent thread pool.
+     *
+     * If a latency budget is given, the pose optimisation is stopped when the
+     * budget (counted from the start of the call) would be exceeded and the
+     * best pose found so far is returned, see PoseDetector::find_pose().
+     * Since the segmentation is not interrupted, the budget should leave
+     * some time for the pose optimisation.
+     *
      * @param images Images from cameras camera60, camera180, camera300.
+     * @param latency_budget Time budget for the detection (not limited if
+     *     NO_LATENCY_BUDGET).
+     * @param frame_time Time at which the images were captured, used for the
+     *     prediction and the update of the motion model (see PoseFilter).  If
+     *     not set, the time of the call is used.
+     *
+     * @return Pose of the cube.
+     */
+    ObjectPose detect_cube(
+        const std::array<cv::Mat, N_CAMERAS> &images,
+        std::chrono::microseconds latency_budget = NO_LATENCY_BUDGET,
+        std::optional<PoseFilter::TimePoint> frame_time = std::nullopt);
+
+    /**
+     * @brief Detect cube in raw Bayer images.
+     *
+     * Like detect_cube() but takes the raw images of the cameras.  The images
+     * are not demosaiced but segmented at half resolution (see
+     * ColorSegmenter::detect_colors_bayer()).  The pose is estimated with the
+     * camera parameters scaled accordingly.
+     *
+     * @param images_bayer Raw images from cameras camera60, camera180,
+     *     camera300.
+     * @param latency_budget See detect_cube().
+     * @param frame_time See detect_cube().
      *
      * @return Pose of the cube.
      */
-    ObjectPose detect_cube(const std::array<cv::Mat, N_CAMERAS> &images);
+    ObjectPose detect_cube_bayer(
+        const std::array<cv::Mat, N_CAMERAS> &images_bayer,
+        std::chrono::microseconds latency_budget = NO_LATENCY_BUDGET,
+        std::optional<PoseFilter::TimePoint> frame_time = std::nullopt);
+
+    /**
+     * @brief Same as detect_cube_bayer() but without using the thread pool.
+     */
+    ObjectPose detect_cube_bayer_single_thread(
+        const std::array<cv::Mat, N_CAMERAS> &images_bayer,
+        std::chrono::microseconds latency_budget = NO_LATENCY_BUDGET,
+        std::optional<PoseFilter::TimePoint> frame_time = std::nullopt);
 
     /**
      * @brief Create debug image for the last call of detect_cube.
@@ -54,10 +176,184 @@ public:
      */
     cv::Mat create_debug_image(bool fill_faces = false) const;
 
+    /**
+     * @brief Enable/disable segmentation of a pose-predicted ROI.
+     *
+     * If enabled, the corners of the object are projected into the images
+     * based on the pose predicted by the motion model and only a padded
+     * bounding box around them is segmented (the padding grows with the
+     * uncertainty of the prediction).  Full images are segmented if the
+     * object is not tracked (no confident pose in the recent frames), if the
+     * object reaches the border of the ROI or if the pose found in the ROI
+     * has low confidence.
+     *
+     * Disabled by default.
+     */
+    void set_roi_tracking_enabled(bool enable);
+
+    /**
+     * @brief Enable/disable warm-started pose optimisation.
+     *
+     * If enabled, the pose optimisation starts around the pose predicted by
+     * the motion model with a reduced budget and only falls back to the
+     * global search if this does not result in a confident pose.  See
+     * PoseDetector::set_tracking_enabled() and PoseDetector::set_prior().
+     *
+     * Disabled by default.
+     */
+    void set_pose_tracking_enabled(bool enable);
+
+    /**
+     * @brief Enable/disable the local refinement of the detected pose.
+     *
+     * See PoseDetector::set_refinement_enabled().  Disabled by default.
+     */
+    void set_pose_refinement_enabled(bool enable);
+
+    /**
+     * @brief Enable/disable the triangulated initialisation of the global
+     * pose search.
+     *
+     * See PoseDetector::set_triangulation_enabled().  Disabled by default.
+     */
+    void set_pose_triangulation_enabled(bool enable);
+
+    /**
+     * @brief Set the objective of the pose optimisation.
+     *
+     * See PoseDetector::set_objective().  Default is
+     * PoseDetector::Objective::PIXEL_DISTANCE.
+     */
+    void set_pose_objective(PoseDetector::Objective objective);
+
+    /**
+     * @brief Set the budget of the pose search.
+     *
+     * See PoseDetector::set_search_parameters().
+     */
+    void set_pose_search_parameters(const PoseSearchParameters &parameters);
+
+    const PoseSearchParameters &get_pose_search_parameters() const
+    {
+        return pose_detector_.get_search_parameters();
+    }
+
+    /**
+     * @brief Get the computation time of the stages of the last detection.
+     *
+     * If the full images had to be segmented after the ROI (see
+     * set_roi_tracking_enabled()), both passes are included.
+     */
+    const StageDurations &get_last_stage_durations() const
+    {
+        return last_stage_durations_;
+    }
+
+    /**
+     * @brief Get the pose of the last detection filtered with PoseFilter.
+     *
+     * The filter is always updated, the prediction of it is used for the ROI
+     * (see set_roi_tracking_enabled()) and as prior of the pose search in the
+     * tracking mode (see set_pose_tracking_enabled()).
+     */
+    const ObjectPose &get_filtered_pose() const
+    {
+        return pose_filter_.get_pose();
+    }
+
+    //! @brief Forget the previous poses (next frame is fully segmented and
+    //! the pose is searched globally).
+    void reset_tracking();
+
+    /**
+     * @brief Load a colour model from an XGBoost dump file.
+     *
+     * The model replaces the compiled-in colour classifier of all cameras
+     * (see load_xgb_model_dump() for the supported formats).  This allows
+     * using a retrained model without recompiling.
+     *
+     * @param model_dump_file Path to the text or JSON dump of the model.
+     * @throw std::runtime_error if the file cannot be read or the detector
+     *     does not use the XGBOOST segmentation backend.
+     * @throw std::invalid_argument if the model is invalid.
+     */
+    void load_color_model(const std::string &model_dump_file);
+
 private:
     CubeModel cube_model_;
     std::array<ColorSegmenter, N_CAMERAS> color_segmenters_;
     PoseDetector pose_detector_;
+    //! Pose detector for half-resolution images of detect_cube_bayer().
+    PoseDetector bayer_pose_detector_;
+    //! True if the last call was detect_cube_bayer().
+    bool bayer_input_ = false;
+    //! Workers used by detect_cube() (pointer, so CubeDetector stays movable).
+    std::unique_ptr<ThreadPool> thread_pool_;
+
+    //! Dominant colours and their masks of the last call for each camera
+    //! (members, so their memory is reused across frames).
+    std::array<std::vector<FaceColor>, N_CAMERAS> dominant_colors_;
+    std::array<std::vector<SparseMask>, N_CAMERAS> masks_;
+
+    bool roi_tracking_enabled_ = false;
+    StageDurations last_stage_durations_ = {};
+    //! Motion model of the object, predicts the pose of the next frame.
+    PoseFilter pose_filter_;
+
+    //! Detect the cube, optionally running the segmentation in parallel.
+    ObjectPose detect(const std::array<cv::Mat, N_CAMERAS> &images,
+                      bool parallel,
+                      bool bayer_input,
+                      std::chrono::microseconds latency_budget,
+                      std::optional<PoseFilter::TimePoint> frame_time);
+
+    //! Pose detector matching the resolution of the last input.
+    PoseDetector &get_pose_detector()
+    {
+        return bayer_input_ ? bayer_pose_detector_ : pose_detector_;
+    }
+    const PoseDetector &get_pose_detector() const
+    {
+        return bayer_input_ ? bayer_pose_detector_ : pose_detector_;
+    }
+
+    /**
+     * @brief Segment the images and find the pose.
+     *
+     * @param images The camera images.
+     * @param rois Regions of interest in which the images are segmented.
+     * @param parallel If true, the images are processed using the thread
+     *     pool.
+     * @param deadline Deadline of the pose optimisation.
+     */
+    Pose segment_and_find_pose(const std::array<cv::Mat, N_CAMERAS> &images,
+                               const std::array<cv::Rect, N_CAMERAS> &rois,
+                               bool parallel,
+                               PoseDetector::TimePoint deadline);
+
+    //! Segment a single image (falls back to full image if the object is
+    //! cut off by the ROI).
+    void segment_image(unsigned int camera_idx,
+                       const cv::Mat &image,
+                       const cv::Rect &roi,
+                       ThreadPool *thread_pool,
+                       std::vector<FaceColor> *dominant_colors,
+                       std::vector<SparseMask> *masks);
+
+    /**
+     * @brief Predict the regions of interest based on the predicted pose.
+     *
+     * The ROI covers the projection of the object moved by up to ROI_NUM_STD
+     * standard deviations of the prediction along each axis.
+     *
+     * @param full_images Rectangles covering the full segmented images.
+     * @param prior The predicted pose.
+     * @return ROI for each camera or std::nullopt if the full images should
+     *     be segmented.
+     */
+    std::optional<std::array<cv::Rect, N_CAMERAS>> predict_rois(
+        const std::array<cv::Rect, N_CAMERAS> &full_images,
+        const PoseDetector::PosePrior &prior) const;
 
     //! Convert Pose to ObjectPose
     static ObjectPose convert_pose(const Pose &pose);
@@ -68,7 +364,11 @@ private:
  *
  * Loads the camera calibration of the robot on which it is executed and creates
  * a CubeDetector instance for it.
+ *
+ * @param num_threads Number of threads used by detect_cube(), see
+ *     CubeDetector::CubeDetector().  If only the single-thread methods are
+ *     used, set it to 1 so no worker threads are started.
  */
-CubeDetector create_trifingerpro_cube_detector();
+CubeDetector create_trifingerpro_cube_detector(unsigned int num_threads = 0);
 
 }  // namespace trifinger_object_tracking
@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+#include <trifinger_object_tracking/sparse_mask.hpp>
+
+namespace trifinger_object_tracking
+{
+/**
+ * @brief Distance transforms of a mask for scoring projected faces.
+ *
+ * Stores for each pixel in a region around the mask the distance to the
+ * closest pixel on the border of the mask and the distance to the closest
+ * pixel of the mask.  Outside of this region, the distances are extrapolated
+ * from its border.
+ *
+ * The transforms are computed once per frame with compute().  After that,
+ * compute_quad_cost() scores a projected face in time proportional to the
+ * length of its edges, independent of the number of mask pixels.
+ */
+class MaskDistanceField
+{
+public:
+    //! Margin (in pixels) around the bounding box of the mask that is covered
+    //! by the distance transforms.
+    static constexpr int MARGIN = 16;
+
+    /**
+     * @brief Compute the distance transforms of a mask.
+     *
+     * @param pixels Pixels of the mask.
+     */
+    void compute(const std::vector<cv::Point> &pixels);
+
+    /**
+     * @brief Compute the distance transforms of a run-length encoded mask.
+     *
+     * @param mask The mask.
+     */
+    void compute(const SparseMask &mask);
+
+    //! @brief True if the mask is empty (the distances are undefined then).
+    bool empty() const
+    {
+        return roi_.empty();
+    }
+
+    //! @brief Distance of a point to the closest pixel on the mask border.
+    float get_border_distance(const cv::Point2f &point) const
+    {
+        return lookup(border_distance_, point);
+    }
+
+    //! @brief Distance of a point to the closest pixel of the mask (zero for
+    //! pixels of the mask).
+    float get_mask_distance(const cv::Point2f &point) const
+    {
+        return lookup(mask_distance_, point);
+    }
+
+    /**
+     * @brief Chamfer cost of a quadrilateral w.r.t. the mask.
+     *
+     * Sum of the mean of sqrt(border distance) along the edges of the
+     * quadrilateral (sampled every EDGE_SAMPLE_SPACING pixels) and the mean of
+     * sqrt(mask distance) on a grid inside of it.  This is zero if the
+     * quadrilateral exactly covers the mask, and grows with the distance of
+     * its edges to the mask border, whether the quadrilateral is too large,
+     * too small or shifted.
+     *
+     * @param corners Corners of the quadrilateral.
+     *
+     * @return The cost.
+     */
+    float compute_quad_cost(const std::array<cv::Point2f, 4> &corners) const;
+
+private:
+    //! Distance between samples along the edges in compute_quad_cost().
+    static constexpr float EDGE_SAMPLE_SPACING = 2.0;
+    //! Maximum number of samples per edge (bounds the cost for implausible
+    //! candidates whose projection is huge).
+    static constexpr int MAX_EDGE_SAMPLES = 256;
+    //! Number of samples per dimension of the grid inside of the
+    //! quadrilateral in compute_quad_cost().
+    static constexpr int INTERIOR_GRID_SIZE = 4;
+
+    //! Region covered by the distance transforms (in image coordinates).
+    cv::Rect roi_;
+    //! Distance transforms (CV_32FC1) of the region.
+    cv::Mat border_distance_, mask_distance_;
+    //! Buffers for computing the transforms (members, so their memory is
+    //! reused).
+    cv::Mat mask_, eroded_mask_, transform_input_;
+
+    /**
+     * @brief Look up the distance at a point, extrapolating outside of the
+     *     region by adding the distance to the region.
+     */
+    float lookup(const cv::Mat &distances, const cv::Point2f &point) const;
+
+    /**
+     * @brief Set the region around the bounding box of the mask and clear
+     *     mask_ (or set the field to empty if the bounding box is empty).
+     */
+    void reset_region(const cv::Rect &bounding_box);
+
+    //! Compute the distance transforms of mask_.
+    void compute_transforms();
+};
+
+}  // namespace trifinger_object_tracking
@@ -1,9 +1,17 @@
 #pragma once
 #include <Eigen/Geometry>
+#include <chrono>
 #include <opencv2/core/eigen.hpp>
+#include <optional>
 #include <opencv2/opencv.hpp>
 #include <trifinger_cameras/camera_parameters.hpp>
+#include <trifinger_object_tracking/camera_projection.hpp>
 #include <trifinger_object_tracking/cube_model.hpp>
+#include <trifinger_object_tracking/mask_distance_field.hpp>
+#include <trifinger_object_tracking/pose_search_parameters.hpp>
+#include <trifinger_object_tracking/quad_distance.hpp>
+#include <trifinger_object_tracking/sparse_mask.hpp>
+#include <trifinger_object_tracking/thread_pool.hpp>
 #include <trifinger_object_tracking/types.hpp>
 
 // ignore all warnings of optim (this is a third-party library)
@@ -33,21 +41,110 @@ public:
     //! Number of cameras
     static constexpr unsigned int N_CAMERAS = 3;
 
+    //! Minimum confidence of the previous pose for using it as starting point
+    //! in the tracking mode (see set_tracking_enabled()).
+    static constexpr float TRACKING_MIN_CONFIDENCE = 0.7;
+
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    //! Deadline of find_pose() that is never reached.
+    static constexpr TimePoint NO_DEADLINE = TimePoint::max();
+
+    //! Objective of the global search (see set_objective()).
+    enum class Objective
+    {
+        //! Distances of the aggregated mask pixels to the projected faces.
+        PIXEL_DISTANCE,
+        //! Distance transforms of the masks sampled along the projected
+        //! faces.
+        DISTANCE_TRANSFORM
+    };
+
     typedef std::array<std::vector<std::vector<cv::Point>>,
                        PoseDetector::N_CAMERAS>
         MasksPixels;
+    //! Same as MasksPixels but run-length encoded.
+    typedef std::array<std::vector<SparseMask>, PoseDetector::N_CAMERAS>
+        SparseMasks;
+    //! Same as MasksPixels but with the coordinates as structure of arrays.
+    typedef std::array<std::vector<PixelCoordinates>, PoseDetector::N_CAMERAS>
+        MasksCoordinates;
+    //! Same as MasksPixels but as bit masks.
+    typedef std::array<std::vector<BitMask>, PoseDetector::N_CAMERAS>
+        MasksBits;
+    //! Distance transforms of the masks in MasksPixels.
+    typedef std::array<std::vector<MaskDistanceField>, PoseDetector::N_CAMERAS>
+        MasksDistanceFields;
+
+    //! @brief Predicted pose of the next frame (e.g. from a motion model).
+    struct PosePrior
+    {
+        Pose pose;
+        //! Standard deviations of the position (in metres) and of the
+        //! orientation (rotation vector).
+        cv::Vec3f position_std;
+        cv::Vec3f orientation_std;
+    };
 
     PoseDetector(const CubeModel &cube_model,
                  const std::array<trifinger_cameras::CameraParameters,
                                   N_CAMERAS> &camera_parameters);
 
+    /**
+     * @brief Find pose based on dense masks.
+     *
+     * @param dominant_colors For each camera the colours of the masks.
+     * @param masks For each camera the masks of the colours in
+     *     dominant_colors.
+     * @param thread_pool If set, the cost function is evaluated for the
+     *     candidates of each generation of the optimisation in parallel by the
+     *     pool.
+     * @param deadline The optimisation is stopped between two generations if
+     *     the next generation would not finish before this time.  The best
+     *     pose found so far is returned (with the confidence computed for
+     *     it).
+     *
+     * @return Pose of the object.
+     */
     Pose find_pose(
         const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
-        const std::array<std::vector<cv::Mat>, N_CAMERAS> &masks);
+        const std::array<std::vector<cv::Mat>, N_CAMERAS> &masks,
+        ThreadPool *thread_pool = nullptr,
+        TimePoint deadline = NO_DEADLINE);
+
+    /**
+     * @brief Find pose based on run-length encoded masks.
+     *
+     * Same as find_pose() with dense masks but avoids scanning the full
+     * images for the segmented pixels.
+     *
+     * @param dominant_colors For each camera the colours of the masks.
+     * @param masks For each camera the masks of the colours in
+     *     dominant_colors.
+     * @param thread_pool See above.
+     * @param deadline See above.
+     *
+     * @return Pose of the object.
+     */
+    Pose find_pose(
+        const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
+        const SparseMasks &masks,
+        ThreadPool *thread_pool = nullptr,
+        TimePoint deadline = NO_DEADLINE);
 
     // TODO which points are projected?
     std::vector<std::vector<cv::Point2f>> get_projected_points() const;
 
+    /**
+     * @brief Project the corners of the object into the images.
+     *
+     * @param object_pose Pose of the object in the world frame.
+     *
+     * @return For each camera the image points of the eight corners.
+     */
+    std::vector<std::vector<cv::Point2f>> get_projected_points(
+        const Pose &object_pose) const;
+
     /**
      * @brief Get corner indices of the visible faces.
      *
@@ -95,16 +192,250 @@ public:
 
     void set_pose(const Pose &pose);
 
+    /**
+     * @brief Enable/disable the tracking mode.
+     *
+     * In the tracking mode, the optimisation is initialised around the pose
+     * found in the previous call of find_pose() (or set with set_pose()) if
+     * its confidence is at least TRACKING_MIN_CONFIDENCE.  The spread of the
+     * initial population grows with decreasing confidence of the previous
+     * pose and a much smaller number of generations and population size is
+     * used.  If a prior is given (see set_prior()), it is used instead of the
+     * previous pose.  If the confidence of the resulting pose is below the
+     * threshold, the full global search is done as fallback.
+     *
+     * Disabled by default.
+     */
+    void set_tracking_enabled(bool enable)
+    {
+        tracking_enabled_ = enable;
+    }
+
+    bool is_tracking_enabled() const
+    {
+        return tracking_enabled_;
+    }
+
+    /**
+     * @brief Set the prior for the next call of find_pose().
+     *
+     * In the tracking mode, the initial population is then sampled within
+     * PRIOR_NUM_STD standard deviations around the predicted pose (but not
+     * less than a quarter and not more than the spread used around the
+     * previous pose) instead of around the previous pose.  This way, the
+     * search follows a moving object and its range adapts to the
+     * uncertainty of the prediction.  The prior is only used for one call.
+     */
+    void set_prior(const PosePrior &prior)
+    {
+        prior_ = prior;
+    }
+
+    /**
+     * @brief Enable/disable the local refinement of the pose.
+     *
+     * If enabled, the pose found by the differential evolution is refined
+     * with Levenberg-Marquardt on a smooth variant of the cost function
+     * (using analytic Jacobians of the projected corners).  Since the
+     * refinement takes care of the final precision, the global search runs
+     * with fewer generations in this case.
+     *
+     * Disabled by default.
+     */
+    void set_refinement_enabled(bool enable)
+    {
+        refinement_enabled_ = enable;
+    }
+
+    bool is_refinement_enabled() const
+    {
+        return refinement_enabled_;
+    }
+
+    /**
+     * @brief Enable/disable the initialisation of the global search with a
+     * triangulated position.
+     *
+     * If enabled, the position is triangulated from the centroids of the
+     * masks of all cameras (see triangulate_position()) and the positions of
+     * the initial population of the global search are sampled within
+     * TRIANGULATION_POSITION_SPREAD around it instead of the whole arena.
+     * This way, the search mostly has to find the orientation.  This helps
+     * when there is no previous pose (first frame, lost object).
+     *
+     * Disabled by default.
+     */
+    void set_triangulation_enabled(bool enable)
+    {
+        triangulation_enabled_ = enable;
+    }
+
+    bool is_triangulation_enabled() const
+    {
+        return triangulation_enabled_;
+    }
+
+    /**
+     * @brief Triangulate the position of the object from the masks.
+     *
+     * The rays through the centroids of the mask pixels (all colours
+     * combined) of the cameras are intersected in the least-squares sense.
+     * Since the masks cover the silhouette of the object, the centroid is
+     * close to the projection of the centre of the object.
+     *
+     * @param masks_pixels For each camera the pixels of the masks.
+     * @return The position or std::nullopt if less than two cameras see the
+     *     object or the rays do not meet (distance of a ray to the position
+     *     is more than TRIANGULATION_MAX_RAY_DISTANCE, e.g. due to
+     *     occlusions or misclassified pixels).
+     */
+    std::optional<cv::Vec3f> triangulate_position(
+        const MasksPixels &masks_pixels) const;
+
+    //! @brief Same as above but for run-length encoded masks.
+    std::optional<cv::Vec3f> triangulate_position(
+        const SparseMasks &masks) const;
+
+    /**
+     * @brief Set the objective of the global search.
+     *
+     * - PIXEL_DISTANCE: The mask pixels are aggregated into weighted grid
+     *   cells and for each cell the distance to the projected face is
+     *   computed, so the cost of one evaluation grows with the number of
+     *   cells (at most PoseSearchParameters::num_samples).
+     * - DISTANCE_TRANSFORM: The distance transforms of the masks are computed
+     *   once per frame and sampled along the edges and in the interior of the
+     *   projected faces, so the cost of one evaluation only depends on the
+     *   size of the faces in the images.
+     *
+     * The confidence and the refinement are not affected.  Default is
+     * PIXEL_DISTANCE.
+     */
+    void set_objective(Objective objective)
+    {
+        objective_ = objective;
+    }
+
+    Objective get_objective() const
+    {
+        return objective_;
+    }
+
+    /**
+     * @brief Set the budget of the global search.
+     *
+     * The number of samples is also used in the tracking mode.  The weight of
+     * the height term of the cost is scaled with the number of samples, so
+     * the balance of the terms does not change.
+     *
+     * @throw std::invalid_argument if num_samples or num_generations is zero
+     *     or population_size is less than 4.
+     */
+    void set_search_parameters(const PoseSearchParameters &parameters);
+
+    const PoseSearchParameters &get_search_parameters() const
+    {
+        return search_parameters_;
+    }
+
+    /**
+     * @brief Forget the previous pose, so the next call of find_pose() does
+     * the global search.
+     */
+    void reset_tracking()
+    {
+        confidence_ = 0.0;
+        prior_.reset();
+    }
+
+    /**
+     * @brief Compute the cost of a batch of candidate poses.
+     *
+     * This is the objective of the global search of find_pose() with
+     * Objective::PIXEL_DISTANCE.  The candidates are evaluated together:  the
+     * image corners of the faces are stored in structure-of-arrays form (one
+     * SIMD lane per candidate), so the distance of each mask pixel to the
+     * face is computed for all candidates at once.
+     *
+     * @param candidates Candidate poses (position, rotation vector), one per
+     *     row.
+     * @param begin First row of the batch.
+     * @param end One past the last row of the batch (at most 8 rows per
+     *     batch).
+     * @param dominant_colors For each camera the colours of the masks.
+     * @param masks_coordinates Pixels of the masks.
+     * @param costs Output of the costs (only the elements begin to end - 1
+     *     are set).
+     */
+    void cost_function(
+        const arma::mat &candidates,
+        size_t begin,
+        size_t end,
+        const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
+        const MasksCoordinates &masks_coordinates,
+        arma::vec *costs) const;
+
+    /**
+     * @brief Compute the cost of a batch of candidate poses on the distance
+     *     transforms of the masks (see Objective::DISTANCE_TRANSFORM).
+     *
+     * Same terms as cost_function() but the distance term of each face is
+     * MaskDistanceField::compute_quad_cost(), scaled with the total weight of
+     * the aggregated pixels of the mask so that it is weighted like in
+     * cost_function().
+     *
+     * @param candidates Candidate poses (position, rotation vector), one per
+     *     row.
+     * @param begin First row of the batch.
+     * @param end One past the last row of the batch.
+     * @param dominant_colors For each camera the colours of the masks.
+     * @param masks_distance_fields Distance transforms of the masks.
+     * @param costs Output of the costs (only the elements begin to end - 1
+     *     are set).
+     */
+    void distance_transform_cost_function(
+        const arma::mat &candidates,
+        size_t begin,
+        size_t end,
+        const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
+        const MasksDistanceFields &masks_distance_fields,
+        arma::vec *costs) const;
+
 private:
+    //! Spread of the initial population around the previous pose in the
+    //! tracking mode if the previous confidence is at
+    //! TRACKING_MIN_CONFIDENCE (position in metres, orientation as rotation
+    //! vector).  It is scaled down for higher confidences.
+    static constexpr float TRACKING_POSITION_SPREAD = 0.02;
+    static constexpr float TRACKING_ORIENTATION_SPREAD = 0.2;
+    //! Spread of the initial population around a prior in multiples of its
+    //! standard deviations.
+    static constexpr float PRIOR_NUM_STD = 3.0;
+    //! Budget of the differential evolution in the tracking mode.
+    static constexpr unsigned int TRACKING_NUM_GENERATIONS = 10;
+    static constexpr unsigned int TRACKING_POPULATION_SIZE = 20;
+    //! The differential evolution is stopped early if the best cost has not
+    //! improved for this number of generations.
+    static constexpr unsigned int NUM_STALL_GENERATIONS = 10;
+    //! Maximum number of aggregated mask points used in the refinement.
+    static constexpr unsigned int REFINEMENT_NUM_SAMPLES = 1000;
+    //! Maximum number of Levenberg-Marquardt iterations of the refinement.
+    static constexpr unsigned int REFINEMENT_MAX_ITERATIONS = 10;
+    //! Spread of the initial positions around the triangulated position (in
+    //! metres).
+    static constexpr float TRIANGULATION_POSITION_SPREAD = 0.02;
+    //! Maximum distance of the rays to the triangulated position (in metres).
+    static constexpr float TRIANGULATION_MAX_RAY_DISTANCE = 0.02;
+
     CubeModel cube_model_;
 
-    std::array<cv::Mat, N_CAMERAS> camera_matrices_;
-    std::array<cv::Mat, N_CAMERAS> distortion_coeffs_;
-    std::array<cv::Vec3d, N_CAMERAS> camera_orientations_;
-    std::array<cv::Vec3d, N_CAMERAS> camera_translations_;
+    //! Projection into the images of the cameras.
+    std::array<CameraProjection, N_CAMERAS> camera_projections_;
 
-    cv::Mat corners_in_cube_frame_;
-    cv::Mat reference_vector_normals_;
+    //! Corners of the object in homogeneous coordinates (one per column).
+    cv::Matx<float, 4, 8> corners_in_cube_frame_;
+    //! Normal vectors of the faces (one per column).
+    cv::Matx<float, 3, 6> reference_vector_normals_;
 
     Stats position_;
     Stats orientation_;
@@ -116,37 +447,165 @@ private:
     unsigned int num_misclassified_pixels_ = 0;
     float segmented_pixels_ratio_ = 0;
     float confidence_ = 0.0;
+    bool tracking_enabled_ = false;
+    bool refinement_enabled_ = false;
+    bool triangulation_enabled_ = false;
+    Objective objective_ = Objective::PIXEL_DISTANCE;
+    PoseSearchParameters search_parameters_;
+    std::optional<PosePrior> prior_;
+
+    //! Pixels of the dense masks (member, so the memory is reused across
+    //! frames).  Not used for sparse masks, those are processed run by run.
+    MasksPixels masks_pixels_;
+    //! Mask pixels aggregated to weighted points for the cost function of
+    //! the global search.
+    MasksCoordinates aggregated_masks_coordinates_;
+    //! Mask pixels aggregated to (more) weighted points for the refinement.
+    MasksCoordinates refinement_masks_coordinates_;
+    //! Bit masks of the masks for compute_confidence().
+    MasksBits masks_bits_;
+    //! Distance transforms of the masks for
+    //! distance_transform_cost_function() (only computed if this objective
+    //! is selected).
+    MasksDistanceFields masks_distance_fields_;
+    //! Population of the differential evolution, reused across frames.
+    optim::de_workspace_t de_workspace_;
 
+    /**
+     * @brief Estimate the pose from the masks (see find_pose()).
+     *
+     * @tparam Masks MasksPixels or SparseMasks.
+     */
+    template <typename Masks>
     void optimize_using_optim(
         const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
-        const std::array<std::vector<cv::Mat>, N_CAMERAS> &masks);
+        const Masks &masks,
+        ThreadPool *thread_pool,
+        TimePoint deadline);
+
+    /**
+     * @brief Run the differential evolution on the aggregated mask pixels.
+     *
+     * The resulting pose is written to position_.mean and orientation_.mean.
+     *
+     * @param dominant_colors For each camera the colours of the masks.
+     * @param initial_lb Lower bound of the initial population.
+     * @param initial_ub Upper bound of the initial population.
+     * @param num_generations Number of generations.
+     * @param population_size Size of the population.
+     * @param thread_pool If set, the batches of the population are evaluated
+     *     in parallel.
+     * @param deadline No generation is started that would not finish before
+     *     this time (estimated with the duration of the previous one).
+     */
+    void run_differential_evolution(
+        const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
+        const arma::vec &initial_lb,
+        const arma::vec &initial_ub,
+        unsigned int num_generations,
+        unsigned int population_size,
+        ThreadPool *thread_pool,
+        TimePoint deadline);
+
+    /**
+     * @brief Refine the pose in position_ and orientation_ with
+     *     Levenberg-Marquardt (see set_refinement_enabled()).
+     *
+     * No further iteration is started once the deadline has passed.
+     *
+     * @tparam Masks MasksPixels or SparseMasks.
+     */
+    template <typename Masks>
+    void refine_pose(
+        const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
+        const Masks &masks,
+        TimePoint deadline);
+
+    /**
+     * @brief Intersect the rays through the centroids of the masks (see
+     *     triangulate_position()).
+     *
+     * @param centroids For each camera the centroid of the mask pixels of
+     *     all colours (not set if the camera has no mask pixels).
+     */
+    std::optional<cv::Vec3f> triangulate_centroids(
+        const std::array<std::optional<cv::Point2f>, N_CAMERAS> &centroids)
+        const;
 
-    float cost_function(
+    /**
+     * @brief Smooth variant of cost_function() used for the refinement.
+     *
+     * @param position Position of the object.
+     * @param orientation Orientation of the object as rotation vector.
+     * @param dominant_colors For each camera the colours of the masks.
+     * @param masks_pixels Pixels of the masks.
+     * @param gradient Output of the gradient w.r.t. a perturbation of the pose
+     *     (see project_corners_with_jacobians()).
+     * @param hessian Output of the Gauss-Newton approximation of the Hessian.
+     *
+     * @return The cost.
+     */
+    double refinement_cost(
         const cv::Vec3f &position,
         const cv::Vec3f &orientation,
         const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
-        const MasksPixels &masks_pixels,
-        const float distance_cost_scaling,
-        const float invisibility_cost_scaling,
-        const float height_cost_scaling);
+        const MasksCoordinates &masks_coordinates,
+        Eigen::Matrix<double, 6, 1> *gradient,
+        Eigen::Matrix<double, 6, 6> *hessian) const;
 
+    /**
+     * @brief Compute the confidence of a pose.
+     *
+     * The projected visible faces are scan-converted and the mask pixels
+     * inside of them are counted on the bit masks, so the cost depends on the
+     * image area of the faces, not on the number of mask pixels.
+     *
+     * @param position Position of the object.
+     * @param orientation Orientation of the object as rotation vector.
+     * @param dominant_colors For each camera the colours of the masks.
+     * @param masks_bits The masks.
+     *
+     * @return Confidence in [0, 1].
+     */
     float compute_confidence(
         const cv::Vec3f &position,
         const cv::Vec3f &orientation,
         const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
-        const MasksPixels &masks_pixels);
+        const MasksBits &masks_bits);
 
     void compute_color_visibility(
         const FaceColor &color,
-        const cv::Mat &face_normals,
-        const cv::Mat &cube_corners,
+        const cv::Matx<float, 3, 6> &face_normals,
+        const cv::Matx<float, 4, 8> &cube_corners,
         bool *is_visible,
         float *face_normal_dot_camera_direction) const;
 
-    void compute_face_normals_and_corners(const unsigned int camera_idx,
-                                          const cv::Affine3f &cube_pose_world,
-                                          cv::Mat *normals,
-                                          cv::Mat *corners) const;
+    void compute_face_normals_and_corners(
+        const unsigned int camera_idx,
+        const cv::Affine3f &cube_pose_world,
+        cv::Matx<float, 3, 6> *normals,
+        cv::Matx<float, 4, 8> *corners) const;
+
+    /**
+     * @brief Project the corners and compute the derivatives of the image
+     *     points w.r.t. a perturbation of the object pose.
+     *
+     * The perturbation (dt, dw) is applied to the pose (R, t) of the object in
+     * the world frame as t + dt and exp(dw) * R.
+     *
+     * @param camera_idx Index of the camera.
+     * @param cube_pose_world Pose of the object in the world frame.
+     * @param cube_corners Corners in the camera frame (as computed by
+     *     compute_face_normals_and_corners()).
+     * @param image_points Output of the image points of the corners.
+     * @param jacobians Output of the 2x6 Jacobian of each image point.
+     */
+    void project_corners_with_jacobians(
+        unsigned int camera_idx,
+        const cv::Affine3f &cube_pose_world,
+        const cv::Matx<float, 4, 8> &cube_corners,
+        std::array<cv::Point2f, 8> *image_points,
+        std::array<cv::Matx<float, 2, 6>, 8> *jacobians) const;
 
     bool is_face_visible(FaceColor color,
                          unsigned int camera_idx,
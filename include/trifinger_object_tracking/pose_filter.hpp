@@ -0,0 +1,132 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+#include <Eigen/Eigen>
+#include <trifinger_object_tracking/object_pose.hpp>
+
+namespace trifinger_object_tracking
+{
+/**
+ * @brief Kalman filter with a constant velocity model for the object pose.
+ *
+ * Position and orientation are filtered independently, each with a constant
+ * (linear/angular) velocity model driven by white-noise acceleration.  The
+ * orientation is handled as error state: the estimate is a quaternion and
+ * the covariance is over a small rotation (rotation vector in the world
+ * frame) applied to it.
+ *
+ * The standard deviation of a measurement is the one given below divided by
+ * its confidence.  Measurements with a confidence below MIN_CONFIDENCE are
+ * ignored.  If a measurement is far off the prediction (e.g. because the
+ * object was moved abruptly), the filter is reinitialised with it instead of
+ * slowly converging towards it.
+ */
+class PoseFilter
+{
+public:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    //! Measurements with a lower confidence are ignored.
+    static constexpr double MIN_CONFIDENCE = 0.7;
+    //! Standard deviations of a measurement with confidence 1 (metres and
+    //! radians).
+    static constexpr double POSITION_MEASUREMENT_STD = 0.002;
+    static constexpr double ORIENTATION_MEASUREMENT_STD = 0.03;
+    //! Standard deviation of the velocities of a newly initialised filter
+    //! (m/s and rad/s).
+    static constexpr double INITIAL_VELOCITY_STD = 0.2;
+    static constexpr double INITIAL_ANGULAR_VELOCITY_STD = 2.0;
+    //! Spectral density of the white-noise accelerations of the motion model
+    //! (m^2/s^3 and rad^2/s^3).
+    static constexpr double ACCELERATION_NOISE = 1e-4;
+    static constexpr double ANGULAR_ACCELERATION_NOISE = 0.01;
+    //! The velocities are only extrapolated for this time (in seconds) after
+    //! the last measurement.  After that, the pose is held and is not
+    //! considered to be tracked anymore.
+    static constexpr double MAX_PREDICTION_TIME = 0.3;
+    //! Threshold on the squared Mahalanobis distance of the position or
+    //! orientation of a measurement to the prediction (99.9% quantile of the
+    //! chi-squared distribution with 3 degrees of freedom) above which the
+    //! filter is reinitialised.
+    static constexpr double REINITIALISATION_THRESHOLD = 16.27;
+    //! The confidence of the estimate is multiplied with this factor for
+    //! every update without a valid measurement.
+    static constexpr double CONFIDENCE_DEGRADATION = 0.9;
+
+    //! @brief Predicted pose and its uncertainty.
+    struct Prediction
+    {
+        ObjectPose pose;
+        //! Standard deviations of the position (in metres) and of the
+        //! orientation (angle around the world axes in radians).
+        Eigen::Vector3d position_std;
+        Eigen::Vector3d orientation_std;
+    };
+
+    /**
+     * @brief Update the filter with the pose detected in a new frame.
+     *
+     * @param measurement The detected pose.
+     * @param time Time at which the frame was taken.
+     *
+     * @return The filtered pose at the given time.  Its confidence is the one
+     *     of the last used measurement, degraded for every update without
+     *     (usable) measurement since then.
+     */
+    const ObjectPose &update(const ObjectPose &measurement, TimePoint time);
+
+    /**
+     * @brief Predict the pose at the given time.
+     *
+     * @return The prediction or std::nullopt if the object is not tracked
+     *     (no usable measurement within the last MAX_PREDICTION_TIME).
+     */
+    std::optional<Prediction> predict(TimePoint time) const;
+
+    //! @brief Filtered pose of the last update().
+    const ObjectPose &get_pose() const
+    {
+        return pose_;
+    }
+
+    //! @brief Forget all previous measurements.
+    void reset();
+
+private:
+    //! Covariance of [position, velocity] resp. [orientation error, angular
+    //! velocity].
+    typedef Eigen::Matrix<double, 6, 6> Covariance;
+
+    struct State
+    {
+        Eigen::Vector3d position;
+        Eigen::Vector3d velocity;
+        Eigen::Quaterniond orientation;
+        //! Angular velocity in the world frame.
+        Eigen::Vector3d angular_velocity;
+        Covariance position_covariance;
+        Covariance orientation_covariance;
+    };
+
+    bool initialised_ = false;
+    State state_;
+    //! Time of state_ and of the last used measurement.
+    TimePoint time_, measurement_time_;
+
+    ObjectPose pose_;
+
+    //! Initialise the state with the given measurement.
+    void initialise(const ObjectPose &measurement, TimePoint time);
+
+    //! Get the state propagated to the given time.
+    State propagate(TimePoint time) const;
+};
+
+}  // namespace trifinger_object_tracking
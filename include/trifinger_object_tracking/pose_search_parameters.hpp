@@ -0,0 +1,35 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+namespace trifinger_object_tracking
+{
+/**
+ * @brief Budget of the global pose search of PoseDetector.
+ *
+ * The computation time of the search is roughly proportional to the product
+ * of the three values.
+ */
+struct PoseSearchParameters
+{
+    //! Maximum number of points (over all cameras and colours) that are used
+    //! in the cost function.  The mask pixels are aggregated into weighted
+    //! grid cells, with the cell size chosen to not exceed this number.
+    unsigned int num_samples = 150;
+    //! Population size of the differential evolution.
+    unsigned int population_size = 40;
+    //! Maximum number of generations of the differential evolution (half of
+    //! it is used if the refinement is enabled).
+    unsigned int num_generations = 50;
+
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(num_samples, population_size, num_generations);
+    }
+};
+
+}  // namespace trifinger_object_tracking
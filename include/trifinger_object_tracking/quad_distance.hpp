@@ -0,0 +1,160 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+#include <trifinger_object_tracking/bit_mask.hpp>
+#include <trifinger_object_tracking/sparse_mask.hpp>
+
+namespace trifinger_object_tracking
+{
+/**
+ * @brief Weighted pixel coordinates stored as structure of arrays.
+ *
+ * Allows loading the coordinates of consecutive pixels directly into SIMD
+ * registers.  Each point has a weight, so one point can represent several
+ * pixels (see assign_aggregated()).
+ */
+struct PixelCoordinates
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> weight;
+    //! Sum of all weights.
+    float total_weight = 0;
+
+    //! @brief Set the coordinates of the given pixels with weight 1 (reuses
+    //! the memory).
+    void assign(const std::vector<cv::Point> &pixels);
+
+    /**
+     * @brief Set the points to the centroids of the pixels in the cells of a
+     * grid (reuses the memory).
+     *
+     * The image is divided into cells of cell_size x cell_size pixels
+     * (aligned to the image origin).  For each cell that contains at least
+     * one of the pixels, a point at the centroid of its pixels is added with
+     * a weight of the number of its pixels times weight_scale.  The points
+     * are sorted by cell row, then column, so the result does not depend on
+     * the order of the pixels.
+     *
+     * @param pixels The pixels (with non-negative coordinates).
+     * @param cell_size Size of the cells (in pixels, at least 1).
+     * @param weight_scale Weight of a single pixel.
+     */
+    void assign_aggregated(const std::vector<cv::Point> &pixels,
+                           int cell_size,
+                           float weight_scale);
+
+    /**
+     * @brief Same as above but for the pixels of a run-length encoded mask.
+     *
+     * The runs are split at the borders of the cells, so the time depends
+     * on the number of runs and cells, not on the number of pixels.
+     */
+    void assign_aggregated(const SparseMask &mask,
+                           int cell_size,
+                           float weight_scale);
+
+    size_t size() const
+    {
+        return x.size();
+    }
+
+    bool empty() const
+    {
+        return x.empty();
+    }
+};
+
+/**
+ * @brief Image corners of one quadrilateral for a batch of candidate poses.
+ *
+ * Stored as structure of arrays, i.e. x[i][lane] is the x-coordinate of
+ * corner i for candidate lane, so corresponding corners of all candidates can
+ * be loaded into one SIMD register.
+ */
+struct QuadBatch
+{
+    //! Number of candidates in a batch (one per lane of an AVX register).
+    static constexpr size_t SIZE = 8;
+
+    alignas(32) float x[4][SIZE];
+    alignas(32) float y[4][SIZE];
+};
+
+/**
+ * @brief Add the distance cost of pixels w.r.t. a quadrilateral for a batch
+ * of candidates.
+ *
+ * For each pixel, the distance d to the border of the quadrilateral (same as
+ * |cv::pointPolygonTest(quad, pixel, true)|) is computed and w * sqrt(d) is
+ * added to the cost if the pixel is outside and 0.05 * w * sqrt(d) if it is
+ * inside, where w is the weight of the pixel.
+ * Pixels close to the borders are cheaper, which helps to resolve ambiguities
+ * under the assumption that some parts of the object boundaries are visible.
+ *
+ * The SIMD implementation uses an approximate square root (relative error
+ * below 1e-3).
+ *
+ * @param quads Corners of the quadrilateral for all candidates.
+ * @param pixels The pixels.
+ * @param costs Costs of the candidates (QuadBatch::SIZE elements) to which
+ *     the distance costs are added.
+ * @param use_simd If true, use the AVX2 implementation if it is supported by
+ *     the CPU.
+ */
+void add_quad_distance_costs(const QuadBatch &quads,
+                             const PixelCoordinates &pixels,
+                             float *costs,
+                             bool use_simd = true);
+
+/**
+ * @brief Count the pixels that are outside of a convex quadrilateral.
+ *
+ * Uses four edge half-plane tests, pixels on the border count as inside.  For
+ * convex quadrilaterals (e.g. the projection of a face of the cube) this is
+ * the same as the number of pixels for which cv::pointPolygonTest returns a
+ * negative value.  The weights of the pixels are ignored.
+ *
+ * @param corners Corners of the quadrilateral (in either orientation).
+ * @param pixels The pixels.
+ * @param use_simd If true, use the AVX2 implementation if it is supported by
+ *     the CPU.
+ *
+ * @return Number of pixels outside of the quadrilateral.
+ */
+size_t count_pixels_outside_quad(const std::array<cv::Point, 4> &corners,
+                                 const PixelCoordinates &pixels,
+                                 bool use_simd = true);
+
+/**
+ * @brief Count the pixels of a mask that are inside of a convex
+ * quadrilateral.
+ *
+ * Gives the same result as
+ * mask.get_num_pixels() - count_pixels_outside_quad(corners, mask pixels) but
+ * scan-converts the quadrilateral into one span of columns per row and counts
+ * the set pixels of the mask in these spans with popcounts.  So the cost is
+ * proportional to the area of the overlap of the bounding boxes of the
+ * quadrilateral and the mask (divided by 64) instead of to the number of
+ * pixels of the mask.  (For degenerate quadrilaterals with all corners on one
+ * line, only pixels on the line within the bounding box of the corners are
+ * counted.)
+ *
+ * @param corners Corners of the quadrilateral (in either orientation).
+ * @param mask The mask.
+ *
+ * @return Number of pixels of the mask inside of the quadrilateral (pixels on
+ *     the border count as inside).
+ */
+unsigned int count_mask_pixels_in_quad(const std::array<cv::Point, 4> &corners,
+                                       const BitMask &mask);
+
+}  // namespace trifinger_object_tracking
@@ -0,0 +1,100 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+namespace trifinger_object_tracking
+{
+/**
+ * @brief Horizontal run of set pixels in one row of a mask.
+ *
+ * Covers the pixels [col_begin, col_end) of the row.
+ */
+struct PixelRun
+{
+    int row;
+    int col_begin;
+    int col_end;
+};
+
+/**
+ * @brief Run-length encoded binary mask.
+ *
+ * Only stores the runs of set pixels, so the memory needed depends on the size
+ * of the segmented regions, not on the size of the image.  Runs are expected
+ * to be added in row-major order, so that the pixels are enumerated in the
+ * same order as by cv::findNonZero.
+ */
+class SparseMask
+{
+public:
+    SparseMask() = default;
+
+    /**
+     * @brief Encode a dense mask.
+     *
+     * @param mask Mask of type CV_8UC1.  All non-zero pixels are considered
+     *     as set.
+     */
+    explicit SparseMask(const cv::Mat &mask);
+
+    //! @brief Remove all runs (keeps the allocated memory).
+    void clear()
+    {
+        runs_.clear();
+        num_pixels_ = 0;
+    }
+
+    //! @brief Append a run.  It must not overlap with any existing run.
+    void add_run(int row, int col_begin, int col_end)
+    {
+        runs_.push_back({row, col_begin, col_end});
+        num_pixels_ += col_end - col_begin;
+    }
+
+    //! @brief Append all runs of another mask.
+    void append(const SparseMask &other);
+
+    const std::vector<PixelRun> &get_runs() const
+    {
+        return runs_;
+    }
+
+    //! @brief Number of set pixels.
+    unsigned int get_num_pixels() const
+    {
+        return num_pixels_;
+    }
+
+    bool empty() const
+    {
+        return num_pixels_ == 0;
+    }
+
+    //! @brief Bounding box of the set pixels (empty if there are none).
+    cv::Rect get_bounding_box() const;
+
+    /**
+     * @brief Get the coordinates of all set pixels.
+     *
+     * Equivalent to calling cv::findNonZero on the dense mask.
+     *
+     * @param pixels Output.  Previous content is replaced.
+     */
+    void get_pixels(std::vector<cv::Point> *pixels) const;
+
+    //! @brief Decode to a dense CV_8UC1 mask (set pixels are 255).
+    cv::Mat to_dense(const cv::Size &size) const;
+
+private:
+    std::vector<PixelRun> runs_;
+    unsigned int num_pixels_ = 0;
+};
+
+}  // namespace trifinger_object_tracking
@@ -0,0 +1,158 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace trifinger_object_tracking
+{
+/**
+ * @brief Persistent pool of worker threads with work stealing.
+ *
+ * Work is submitted with parallel_for().  Each worker has its own task queue
+ * and takes tasks from the back of it.  Workers that run out of tasks steal
+ * from the front of the queues of the other workers.  The calling thread
+ * helps executing tasks until all tasks of its call are done, so
+ * parallel_for() can also be called from within a task (nested parallelism)
+ * without blocking a worker.  Once there are no queued tasks left, it
+ * sleeps until the last task of its call is finished (instead of spinning).
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @param num_threads Number of threads that execute tasks, including the
+     *     thread calling parallel_for() (i.e. num_threads - 1 workers are
+     *     started).  If zero, the number of hardware threads is used.
+     */
+    explicit ThreadPool(unsigned int num_threads = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    //! @brief Number of threads executing tasks (workers + calling thread).
+    unsigned int get_num_threads() const
+    {
+        return workers_.size() + 1;
+    }
+
+    /**
+     * @brief Call func(i) for i in [0, num_tasks) in parallel.
+     *
+     * Blocks until all calls are finished.  func is only referenced, not
+     * copied, so no memory is allocated once the task queues have grown to
+     * the needed size.
+     *
+     * If func throws, the other calls are still executed and the first
+     * exception is rethrown on the calling thread once all calls are
+     * finished.
+     */
+    template <typename Func>
+    void parallel_for(size_t num_tasks, const Func &func)
+    {
+        run_tasks(num_tasks, &call_function<Func>, &func);
+    }
+
+private:
+    //! Type-erased call of the function of a parallel_for() call.
+    typedef void (*TaskFunction)(const void *func, size_t index);
+
+    template <typename Func>
+    static void call_function(const void *func, size_t index)
+    {
+        (*static_cast<const Func *>(func))(index);
+    }
+
+    //! State of one parallel_for() call.
+    struct Call
+    {
+        //! Number of unfinished tasks.
+        std::atomic<size_t> num_remaining;
+        //! Set (with mutex locked) by the task that finishes last.
+        bool finished = false;
+        //! First exception thrown by a task (set with mutex locked).
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable finished_condition;
+
+        explicit Call(size_t num_tasks) : num_remaining(num_tasks)
+        {
+        }
+    };
+
+    struct Task
+    {
+        TaskFunction call;
+        const void *func;
+        size_t index;
+        //! The parallel_for() call the task belongs to.
+        Call *parent;
+    };
+
+    /**
+     * @brief Double-ended task queue.
+     *
+     * Stored in a ring buffer that only grows, so unlike std::deque, pushing
+     * and popping tasks does not allocate memory in the steady state.
+     */
+    class TaskQueue
+    {
+    public:
+        std::mutex mutex;
+
+        TaskQueue();
+
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+        void push_back(const Task &task);
+        Task pop_back();
+        Task pop_front();
+
+    private:
+        std::vector<Task> buffer_;
+        size_t begin_ = 0;
+        size_t size_ = 0;
+    };
+
+    std::vector<std::thread> workers_;
+    //! One queue per worker plus one shared by all non-worker threads.
+    std::vector<std::unique_ptr<TaskQueue>> queues_;
+
+    //! Number of tasks in all queues.
+    std::atomic<size_t> num_queued_tasks_{0};
+    std::mutex wake_up_mutex_;
+    std::condition_variable wake_up_;
+    bool stop_ = false;
+
+    //! Implementation of parallel_for().
+    void run_tasks(size_t num_tasks, TaskFunction call, const void *func);
+
+    void worker_loop(size_t queue_index);
+
+    //! Index of the queue of the current thread.
+    size_t get_own_queue_index() const;
+
+    /**
+     * @brief Take a task from the own queue or steal one from another queue.
+     *
+     * @return True if a task was found.
+     */
+    bool try_pop_task(size_t own_queue_index, Task *task);
+
+    static void run_task(const Task &task);
+};
+
+}  // namespace trifinger_object_tracking
@@ -7,11 +7,16 @@
 
 #include <trifinger_cameras/camera_observation.hpp>
 #include <trifinger_object_tracking/object_pose.hpp>
+#include <trifinger_object_tracking/pose_search_parameters.hpp>
 
 namespace trifinger_object_tracking
 {
 /**
  * @brief Observation of three cameras + object tracking
+ *
+ * Only the camera observations and the object poses are serialised, so the
+ * format of existing log files stays readable.  The other fields describe
+ * the processing of the frame and are only available at runtime.
  */
 struct TriCameraObjectObservation
 {
@@ -20,6 +25,17 @@ struct TriCameraObjectObservation
     trifinger_object_tracking::ObjectPose object_pose;
     trifinger_object_tracking::ObjectPose filtered_object_pose;
 
+    //! Budget of the pose search that was used for object_pose.
+    trifinger_object_tracking::PoseSearchParameters pose_search_parameters;
+
+    //! Number of preprocessed frames that were waiting for the detection when
+    //! the detection of this frame started (0 if the detection keeps up with
+    //! the camera rate).
+    unsigned int detection_queue_depth = 0;
+    //! Number of frames that were dropped by the pipeline since the previous
+    //! observation because a stage could not keep up.
+    unsigned int num_dropped_frames = 0;
+
     template <class Archive>
     void serialize(Archive& archive)
     {
@@ -5,18 +5,97 @@
  */
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 #include <robot_interfaces/sensors/sensor_driver.hpp>
 #include <trifinger_cameras/pylon_driver.hpp>
+#include <trifinger_object_tracking/bounded_queue.hpp>
+#include <trifinger_object_tracking/compute_budget_controller.hpp>
 #include <trifinger_object_tracking/cube_detector.hpp>
 #include <trifinger_object_tracking/tricamera_object_observation.hpp>
 
 namespace trifinger_object_tracking
 {
+//! @brief Options of the object tracking of TriCameraObjectTrackerDriver.
+struct TriCameraObjectTrackerOptions
+{
+    /**
+     * @brief Segment the raw Bayer images at half resolution instead of
+     * demosaicing them (see CubeDetector::detect_cube_bayer()).
+     *
+     * Disabled by default, as the compiled-in colour model is trained on
+     * demosaiced images and the accuracy on raw camera images is not
+     * validated yet.
+     */
+    bool segment_bayer_images = false;
+
+    /**
+     * @brief Segment only the region of the images where the motion model
+     * predicts the object (see CubeDetector::set_roi_tracking_enabled()).
+     */
+    bool roi_tracking = false;
+
+    /**
+     * @brief Start the pose search around the predicted pose (see
+     * CubeDetector::set_pose_tracking_enabled()).
+     */
+    bool pose_tracking = false;
+
+    /**
+     * @brief Start the global pose search around the triangulated position
+     * of the object (see CubeDetector::set_pose_triangulation_enabled()).
+     */
+    bool pose_triangulation = false;
+};
+
 /**
  * @brief Driver to create three instances of the PylonDriver
  * and get observations from them.
+ *
+ * The processing runs as a pipeline of three stages, each on its own thread,
+ * connected by BoundedQueues:
+ *
+ * 1. Capture: Acquires the images of the three cameras at the given rate.
+ * 2. Preprocessing: Demosaics the raw images.  If
+ *    TriCameraObjectTrackerOptions::segment_bayer_images is set, the raw
+ *    images are passed on unchanged.
+ * 3. Detection: Segments the images and estimates the object pose (see
+ *    CubeDetector::detect_cube_single_thread() and
+ *    CubeDetector::detect_cube_bayer_single_thread()).
+ *
+ * So the stages of consecutive frames overlap and the throughput is limited
+ * by the slowest stage instead of the sum of all.  get_observation() returns
+ * the most recent completed observation.  Segmentation and pose estimation
+ * are kept in one stage, as the ROI of the segmentation and the prior of the
+ * pose search of a frame depend on the pose of the previous one and a
+ * low-confidence pose found in the ROI triggers a segmentation of the full
+ * images.
+ *
+ * The parallelism comes from the pipeline only: the detection runs on a
+ * single thread, so the stages do not compete for the cores with a thread
+ * pool of the CubeDetector (which is created without workers).
+ *
+ * If a stage falls behind, the queues drop the oldest frames instead of
+ * blocking the camera, so the latency stays bounded.  The number of frames
+ * that waited for the detection and the number of dropped frames are
+ * reported in the observation.
+ *
+ * The budget of the pose search is adapted by a ComputeBudgetController
+ * based on the measured computation time of the previous frames, so that the
+ * processing of a frame fits into the period given by rate.  Additionally,
+ * the pose search is stopped when the end of the period is reached (see
+ * CubeDetector::detect_cube()).  The used parameters are reported in the
+ * observation.
+ *
+ * The ROI tracking, pose tracking and triangulation of the CubeDetector can
+ * be enabled with the TriCameraObjectTrackerOptions.  The filtered object
+ * pose of the observation is the output of its motion model (see
+ * PoseFilter).
  */
 class TriCameraObjectTrackerDriver
     : public robot_interfaces::SensorDriver<TriCameraObjectObservation>
@@ -28,31 +107,99 @@ public:
 
     static constexpr unsigned int N_CAMERAS = 3;
 
+    //! Maximum number of frames waiting in each queue of the pipeline.
+    static constexpr size_t QUEUE_CAPACITY = 2;
+
+    //! Number of frames waiting in the queues of the pipeline.
+    struct QueueDepths
+    {
+        //! Captured frames waiting for the preprocessing.
+        size_t preprocessing;
+        //! Preprocessed frames waiting for the detection.
+        size_t detection;
+        //! Completed observations waiting for get_observation().
+        size_t output;
+    };
+
     /**
      * @param device_id_1 device user id of first camera
      * @param device_id_2 likewise, the 2nd's
      * @param device_id_3 and the 3rd's
      * @param downsample_images If set to true (default), images are
      *     downsampled to half their original size.
+     * @param options Options of the object tracking.
      */
-    TriCameraObjectTrackerDriver(const std::string& device_id_1,
-                                 const std::string& device_id_2,
-                                 const std::string& device_id_3,
-                                 bool downsample_images = true);
+    TriCameraObjectTrackerDriver(
+        const std::string& device_id_1,
+        const std::string& device_id_2,
+        const std::string& device_id_3,
+        bool downsample_images = true,
+        const TriCameraObjectTrackerOptions& options =
+            TriCameraObjectTrackerOptions());
+
+    //! Stops the threads of the pipeline.
+    ~TriCameraObjectTrackerDriver();
+
+    TriCameraObjectTrackerDriver(const TriCameraObjectTrackerDriver&) = delete;
+    TriCameraObjectTrackerDriver& operator=(
+        const TriCameraObjectTrackerDriver&) = delete;
 
     /**
      * @brief Get the latest observation from the three cameras
+     *
+     * Waits until an observation is completed that has not been returned
+     * before.  If several are available, older ones are dropped.
+     *
      * @return TricameraObservation
+     * @throw The exception of a stage of the pipeline that failed, once the
+     *     observations completed before the failure have been returned (the
+     *     pipeline is stopped then).
      */
     TriCameraObjectObservation get_observation();
 
+    //! @brief Get the current number of frames in the queues of the
+    //! pipeline.
+    QueueDepths get_queue_depths() const;
+
 private:
     std::array<trifinger_cameras::PylonDriver, N_CAMERAS> cameras_;
     trifinger_object_tracking::CubeDetector cube_detector_;
+    ComputeBudgetController budget_controller_;
     std::chrono::time_point<std::chrono::system_clock> last_update_time_;
     bool downsample_images_;
+    TriCameraObjectTrackerOptions options_;
+
+    //! A frame with the images that are passed to the CubeDetector.
+    struct PreprocessedFrame
+    {
+        TriCameraObjectObservation observation;
+        std::array<cv::Mat, N_CAMERAS> images;
+    };
+
+    //! Captured frames (with only the camera observations set).
+    BoundedQueue<TriCameraObjectObservation> capture_queue_;
+    //! Frames with demosaiced (or raw) images.
+    BoundedQueue<PreprocessedFrame> preprocessed_queue_;
+    //! Completed observations.
+    BoundedQueue<TriCameraObjectObservation> output_queue_;
+    //! Frames dropped since the last call of get_observation().
+    std::atomic<unsigned int> num_dropped_frames_{0};
+
+    std::atomic<bool> stop_{false};
+    //! First error that occurred in one of the stages.
+    std::exception_ptr error_;
+    std::mutex error_mutex_;
+
+    std::thread capture_thread_;
+    std::thread preprocessing_thread_;
+    std::thread detection_thread_;
+
+    void capture_loop();
+    void preprocessing_loop();
+    void detection_loop();
 
-    ObjectPose previous_pose_;
+    //! Store the error if it is the first one.
+    void set_error(std::exception_ptr error);
 };
 
 }  // namespace trifinger_object_tracking
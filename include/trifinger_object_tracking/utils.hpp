@@ -21,4 +21,22 @@ namespace trifinger_object_tracking
 std::array<trifinger_cameras::CameraParameters, 3> load_camera_parameters(
     std::array<std::string, 3> parameter_files);
 
+/**
+ * @brief Adjust camera calibration parameters to a scaled image.
+ *
+ * Scales image size and intrinsic camera matrix such that a pixel of the
+ * scaled image corresponds to a block of 1/scale x 1/scale pixels of the
+ * original image (e.g. the 2x2 quads of a Bayer image for scale = 0.5).
+ * Pixel coordinates are assumed to refer to pixel centres, so the principal
+ * point is shifted accordingly.  Distortion and extrinsic parameters do not
+ * depend on the image resolution and are kept.
+ *
+ * @param camera_params Parameters of the original image.
+ * @param scale Scale factor of the image (e.g. 0.5 for half resolution).
+ *
+ * @return Parameters for the scaled image.
+ */
+trifinger_cameras::CameraParameters scale_camera_parameters(
+    const trifinger_cameras::CameraParameters &camera_params, double scale);
+
 }  // namespace trifinger_object_tracking
@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <trifinger_object_tracking/xgboost_classifier.h>
+
+namespace trifinger_object_tracking
+{
+/**
+ * @brief XGBoost tree ensemble stored as flat node arrays.
+ *
+ * Nodes of all trees are stored in one array (structure of arrays).  Child
+ * indices are absolute indices into these arrays.  Leaves are marked with
+ * feature = -1 and point to themselves as children, so a tree can be
+ * traversed with a fixed number of steps.
+ */
+struct XGBoostFlatModel
+{
+    int num_classes = 0;
+    int num_features = 0;
+
+    //! Index of the root node of each tree.
+    std::vector<int32_t> tree_roots;
+    //! Class to which the output of each tree is added.
+    std::vector<int32_t> tree_classes;
+    //! Depth of each tree (number of splits on the longest path).
+    std::vector<int32_t> tree_depths;
+
+    //! Feature index used by the split (-1 for leaves).
+    std::vector<int32_t> feature;
+    //! Split threshold.  The "yes" child is taken if feature < threshold.
+    std::vector<double> threshold;
+    //! Child taken if feature < threshold.
+    std::vector<int32_t> yes;
+    //! Child taken otherwise.
+    std::vector<int32_t> no;
+    //! Output value of leaves (0 for split nodes).
+    std::vector<double> leaf_value;
+
+    /**
+     * @brief Check the model for consistency.
+     *
+     * @throw std::invalid_argument if the model is invalid.
+     */
+    void validate() const;
+};
+
+/**
+ * @brief Get the flat representation of the compiled-in classifier model.
+ *
+ * Implemented by the generated file xgboost_flat_model.cpp of the object
+ * (see scripts/xgb_dump_to_flat_cpp.py).
+ */
+XGBoostFlatModel get_compiled_xgb_flat_model();
+
+/**
+ * @brief Evaluate an XGBoost ensemble on batches of pixels.
+ *
+ * Instead of evaluating the trees of one sample with nested branches (which
+ * mispredict a lot on natural images), the trees are traversed for
+ * BATCH_SIZE pixels at once using AVX2 gather instructions.  Nodes are
+ * reordered so that the two children of a split are adjacent and packed into
+ * 32 bit, so one traversal step needs only two gathers (node and feature
+ * value).  If the CPU does not support AVX2, a scalar implementation is used.
+ *
+ * The features of the pixel classification (B, G, R, H, S, V) are integers,
+ * so thresholds are converted to integer cut points (x < t <=> x < ceil(t)).
+ * The result is identical to xgb_classify() of the generated code.
+ */
+class XGBoostBatchClassifier
+{
+public:
+    //! Number of pixels that are processed at once.
+    static constexpr int BATCH_SIZE = 8;
+
+    /**
+     * @param model The tree ensemble.  Has to use at most XGB_NUM_FEATURES
+     *     features and XGB_NUM_CLASSES classes.
+     * @throw std::invalid_argument if the model is invalid.
+     */
+    explicit XGBoostBatchClassifier(const XGBoostFlatModel &model);
+
+    /**
+     * @brief Classify pixels.
+     *
+     * @param bgr Interleaved BGR values of the pixels.
+     * @param hsv Interleaved HSV values of the pixels.
+     * @param num_pixels Number of pixels.
+     * @param labels Output.  Label with the highest score for each pixel.
+     */
+    void classify_pixels(const uint8_t *bgr,
+                         const uint8_t *hsv,
+                         int num_pixels,
+                         uint8_t *labels) const;
+
+    //! @brief Classify a single sample (works for non-integer features).
+    int classify(const std::array<float, XGB_NUM_FEATURES> &sample) const;
+
+    //! @brief Enable/disable the SIMD implementation (if supported by CPU).
+    void set_use_simd(bool use_simd);
+
+    //! @brief Check if the SIMD implementation is used.
+    bool is_using_simd() const
+    {
+        return use_simd_;
+    }
+
+    /**
+     * @brief Get a classifier for the compiled-in model.
+     *
+     * The instance is shared by all users in the process.
+     */
+    static std::shared_ptr<const XGBoostBatchClassifier> get_compiled();
+
+private:
+    int num_classes_;
+    std::vector<int32_t> tree_roots_, tree_classes_, tree_depths_;
+    //! Node arrays, reordered such that no_[i] == yes_[i] + 1 for splits.
+    std::vector<int32_t> feature_, yes_, no_;
+    std::vector<double> threshold_, leaf_value_;
+    //! Integer cut points of the splits (INT32_MAX for leaves).
+    std::vector<int32_t> cutpoint_;
+    //! Like feature_ but 0 for leaves, so it can always be used as index.
+    std::vector<int32_t> step_feature_;
+
+    /**
+     * @brief Nodes packed into 32 bit for the SIMD implementation.
+     *
+     * Bits 0-19: index of the "yes" child (leaves: own index), bits 20-22:
+     * feature, bits 23-31: cut point clamped to [0, 256] (leaves: 256).
+     */
+    std::vector<int32_t> packed_nodes_;
+    //! Leaf values as float, only used if there is one tree per class.
+    std::vector<float> leaf_value_float_;
+    bool one_tree_per_class_;
+
+    bool use_simd_ = false;
+
+    /**
+     * @brief Find the leaf of each tree for a batch of pixels.
+     *
+     * @param features Features in layout [feature][BATCH_SIZE].
+     * @param leaves Output in layout [tree][BATCH_SIZE].
+     */
+    void traverse_scalar(const int32_t *features, int32_t *leaves) const;
+
+    //! Sum up the leaf values of one pixel and return the best label.
+    int get_label(const int32_t *leaves, int lane) const;
+
+    /**
+     * @brief Classify one batch using AVX2.
+     *
+     * @param features Features in layout [feature][BATCH_SIZE].
+     * @param leaves Buffer for the leaves (layout [tree][BATCH_SIZE]).
+     * @param labels Output labels of the batch.
+     */
+    void classify_batch_avx2(const int32_t *features,
+                             int32_t *leaves,
+                             int32_t *labels) const;
+};
+
+}  // namespace trifinger_object_tracking
@@ -1,6 +1,7 @@
 #ifndef XGBOOST_CLASSIFIER_H
 #define XGBOOST_CLASSIFIER_H
 
+#include <algorithm>
 #include <array>
 
 constexpr int XGB_NUM_CLASSES = 7;
@@ -9,4 +10,12 @@ constexpr int XGB_NUM_FEATURES = 6;
 std::array<float, XGB_NUM_CLASSES> xgb_classify(
     std::array<float, XGB_NUM_FEATURES> &sample);
 
+//! Classify the sample and return the label with the highest score.
+inline int xgb_classify_label(std::array<float, XGB_NUM_FEATURES> &sample)
+{
+    std::array<float, XGB_NUM_CLASSES> probabilities = xgb_classify(sample);
+    return std::max_element(probabilities.begin(), probabilities.end()) -
+           probabilities.begin();
+}
+
 #endif
@@ -0,0 +1,60 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#pragma once
+
+#include <string>
+
+#include <trifinger_object_tracking/xgboost_batch_classifier.hpp>
+#include <trifinger_object_tracking/xgboost_classifier.h>
+
+namespace trifinger_object_tracking
+{
+/**
+ * @brief Parse a dump of an XGBoost model.
+ *
+ * Supports both formats of ``Booster.dump_model()``:  the text format
+ * ("booster[0]:" followed by one line per node, as written by
+ * scripts/train_xgb_tree.py) and the JSON format (``dump_format="json"``).
+ * Features have to be called "f0", "f1", ... (i.e. the model is trained
+ * without feature names).
+ *
+ * The nodes of each tree are stored in depth-first order, so the result is
+ * identical to the model generated by scripts/xgb_dump_to_flat_cpp.py from the
+ * same dump.
+ *
+ * @param dump Content of the dump.
+ * @param num_classes Number of classes of the model.  Tree i contributes to
+ *     class i % num_classes (this is not part of the dump).
+ * @param num_features Number of features of the model.
+ *
+ * @return The parsed model.
+ * @throw std::invalid_argument if the dump cannot be parsed or the resulting
+ *     model is invalid.
+ */
+XGBoostFlatModel parse_xgb_model_dump(const std::string &dump,
+                                      int num_classes = XGB_NUM_CLASSES,
+                                      int num_features = XGB_NUM_FEATURES);
+
+/**
+ * @brief Load a dump of an XGBoost model from a file.
+ *
+ * See parse_xgb_model_dump() for the supported formats.  The resulting model
+ * can be evaluated with XGBoostBatchClassifier, which allows changing the
+ * colour model at runtime without recompiling.
+ *
+ * @param filename Path to the dump file.
+ * @param num_classes See parse_xgb_model_dump().
+ * @param num_features See parse_xgb_model_dump().
+ *
+ * @return The parsed model.
+ * @throw std::runtime_error if the file cannot be read.
+ * @throw std::invalid_argument if the dump cannot be parsed.
+ */
+XGBoostFlatModel load_xgb_model_dump(const std::string &filename,
+                                     int num_classes = XGB_NUM_CLASSES,
+                                     int num_features = XGB_NUM_FEATURES);
+
+}  // namespace trifinger_object_tracking
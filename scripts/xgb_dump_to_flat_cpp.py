@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""Convert a text dump of an xgboost model to flat node arrays in C++.
+
+The generated file implements ``get_compiled_xgb_flat_model()`` which is used
+by the XGBoostBatchClassifier to evaluate the model on batches of pixels.  The
+input is the dump created by ``get_xgb_dump.py`` (i.e. with features called
+"f0", "f1", ...).
+"""
+import argparse
+import pathlib
+import re
+
+SPLIT_PATTERN = re.compile(
+    r"^(\d+):\[f(\d+)<([^\]]+)\] yes=(\d+),no=(\d+)(,missing=\d+)?"
+)
+LEAF_PATTERN = re.compile(r"^(\d+):leaf=([^,\s]+)")
+BOOSTER_PATTERN = re.compile(r"^booster\[(\d+)\]:")
+
+
+def parse_dump(dump_file):
+    """Parse the dump.
+
+    Returns:
+        List of trees.  Each tree is a dictionary mapping node id to either
+        ("split", feature, threshold, yes, no) or ("leaf", value).  Threshold
+        and leaf values are kept as strings, so they are not changed by
+        rounding.
+    """
+    trees = []
+    for line in dump_file.read_text().splitlines():
+        line = line.strip()
+        if not line:
+            continue
+
+        if BOOSTER_PATTERN.match(line):
+            trees.append({})
+            continue
+
+        match = SPLIT_PATTERN.match(line)
+        if match:
+            node_id, feature, threshold, yes, no, _ = match.groups()
+            trees[-1][int(node_id)] = (
+                "split",
+                int(feature),
+                threshold,
+                int(yes),
+                int(no),
+            )
+            continue
+
+        match = LEAF_PATTERN.match(line)
+        if match:
+            node_id, value = match.groups()
+            trees[-1][int(node_id)] = ("leaf", value)
+            continue
+
+        raise ValueError("Cannot parse line '{}'".format(line))
+
+    return trees
+
+
+def flatten(trees):
+    """Put nodes of all trees into flat arrays with absolute child indices."""
+    nodes = []  # (feature, threshold, yes, no, leaf_value)
+    roots = []
+    depths = []
+
+    for tree in trees:
+        # assign consecutive indices in depth-first order
+        index = {}
+
+        def assign(node_id, depth):
+            index[node_id] = len(nodes) + len(index)
+            node = tree[node_id]
+            if node[0] == "split":
+                return max(
+                    assign(node[3], depth + 1), assign(node[4], depth + 1)
+                )
+            return depth
+
+        depths.append(assign(0, 0))
+        roots.append(index[0])
+
+        for node_id in sorted(index, key=index.get):
+            node = tree[node_id]
+            i = index[node_id]
+            if node[0] == "split":
+                nodes.append(
+                    (node[1], node[2], index[node[3]], index[node[4]], "0.0")
+                )
+            else:
+                # leaves point to themselves
+                nodes.append((-1, "0.0", i, i, node[1]))
+
+    return nodes, roots, depths
+
+
+def format_array(values, indent=8, width=80):
+    lines = []
+    line = ""
+    for value in values:
+        item = str(value) + ","
+        if line and indent + len(line) + 1 + len(item) > width:
+            lines.append(" " * indent + line)
+            line = ""
+        line = (line + " " + item) if line else item
+    lines.append(" " * indent + line)
+    return "\n".join(lines)
+
+
+def generate_cpp(trees, num_classes, num_features, source_name):
+    nodes, roots, depths = flatten(trees)
+    classes = [i % num_classes for i in range(len(trees))]
+
+    def member(name, values):
+        return "    model.{} = {{\n{}\n    }};\n".format(
+            name, format_array(values)
+        )
+
+    return (
+        "// Generated by xgb_dump_to_flat_cpp.py from {source}.\n"
+        "// Do not edit manually!\n"
+        "#include <trifinger_object_tracking/xgboost_batch_classifier.hpp>\n"
+        "\n"
+        "namespace trifinger_object_tracking\n"
+        "{{\n"
+        "XGBoostFlatModel get_compiled_xgb_flat_model()\n"
+        "{{\n"
+        "    XGBoostFlatModel model;\n"
+        "    model.num_classes = {num_classes};\n"
+        "    model.num_features = {num_features};\n"
+        "{tree_roots}{tree_classes}{tree_depths}"
+        "{feature}{threshold}{yes}{no}{leaf_value}"
+        "\n"
+        "    return model;\n"
+        "}}\n"
+        "}}  // namespace trifinger_object_tracking\n"
+    ).format(
+        source=source_name,
+        num_classes=num_classes,
+        num_features=num_features,
+        tree_roots=member("tree_roots", roots),
+        tree_classes=member("tree_classes", classes),
+        tree_depths=member("tree_depths", depths),
+        feature=member("feature", [n[0] for n in nodes]),
+        threshold=member("threshold", [n[1] for n in nodes]),
+        yes=member("yes", [n[2] for n in nodes]),
+        no=member("no", [n[3] for n in nodes]),
+        leaf_value=member("leaf_value", [n[4] for n in nodes]),
+    )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        "xgb_dump", type=pathlib.Path, help="Text dump of the xgboost model."
+    )
+    parser.add_argument(
+        "out_file", type=pathlib.Path, help="Path of the generated C++ file."
+    )
+    parser.add_argument("--num-classes", type=int, default=7)
+    parser.add_argument("--num-features", type=int, default=6)
+    args = parser.parse_args()
+
+    trees = parse_dump(args.xgb_dump)
+    code = generate_cpp(
+        trees, args.num_classes, args.num_features, args.xgb_dump.name
+    )
+    args.out_file.write_text(code)
+
+
+if __name__ == "__main__":
+    main()
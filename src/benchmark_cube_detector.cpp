@@ -0,0 +1,104 @@
+/**
+ * @brief Measure latency of the cube detection for different thread counts.
+ *
+ * Load images of the three cameras from files "camera{60,180,300}.png" (same
+ * layout as for single_observation), run CubeDetector::detect_cube on them
+ * repeatedly with thread pools of different size and print the frame latency
+ * for each number of threads.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <trifinger_object_tracking/cube_detector.hpp>
+#include <trifinger_object_tracking/utils.hpp>
+
+/**
+ * @brief Load images camera{60,180,300}.png from the given directory.
+ *
+ * @param directory Directory containing the image files.
+ *
+ * @return Array with images [camera60.png, camera180.png, camera300.png]
+ */
+std::array<cv::Mat, 3> load_images(const std::string &directory)
+{
+    cv::Mat image60 = cv::imread(directory + "/camera60.png");
+    cv::Mat image180 = cv::imread(directory + "/camera180.png");
+    cv::Mat image300 = cv::imread(directory + "/camera300.png");
+
+    if (image60.empty() || image180.empty() || image300.empty())
+    {
+        throw std::runtime_error("Failed to load image.");
+    }
+
+    return {image60, image180, image300};
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 2 && argc != 3)
+    {
+        std::cout << "Invalid number of arguments." << std::endl;
+        std::cout << "Usage: " << argv[0]
+                  << " image_directory [num_iterations]" << std::endl;
+        return 1;
+    }
+    const std::string data_dir = argv[1];
+    const int num_iterations = argc > 2 ? std::stoi(argv[2]) : 50;
+    if (num_iterations < 1)
+    {
+        std::cout << "num_iterations must be positive." << std::endl;
+        return 1;
+    }
+
+    auto frames = load_images(data_dir);
+
+    // same file layout as expected by single_observation
+    std::array<trifinger_cameras::CameraParameters, 3> camera_params =
+        trifinger_object_tracking::load_camera_parameters({
+            data_dir + "/../camera_calib_60.yml",
+            data_dir + "/../camera_calib_180.yml",
+            data_dir + "/../camera_calib_300.yml",
+        });
+
+    const unsigned int max_threads =
+        std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::cout << "threads | mean [ms] | median [ms] | max [ms]" << std::endl;
+    for (unsigned int num_threads = 1; num_threads <= max_threads;
+         num_threads++)
+    {
+        trifinger_object_tracking::CubeDetector cube_detector(
+            camera_params,
+            trifinger_object_tracking::ColorSegmenter::Backend::XGBOOST,
+            num_threads);
+
+        // warm up (allocation of buffers, etc.)
+        cube_detector.detect_cube(frames);
+
+        std::vector<double> latencies_ms;
+        for (int i = 0; i < num_iterations; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            cube_detector.detect_cube(frames);
+            std::chrono::duration<double, std::milli> duration =
+                std::chrono::steady_clock::now() - start;
+            latencies_ms.push_back(duration.count());
+        }
+
+        std::sort(latencies_ms.begin(), latencies_ms.end());
+        double mean = 0;
+        for (double latency : latencies_ms)
+        {
+            mean += latency / latencies_ms.size();
+        }
+
+        std::cout << std::setw(7) << num_threads << " | " << std::setw(9)
+                  << std::fixed << std::setprecision(2) << mean << " | "
+                  << std::setw(11) << latencies_ms[latencies_ms.size() / 2]
+                  << " | " << std::setw(8) << latencies_ms.back() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * @brief Compare the objectives of the pose optimisation.
+ *
+ * Load the masks "{r,g,b,c,m,y}{60,180,300}.png" and the camera calibration
+ * files "camera_calib_{60,180,300}.yml" from a directory (same layout as the
+ * test images in test/images/pose_detection), run PoseDetector::find_pose on
+ * them repeatedly with each objective and print the latency, the confidence
+ * and the spread of the found positions.  The deviation is the distance of
+ * the mean position to the mean position found with the pixel-distance
+ * objective.
+ */
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <trifinger_object_tracking/cube_model.hpp>
+#include <trifinger_object_tracking/pose_detector.hpp>
+#include <trifinger_object_tracking/utils.hpp>
+
+using namespace trifinger_object_tracking;
+
+int main(int argc, char **argv)
+{
+    if (argc != 2 && argc != 3)
+    {
+        std::cout << "Invalid number of arguments." << std::endl;
+        std::cout << "Usage: " << argv[0]
+                  << " image_directory [num_iterations]" << std::endl;
+        return 1;
+    }
+    const std::string data_dir = std::string(argv[1]) + "/";
+    const int num_iterations = argc > 2 ? std::stoi(argv[2]) : 20;
+    if (num_iterations < 1)
+    {
+        std::cout << "num_iterations must be positive." << std::endl;
+        return 1;
+    }
+
+    const std::array<std::string, PoseDetector::N_CAMERAS> camera_ids = {
+        "60", "180", "300"};
+    const std::array<std::string, FaceColor::N_COLORS> color_names = {
+        "r", "g", "b", "c", "m", "y"};
+
+    std::array<std::vector<FaceColor>, PoseDetector::N_CAMERAS>
+        dominant_colors;
+    std::array<std::vector<cv::Mat>, PoseDetector::N_CAMERAS> masks;
+    for (size_t i = 0; i < PoseDetector::N_CAMERAS; i++)
+    {
+        for (int color = 0; color < FaceColor::N_COLORS; color++)
+        {
+            cv::Mat mask =
+                cv::imread(data_dir + color_names[color] + camera_ids[i] +
+                               ".png",
+                           cv::IMREAD_GRAYSCALE);
+            if (!mask.empty())
+            {
+                masks[i].push_back(mask);
+                dominant_colors[i].push_back(static_cast<FaceColor>(color));
+            }
+        }
+    }
+
+    auto camera_params = load_camera_parameters({
+        data_dir + "camera_calib_60.yml",
+        data_dir + "camera_calib_180.yml",
+        data_dir + "camera_calib_300.yml",
+    });
+
+    const CubeModel cube_model;
+    const std::array<std::pair<PoseDetector::Objective, std::string>, 2>
+        objectives = {
+            {{PoseDetector::Objective::PIXEL_DISTANCE, "pixel distance"},
+             {PoseDetector::Objective::DISTANCE_TRANSFORM,
+              "distance transform"}}};
+
+    cv::Vec3f reference_position;
+
+    std::cout << "objective          | mean [ms] | confidence | "
+                 "position std [mm] | deviation [mm]"
+              << std::endl;
+    for (const auto &[objective, name] : objectives)
+    {
+        PoseDetector pose_detector(cube_model, camera_params);
+        pose_detector.set_objective(objective);
+
+        // warm up (allocation of buffers, etc.)
+        pose_detector.find_pose(dominant_colors, masks);
+
+        double total_ms = 0, total_confidence = 0;
+        std::vector<cv::Vec3f> positions;
+        for (int i = 0; i < num_iterations; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            Pose pose = pose_detector.find_pose(dominant_colors, masks);
+            std::chrono::duration<double, std::milli> duration =
+                std::chrono::steady_clock::now() - start;
+
+            total_ms += duration.count();
+            total_confidence += pose.confidence;
+            positions.push_back(pose.translation);
+        }
+
+        cv::Vec3f mean_position(0, 0, 0);
+        for (const cv::Vec3f &position : positions)
+        {
+            mean_position += position / num_iterations;
+        }
+        double variance = 0;
+        for (const cv::Vec3f &position : positions)
+        {
+            variance += cv::norm(position - mean_position, cv::NORM_L2SQR) /
+                        num_iterations;
+        }
+        if (objective == PoseDetector::Objective::PIXEL_DISTANCE)
+        {
+            reference_position = mean_position;
+        }
+
+        std::cout << std::left << std::setw(18) << name << std::right
+                  << " | " << std::setw(9) << std::fixed
+                  << std::setprecision(2) << total_ms / num_iterations
+                  << " | " << std::setw(10) << std::setprecision(3)
+                  << total_confidence / num_iterations << " | "
+                  << std::setw(17) << std::setprecision(2)
+                  << 1000 * std::sqrt(variance) << " | " << std::setw(14)
+                  << 1000 * cv::norm(mean_position - reference_position)
+                  << std::endl;
+    }
+
+    return 0;
+}
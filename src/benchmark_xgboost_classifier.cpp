@@ -0,0 +1,146 @@
+/**
+ * @brief Compare the throughput of the colour classifier implementations.
+ *
+ * Classifies all pixels of an image with
+ *  - the generated code of the compiled-in model (xgb_classify()),
+ *  - the flat tree interpreter (XGBoostBatchClassifier) with the compiled-in
+ *    model and
+ *  - the flat tree interpreter with a model loaded at runtime from a dump
+ *    file,
+ * and prints the number of pixels per second as well as the agreement of the
+ * labels with the generated code.
+ */
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <trifinger_object_tracking/xgboost_batch_classifier.hpp>
+#include <trifinger_object_tracking/xgboost_classifier.h>
+#include <trifinger_object_tracking/xgboost_model_loader.hpp>
+
+using namespace trifinger_object_tracking;
+
+//! Classify all pixels with the generated code.
+void classify_generated(const cv::Mat &bgr,
+                        const cv::Mat &hsv,
+                        std::vector<uint8_t> *labels)
+{
+    const uint8_t *bgr_data = bgr.ptr<uint8_t>();
+    const uint8_t *hsv_data = hsv.ptr<uint8_t>();
+    std::array<float, XGB_NUM_FEATURES> features;
+    for (size_t i = 0; i < bgr.total(); i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            features[j] = bgr_data[3 * i + j];
+            features[3 + j] = hsv_data[3 * i + j];
+        }
+        (*labels)[i] = static_cast<uint8_t>(xgb_classify_label(features));
+    }
+}
+
+//! Run func repeatedly and return the number of pixels per second.
+template <typename Func>
+double measure(size_t num_pixels, int num_iterations, Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_iterations; i++)
+    {
+        func();
+    }
+    std::chrono::duration<double> duration =
+        std::chrono::steady_clock::now() - start;
+
+    return num_iterations * num_pixels / duration.count();
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3 && argc != 4)
+    {
+        std::cout << "Invalid number of arguments." << std::endl;
+        std::cout << "Usage: " << argv[0]
+                  << " image_file model_dump_file [num_iterations]"
+                  << std::endl;
+        return 1;
+    }
+    const int num_iterations = argc > 3 ? std::stoi(argv[3]) : 10;
+    if (num_iterations < 1)
+    {
+        std::cout << "num_iterations must be positive." << std::endl;
+        return 1;
+    }
+
+    cv::Mat image = cv::imread(argv[1]);
+    if (image.empty())
+    {
+        std::cout << "Failed to load image " << argv[1] << std::endl;
+        return 1;
+    }
+    // same preprocessing as in ColorSegmenter
+    cv::Mat bgr, hsv;
+    cv::medianBlur(image, bgr, 5);
+    cv::cvtColor(bgr, hsv, cv::COLOR_BGR2HSV);
+
+    const size_t num_pixels = bgr.total();
+    std::vector<uint8_t> expected(num_pixels), labels(num_pixels);
+
+    double generated = measure(num_pixels, num_iterations, [&]() {
+        classify_generated(bgr, hsv, &expected);
+    });
+
+    std::cout << "implementation         | pixels/s [M] | agreement"
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "generated code         | " << std::setw(12)
+              << generated * 1e-6 << " |         -" << std::endl;
+
+    auto run_interpreter = [&](const std::string &name,
+                               XGBoostBatchClassifier *classifier) {
+        for (bool use_simd : {false, true})
+        {
+            classifier->set_use_simd(use_simd);
+            if (use_simd && !classifier->is_using_simd())
+            {
+                std::cout << std::left << std::setw(22) << (name + " (SIMD)")
+                          << std::right << " | not supported by CPU"
+                          << std::endl;
+                continue;
+            }
+
+            double pixels_per_second =
+                measure(num_pixels, num_iterations, [&]() {
+                    classifier->classify_pixels(bgr.ptr<uint8_t>(),
+                                                hsv.ptr<uint8_t>(),
+                                                num_pixels,
+                                                labels.data());
+                });
+
+            size_t num_equal = 0;
+            for (size_t i = 0; i < num_pixels; i++)
+            {
+                num_equal += labels[i] == expected[i];
+            }
+
+            std::cout << std::left << std::setw(22)
+                      << (name + (use_simd ? " (SIMD)" : " (scalar)"))
+                      << std::right << " | " << std::setw(12)
+                      << pixels_per_second * 1e-6 << " | " << std::setw(8)
+                      << 100.0 * num_equal / num_pixels << "%" << std::endl;
+        }
+    };
+
+    XGBoostBatchClassifier compiled(get_compiled_xgb_flat_model());
+    run_interpreter("compiled flat", &compiled);
+
+    auto load_start = std::chrono::steady_clock::now();
+    XGBoostBatchClassifier loaded(load_xgb_model_dump(argv[2]));
+    std::chrono::duration<double, std::milli> load_duration =
+        std::chrono::steady_clock::now() - load_start;
+    run_interpreter("loaded dump", &loaded);
+
+    std::cout << "Loading the model dump took " << load_duration.count()
+              << " ms." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <trifinger_object_tracking/bit_mask.hpp>
+
+#include <algorithm>
+
+namespace trifinger_object_tracking
+{
+void BitMask::assign(const std::vector<cv::Point> &pixels)
+{
+    num_pixels_ = pixels.size();
+    if (pixels.empty())
+    {
+        roi_ = cv::Rect();
+        words_per_row_ = 0;
+        words_.clear();
+        return;
+    }
+
+    int min_x = pixels[0].x, max_x = pixels[0].x;
+    int min_y = pixels[0].y, max_y = pixels[0].y;
+    for (const cv::Point &pixel : pixels)
+    {
+        min_x = std::min(min_x, pixel.x);
+        max_x = std::max(max_x, pixel.x);
+        min_y = std::min(min_y, pixel.y);
+        max_y = std::max(max_y, pixel.y);
+    }
+    roi_ = cv::Rect(min_x, min_y, max_x - min_x + 1, max_y - min_y + 1);
+
+    words_per_row_ = (roi_.width + 63) / 64;
+    words_.assign(words_per_row_ * roi_.height, 0);
+    for (const cv::Point &pixel : pixels)
+    {
+        const int col = pixel.x - roi_.x;
+        const int row = pixel.y - roi_.y;
+        words_[row * words_per_row_ + col / 64] |= uint64_t(1) << (col % 64);
+    }
+}
+
+void BitMask::assign(const SparseMask &mask)
+{
+    num_pixels_ = mask.get_num_pixels();
+    roi_ = mask.get_bounding_box();
+    if (roi_.empty())
+    {
+        words_per_row_ = 0;
+        words_.clear();
+        return;
+    }
+
+    words_per_row_ = (roi_.width + 63) / 64;
+    words_.assign(words_per_row_ * roi_.height, 0);
+    for (const PixelRun &run : mask.get_runs())
+    {
+        uint64_t *row_words = &words_[(run.row - roi_.y) * words_per_row_];
+        const int end = run.col_end - roi_.x;
+        int col = run.col_begin - roi_.x;
+        while (col < end)
+        {
+            // set the bits [col % 64, col % 64 + num_bits) of the word
+            const int bit = col % 64;
+            const int num_bits = std::min(64 - bit, end - col);
+            const uint64_t bits =
+                num_bits == 64 ? ~uint64_t(0)
+                               : ((uint64_t(1) << num_bits) - 1) << bit;
+            row_words[col / 64] |= bits;
+            col += num_bits;
+        }
+    }
+}
+
+unsigned int BitMask::count_in_row(int row, int col_begin, int col_end) const
+{
+    if (row < roi_.y || row >= roi_.y + roi_.height)
+    {
+        return 0;
+    }
+
+    // clip to the bounding box and convert to columns of the bounding box
+    const int begin = std::max(col_begin, roi_.x) - roi_.x;
+    const int end = std::min(col_end, roi_.x + roi_.width - 1) - roi_.x;
+    if (begin > end)
+    {
+        return 0;
+    }
+
+    const uint64_t *row_words = &words_[(row - roi_.y) * words_per_row_];
+    const int first_word = begin / 64;
+    const int last_word = end / 64;
+    // bits [begin % 64, 63] of the first and [0, end % 64] of the last word
+    const uint64_t first_mask = ~uint64_t(0) << (begin % 64);
+    const uint64_t last_mask = ~uint64_t(0) >> (63 - end % 64);
+
+    if (first_word == last_word)
+    {
+        return __builtin_popcountll(row_words[first_word] & first_mask &
+                                    last_mask);
+    }
+
+    unsigned int count =
+        __builtin_popcountll(row_words[first_word] & first_mask);
+    for (int k = first_word + 1; k < last_word; k++)
+    {
+        count += __builtin_popcountll(row_words[k]);
+    }
+    count += __builtin_popcountll(row_words[last_word] & last_mask);
+
+    return count;
+}
+
+}  // namespace trifinger_object_tracking
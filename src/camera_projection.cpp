@@ -0,0 +1,107 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <trifinger_object_tracking/camera_projection.hpp>
+
+#include <stdexcept>
+
+namespace trifinger_object_tracking
+{
+CameraProjection::CameraProjection(
+    const trifinger_cameras::CameraParameters &camera_parameters)
+{
+    const auto &tf = camera_parameters.tf_world_to_camera;
+    const cv::Matx33f rotation(tf(0, 0),
+                               tf(0, 1),
+                               tf(0, 2),
+                               tf(1, 0),
+                               tf(1, 1),
+                               tf(1, 2),
+                               tf(2, 0),
+                               tf(2, 1),
+                               tf(2, 2));
+    const cv::Vec3f translation(tf(0, 3), tf(1, 3), tf(2, 3));
+    world_to_camera_ = cv::Affine3f(rotation, translation);
+
+    const auto &camera_matrix = camera_parameters.camera_matrix;
+    fx_ = camera_matrix(0, 0);
+    fy_ = camera_matrix(1, 1);
+    cx_ = camera_matrix(0, 2);
+    cy_ = camera_matrix(1, 2);
+
+    const auto &distortion = camera_parameters.distortion_coefficients;
+    if (distortion.size() != 0 && distortion.size() != 4 &&
+        distortion.size() != 5)
+    {
+        throw std::invalid_argument(
+            "Only 4 or 5 distortion coefficients are supported.");
+    }
+    if (distortion.size() >= 4)
+    {
+        k1_ = distortion(0);
+        k2_ = distortion(1);
+        p1_ = distortion(2);
+        p2_ = distortion(3);
+    }
+    if (distortion.size() == 5)
+    {
+        k3_ = distortion(4);
+    }
+}
+
+cv::Vec3f CameraProjection::unproject(const cv::Point2f &image_point) const
+{
+    constexpr int NUM_UNDISTORTION_ITERATIONS = 10;
+
+    const float xd = (image_point.x - cx_) / fx_;
+    const float yd = (image_point.y - cy_) / fy_;
+
+    // fixed-point iteration x = (xd - tangential(x)) / radial(x)
+    float x = xd, y = yd;
+    for (int i = 0; i < NUM_UNDISTORTION_ITERATIONS; i++)
+    {
+        const float r2 = x * x + y * y;
+        const float radial = 1 + r2 * (k1_ + r2 * (k2_ + r2 * k3_));
+        const float tangential_x = 2 * p1_ * x * y + p2_ * (r2 + 2 * x * x);
+        const float tangential_y = p1_ * (r2 + 2 * y * y) + 2 * p2_ * x * y;
+        x = (xd - tangential_x) / radial;
+        y = (yd - tangential_y) / radial;
+    }
+
+    return cv::normalize(world_to_camera_.rotation().t() * cv::Vec3f(x, y, 1));
+}
+
+cv::Matx<float, 2, 3> CameraProjection::project_camera_point_jacobian(
+    const cv::Vec3f &point) const
+{
+    const float z = point[2];
+    const float x = point[0] / z;
+    const float y = point[1] / z;
+
+    // derivative of the normalized coordinates (x, y) w.r.t. the point
+    // clang-format off
+    const cv::Matx<float, 2, 3> normalized_jacobian(
+        1 / z,     0, -x / z,
+            0, 1 / z, -y / z);
+    // clang-format on
+
+    // derivative of the image point w.r.t. (x, y)
+    const float r2 = x * x + y * y;
+    const float radial = 1 + r2 * (k1_ + r2 * (k2_ + r2 * k3_));
+    const float radial_derivative = k1_ + r2 * (2 * k2_ + r2 * 3 * k3_);
+    const float cross_term =
+        2 * x * y * radial_derivative + 2 * p1_ * x + 2 * p2_ * y;
+    const cv::Matx22f distortion_jacobian(
+        fx_ * (radial + 2 * x * x * radial_derivative + 2 * p1_ * y +
+               6 * p2_ * x),
+        fx_ * cross_term,
+        fy_ * cross_term,
+        fy_ * (radial + 2 * y * y * radial_derivative + 6 * p1_ * y +
+               2 * p2_ * x));
+
+    return distortion_jacobian * normalized_jacobian;
+}
+
+}  // namespace trifinger_object_tracking
@@ -0,0 +1,271 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <trifinger_object_tracking/color_lookup_table.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <opencv2/opencv.hpp>
+#include <trifinger_object_tracking/xgboost_batch_classifier.hpp>
+#include <trifinger_object_tracking/xgboost_classifier.h>
+
+namespace trifinger_object_tracking
+{
+namespace
+{
+//! Header of the cache file.
+struct CacheFileHeader
+{
+    char magic[8];
+    uint32_t object_version;
+    //! Explicit padding, so that no uninitialised bytes are written.
+    uint32_t padding;
+    uint64_t model_fingerprint;
+    uint64_t table_size;
+};
+
+constexpr char CACHE_FILE_MAGIC[8] = {'T', 'F', 'O', 'T', 'L', 'U', 'T', '2'};
+
+//! Add the bytes of the given values to an FNV-1a hash.
+template <typename T>
+void hash_values(const T *values, size_t num_values, uint64_t *hash)
+{
+    const auto *bytes = reinterpret_cast<const uint8_t *>(values);
+    for (size_t i = 0; i < num_values * sizeof(T); i++)
+    {
+        *hash ^= bytes[i];
+        *hash *= 1099511628211ull;
+    }
+}
+
+template <typename T>
+void hash_values(const std::vector<T> &values, uint64_t *hash)
+{
+    // include the size, so that the boundaries of the arrays are part of
+    // the hash
+    const uint64_t size = values.size();
+    hash_values(&size, 1, hash);
+    hash_values(values.data(), values.size(), hash);
+}
+
+/**
+ * @brief Classify all pixels of the given BGR image.
+ *
+ * HSV is computed with cv::cvtColor, exactly like in ColorSegmenter, so the
+ * result is bit-exact with the per-pixel classification there.
+ *
+ * @param image_bgr Image of type CV_8UC3.
+ * @param labels Output array, needs to have space for image_bgr.total()
+ *     labels.  Labels are written in row-major order.
+ */
+void classify_image(const cv::Mat &image_bgr, uint8_t *labels)
+{
+    cv::Mat image_hsv;
+    cv::cvtColor(image_bgr, image_hsv, cv::COLOR_BGR2HSV);
+
+    std::array<float, XGB_NUM_FEATURES> features;
+    for (int r = 0; r < image_bgr.rows; r++)
+    {
+        const cv::Vec3b *bgr_row = image_bgr.ptr<cv::Vec3b>(r);
+        const cv::Vec3b *hsv_row = image_hsv.ptr<cv::Vec3b>(r);
+
+        for (int c = 0; c < image_bgr.cols; c++)
+        {
+            features[0] = static_cast<float>(bgr_row[c][0]);
+            features[1] = static_cast<float>(bgr_row[c][1]);
+            features[2] = static_cast<float>(bgr_row[c][2]);
+            features[3] = static_cast<float>(hsv_row[c][0]);
+            features[4] = static_cast<float>(hsv_row[c][1]);
+            features[5] = static_cast<float>(hsv_row[c][2]);
+
+            *labels++ = static_cast<uint8_t>(xgb_classify_label(features));
+        }
+    }
+}
+}  // namespace
+
+void ColorLookupTable::build()
+{
+    table_.resize(TABLE_SIZE);
+
+    // Each blue value is one "slice" of 256x256 colours (green along the rows,
+    // red along the columns), which is converted and classified as one image.
+    auto build_slices = [this](int b_begin, int b_end) {
+        cv::Mat slice_bgr(256, 256, CV_8UC3);
+        for (int b = b_begin; b < b_end; b++)
+        {
+            for (int g = 0; g < 256; g++)
+            {
+                cv::Vec3b *row = slice_bgr.ptr<cv::Vec3b>(g);
+                for (int r = 0; r < 256; r++)
+                {
+                    row[r] = cv::Vec3b(b, g, r);
+                }
+            }
+
+            classify_image(slice_bgr, &table_[b << 16]);
+        }
+    };
+
+    const int num_threads =
+        std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, 256);
+    const int slices_per_thread = (256 + num_threads - 1) / num_threads;
+
+    std::vector<std::thread> threads;
+    for (int b_begin = 0; b_begin < 256; b_begin += slices_per_thread)
+    {
+        threads.emplace_back(build_slices,
+                             b_begin,
+                             std::min(b_begin + slices_per_thread, 256));
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+bool ColorLookupTable::load(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    CacheFileHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+    {
+        return false;
+    }
+    if (std::memcmp(header.magic, CACHE_FILE_MAGIC, sizeof(header.magic)) !=
+            0 ||
+        header.object_version != OBJECT_VERSION ||
+        header.table_size != TABLE_SIZE ||
+        header.model_fingerprint != compute_model_fingerprint())
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> table(TABLE_SIZE);
+    if (!file.read(reinterpret_cast<char *>(table.data()), table.size()))
+    {
+        return false;
+    }
+
+    table_ = std::move(table);
+    return true;
+}
+
+void ColorLookupTable::save(const std::string &filename) const
+{
+    if (empty())
+    {
+        throw std::runtime_error("Cannot save empty colour lookup table.");
+    }
+
+    CacheFileHeader header;
+    std::memcpy(header.magic, CACHE_FILE_MAGIC, sizeof(header.magic));
+    header.object_version = OBJECT_VERSION;
+    header.padding = 0;
+    header.model_fingerprint = compute_model_fingerprint();
+    header.table_size = TABLE_SIZE;
+
+    std::ofstream file(filename, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(table_.data()), table_.size());
+    if (!file)
+    {
+        throw std::runtime_error("Failed to write colour lookup table to " +
+                                 filename);
+    }
+}
+
+std::shared_ptr<const ColorLookupTable> ColorLookupTable::get_shared(
+    const std::string &cache_file)
+{
+    static std::mutex mutex;
+    //! Tables by the path of their cache file.
+    static std::map<std::string, std::shared_ptr<const ColorLookupTable>>
+        shared_tables;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = shared_tables.find(cache_file);
+    if (it != shared_tables.end())
+    {
+        return it->second;
+    }
+
+    std::shared_ptr<const ColorLookupTable> shared_table;
+    if (!cache_file.empty())
+    {
+        auto table = std::make_shared<ColorLookupTable>();
+        if (table->load(cache_file))
+        {
+            shared_table = table;
+        }
+    }
+
+    if (!shared_table)
+    {
+        if (!shared_tables.empty())
+        {
+            // all tables are computed from the compiled-in model, so there is
+            // no need to build it again for another cache file
+            shared_table = shared_tables.begin()->second;
+        }
+        else
+        {
+            auto table = std::make_shared<ColorLookupTable>();
+            table->build();
+            shared_table = table;
+        }
+
+        if (!cache_file.empty())
+        {
+            try
+            {
+                shared_table->save(cache_file);
+            }
+            catch (const std::runtime_error &e)
+            {
+                std::cerr << "WARNING: " << e.what() << std::endl;
+            }
+        }
+    }
+
+    shared_tables[cache_file] = shared_table;
+    return shared_table;
+}
+
+uint64_t ColorLookupTable::compute_model_fingerprint()
+{
+    // The flat model is generated from the same model dump as the compiled-in
+    // classifier that is used to build the table, so any change of the
+    // model changes the hash.
+    const XGBoostFlatModel model = get_compiled_xgb_flat_model();
+
+    uint64_t hash = 14695981039346656037ull;
+    hash_values(&model.num_classes, 1, &hash);
+    hash_values(&model.num_features, 1, &hash);
+    hash_values(model.tree_roots, &hash);
+    hash_values(model.tree_classes, &hash);
+    hash_values(model.tree_depths, &hash);
+    hash_values(model.feature, &hash);
+    hash_values(model.threshold, &hash);
+    hash_values(model.yes, &hash);
+    hash_values(model.no, &hash);
+    hash_values(model.leaf_value, &hash);
+
+    return hash;
+}
+
+}  // namespace trifinger_object_tracking
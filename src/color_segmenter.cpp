@@ -1,102 +1,801 @@
 #include <math.h>
-#include <trifinger_object_tracking/xgboost_classifier.h>
 
 #include <algorithm>  // std::sort, std::stable_sort
 #include <chrono>
+#include <cstring>
 #include <iostream>
+#include <iterator>  // std::size
 #include <numeric>  // std::iota
+#include <stdexcept>
 #include <thread>
 #include <trifinger_object_tracking/color_segmenter.hpp>
 #include <trifinger_object_tracking/scoped_timer.hpp>
+#include <trifinger_object_tracking/thread_pool.hpp>
 #include <typeinfo>
 
+#if defined(__x86_64__) || defined(__i386__)
+#define COLOR_SEGMENTER_HAS_X86_SIMD
+#endif
+
 namespace trifinger_object_tracking
 {
-ColorSegmenter::ColorSegmenter(const CubeModel &cube_model)
-    : cube_model_(cube_model)
+ColorSegmenter::ColorSegmenter(const CubeModel &cube_model,
+                               Backend backend,
+                               const std::string &lookup_table_cache_file,
+                               unsigned int coarse_scale)
+    : cube_model_(cube_model), backend_(backend), coarse_scale_(coarse_scale)
+{
+    if (coarse_scale_ == 0)
+    {
+        throw std::invalid_argument("coarse_scale must be greater than zero.");
+    }
+
+    if (backend_ == Backend::LOOKUP_TABLE)
+    {
+        lookup_table_ = ColorLookupTable::get_shared(lookup_table_cache_file);
+    }
+    else
+    {
+        batch_classifier_ = XGBoostBatchClassifier::get_compiled();
+    }
+}
+
+void ColorSegmenter::set_classifier(
+    std::shared_ptr<const XGBoostBatchClassifier> classifier)
 {
+    if (backend_ != Backend::XGBOOST)
+    {
+        throw std::runtime_error(
+            "The classifier can only be replaced with the XGBOOST backend.");
+    }
+    if (!classifier)
+    {
+        throw std::invalid_argument("classifier must not be null.");
+    }
+    batch_classifier_ = std::move(classifier);
 }
 
-void ColorSegmenter::detect_colors(const cv::Mat &image_bgr)
+namespace
+{
+//! Radius of the median blur (i.e. kernel size is 5x5).
+constexpr int BLUR_RADIUS = 2;
+
+//! Number of image rows that are blurred and classified in one batch.
+constexpr int TILE_ROWS = 16;
+
+//! Compare-exchange operations of a sorting network which moves the median of
+//! 25 values to position 12 (N. Devillard, "Fast median search: an ANSI C
+//! implementation", 1998).
+constexpr uint8_t MEDIAN_25_NETWORK[][2] = {
+    {0, 1},   {3, 4},   {2, 4},   {2, 3},   {6, 7},   {5, 7},   {5, 6},
+    {9, 10},  {8, 10},  {8, 9},   {12, 13}, {11, 13}, {11, 12}, {15, 16},
+    {14, 16}, {14, 15}, {18, 19}, {17, 19}, {17, 18}, {21, 22}, {20, 22},
+    {20, 21}, {23, 24}, {2, 5},   {3, 6},   {0, 6},   {0, 3},   {4, 7},
+    {1, 7},   {1, 4},   {11, 14}, {8, 14},  {8, 11},  {12, 15}, {9, 15},
+    {9, 12},  {13, 16}, {10, 16}, {10, 13}, {20, 23}, {17, 23}, {17, 20},
+    {21, 24}, {18, 24}, {18, 21}, {19, 22}, {8, 17},  {9, 18},  {0, 18},
+    {0, 9},   {10, 19}, {1, 19},  {1, 10},  {11, 20}, {2, 20},  {2, 11},
+    {12, 21}, {3, 21},  {3, 12},  {13, 22}, {4, 22},  {4, 13},  {14, 23},
+    {5, 23},  {5, 14},  {15, 24}, {6, 24},  {6, 15},  {7, 16},  {7, 19},
+    {13, 21}, {15, 23}, {7, 13},  {7, 15},  {1, 9},   {3, 11},  {5, 17},
+    {11, 17}, {9, 17},  {4, 10},  {6, 12},  {7, 14},  {4, 6},   {4, 7},
+    {12, 14}, {10, 14}, {6, 7},   {10, 12}, {6, 10},  {6, 17},  {12, 17},
+    {7, 17},  {7, 10},  {12, 18}, {7, 12},  {10, 18}, {12, 20}, {10, 20},
+    {10, 12}};
+
+//! Apply MEDIAN_25_NETWORK to the given 25 values (fully unrolled, so that
+//! the values can be kept in registers).
+template <size_t OP = 0>
+inline __attribute__((always_inline)) void apply_median_25_network(
+    uint8_t *values)
+{
+    if constexpr (OP < std::size(MEDIAN_25_NETWORK))
+    {
+        const uint8_t a = values[MEDIAN_25_NETWORK[OP][0]];
+        const uint8_t b = values[MEDIAN_25_NETWORK[OP][1]];
+        values[MEDIAN_25_NETWORK[OP][0]] = std::min(a, b);
+        values[MEDIAN_25_NETWORK[OP][1]] = std::max(a, b);
+        apply_median_25_network<OP + 1>(values);
+    }
+}
+
+/**
+ * @brief Compute the medians of the 5x5 neighbourhoods of a row.
+ *
+ * The loop has no dependencies between iterations, so the compiler vectorises
+ * it.
+ *
+ * @param rows Pointers to the five source rows around the output row, pointing
+ *     to the first channel of the first output pixel.  The neighbourhoods of
+ *     all pixels need to be inside of the rows.
+ * @param num_bytes Number of output bytes (i.e. 3 * number of pixels).
+ * @param out Output row.
+ */
+inline __attribute__((always_inline)) void median_blur_row_impl(
+    const uint8_t *const rows[], int num_bytes, uint8_t *__restrict out)
+{
+    for (int i = 0; i < num_bytes; i++)
+    {
+        uint8_t values[25];
+        for (int dy = 0; dy < 5; dy++)
+        {
+            for (int dx = 0; dx < 5; dx++)
+            {
+                values[5 * dy + dx] = rows[dy][i + 3 * (dx - BLUR_RADIUS)];
+            }
+        }
+        apply_median_25_network(values);
+        out[i] = values[12];
+    }
+}
+
+typedef void (*MedianBlurRowFunction)(const uint8_t *const rows[],
+                                      int num_bytes,
+                                      uint8_t *out);
+
+void median_blur_row(const uint8_t *const rows[], int num_bytes, uint8_t *out)
+{
+    median_blur_row_impl(rows, num_bytes, out);
+}
+
+#ifdef COLOR_SEGMENTER_HAS_X86_SIMD
+__attribute__((target("avx2"))) void median_blur_row_avx2(
+    const uint8_t *const rows[], int num_bytes, uint8_t *out)
 {
-    // TODO better solution than class members for images
+    median_blur_row_impl(rows, num_bytes, out);
+}
 
-    // blur the image to make colour classification easier
-    cv::medianBlur(image_bgr, image_bgr_, 5);
-    cv::cvtColor(image_bgr_, image_hsv_, cv::COLOR_BGR2HSV);
+__attribute__((target("avx512bw"))) void median_blur_row_avx512(
+    const uint8_t *const rows[], int num_bytes, uint8_t *out)
+{
+    median_blur_row_impl(rows, num_bytes, out);
+}
+#endif
 
-    xgboost_mask();
+//! Get the median_blur_row() variant for the widest SIMD supported by the CPU.
+MedianBlurRowFunction select_median_blur_row()
+{
+#ifdef COLOR_SEGMENTER_HAS_X86_SIMD
+    if (__builtin_cpu_supports("avx512bw"))
+    {
+        return median_blur_row_avx512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return median_blur_row_avx2;
+    }
+#endif
+    return median_blur_row;
 }
 
-void ColorSegmenter::xgboost_mask()
+/**
+ * @brief Median blur with a 5x5 kernel of a region of a BGR image.
+ *
+ * Gives the same result as cv::medianBlur with kernel size 5 (i.e. pixels
+ * outside of src are replicated from its border) but does not allocate any
+ * memory.  The medians are selected with a sorting network, which is
+ * vectorised over the pixels of a row (using AVX2/AVX-512 if supported by
+ * the CPU).
+ *
+ * @param src Image of type CV_8UC3.
+ * @param region Region of src that is blurred.
+ * @param dst Output of type CV_8UC3 and size region.size().
+ */
+void median_blur_5x5(const cv::Mat &src, const cv::Rect &region, cv::Mat *dst)
 {
-    // map label index of the xgboost model to color
-    constexpr std::array<FaceColor, FaceColor::N_COLORS> map_label_to_color = {
-        FaceColor::BLUE,
-        FaceColor::CYAN,
-        FaceColor::GREEN,
-        FaceColor::MAGENTA,
-        FaceColor::RED,
-        FaceColor::YELLOW,
+    static const MedianBlurRowFunction blur_row = select_median_blur_row();
+
+    // columns (relative to region) whose neighbourhood is inside of src
+    const int inner_begin = std::clamp(BLUR_RADIUS - region.x, 0, region.width);
+    const int inner_end = std::clamp(
+        src.cols - BLUR_RADIUS - region.x, inner_begin, region.width);
+
+    for (int r = 0; r < region.height; r++)
+    {
+        const uint8_t *rows[5];
+        for (int dy = 0; dy < 5; dy++)
+        {
+            rows[dy] = src.ptr<uint8_t>(std::clamp(
+                region.y + r + dy - BLUR_RADIUS, 0, src.rows - 1));
+        }
+        uint8_t *out = dst->ptr<uint8_t>(r);
+
+        // pixels at the border of src, whose neighbourhood is replicated
+        auto blur_border_pixel = [&](int c) {
+            for (int channel = 0; channel < 3; channel++)
+            {
+                uint8_t values[25];
+                for (int dy = 0; dy < 5; dy++)
+                {
+                    for (int dx = 0; dx < 5; dx++)
+                    {
+                        const int col = std::clamp(
+                            region.x + c + dx - BLUR_RADIUS, 0, src.cols - 1);
+                        values[5 * dy + dx] = rows[dy][3 * col + channel];
+                    }
+                }
+                apply_median_25_network(values);
+                out[3 * c + channel] = values[12];
+            }
+        };
+        for (int c = 0; c < inner_begin; c++)
+        {
+            blur_border_pixel(c);
+        }
+        for (int c = inner_end; c < region.width; c++)
+        {
+            blur_border_pixel(c);
+        }
+
+        if (inner_begin < inner_end)
+        {
+            const uint8_t *inner_rows[5];
+            for (int dy = 0; dy < 5; dy++)
+            {
+                inner_rows[dy] = rows[dy] + 3 * (region.x + inner_begin);
+            }
+            blur_row(inner_rows,
+                     3 * (inner_end - inner_begin),
+                     out + 3 * inner_begin);
+        }
+    }
+}
+
+/**
+ * @brief Erode one row of a label image.
+ *
+ * A pixel keeps its label if all its 4-neighbours have the same label,
+ * otherwise it is set to background.  Since the colour masks are disjoint,
+ * this is equivalent to eroding each binary colour mask separately with
+ * the 3x3 elliptic (i.e. cross-shaped) kernel of cv::erode.  As there, pixels
+ * outside of the image are ignored.
+ *
+ * @param above Row above or nullptr at the top border of the image.
+ * @param row The row that is eroded.
+ * @param below Row below or nullptr at the bottom border of the image.
+ * @param out Output row.
+ * @param cols Number of columns.
+ */
+void erode_label_row(const uint8_t *above,
+                     const uint8_t *row,
+                     const uint8_t *below,
+                     uint8_t *out,
+                     int cols)
+{
+    for (int c = 0; c < cols; c++)
+    {
+        const uint8_t label = row[c];
+        const bool keep = (above == nullptr || above[c] == label) &&
+                          (below == nullptr || below[c] == label) &&
+                          (c == 0 || row[c - 1] == label) &&
+                          (c == cols - 1 || row[c + 1] == label);
+        out[c] = keep ? label : 0;
+    }
+}
+
+/**
+ * @brief Dilate one row of an eroded label image.
+ *
+ * Counterpart of erode_label_row() to complete the morphological opening.
+ * The opened mask of a colour is a subset of the raw mask of that colour, so
+ * a pixel can only get the label it had before the erosion.
+ *
+ * @param above Eroded row above or nullptr at the top border of the image.
+ * @param row The eroded row.
+ * @param below Eroded row below or nullptr at the bottom border of the image.
+ * @param raw_row The row before the erosion.
+ * @param out Output row.
+ * @param cols Number of columns.
+ */
+void dilate_label_row(const uint8_t *above,
+                      const uint8_t *row,
+                      const uint8_t *below,
+                      const uint8_t *raw_row,
+                      uint8_t *out,
+                      int cols)
+{
+    for (int c = 0; c < cols; c++)
+    {
+        const uint8_t label = raw_row[c];
+        const bool set = label != 0 &&
+                         (row[c] == label ||
+                          (above != nullptr && above[c] == label) ||
+                          (below != nullptr && below[c] == label) ||
+                          (c > 0 && row[c - 1] == label) ||
+                          (c < cols - 1 && row[c + 1] == label));
+        out[c] = set ? label : 0;
+    }
+}
+
+/**
+ * @brief Get a view of the given size into a buffer.
+ *
+ * The buffer is enlarged if needed but never shrunk, so that it is not
+ * reallocated when the requested size varies.
+ */
+cv::Mat get_buffer_view(cv::Mat *buffer, int rows, int cols, int type)
+{
+    if (buffer->rows < rows || buffer->cols < cols || buffer->type() != type)
+    {
+        buffer->create(
+            std::max(buffer->rows, rows), std::max(buffer->cols, cols), type);
+    }
+    return (*buffer)(cv::Rect(0, 0, cols, rows));
+}
+
+/**
+ * @brief Convert Bayer image to half resolution BGR without demosaicing.
+ *
+ * @param image_bayer Bayer image with quads "R G / G B".
+ * @param image_bgr Output.  One pixel per quad.
+ */
+void bayer_quads_to_bgr(const cv::Mat &image_bayer, cv::Mat *image_bgr)
+{
+    image_bgr->create(image_bayer.rows / 2, image_bayer.cols / 2, CV_8UC3);
+
+    for (int r = 0; r < image_bgr->rows; r++)
+    {
+        const uint8_t *top = image_bayer.ptr<uint8_t>(2 * r);
+        const uint8_t *bottom = image_bayer.ptr<uint8_t>(2 * r + 1);
+        uint8_t *bgr = image_bgr->ptr<uint8_t>(r);
+
+        for (int c = 0; c < image_bgr->cols; c++)
+        {
+            bgr[3 * c + 0] = bottom[2 * c + 1];
+            bgr[3 * c + 1] = (top[2 * c + 1] + bottom[2 * c] + 1) / 2;
+            bgr[3 * c + 2] = top[2 * c];
+        }
+    }
+}
+}  // namespace
+
+void ColorSegmenter::detect_colors(const cv::Mat &image_bgr)
+{
+    detect_colors(image_bgr, cv::Rect(0, 0, image_bgr.cols, image_bgr.rows));
+}
+
+void ColorSegmenter::detect_colors(const cv::Mat &image_bgr,
+                                   const cv::Rect &roi,
+                                   ThreadPool *thread_pool)
+{
+    // copy (into the reused buffer), as the caller may reuse the memory of
+    // the image before get_image() is called
+    image_bgr.copyTo(image_bgr_);
+    reset_output(image_bgr.size());
+
+    roi_ = roi & cv::Rect(0, 0, image_bgr.cols, image_bgr.rows);
+    const cv::Mat image_roi = image_bgr(roi_);
+
+    if (coarse_scale_ > 1 && !roi_.empty())
+    {
+        classify_coarse(image_roi);
+    }
+
+    // split the rows into bands which are processed independently
+    size_t num_bands = 1;
+    if (thread_pool)
+    {
+        num_bands = std::clamp(roi_.height / MIN_BAND_ROWS,
+                               1,
+                               static_cast<int>(thread_pool->get_num_threads()));
+    }
+    if (band_workspaces_.size() < num_bands)
+    {
+        band_workspaces_.resize(num_bands);
+    }
+
+    auto run_band = [this, &image_roi, num_bands](size_t band) {
+        const int row_begin = band * roi_.height / num_bands;
+        const int row_end = (band + 1) * roi_.height / num_bands;
+        this->process_band(
+            image_roi, row_begin, row_end, &band_workspaces_[band]);
     };
+    if (num_bands > 1)
+    {
+        thread_pool->parallel_for(num_bands, run_band);
+    }
+    else
+    {
+        run_band(0);
+    }
+
+    // sum up the pixel counts of the bands and concatenate their runs (in
+    // order of the bands, so the runs stay sorted)
+    label_counts_.fill(0);
+    label_counts_[0] = image_bgr.total() - roi_.area();
+    roi_border_counts_.fill(0);
+    for (SparseMask &mask : sparse_masks_)
+    {
+        mask.clear();
+    }
+    // release instead of overwriting, as callers may still hold the masks
+    for (cv::Mat &mask : dense_masks_)
+    {
+        mask.release();
+    }
+    for (size_t band = 0; band < num_bands; band++)
+    {
+        const BandWorkspace &workspace = band_workspaces_[band];
+        for (size_t i = 0; i < label_counts_.size(); i++)
+        {
+            label_counts_[i] += workspace.label_counts[i];
+            roi_border_counts_[i] += workspace.roi_border_counts[i];
+        }
+        for (size_t i = 0; i < sparse_masks_.size(); i++)
+        {
+            sparse_masks_[i].append(workspace.sparse_masks[i]);
+        }
+    }
+
+    select_dominant_colors();
+}
+
+void ColorSegmenter::process_band(const cv::Mat &image_roi,
+                                  int row_begin,
+                                  int row_end,
+                                  BandWorkspace *workspace)
+{
+    const int rows = roi_.height;
+    const int cols = roi_.width;
+    const bool coarse_to_fine = coarse_scale_ > 1;
+
+    workspace->raw_label_rows =
+        get_buffer_view(&workspace->raw_label_buffer, 3, cols, CV_8UC1);
+    workspace->eroded_label_rows =
+        get_buffer_view(&workspace->eroded_label_buffer, 3, cols, CV_8UC1);
+    workspace->label_counts.fill(0);
+    workspace->roi_border_counts.fill(0);
+    for (SparseMask &mask : workspace->sparse_masks)
+    {
+        mask.clear();
+    }
 
-    // structuring element for denoising
-    constexpr unsigned OPEN_RADIUS = 1;
-    static const cv::Mat open_kernel = cv::getStructuringElement(
-        cv::MORPH_ELLIPSE, cv::Size(2 * OPEN_RADIUS + 1, 2 * OPEN_RADIUS + 1));
+    // Rows are streamed through the pipeline classify -> erode -> dilate.
+    // Each stage lags one row behind the previous one, as it needs the
+    // neighbouring rows.  So to finish the rows of the band, two rows above
+    // and below of it need to be classified and one row eroded.
+    const int classify_begin = std::max(row_begin - 2, 0);
+    const int classify_end = std::min(row_end + 2, rows);
+    const int erode_begin = std::max(row_begin - 1, 0);
+    const int erode_end = std::min(row_end + 1, rows);
 
-    // initialize masks
-    for (FaceColor color : cube_model_.get_colors())
+    for (int tile_begin = classify_begin; tile_begin < classify_end;
+         tile_begin += TILE_ROWS)
     {
-        masks_[color] =
-            cv::Mat(image_bgr_.rows, image_bgr_.cols, CV_8UC1, cv::Scalar(0));
+        const int tile_end = std::min(tile_begin + TILE_ROWS, classify_end);
+
+        // only the columns that contain active blocks need to be processed
+        int col_begin = 0, col_end = cols;
+        if (coarse_to_fine)
+        {
+            col_begin = cols;
+            col_end = 0;
+            for (int i = active_spans_begin_[get_coarse_row(tile_begin)];
+                 i < active_spans_begin_[get_coarse_row(tile_end - 1) + 1];
+                 i++)
+            {
+                col_begin = std::min(col_begin, active_spans_[i].start);
+                col_end = std::max(col_end, active_spans_[i].end);
+            }
+        }
+        if (col_begin < col_end)
+        {
+            preprocess_tile(
+                image_roi, tile_begin, tile_end, col_begin, col_end, workspace);
+        }
+
+        for (int r = tile_begin; r < tile_end; r++)
+        {
+            uint8_t *raw_labels = workspace->raw_label_rows.ptr<uint8_t>(r % 3);
+
+            if (coarse_to_fine)
+            {
+                std::memset(raw_labels, 0, cols);
+                const int coarse_row = get_coarse_row(r);
+                for (int i = active_spans_begin_[coarse_row];
+                     i < active_spans_begin_[coarse_row + 1];
+                     i++)
+                {
+                    classify_row(*workspace,
+                                 r - tile_begin,
+                                 active_spans_[i].start,
+                                 active_spans_[i].end,
+                                 raw_labels);
+                }
+            }
+            else
+            {
+                classify_row(*workspace, r - tile_begin, 0, cols, raw_labels);
+            }
+
+            if (r - 1 >= erode_begin)
+            {
+                erode_row(r - 1, workspace);
+            }
+            if (r - 2 >= row_begin)
+            {
+                finish_row(r - 2, workspace);
+            }
+        }
     }
 
-    for (int r = 0; r < image_bgr_.rows; r += 1)
+    // flush the pipeline at the bottom of the image
+    if (classify_end == rows)
     {
-        for (int c = 0; c < image_bgr_.cols; c += 1)
+        if (rows - 1 >= erode_begin && rows - 1 < erode_end)
         {
-            std::array<float, XGB_NUM_FEATURES> features;
+            erode_row(rows - 1, workspace);
+        }
+        for (int r = std::max(rows - 2, row_begin); r < row_end; r++)
+        {
+            finish_row(r, workspace);
+        }
+    }
+}
+
+void ColorSegmenter::detect_colors_bayer(const cv::Mat &image_bayer,
+                                         const cv::Rect &roi,
+                                         ThreadPool *thread_pool)
+{
+    if (image_bayer.type() != CV_8UC1)
+    {
+        throw std::invalid_argument("Bayer image needs to be of type CV_8UC1.");
+    }
+
+    bayer_quads_to_bgr(image_bayer, &bayer_quads_bgr_);
+
+    detect_colors(bayer_quads_bgr_, roi, thread_pool);
+}
 
-            cv::Vec3b bgr = image_bgr_.at<cv::Vec3b>(r, c);
-            cv::Vec3b hsv = image_hsv_.at<cv::Vec3b>(r, c);
+void ColorSegmenter::reset_output(const cv::Size &image_size)
+{
+    if (labels_.size() != image_size)
+    {
+        labels_ = cv::Mat::zeros(image_size, CV_8UC1);
+    }
+    else
+    {
+        // only the previous ROI can contain non-zero values
+        labels_(roi_).setTo(0);
+    }
+}
+
+void ColorSegmenter::preprocess_tile(const cv::Mat &image_bgr,
+                                     int row_begin,
+                                     int row_end,
+                                     int col_begin,
+                                     int col_end,
+                                     BandWorkspace *workspace) const
+{
+    // Blur the image to make colour classification easier.  Pixels outside
+    // of the tile are used for the blur but at the image border the border
+    // pixels are replicated, exactly like when blurring the whole image.
+    workspace->tile_bgr = get_buffer_view(&workspace->tile_bgr_buffer,
+                                          row_end - row_begin,
+                                          col_end - col_begin,
+                                          CV_8UC3);
+    median_blur_5x5(
+        image_bgr,
+        cv::Rect(col_begin, row_begin, col_end - col_begin, row_end - row_begin),
+        &workspace->tile_bgr);
+    workspace->tile_col_begin = col_begin;
 
-            features[0] = static_cast<float>(bgr[0]);
-            features[1] = static_cast<float>(bgr[1]);
-            features[2] = static_cast<float>(bgr[2]);
-            features[3] = static_cast<float>(hsv[0]);
-            features[4] = static_cast<float>(hsv[1]);
-            features[5] = static_cast<float>(hsv[2]);
+    // the lookup table already accounts for the HSV features
+    if (backend_ == Backend::XGBOOST)
+    {
+        workspace->tile_hsv = get_buffer_view(&workspace->tile_hsv_buffer,
+                                              row_end - row_begin,
+                                              col_end - col_begin,
+                                              CV_8UC3);
+        cv::cvtColor(
+            workspace->tile_bgr, workspace->tile_hsv, cv::COLOR_BGR2HSV);
+    }
+}
+
+void ColorSegmenter::classify_coarse(const cv::Mat &image_bgr)
+{
+    const cv::Size coarse_size(
+        (image_bgr.cols + coarse_scale_ - 1) / coarse_scale_,
+        (image_bgr.rows + coarse_scale_ - 1) / coarse_scale_);
 
-            std::array<float, XGB_NUM_CLASSES> probabilities =
-                xgb_classify(features);
+    // Averaging over the blocks already removes most of the noise, so no
+    // additional blur is needed here.
+    cv::resize(image_bgr, coarse_bgr_, coarse_size, 0, 0, cv::INTER_AREA);
+    if (backend_ == Backend::XGBOOST)
+    {
+        cv::cvtColor(coarse_bgr_, coarse_hsv_, cv::COLOR_BGR2HSV);
+    }
 
-            auto max_elem =
-                std::max_element(probabilities.begin(), probabilities.end());
-            int label = max_elem - probabilities.begin();
+    coarse_labels_.create(coarse_size, CV_8UC1);
+    for (int r = 0; r < coarse_size.height; r++)
+    {
+        classify_pixels(coarse_bgr_.ptr<uint8_t>(r),
+                        coarse_hsv_.empty() ? nullptr
+                                            : coarse_hsv_.ptr<uint8_t>(r),
+                        coarse_size.width,
+                        coarse_labels_.ptr<uint8_t>(r));
+    }
 
-            if (label > 0)
+    // blocks with coloured pixels and their neighbours are active (i.e. a
+    // 3x3 dilation, done manually as cv::dilate allocates a filter engine on
+    // every call)
+    active_blocks_.create(coarse_size, CV_8UC1);
+    for (int r = 0; r < coarse_size.height; r++)
+    {
+        uint8_t *active = active_blocks_.ptr<uint8_t>(r);
+        std::memset(active, 0, coarse_size.width);
+        for (int nr = std::max(r - 1, 0);
+             nr <= std::min(r + 1, coarse_size.height - 1);
+             nr++)
+        {
+            const uint8_t *labels = coarse_labels_.ptr<uint8_t>(nr);
+            for (int c = 0; c < coarse_size.width; c++)
             {
-                FaceColor color = map_label_to_color[label - 1];
-                masks_[color].at<uint8_t>(r, c) = 255;
+                if (labels[c] != 0)
+                {
+                    active[std::max(c - 1, 0)] = 1;
+                    active[c] = 1;
+                    active[std::min(c + 1, coarse_size.width - 1)] = 1;
+                }
             }
         }
     }
 
-    std::array<unsigned int, FaceColor::N_COLORS> color_counts;
-    // post-process masks
-    for (FaceColor color : cube_model_.get_colors())
+    // convert to column spans at full resolution (blocks are mapped to full
+    // resolution columns such that the whole image is covered)
+    const int cols = image_bgr.cols;
+    auto block_begin = [cols, coarse_size](int block) {
+        return (block * cols + coarse_size.width - 1) / coarse_size.width;
+    };
+
+    active_spans_.clear();
+    active_spans_begin_.resize(coarse_size.height + 1);
+    for (int r = 0; r < coarse_size.height; r++)
     {
-        // "open" image to get rid of single-pixel noise
-        cv::morphologyEx(
-            masks_[color], masks_[color], cv::MORPH_OPEN, open_kernel);
+        active_spans_begin_[r] = active_spans_.size();
 
-        // count number of pixels of each color
-        color_counts[color] = cv::countNonZero(masks_[color]);
+        const uint8_t *active = active_blocks_.ptr<uint8_t>(r);
+        for (int block = 0; block < coarse_size.width; block++)
+        {
+            if (!active[block])
+            {
+                continue;
+            }
+            const int begin = block_begin(block);
+            const int end = block_begin(block + 1);
+            // merge with the previous span if adjacent
+            if (static_cast<int>(active_spans_.size()) >
+                    active_spans_begin_[r] &&
+                active_spans_.back().end == begin)
+            {
+                active_spans_.back().end = end;
+            }
+            else
+            {
+                active_spans_.emplace_back(begin, end);
+            }
+        }
+    }
+    active_spans_begin_[coarse_size.height] = active_spans_.size();
+}
+
+void ColorSegmenter::classify_pixels(const uint8_t *bgr,
+                                     const uint8_t *hsv,
+                                     int num_pixels,
+                                     uint8_t *labels) const
+{
+    if (backend_ == Backend::LOOKUP_TABLE)
+    {
+        for (int i = 0; i < num_pixels; i++)
+        {
+            labels[i] = lookup_table_->get_label(bgr + 3 * i);
+        }
+    }
+    else
+    {
+        batch_classifier_->classify_pixels(bgr, hsv, num_pixels, labels);
+    }
+}
+
+void ColorSegmenter::classify_row(const BandWorkspace &workspace,
+                                  int tile_row,
+                                  int col_begin,
+                                  int col_end,
+                                  uint8_t *labels) const
+{
+    const int offset = 3 * (col_begin - workspace.tile_col_begin);
+    const uint8_t *bgr = workspace.tile_bgr.ptr<uint8_t>(tile_row) + offset;
+    const uint8_t *hsv =
+        backend_ == Backend::XGBOOST
+            ? workspace.tile_hsv.ptr<uint8_t>(tile_row) + offset
+            : nullptr;
+
+    classify_pixels(bgr, hsv, col_end - col_begin, labels + col_begin);
+}
+
+void ColorSegmenter::erode_row(int row, BandWorkspace *workspace) const
+{
+    const int rows = roi_.height;
+    const cv::Mat &raw_rows = workspace->raw_label_rows;
+
+    erode_label_row(
+        row > 0 ? raw_rows.ptr<uint8_t>((row - 1) % 3) : nullptr,
+        raw_rows.ptr<uint8_t>(row % 3),
+        row + 1 < rows ? raw_rows.ptr<uint8_t>((row + 1) % 3) : nullptr,
+        workspace->eroded_label_rows.ptr<uint8_t>(row % 3),
+        roi_.width);
+}
+
+void ColorSegmenter::finish_row(int row, BandWorkspace *workspace)
+{
+    const int rows = roi_.height;
+    const int cols = roi_.width;
+    const int image_row = roi_.y + row;
+
+    const cv::Mat &eroded_rows = workspace->eroded_label_rows;
+    auto &label_counts = workspace->label_counts;
+    auto &roi_border_counts = workspace->roi_border_counts;
+
+    uint8_t *labels = labels_.ptr<uint8_t>(image_row) + roi_.x;
+
+    dilate_label_row(
+        row > 0 ? eroded_rows.ptr<uint8_t>((row - 1) % 3) : nullptr,
+        eroded_rows.ptr<uint8_t>(row % 3),
+        row + 1 < rows ? eroded_rows.ptr<uint8_t>((row + 1) % 3) : nullptr,
+        workspace->raw_label_rows.ptr<uint8_t>(row % 3),
+        labels,
+        cols);
+
+    // run-length encode the row and count pixels per label
+    int c = 0;
+    while (c < cols)
+    {
+        const uint8_t label = labels[c];
+        const int run_begin = c;
+        while (c < cols && labels[c] == label)
+        {
+            c++;
+        }
+        label_counts[label] += c - run_begin;
+        if (label > 0)
+        {
+            workspace->sparse_masks[map_label_to_color_[label - 1]].add_run(
+                image_row, roi_.x + run_begin, roi_.x + c);
+        }
+    }
+
+    // count pixels on the sides of the ROI that are inside the image
+    if ((row == 0 && roi_.y > 0) ||
+        (row == rows - 1 && roi_.y + rows < labels_.rows))
+    {
+        for (int c = 0; c < cols; c++)
+        {
+            roi_border_counts[labels[c]]++;
+        }
+    }
+    else
+    {
+        if (roi_.x > 0)
+        {
+            roi_border_counts[labels[0]]++;
+        }
+        if (roi_.x + cols < labels_.cols)
+        {
+            roi_border_counts[labels[cols - 1]]++;
+        }
+    }
+}
+
+void ColorSegmenter::select_dominant_colors()
+{
+    std::array<unsigned int, FaceColor::N_COLORS> color_counts;
+    for (size_t i = 0; i < map_label_to_color_.size(); i++)
+    {
+        color_counts[map_label_to_color_[i]] = label_counts_[i + 1];
     }
 
     // we store the 3 colors with most pixels in dominant_colors_
-    std::vector<unsigned int> colors_sorted_descending(FaceColor::N_COLORS);
+    std::array<unsigned int, FaceColor::N_COLORS> colors_sorted_descending;
     std::iota(
         colors_sorted_descending.begin(), colors_sorted_descending.end(), 0);
     std::sort(colors_sorted_descending.begin(),
@@ -112,32 +811,68 @@ void ColorSegmenter::xgboost_mask()
     }
 }
 
-cv::Mat ColorSegmenter::get_segmented_image() const
+uint8_t ColorSegmenter::get_label(FaceColor color)
 {
-    cv::Mat segmentation(
-        image_bgr_.rows, image_bgr_.cols, CV_8UC3, cv::Scalar(0, 0, 0));
+    for (size_t i = 0; i < map_label_to_color_.size(); i++)
+    {
+        if (map_label_to_color_[i] == color)
+        {
+            return i + 1;
+        }
+    }
+    throw std::invalid_argument("Invalid colour.");
+}
+
+unsigned int ColorSegmenter::get_num_roi_border_pixels(FaceColor color) const
+{
+    return roi_border_counts_[get_label(color)];
+}
 
+cv::Mat ColorSegmenter::get_segmented_image() const
+{
+    // colour of each label (only dominant colours are shown)
+    std::array<cv::Vec3b, FaceColor::N_COLORS + 1> palette;
+    palette.fill(cv::Vec3b(0, 0, 0));
     for (FaceColor color : dominant_colors_)
     {
         auto rgb = cube_model_.get_rgb(color);
         // image is BGR, so swap R and B
-        cv::Scalar color_bgr(rgb[2], rgb[1], rgb[0]);
-        segmentation.setTo(color_bgr, masks_[color]);
+        palette[get_label(color)] = cv::Vec3b(rgb[2], rgb[1], rgb[0]);
     }
-    return segmentation.clone();
+
+    cv::Mat segmentation(labels_.size(), CV_8UC3);
+    for (int r = 0; r < labels_.rows; r++)
+    {
+        const uint8_t *labels = labels_.ptr<uint8_t>(r);
+        cv::Vec3b *pixels = segmentation.ptr<cv::Vec3b>(r);
+        for (int c = 0; c < labels_.cols; c++)
+        {
+            pixels[c] = palette[labels[c]];
+        }
+    }
+    return segmentation;
 }
 
 cv::Mat ColorSegmenter::get_image() const
 {
-    return image_bgr_.clone();
+    // the blurred image is not stored by the fused segmentation, so compute
+    // it here (same as the median filter applied for the classification)
+    cv::Mat image;
+    cv::medianBlur(image_bgr_, image, 2 * BLUR_RADIUS + 1);
+    return image;
 }
 
 cv::Mat ColorSegmenter::get_mask(FaceColor color) const
 {
-    return masks_[color];
+    cv::Mat &mask = dense_masks_[color];
+    if (mask.empty())
+    {
+        cv::compare(labels_, get_label(color), mask, cv::CMP_EQ);
+    }
+    return mask;
 }
 
-std::vector<FaceColor> ColorSegmenter::get_dominant_colors() const
+const std::vector<FaceColor> &ColorSegmenter::get_dominant_colors() const
 {
     return dominant_colors_;
 }
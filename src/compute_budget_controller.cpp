@@ -0,0 +1,96 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <trifinger_object_tracking/compute_budget_controller.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace trifinger_object_tracking
+{
+namespace
+{
+//! Product of the parameters, to which the work is proportional.
+double get_work(const PoseSearchParameters &parameters)
+{
+    return static_cast<double>(parameters.num_samples) *
+           parameters.population_size * parameters.num_generations;
+}
+
+//! Scale a parameter, keeping it between min_value and max_value.
+unsigned int scale_parameter(unsigned int max_value,
+                             unsigned int min_value,
+                             double factor)
+{
+    const unsigned int value = std::lround(max_value * factor);
+    return std::clamp(value, std::min(min_value, max_value), max_value);
+}
+}  // namespace
+
+ComputeBudgetController::ComputeBudgetController(
+    std::chrono::microseconds frame_period,
+    const PoseSearchParameters &max_parameters)
+    : frame_period_(frame_period),
+      max_parameters_(max_parameters),
+      parameters_(max_parameters)
+{
+    if (frame_period.count() <= 0)
+    {
+        throw std::invalid_argument("Frame period must be positive.");
+    }
+}
+
+void ComputeBudgetController::update(
+    std::chrono::microseconds fixed_duration,
+    std::chrono::microseconds pose_search_duration)
+{
+    const double fixed_us = fixed_duration.count();
+    // avoid a division by zero for implausibly fast searches
+    const double pose_us_per_effort =
+        std::max<double>(pose_search_duration.count(), 1.0) / effort_;
+
+    if (has_estimates_)
+    {
+        fixed_duration_us_ +=
+            SMOOTHING_FACTOR * (fixed_us - fixed_duration_us_);
+        pose_search_duration_us_per_effort_ +=
+            SMOOTHING_FACTOR *
+            (pose_us_per_effort - pose_search_duration_us_per_effort_);
+    }
+    else
+    {
+        fixed_duration_us_ = fixed_us;
+        pose_search_duration_us_per_effort_ = pose_us_per_effort;
+        has_estimates_ = true;
+    }
+
+    const double available_us =
+        TARGET_UTILISATION * frame_period_.count() - fixed_duration_us_;
+    const double target_effort =
+        available_us / pose_search_duration_us_per_effort_;
+
+    // decrease immediately, increase slowly
+    set_effort(
+        std::min(target_effort, requested_effort_ * MAX_INCREASE_FACTOR));
+}
+
+void ComputeBudgetController::set_effort(double effort)
+{
+    requested_effort_ = std::clamp(effort, MIN_EFFORT, 1.0);
+
+    // distribute the effort evenly over the three parameters
+    const double factor = std::cbrt(requested_effort_);
+    parameters_.num_samples = scale_parameter(
+        max_parameters_.num_samples, MIN_NUM_SAMPLES, factor);
+    parameters_.population_size = scale_parameter(
+        max_parameters_.population_size, MIN_POPULATION_SIZE, factor);
+    parameters_.num_generations = scale_parameter(
+        max_parameters_.num_generations, MIN_NUM_GENERATIONS, factor);
+
+    effort_ = get_work(parameters_) / get_work(max_parameters_);
+}
+
+}  // namespace trifinger_object_tracking
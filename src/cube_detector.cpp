@@ -1,88 +1,387 @@
 #include <trifinger_object_tracking/cube_detector.hpp>
 
+#include <algorithm>
 #include <opencv2/core/eigen.hpp>
-#include <thread>
 #include <trifinger_object_tracking/utils.hpp>
+#include <trifinger_object_tracking/xgboost_model_loader.hpp>
 
 namespace trifinger_object_tracking
 {
+namespace
+{
+std::array<trifinger_cameras::CameraParameters, CubeDetector::N_CAMERAS>
+get_half_resolution_parameters(
+    const std::array<trifinger_cameras::CameraParameters,
+                     CubeDetector::N_CAMERAS> &camera_params)
+{
+    std::array<trifinger_cameras::CameraParameters, CubeDetector::N_CAMERAS>
+        scaled_params;
+    for (size_t i = 0; i < camera_params.size(); i++)
+    {
+        scaled_params[i] = scale_camera_parameters(camera_params[i], 0.5);
+    }
+    return scaled_params;
+}
+
+cv::Vec3f to_cv(const Eigen::Vector3d &vector)
+{
+    return cv::Vec3f(vector[0], vector[1], vector[2]);
+}
+
+//! Convert the prediction of the pose filter to a prior of the pose search.
+PoseDetector::PosePrior to_pose_prior(const PoseFilter::Prediction &prediction)
+{
+    const Eigen::AngleAxisd rotation(
+        Eigen::Quaterniond(prediction.pose.orientation));
+
+    return {Pose(to_cv(prediction.pose.position),
+                 to_cv(rotation.angle() * rotation.axis()),
+                 prediction.pose.confidence),
+            to_cv(prediction.position_std),
+            to_cv(prediction.orientation_std)};
+}
+}  // namespace
+
 CubeDetector::CubeDetector(const std::array<trifinger_cameras::CameraParameters,
-                                            N_CAMERAS> &camera_params)
-    : color_segmenters_{ColorSegmenter(cube_model_),
-                        ColorSegmenter(cube_model_),
-                        ColorSegmenter(cube_model_)},
-      pose_detector_(cube_model_, camera_params)
+                                            N_CAMERAS> &camera_params,
+                           ColorSegmenter::Backend segmentation_backend,
+                           unsigned int num_threads,
+                           const std::string &lookup_table_cache_file)
+    : color_segmenters_{ColorSegmenter(cube_model_,
+                                       segmentation_backend,
+                                       lookup_table_cache_file),
+                        ColorSegmenter(cube_model_,
+                                       segmentation_backend,
+                                       lookup_table_cache_file),
+                        ColorSegmenter(cube_model_,
+                                       segmentation_backend,
+                                       lookup_table_cache_file)},
+      pose_detector_(cube_model_, camera_params),
+      bayer_pose_detector_(cube_model_,
+                           get_half_resolution_parameters(camera_params)),
+      thread_pool_(std::make_unique<ThreadPool>(num_threads))
 {
 }
 
 CubeDetector::CubeDetector(
-    const std::array<std::string, N_CAMERAS> &camera_param_files)
+    const std::array<std::string, N_CAMERAS> &camera_param_files,
+    ColorSegmenter::Backend segmentation_backend,
+    unsigned int num_threads,
+    const std::string &lookup_table_cache_file)
     : CubeDetector(
-          trifinger_object_tracking::load_camera_parameters(camera_param_files))
+          trifinger_object_tracking::load_camera_parameters(camera_param_files),
+          segmentation_backend,
+          num_threads,
+          lookup_table_cache_file)
 {
 }
 
+std::string CubeDetector::get_default_lookup_table_cache_file()
+{
+    return COLOR_LOOKUP_TABLE_CACHE_FILE;
+}
+
 ObjectPose CubeDetector::detect_cube(
-    const std::array<cv::Mat, N_CAMERAS> &images)
+    const std::array<cv::Mat, N_CAMERAS> &images,
+    std::chrono::microseconds latency_budget,
+    std::optional<PoseFilter::TimePoint> frame_time)
+{
+    return detect(images, true, false, latency_budget, frame_time);
+}
+
+ObjectPose CubeDetector::detect_cube_bayer(
+    const std::array<cv::Mat, N_CAMERAS> &images_bayer,
+    std::chrono::microseconds latency_budget,
+    std::optional<PoseFilter::TimePoint> frame_time)
+{
+    return detect(images_bayer, true, true, latency_budget, frame_time);
+}
+
+ObjectPose CubeDetector::detect_cube_bayer_single_thread(
+    const std::array<cv::Mat, N_CAMERAS> &images_bayer,
+    std::chrono::microseconds latency_budget,
+    std::optional<PoseFilter::TimePoint> frame_time)
+{
+    return detect(images_bayer, false, true, latency_budget, frame_time);
+}
+
+ObjectPose CubeDetector::detect_cube_single_thread(
+    const std::array<cv::Mat, N_CAMERAS> &images,
+    std::chrono::microseconds latency_budget,
+    std::optional<PoseFilter::TimePoint> frame_time)
+{
+    return detect(images, false, false, latency_budget, frame_time);
+}
+
+void CubeDetector::set_roi_tracking_enabled(bool enable)
+{
+    roi_tracking_enabled_ = enable;
+}
+
+void CubeDetector::set_pose_tracking_enabled(bool enable)
+{
+    pose_detector_.set_tracking_enabled(enable);
+    bayer_pose_detector_.set_tracking_enabled(enable);
+}
+
+void CubeDetector::set_pose_refinement_enabled(bool enable)
+{
+    pose_detector_.set_refinement_enabled(enable);
+    bayer_pose_detector_.set_refinement_enabled(enable);
+}
+
+void CubeDetector::set_pose_triangulation_enabled(bool enable)
+{
+    pose_detector_.set_triangulation_enabled(enable);
+    bayer_pose_detector_.set_triangulation_enabled(enable);
+}
+
+void CubeDetector::set_pose_objective(PoseDetector::Objective objective)
+{
+    pose_detector_.set_objective(objective);
+    bayer_pose_detector_.set_objective(objective);
+}
+
+void CubeDetector::set_pose_search_parameters(
+    const PoseSearchParameters &parameters)
+{
+    pose_detector_.set_search_parameters(parameters);
+    bayer_pose_detector_.set_search_parameters(parameters);
+}
+
+void CubeDetector::reset_tracking()
+{
+    pose_filter_.reset();
+    pose_detector_.reset_tracking();
+    bayer_pose_detector_.reset_tracking();
+}
+
+ObjectPose CubeDetector::detect(const std::array<cv::Mat, N_CAMERAS> &images,
+                                bool parallel,
+                                bool bayer_input,
+                                std::chrono::microseconds latency_budget,
+                                std::optional<PoseFilter::TimePoint> frame_time)
 {
     // ScopedTimer timer("CubeDetector/detect_cube");
 
-    std::array<std::vector<FaceColor>, N_CAMERAS> dominant_colors;
-    std::array<std::vector<cv::Mat>, N_CAMERAS> masks;
+    const PoseDetector::TimePoint start = std::chrono::steady_clock::now();
+    const PoseDetector::TimePoint deadline =
+        latency_budget == NO_LATENCY_BUDGET ? PoseDetector::NO_DEADLINE
+                                            : start + latency_budget;
+    // the motion model is driven by the capture time of the frames, so the
+    // time the frame was waiting for the detection does not distort it
+    const PoseFilter::TimePoint filter_time = frame_time.value_or(start);
+    last_stage_durations_ = {};
+
+    bayer_input_ = bayer_input;
 
-    // run line detection multi-threaded (one thread per image)
-    std::array<std::thread, N_CAMERAS> threads;
+    // Bayer images are segmented at half resolution
+    const int scale = bayer_input ? 2 : 1;
+    std::array<cv::Rect, N_CAMERAS> full_images;
     for (size_t i = 0; i < N_CAMERAS; i++)
     {
-        threads[i] = std::thread(
-            [this, &dominant_colors, &masks](int camera_idx,
-                                             const cv::Mat &image) {
-                color_segmenters_[camera_idx].detect_colors(image);
-
-                dominant_colors[camera_idx] =
-                    color_segmenters_[camera_idx].get_dominant_colors();
-                for (FaceColor color : dominant_colors[camera_idx])
-                {
-                    masks[camera_idx].push_back(
-                        color_segmenters_[camera_idx].get_mask(color));
-                }
-            },
-            i,
-            images[i]);
+        full_images[i] =
+            cv::Rect(0, 0, images[i].cols / scale, images[i].rows / scale);
+    }
+
+    std::optional<PoseDetector::PosePrior> prior;
+    if (auto prediction = pose_filter_.predict(filter_time))
+    {
+        prior = to_pose_prior(prediction.value());
+    }
+
+    std::optional<std::array<cv::Rect, N_CAMERAS>> rois;
+    if (roi_tracking_enabled_ && prior)
+    {
+        rois = predict_rois(full_images, prior.value());
+    }
+
+    if (prior)
+    {
+        get_pose_detector().set_prior(prior.value());
     }
-    for (std::thread &thread : threads)
+    Pose pose = segment_and_find_pose(
+        images, rois ? rois.value() : full_images, parallel, deadline);
+
+    // The object may not have been fully visible in the ROIs (e.g. after a
+    // sudden movement), so try again with the full images (if there is time
+    // left).
+    if (rois && pose.confidence < ROI_MIN_CONFIDENCE &&
+        std::chrono::steady_clock::now() < deadline)
     {
-        if (thread.joinable())
+        get_pose_detector().set_prior(prior.value());
+        pose = segment_and_find_pose(images, full_images, parallel, deadline);
+    }
+
+    ObjectPose object_pose = convert_pose(pose);
+    pose_filter_.update(object_pose, filter_time);
+
+    return object_pose;
+}
+
+Pose CubeDetector::segment_and_find_pose(
+    const std::array<cv::Mat, N_CAMERAS> &images,
+    const std::array<cv::Rect, N_CAMERAS> &rois,
+    bool parallel,
+    PoseDetector::TimePoint deadline)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    if (parallel)
+    {
+        // Each camera is one task, which is again split into bands of rows,
+        // so all workers of the pool can be used.
+        thread_pool_->parallel_for(N_CAMERAS, [&](size_t i) {
+            segment_image(i,
+                          images[i],
+                          rois[i],
+                          thread_pool_.get(),
+                          &dominant_colors_[i],
+                          &masks_[i]);
+        });
+    }
+    else
+    {
+        for (size_t i = 0; i < N_CAMERAS; i++)
         {
-            thread.join();
+            segment_image(i,
+                          images[i],
+                          rois[i],
+                          nullptr,
+                          &dominant_colors_[i],
+                          &masks_[i]);
         }
     }
 
-    Pose pose = pose_detector_.find_pose(dominant_colors, masks);
-    return convert_pose(pose);
+    const auto segmentation_end = std::chrono::steady_clock::now();
+    Pose pose =
+        get_pose_detector().find_pose(dominant_colors_,
+                                      masks_,
+                                      parallel ? thread_pool_.get() : nullptr,
+                                      deadline);
+
+    last_stage_durations_.segmentation +=
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            segmentation_end - start);
+    last_stage_durations_.pose_estimation +=
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - segmentation_end);
+
+    return pose;
 }
 
-ObjectPose CubeDetector::detect_cube_single_thread(
-    const std::array<cv::Mat, N_CAMERAS> &images)
+void CubeDetector::segment_image(unsigned int camera_idx,
+                                 const cv::Mat &image,
+                                 const cv::Rect &roi,
+                                 ThreadPool *thread_pool,
+                                 std::vector<FaceColor> *dominant_colors,
+                                 std::vector<SparseMask> *masks)
 {
-    // ScopedTimer timer("CubeDetector/detect_cube");
+    ColorSegmenter &segmenter = color_segmenters_[camera_idx];
+    auto detect_colors = [this, &segmenter, &image, thread_pool](
+                             const cv::Rect &region) {
+        if (bayer_input_)
+        {
+            segmenter.detect_colors_bayer(image, region, thread_pool);
+        }
+        else
+        {
+            segmenter.detect_colors(image, region, thread_pool);
+        }
+    };
 
-    std::array<std::vector<FaceColor>, N_CAMERAS> dominant_colors;
-    std::array<std::vector<cv::Mat>, N_CAMERAS> masks;
+    detect_colors(roi);
+    *dominant_colors = segmenter.get_dominant_colors();
 
-    for (size_t i = 0; i < N_CAMERAS; i++)
+    // if the object extends beyond the ROI, segment the full image instead
+    for (FaceColor color : *dominant_colors)
     {
-        color_segmenters_[i].detect_colors(images[i]);
+        if (segmenter.get_num_roi_border_pixels(color) > 0)
+        {
+            const int scale = bayer_input_ ? 2 : 1;
+            detect_colors(
+                cv::Rect(0, 0, image.cols / scale, image.rows / scale));
+            *dominant_colors = segmenter.get_dominant_colors();
+            break;
+        }
+    }
+
+    // assign instead of clear() + push_back(), so the memory of the masks is
+    // reused
+    masks->resize(dominant_colors->size());
+    for (size_t i = 0; i < dominant_colors->size(); i++)
+    {
+        (*masks)[i] = segmenter.get_sparse_mask((*dominant_colors)[i]);
+    }
+}
+
+void CubeDetector::load_color_model(const std::string &model_dump_file)
+{
+    auto classifier = std::make_shared<const XGBoostBatchClassifier>(
+        load_xgb_model_dump(model_dump_file));
+    for (ColorSegmenter &segmenter : color_segmenters_)
+    {
+        segmenter.set_classifier(classifier);
+    }
+}
+
+std::optional<std::array<cv::Rect, CubeDetector::N_CAMERAS>>
+CubeDetector::predict_rois(const std::array<cv::Rect, N_CAMERAS> &full_images,
+                           const PoseDetector::PosePrior &prior) const
+{
+    // an error of the orientation moves the corners by up to their distance
+    // to the centre times the angle
+    const float corner_distance =
+        cv::norm(cv::Vec3f(CubeModel::cube_corners[0]));
+    const float max_orientation_std = std::max({prior.orientation_std[0],
+                                                prior.orientation_std[1],
+                                                prior.orientation_std[2]});
+    const cv::Vec3f extent =
+        ROI_NUM_STD *
+        (prior.position_std +
+         cv::Vec3f::all(corner_distance * max_orientation_std));
+
+    // cover the object moved to each corner of the box of possible positions
+    std::array<cv::Rect, N_CAMERAS> bboxes;
+    for (int corner = 0; corner < 8; corner++)
+    {
+        Pose moved_pose = prior.pose;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            moved_pose.translation[axis] +=
+                (corner & (1 << axis)) ? extent[axis] : -extent[axis];
+        }
 
-        dominant_colors[i] = color_segmenters_[i].get_dominant_colors();
-        for (FaceColor color : dominant_colors[i])
+        auto projected_corners =
+            get_pose_detector().get_projected_points(moved_pose);
+        for (size_t i = 0; i < N_CAMERAS; i++)
         {
-            masks[i].push_back(color_segmenters_[i].get_mask(color));
+            const cv::Rect bbox = cv::boundingRect(projected_corners[i]);
+            bboxes[i] = corner == 0 ? bbox : (bboxes[i] | bbox);
         }
     }
 
-    Pose pose = pose_detector_.find_pose(dominant_colors, masks);
-    return convert_pose(pose);
+    std::array<cv::Rect, N_CAMERAS> rois;
+    for (size_t i = 0; i < N_CAMERAS; i++)
+    {
+        cv::Rect bbox = bboxes[i];
+        const int padding =
+            std::max(ROI_MIN_PADDING,
+                     static_cast<int>(ROI_RELATIVE_PADDING *
+                                      std::max(bbox.width, bbox.height)));
+        bbox -= cv::Point(padding, padding);
+        bbox += cv::Size(2 * padding, 2 * padding);
+
+        rois[i] = bbox & full_images[i];
+
+        // object is predicted to be outside of the image
+        if (rois[i].empty())
+        {
+            return std::nullopt;
+        }
+    }
+
+    return rois;
 }
 
 cv::Mat CubeDetector::create_debug_image(bool fill_faces) const
@@ -91,19 +390,27 @@ cv::Mat CubeDetector::create_debug_image(bool fill_faces) const
     trifinger_object_tracking::CvSubImages subplot(
         cv::Size(image0.cols, image0.rows), 3, 3);
 
-    auto projected_cube_corners = pose_detector_.get_projected_points();
+    const PoseDetector &pose_detector = get_pose_detector();
+    auto projected_cube_corners = pose_detector.get_projected_points();
     for (size_t i = 0; i < N_CAMERAS; i++)
     {
         cv::Mat image = color_segmenters_[i].get_image();
         subplot.set_subimg(image, i, 0);
-        subplot.set_subimg(color_segmenters_[i].get_segmented_image(), i, 1);
+        cv::Mat segmented_image = color_segmenters_[i].get_segmented_image();
+        // mark the region that was segmented
+        cv::Rect roi = color_segmenters_[i].get_roi();
+        if (roi.size() != segmented_image.size())
+        {
+            cv::rectangle(segmented_image, roi, cv::Scalar(255, 255, 255), 1);
+        }
+        subplot.set_subimg(segmented_image, i, 1);
 
         std::vector<cv::Point2f> imgpoints = projected_cube_corners[i];
 
         if (fill_faces)
         {
             for (auto [color, corner_indices] :
-                 pose_detector_.get_visible_faces(i))
+                 pose_detector.get_visible_faces(i))
             {
                 auto rgb = cube_model_.get_rgb(color);
 
@@ -129,7 +436,7 @@ cv::Mat CubeDetector::create_debug_image(bool fill_faces) const
 
             // over-draw with the visible edges in a brighter colour
             for (auto [color, corner_indices] :
-                 pose_detector_.get_visible_faces(i))
+                 pose_detector.get_visible_faces(i))
             {
                 (void)color;  // suppress unused warning
 
@@ -155,12 +462,12 @@ cv::Mat CubeDetector::create_debug_image(bool fill_faces) const
 
     std::string text_misclassied_pixels =
         "num_misclassified_pixels: " +
-        std::to_string(pose_detector_.get_num_misclassified_pixels());
+        std::to_string(pose_detector.get_num_misclassified_pixels());
     std::string text_segmented_pixels =
         "segmented_pixels_ratio: " +
-        std::to_string(pose_detector_.get_segmented_pixels_ratio());
+        std::to_string(pose_detector.get_segmented_pixels_ratio());
     std::string text_confidence =
-        "confidence: " + std::to_string(pose_detector_.get_confidence());
+        "confidence: " + std::to_string(pose_detector.get_confidence());
 
     cv::putText(complete_image_with_text_field,
                 text_misclassied_pixels,
@@ -217,13 +524,16 @@ ObjectPose CubeDetector::convert_pose(const Pose &pose)
     return object_pose;
 }
 
-CubeDetector create_trifingerpro_cube_detector()
+CubeDetector create_trifingerpro_cube_detector(unsigned int num_threads)
 {
-    return CubeDetector({
-        "/etc/trifingerpro/camera60_cropped_and_downsampled.yml",
-        "/etc/trifingerpro/camera180_cropped_and_downsampled.yml",
-        "/etc/trifingerpro/camera300_cropped_and_downsampled.yml",
-    });
+    return CubeDetector(
+        {
+            "/etc/trifingerpro/camera60_cropped_and_downsampled.yml",
+            "/etc/trifingerpro/camera180_cropped_and_downsampled.yml",
+            "/etc/trifingerpro/camera300_cropped_and_downsampled.yml",
+        },
+        ColorSegmenter::Backend::XGBOOST,
+        num_threads);
 }
 
 }  // namespace trifinger_object_tracking
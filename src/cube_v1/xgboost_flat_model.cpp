@@ -0,0 +1,294 @@
+// Generated by xgb_dump_to_flat_cpp.py from xgb_model_dump.txt.
+// Do not edit manually!
+#include <trifinger_object_tracking/xgboost_batch_classifier.hpp>
+
+namespace trifinger_object_tracking
+{
+XGBoostFlatModel get_compiled_xgb_flat_model()
+{
+    XGBoostFlatModel model;
+    model.num_classes = 7;
+    model.num_features = 6;
+    model.tree_roots = {
+        0, 119, 222, 327, 394, 493, 558,
+    };
+    model.tree_classes = {
+        0, 1, 2, 3, 4, 5, 6,
+    };
+    model.tree_depths = {
+        6, 6, 6, 6, 6, 6, 6,
+    };
+    model.feature = {
+        4, 3, 4, 4, 4, -1, 0, -1, -1, 0, 3, -1, -1, 3, -1, -1, 5, 0, 0, -1, -1,
+        1, -1, -1, 1, 2, -1, -1, 3, -1, -1, 4, 4, 4, -1, 2, -1, -1, 2, 2, -1,
+        -1, 1, -1, -1, 5, 5, 2, -1, -1, 0, -1, -1, 2, 4, -1, -1, 2, -1, -1, 5,
+        0, 0, 0, -1, 3, -1, -1, 4, 1, -1, -1, 3, -1, -1, 4, 1, 3, -1, -1, 0, -1,
+        -1, 2, 3, -1, -1, -1, 5, 3, 1, 2, -1, -1, 3, -1, -1, 3, 3, -1, -1, 2,
+        -1, -1, 5, 3, 1, -1, -1, 3, -1, -1, 3, 5, -1, -1, 3, -1, -1, 2, 3, 3, 3,
+        3, -1, 1, -1, -1, 1, -1, 0, -1, -1, 1, 5, -1, 0, -1, -1, 4, 0, -1, -1,
+        3, -1, -1, 0, 0, 1, 5, -1, -1, 4, -1, -1, 4, 3, -1, -1, 3, -1, -1, 3, 4,
+        1, -1, -1, 3, -1, -1, 4, 5, -1, -1, 1, -1, -1, 2, 3, 3, 3, -1, 1, -1,
+        -1, 4, 1, -1, -1, 3, -1, -1, 0, 5, 5, -1, -1, 2, -1, -1, 3, 3, -1, -1,
+        1, -1, -1, 4, -1, 0, 0, -1, 2, -1, -1, 2, 3, -1, -1, 2, -1, -1, 2, 0, 0,
+        0, -1, 1, 1, -1, -1, 1, -1, -1, 1, 3, 5, -1, -1, -1, 1, 1, -1, -1, 1,
+        -1, -1, 3, 3, 1, 0, -1, -1, 3, -1, -1, 1, 3, -1, -1, 3, -1, -1, 3, 1, 0,
+        -1, -1, 0, -1, -1, 3, 1, -1, -1, -1, 4, 4, 4, -1, 3, -1, 3, -1, -1, 3,
+        3, -1, 0, -1, -1, 1, -1, 2, -1, -1, 0, 0, 0, 0, -1, -1, 2, -1, -1, 2, 3,
+        -1, -1, 2, -1, -1, 3, 2, 3, -1, -1, 2, -1, -1, 3, 2, -1, -1, 3, -1, -1,
+        2, 1, 1, 1, 1, 1, -1, -1, 3, -1, -1, 0, 4, -1, -1, 0, -1, -1, 0, -1, 0,
+        1, -1, -1, 0, -1, -1, 3, 3, -1, 1, 1, -1, -1, -1, 0, 5, 0, -1, -1, 1,
+        -1, -1, 3, 0, -1, -1, -1, 4, -1, 1, 1, -1, 5, 2, -1, -1, -1, 3, -1, 3,
+        3, -1, -1, 0, -1, -1, 3, 3, 2, 4, 4, 4, -1, -1, 1, -1, -1, 2, 2, -1, -1,
+        1, -1, -1, 4, -1, 4, 1, -1, -1, 2, -1, -1, 3, -1, 4, 4, -1, 2, -1, -1,
+        2, 2, -1, -1, 0, -1, -1, 4, 4, 4, 4, 4, -1, -1, 2, -1, -1, 2, 3, -1, -1,
+        2, -1, -1, 2, 2, 5, -1, -1, 1, -1, -1, 1, 4, -1, -1, 5, -1, -1, 5, 5, 2,
+        -1, 4, -1, -1, 4, 0, -1, -1, 0, -1, -1, 2, 4, 5, -1, -1, 2, -1, -1, 1,
+        -1, -1, 2, 1, 2, 2, 2, 5, -1, -1, 0, -1, -1, 3, 4, -1, -1, 0, -1, -1, 0,
+        3, 2, -1, -1, 2, -1, -1, 2, 0, -1, -1, 0, -1, -1, 3, 4, 4, 4, -1, -1, 2,
+        -1, -1, 2, 2, -1, -1, 2, -1, -1, 3, 3, -1, 0, -1, -1, 4, 2, -1, -1, 2,
+        -1, -1, 1, -1, -1, 0, 1, 1, 1, 1, 1, -1, -1, 2, -1, -1, 2, 3, -1, -1, 3,
+        -1, -1, 2, 2, -1, -1, 2, 2, -1, -1, 2, -1, -1, 2, 2, 3, 3, -1, -1, -1,
+        1, 3, -1, -1, 2, -1, -1, 3, 5, 1, -1, -1, -1, 3, 1, -1, -1, 2, -1, -1,
+        4, 4, -1, 1, 1, -1, 0, -1, -1, 3, 3, -1, -1, 3, -1, -1, 1, 1, 1, -1, 2,
+        -1, -1, 2, 2, -1, -1, 3, -1, -1, 3, 3, -1, 0, -1, -1, 3, 5, -1, -1, -1,
+    };
+    model.threshold = {
+        235, 162, 174, 142, 105, 0.0, 49, 0.0, 0.0, 52, 14.999999, 0.0, 0.0, 88,
+        0.0, 0.0, 65, 49, 34, 0.0, 0.0, 52, 0.0, 0.0, 107, 26.9999981, 0.0, 0.0,
+        30.9999981, 0.0, 0.0, 142, 105, 90, 0.0, 123, 0.0, 0.0, 120, 63, 0.0,
+        0.0, 96, 0.0, 0.0, 68, 60, 45, 0.0, 0.0, 25.9999981, 0.0, 0.0, 76, 174,
+        0.0, 0.0, 140, 0.0, 0.0, 63, 49, 44, 34, 0.0, 108, 0.0, 0.0, 255, 57,
+        0.0, 0.0, 98, 0.0, 0.0, 255, 52, 110, 0.0, 0.0, 52, 0.0, 0.0, 15.999999,
+        101, 0.0, 0.0, 0.0, 95, 53, 25.9999981, 88, 0.0, 0.0, 50, 0.0, 0.0, 110,
+        90, 0.0, 0.0, 74, 0.0, 0.0, 126, 30.9999981, 25.9999981, 0.0, 0.0, 53,
+        0.0, 0.0, 110, 175, 0.0, 0.0, 162, 0.0, 0.0, 7.99999905, 101, 98, 97,
+        80, 0.0, 54, 0.0, 0.0, 25.9999981, 0.0, 71, 0.0, 0.0, 25.9999981, 35,
+        0.0, 38, 0.0, 0.0, 255, 38, 0.0, 0.0, 100, 0.0, 0.0, 49, 44, 15.999999,
+        42, 0.0, 0.0, 255, 0.0, 0.0, 255, 111, 0.0, 0.0, 108, 0.0, 0.0, 111,
+        235, 34, 0.0, 0.0, 103, 0.0, 0.0, 255, 95, 0.0, 0.0, 38, 0.0, 0.0,
+        26.9999981, 100, 97, 85, 0.0, 110, 0.0, 0.0, 174, 46, 0.0, 0.0, 99, 0.0,
+        0.0, 63, 53, 46, 0.0, 0.0, 15.999999, 0.0, 0.0, 104, 102, 0.0, 0.0, 57,
+        0.0, 0.0, 120, 0.0, 79, 52, 0.0, 34, 0.0, 0.0, 45, 101, 0.0, 0.0, 48,
+        0.0, 0.0, 7.99999905, 52, 41, 34, 0.0, 49, 34, 0.0, 0.0, 90, 0.0, 0.0,
+        43, 99, 51, 0.0, 0.0, 0.0, 67, 49, 0.0, 0.0, 78, 0.0, 0.0, 98, 88, 69,
+        57, 0.0, 0.0, 85, 0.0, 0.0, 52, 94, 0.0, 0.0, 97, 0.0, 0.0, 100, 46, 57,
+        0.0, 0.0, 144, 0.0, 0.0, 103, 40, 0.0, 0.0, 0.0, 142, 120, 90, 0.0, 85,
+        0.0, 109, 0.0, 0.0, 83, 78, 0.0, 49, 0.0, 0.0, 52, 0.0, 36, 0.0, 0.0,
+        123, 52, 49, 38, 0.0, 0.0, 15.999999, 0.0, 0.0, 26.9999981, 98, 0.0,
+        0.0, 52, 0.0, 0.0, 98, 52, 90, 0.0, 0.0, 63, 0.0, 0.0, 102, 61, 0.0,
+        0.0, 105, 0.0, 0.0, 7.99999905, 83, 78, 76, 69, 49, 0.0, 0.0, 72, 0.0,
+        0.0, 25.9999981, 255, 0.0, 0.0, 34, 0.0, 0.0, 34, 0.0, 44, 80, 0.0, 0.0,
+        57, 0.0, 0.0, 75, 72, 0.0, 110, 86, 0.0, 0.0, 0.0, 52, 85, 49, 0.0, 0.0,
+        93, 0.0, 0.0, 78, 63, 0.0, 0.0, 0.0, 174, 0.0, 74, 69, 0.0, 75, 34, 0.0,
+        0.0, 0.0, 47, 0.0, 70, 50, 0.0, 0.0, 63, 0.0, 0.0, 162, 14.999999, 99,
+        105, 79, 60, 0.0, 0.0, 38, 0.0, 0.0, 65, 58, 0.0, 0.0, 34, 0.0, 0.0, 60,
+        0.0, 235, 43, 0.0, 0.0, 122, 0.0, 0.0, 135, 0.0, 105, 79, 0.0, 63, 0.0,
+        0.0, 63, 58, 0.0, 0.0, 85, 0.0, 0.0, 142, 105, 90, 70, 51, 0.0, 0.0,
+        121, 0.0, 0.0, 56, 179, 0.0, 0.0, 170, 0.0, 0.0, 120, 56, 53, 0.0, 0.0,
+        49, 0.0, 0.0, 96, 120, 0.0, 0.0, 175, 0.0, 0.0, 68, 60, 45, 0.0, 255,
+        0.0, 0.0, 255, 38, 0.0, 0.0, 11.999999, 0.0, 0.0, 205, 255, 75, 0.0,
+        0.0, 118, 0.0, 0.0, 83, 0.0, 0.0, 255, 15.999999, 117, 99, 88, 75, 0.0,
+        0.0, 6.99999905, 0.0, 0.0, 14.999999, 255, 0.0, 0.0, 19.9999981, 0.0,
+        0.0, 29.9999981, 14.999999, 134, 0.0, 0.0, 134, 0.0, 0.0, 205, 52, 0.0,
+        0.0, 76, 0.0, 0.0, 14.999999, 235, 208, 142, 0.0, 0.0, 124, 0.0, 0.0,
+        107, 95, 0.0, 0.0, 123, 0.0, 0.0, 179, 162, 0.0, 52, 0.0, 0.0, 208, 109,
+        0.0, 0.0, 138, 0.0, 0.0, 124, 0.0, 0.0, 6.99999905, 114, 107, 100, 90,
+        76, 0.0, 0.0, 39, 0.0, 0.0, 58, 45, 0.0, 0.0, 30.9999981, 0.0, 0.0, 56,
+        42, 0.0, 0.0, 117, 74, 0.0, 0.0, 152, 0.0, 0.0, 69, 58, 53, 50, 0.0,
+        0.0, 0.0, 199, 45, 0.0, 0.0, 61, 0.0, 0.0, 25.9999981, 148, 116, 0.0,
+        0.0, 0.0, 30.9999981, 184, 0.0, 0.0, 88, 0.0, 0.0, 174, 142, 0.0, 100,
+        83, 0.0, 44, 0.0, 0.0, 50, 25.9999981, 0.0, 0.0, 53, 0.0, 0.0, 174, 100,
+        86, 0.0, 69, 0.0, 0.0, 76, 69, 0.0, 0.0, 30.9999981, 0.0, 0.0, 50,
+        25.9999981, 0.0, 66, 0.0, 0.0, 53, 209, 0.0, 0.0, 0.0,
+    };
+    model.yes = {
+        1, 2, 3, 4, 5, 5, 7, 7, 8, 10, 11, 11, 12, 14, 14, 15, 17, 18, 19, 19,
+        20, 22, 22, 23, 25, 26, 26, 27, 29, 29, 30, 32, 33, 34, 34, 36, 36, 37,
+        39, 40, 40, 41, 43, 43, 44, 46, 47, 48, 48, 49, 51, 51, 52, 54, 55, 55,
+        56, 58, 58, 59, 61, 62, 63, 64, 64, 66, 66, 67, 69, 70, 70, 71, 73, 73,
+        74, 76, 77, 78, 78, 79, 81, 81, 82, 84, 85, 85, 86, 87, 89, 90, 91, 92,
+        92, 93, 95, 95, 96, 98, 99, 99, 100, 102, 102, 103, 105, 106, 107, 107,
+        108, 110, 110, 111, 113, 114, 114, 115, 117, 117, 118, 120, 121, 122,
+        123, 124, 124, 126, 126, 127, 129, 129, 131, 131, 132, 134, 135, 135,
+        137, 137, 138, 140, 141, 141, 142, 144, 144, 145, 147, 148, 149, 150,
+        150, 151, 153, 153, 154, 156, 157, 157, 158, 160, 160, 161, 163, 164,
+        165, 165, 166, 168, 168, 169, 171, 172, 172, 173, 175, 175, 176, 178,
+        179, 180, 181, 181, 183, 183, 184, 186, 187, 187, 188, 190, 190, 191,
+        193, 194, 195, 195, 196, 198, 198, 199, 201, 202, 202, 203, 205, 205,
+        206, 208, 208, 210, 211, 211, 213, 213, 214, 216, 217, 217, 218, 220,
+        220, 221, 223, 224, 225, 226, 226, 228, 229, 229, 230, 232, 232, 233,
+        235, 236, 237, 237, 238, 239, 241, 242, 242, 243, 245, 245, 246, 248,
+        249, 250, 251, 251, 252, 254, 254, 255, 257, 258, 258, 259, 261, 261,
+        262, 264, 265, 266, 266, 267, 269, 269, 270, 272, 273, 273, 274, 275,
+        277, 278, 279, 279, 281, 281, 283, 283, 284, 286, 287, 287, 289, 289,
+        290, 292, 292, 294, 294, 295, 297, 298, 299, 300, 300, 301, 303, 303,
+        304, 306, 307, 307, 308, 310, 310, 311, 313, 314, 315, 315, 316, 318,
+        318, 319, 321, 322, 322, 323, 325, 325, 326, 328, 329, 330, 331, 332,
+        333, 333, 334, 336, 336, 337, 339, 340, 340, 341, 343, 343, 344, 346,
+        346, 348, 349, 349, 350, 352, 352, 353, 355, 356, 356, 358, 359, 359,
+        360, 361, 363, 364, 365, 365, 366, 368, 368, 369, 371, 372, 372, 373,
+        374, 376, 376, 378, 379, 379, 381, 382, 382, 383, 384, 386, 386, 388,
+        389, 389, 390, 392, 392, 393, 395, 396, 397, 398, 399, 400, 400, 401,
+        403, 403, 404, 406, 407, 407, 408, 410, 410, 411, 413, 413, 415, 416,
+        416, 417, 419, 419, 420, 422, 422, 424, 425, 425, 427, 427, 428, 430,
+        431, 431, 432, 434, 434, 435, 437, 438, 439, 440, 441, 441, 442, 444,
+        444, 445, 447, 448, 448, 449, 451, 451, 452, 454, 455, 456, 456, 457,
+        459, 459, 460, 462, 463, 463, 464, 466, 466, 467, 469, 470, 471, 471,
+        473, 473, 474, 476, 477, 477, 478, 480, 480, 481, 483, 484, 485, 485,
+        486, 488, 488, 489, 491, 491, 492, 494, 495, 496, 497, 498, 499, 499,
+        500, 502, 502, 503, 505, 506, 506, 507, 509, 509, 510, 512, 513, 514,
+        514, 515, 517, 517, 518, 520, 521, 521, 522, 524, 524, 525, 527, 528,
+        529, 530, 530, 531, 533, 533, 534, 536, 537, 537, 538, 540, 540, 541,
+        543, 544, 544, 546, 546, 547, 549, 550, 550, 551, 553, 553, 554, 556,
+        556, 557, 559, 560, 561, 562, 563, 564, 564, 565, 567, 567, 568, 570,
+        571, 571, 572, 574, 574, 575, 577, 578, 578, 579, 581, 582, 582, 583,
+        585, 585, 586, 588, 589, 590, 591, 591, 592, 593, 595, 596, 596, 597,
+        599, 599, 600, 602, 603, 604, 604, 605, 606, 608, 609, 609, 610, 612,
+        612, 613, 615, 616, 616, 618, 619, 619, 621, 621, 622, 624, 625, 625,
+        626, 628, 628, 629, 631, 632, 633, 633, 635, 635, 636, 638, 639, 639,
+        640, 642, 642, 643, 645, 646, 646, 648, 648, 649, 651, 652, 652, 653,
+        654,
+    };
+    model.no = {
+        60, 31, 16, 9, 6, 5, 8, 7, 8, 13, 12, 11, 12, 15, 14, 15, 24, 21, 20,
+        19, 20, 23, 22, 23, 28, 27, 26, 27, 30, 29, 30, 45, 38, 35, 34, 37, 36,
+        37, 42, 41, 40, 41, 44, 43, 44, 53, 50, 49, 48, 49, 52, 51, 52, 57, 56,
+        55, 56, 59, 58, 59, 88, 75, 68, 65, 64, 67, 66, 67, 72, 71, 70, 71, 74,
+        73, 74, 83, 80, 79, 78, 79, 82, 81, 82, 87, 86, 85, 86, 87, 104, 97, 94,
+        93, 92, 93, 96, 95, 96, 101, 100, 99, 100, 103, 102, 103, 112, 109, 108,
+        107, 108, 111, 110, 111, 116, 115, 114, 115, 118, 117, 118, 177, 146,
+        133, 128, 125, 124, 127, 126, 127, 130, 129, 132, 131, 132, 139, 136,
+        135, 138, 137, 138, 143, 142, 141, 142, 145, 144, 145, 162, 155, 152,
+        151, 150, 151, 154, 153, 154, 159, 158, 157, 158, 161, 160, 161, 170,
+        167, 166, 165, 166, 169, 168, 169, 174, 173, 172, 173, 176, 175, 176,
+        207, 192, 185, 182, 181, 184, 183, 184, 189, 188, 187, 188, 191, 190,
+        191, 200, 197, 196, 195, 196, 199, 198, 199, 204, 203, 202, 203, 206,
+        205, 206, 209, 208, 215, 212, 211, 214, 213, 214, 219, 218, 217, 218,
+        221, 220, 221, 276, 247, 234, 227, 226, 231, 230, 229, 230, 233, 232,
+        233, 240, 239, 238, 237, 238, 239, 244, 243, 242, 243, 246, 245, 246,
+        263, 256, 253, 252, 251, 252, 255, 254, 255, 260, 259, 258, 259, 262,
+        261, 262, 271, 268, 267, 266, 267, 270, 269, 270, 275, 274, 273, 274,
+        275, 296, 285, 280, 279, 282, 281, 284, 283, 284, 291, 288, 287, 290,
+        289, 290, 293, 292, 295, 294, 295, 312, 305, 302, 301, 300, 301, 304,
+        303, 304, 309, 308, 307, 308, 311, 310, 311, 320, 317, 316, 315, 316,
+        319, 318, 319, 324, 323, 322, 323, 326, 325, 326, 375, 354, 345, 338,
+        335, 334, 333, 334, 337, 336, 337, 342, 341, 340, 341, 344, 343, 344,
+        347, 346, 351, 350, 349, 350, 353, 352, 353, 362, 357, 356, 361, 360,
+        359, 360, 361, 370, 367, 366, 365, 366, 369, 368, 369, 374, 373, 372,
+        373, 374, 377, 376, 385, 380, 379, 384, 383, 382, 383, 384, 387, 386,
+        391, 390, 389, 390, 393, 392, 393, 436, 421, 412, 405, 402, 401, 400,
+        401, 404, 403, 404, 409, 408, 407, 408, 411, 410, 411, 414, 413, 418,
+        417, 416, 417, 420, 419, 420, 423, 422, 429, 426, 425, 428, 427, 428,
+        433, 432, 431, 432, 435, 434, 435, 468, 453, 446, 443, 442, 441, 442,
+        445, 444, 445, 450, 449, 448, 449, 452, 451, 452, 461, 458, 457, 456,
+        457, 460, 459, 460, 465, 464, 463, 464, 467, 466, 467, 482, 475, 472,
+        471, 474, 473, 474, 479, 478, 477, 478, 481, 480, 481, 490, 487, 486,
+        485, 486, 489, 488, 489, 492, 491, 492, 555, 526, 511, 504, 501, 500,
+        499, 500, 503, 502, 503, 508, 507, 506, 507, 510, 509, 510, 519, 516,
+        515, 514, 515, 518, 517, 518, 523, 522, 521, 522, 525, 524, 525, 542,
+        535, 532, 531, 530, 531, 534, 533, 534, 539, 538, 537, 538, 541, 540,
+        541, 548, 545, 544, 547, 546, 547, 552, 551, 550, 551, 554, 553, 554,
+        557, 556, 557, 614, 587, 576, 569, 566, 565, 564, 565, 568, 567, 568,
+        573, 572, 571, 572, 575, 574, 575, 580, 579, 578, 579, 584, 583, 582,
+        583, 586, 585, 586, 601, 594, 593, 592, 591, 592, 593, 598, 597, 596,
+        597, 600, 599, 600, 607, 606, 605, 604, 605, 606, 611, 610, 609, 610,
+        613, 612, 613, 630, 617, 616, 623, 620, 619, 622, 621, 622, 627, 626,
+        625, 626, 629, 628, 629, 644, 637, 634, 633, 636, 635, 636, 641, 640,
+        639, 640, 643, 642, 643, 650, 647, 646, 649, 648, 649, 654, 653, 652,
+        653, 654,
+    };
+    model.leaf_value = {
+        0.0, 0.0, 0.0, 0.0, 0.0, 3.49965096, 0.0, 3.49364305, 3.41167545, 0.0,
+        0.0, 2.96999526, 3.48441577, 0.0, 3.1216495, 2.70985818, 0.0, 0.0, 0.0,
+        3.49600673, 3.23305202, 0.0, 2.69915366, 0.555397391, 0.0, 0.0,
+        1.14262915, 2.69821239, 0.0, 2.4551394, -0.0444328077, 0.0, 0.0, 0.0,
+        3.49376702, 0.0, 3.09467435, 2.4704349, 0.0, 0.0, 3.32813144,
+        2.38624096, 0.0, 0.588173389, 3.02607226, 0.0, 0.0, 0.0, 3.47867155,
+        2.76842737, 0.0, 1.0138768, 1.70368755, 0.0, 0.0, 1.1192801,
+        -0.0809754729, 0.0, -0.475870162, -0.570258677, 0.0, 0.0, 0.0, 0.0,
+        3.49532294, 0.0, 3.09685159, 3.41303158, 0.0, 0.0, 3.24041843,
+        0.834196866, 0.0, 2.5269773, 1.4237287, 0.0, 0.0, 0.0, 2.31758833,
+        3.06643057, 0.0, 1.35820889, 0.560887218, 0.0, 0.0, 0.437563419,
+        -0.23007144, 3.15622067, 0.0, 0.0, 0.0, 0.0, 2.81752968, 0.995222569,
+        0.0, 3.44812655, 1.97062409, 0.0, 0.0, 0.051456105, -0.41882062, 0.0,
+        0.869058073, -0.277825862, 0.0, 0.0, 0.0, -0.152445823, 2.59523726, 0.0,
+        -0.119218998, -0.458424926, 0.0, 0.0, -0.514339745, -0.575347364, 0.0,
+        2.02335119, -0.2989209, 0.0, 0.0, 0.0, 0.0, 0.0, -0.583028257, 0.0,
+        -0.479809195, -0.575630486, 0.0, -0.571368754, 0.0, 0.069733724,
+        -0.413224608, 0.0, 0.0, -0.558419049, 0.0, -0.225305215, 0.386740297,
+        0.0, 0.0, 1.38761961, -0.277484566, 0.0, 0.69740057, 2.02082992, 0.0,
+        0.0, 0.0, 0.0, -0.563308954, -0.403332174, 0.0, -0.454940557,
+        -0.206361532, 0.0, 0.0, -0.0240446702, -0.529157639, 0.0, 2.15808439,
+        0.324402571, 0.0, 0.0, 0.0, 0.302158237, 0.877837777, 0.0, 2.81947494,
+        3.43537307, 0.0, 0.0, 0.406122655, 2.59978127, 0.0, 2.66980958,
+        -0.0580912977, 0.0, 0.0, 0.0, 0.0, -0.582423627, 0.0, -0.550281823,
+        -0.582885921, 0.0, 0.0, -0.553426743, -0.395178527, 0.0, -0.350989312,
+        -0.0736423209, 0.0, 0.0, 0.0, -0.566625118, -0.413343191, 0.0,
+        0.570592165, -0.097211346, 0.0, 0.0, -1.72251937e-08, 0.427686363, 0.0,
+        0.79704535, 2.6449163, 0.0, -0.583249569, 0.0, 0.0, -0.583132505, 0.0,
+        -0.501312256, -0.57755363, 0.0, 0.0, -0.484455675, 0.0863112733, 0.0,
+        -0.447875619, -0.5802145, 0.0, 0.0, 0.0, 0.0, -0.582904458, 0.0, 0.0,
+        -0.578565776, -0.503978372, 0.0, -0.29376626, -0.572360814, 0.0, 0.0,
+        0.0, -0.444169521, 0.135396495, -0.57512027, 0.0, 0.0, -0.0416611694,
+        0.957309604, 0.0, -0.105197258, -0.535721838, 0.0, 0.0, 0.0, 0.0,
+        1.95989192, 3.02786827, 0.0, -0.138768166, 0.814298272, 0.0, 0.0,
+        1.41559005, 0.0769772828, 0.0, 3.37971115, 1.83684635, 0.0, 0.0, 0.0,
+        -0.476871312, -0.270187914, 0.0, 0.189018875, 1.55017292, 0.0, 0.0,
+        -0.557806432, -0.424058855, -0.580755353, 0.0, 0.0, 0.0, -0.583276153,
+        0.0, -0.58216846, 0.0, -0.559930027, -0.580305815, 0.0, 0.0,
+        -0.582258523, 0.0, -0.577616274, -0.521125019, 0.0, -0.570540428, 0.0,
+        -0.35800609, -0.520168126, 0.0, 0.0, 0.0, 0.0, -0.583081782,
+        -0.562027454, 0.0, 0.139829457, -0.54536581, 0.0, 0.0, 1.88858771,
+        -0.392981976, 0.0, -0.236407369, -0.581757188, 0.0, 0.0, 0.0,
+        1.39562714, 3.39506865, 0.0, 0.962764621, -0.551758528, 0.0, 0.0,
+        0.741721809, -0.552026272, 0.0, -0.281879187, -0.56752491, 0.0, 0.0,
+        0.0, 0.0, 0.0, 0.0, -0.583323061, -0.571019292, 0.0, 2.7713151,
+        -0.580906689, 0.0, 0.0, 1.02752292, 3.25343084, 0.0, 0.736842096,
+        -0.580666244, 0.0, 3.43496799, 0.0, 0.0, -0.0482758731, 0.818867862,
+        0.0, -0.413422823, -0.581726134, 0.0, 0.0, 3.49734855, 0.0, 0.0,
+        0.0725388452, 1.03039992, 2.74890494, 0.0, 0.0, 0.0, 0.0725388452,
+        -0.32110092, 0.0, 0.509090841, -0.0482758731, 0.0, 0.0, -1.58442717e-08,
+        -0.465960652, -0.583253145, 0.0, -0.583274901, 0.0, 0.0, -0.583043575,
+        0.0, 0.0, -0.29402262, -0.580232143, -0.582604229, 0.0, -0.583050609,
+        0.0, 0.0, -0.216718271, 2.61570215, 0.0, 0.0674698576, -0.583110809,
+        0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.581845701, -0.55707258, 0.0,
+        -0.565022409, -0.475270599, 0.0, 0.0, -0.561189353, -0.32302475, 0.0,
+        0.777689636, -0.359524727, 0.0, -0.583047748, 0.0, 0.0, 0.639188945,
+        -0.46041733, 0.0, -0.427367061, -0.58126384, 0.0, -0.58323133, 0.0, 0.0,
+        -0.582764387, 0.0, -0.560567677, -0.467271537, 0.0, 0.0, -0.572015941,
+        -0.32041502, 0.0, 0.307317048, -0.26087296, 0.0, 0.0, 0.0, 0.0, 0.0,
+        -0.582525909, -0.552538097, 0.0, -0.469915211, -0.24839291, 0.0, 0.0,
+        -0.537486434, -0.0891719833, 0.0, 0.175947756, -0.553213894, 0.0, 0.0,
+        0.0, -0.568507552, -0.10918545, 0.0, 0.649709463, 0.00424112147, 0.0,
+        0.0, 1.38557315, 2.61398745, 0.0, 0.627586186, -0.467520565, 0.0, 0.0,
+        0.0, -0.582127929, 0.0, 0.133897349, -0.29594627, 0.0, 0.0, 1.49983335,
+        0.702241123, 0.0, -0.351387054, 0.170463443, 0.0, 0.0, 0.0, 2.69825196,
+        3.44270968, 0.0, 2.96554828, 1.39206886, 0.0, -0.571718812,
+        -1.09798028e-08, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.583057165,
+        -0.528164625, 0.0, 0.62627399, -0.568279922, 0.0, 0.0, 1.11401415,
+        2.70367098, 0.0, -0.171295032, -0.568281472, 0.0, 0.0, 0.0, 3.32189608,
+        3.48750615, 0.0, 0.599840522, 3.07803154, 0.0, 0.0, 0.262087733,
+        -0.553426743, 0.0, 3.19918132, 0.12844035, 0.0, 0.0, 0.0, 0.0,
+        -0.582763851, -0.421477467, 0.0, -0.455087185, 1.71768963, 0.0, 0.0,
+        -0.540513992, 0.539451838, 0.0, 1.88332105, 3.2983849, 0.0, 0.0,
+        -0.583289564, 0.0, -0.546771884, -0.581627667, 0.0, 0.0, -0.552145541,
+        -0.302647561, 0.0, 0.392931372, 3.00859594, 0.0, 3.49952722,
+        -0.58276552, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.583305895, -0.554143667,
+        0.0, -0.582802236, -0.25685364, 0.0, 0.0, -0.0482758731, -0.58244586,
+        0.0, -0.424164057, 1.60830784, 0.0, 0.0, -0.582342923, 0.22292991, 0.0,
+        0.0, 0.797468305, 2.80943274, 0.0, 0.0572987534, -0.575960755, 0.0, 0.0,
+        0.0, 0.0, 0.0314606577, -0.353238016, -0.583139479, 0.0, 0.0,
+        -0.0580912977, 1.55867589, 0.0, 0.0341463275, -0.443902433, 0.0, 0.0,
+        0.0, 0.867768586, -0.124260366, -0.561273813, 0.0, 0.0, 1.85029113,
+        3.15997052, 0.0, 2.14621687, 3.46757841, 0.0, 0.0, -0.583255887, 0.0,
+        0.0, -0.583218396, 0.0, -0.458729357, -0.579729676, 0.0, 0.0,
+        -0.50783515, 0.0893083885, 0.0, -0.363369256, -0.580881655, 0.0, 0.0,
+        0.0, -0.583236635, 0.0, -0.582888365, -0.303189248, 0.0, 0.0,
+        -0.583149612, 0.20121026, 0.0, 0.0646153614, 2.51127076, 0.0, 0.0,
+        -0.528046429, 0.0, 3.01119328, 0.615384579, 0.0, 0.0, 0.745562077,
+        -0.443902433, -0.580626845,
+    };
+
+    return model;
+}
+}  // namespace trifinger_object_tracking
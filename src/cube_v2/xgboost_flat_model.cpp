@@ -0,0 +1,303 @@
+// Generated by xgb_dump_to_flat_cpp.py from xgb_model_dump.txt.
+// Do not edit manually!
+#include <trifinger_object_tracking/xgboost_batch_classifier.hpp>
+
+namespace trifinger_object_tracking
+{
+XGBoostFlatModel get_compiled_xgb_flat_model()
+{
+    XGBoostFlatModel model;
+    model.num_classes = 7;
+    model.num_features = 6;
+    model.tree_roots = {
+        0, 115, 234, 331, 410, 469, 576,
+    };
+    model.tree_classes = {
+        0, 1, 2, 3, 4, 5, 6,
+    };
+    model.tree_depths = {
+        6, 6, 6, 6, 6, 6, 6,
+    };
+    model.feature = {
+        4, 4, 4, 4, -1, 3, -1, 1, -1, -1, 0, 3, 3, -1, -1, 0, -1, -1, 3, 2, -1,
+        -1, 3, -1, -1, 0, 3, 0, 3, -1, -1, 3, -1, -1, 2, 1, -1, -1, 3, -1, -1,
+        3, 5, -1, -1, 3, 3, -1, -1, 3, -1, -1, 5, 3, 3, 5, 3, -1, -1, 1, -1, -1,
+        1, 4, -1, -1, 5, -1, -1, 3, 4, 3, -1, -1, 0, -1, -1, 5, 3, -1, -1, 2,
+        -1, -1, 5, 3, 1, 4, -1, -1, 1, -1, -1, 4, 3, -1, -1, 4, -1, -1, 3, 3, 4,
+        -1, -1, 2, -1, -1, 4, 3, -1, -1, 4, -1, -1, 2, 0, 3, 3, 3, -1, 5, -1,
+        -1, 1, 1, -1, -1, -1, 3, 3, 5, -1, -1, 0, -1, -1, 3, 4, -1, -1, 3, -1,
+        -1, 4, 5, 3, 5, -1, -1, 3, -1, -1, 1, 1, -1, -1, -1, 0, 3, 1, -1, -1, 4,
+        -1, -1, 3, 0, -1, -1, 0, -1, -1, 2, 0, 0, 3, -1, 3, -1, -1, 2, 1, -1,
+        -1, 3, -1, -1, 3, 3, 3, -1, -1, 2, -1, -1, 1, 0, -1, -1, 4, -1, -1, 4,
+        4, 4, 5, -1, -1, 3, -1, -1, 3, 3, -1, -1, 3, -1, -1, 3, 3, 3, -1, -1, 2,
+        -1, -1, 3, 4, -1, -1, 3, -1, -1, 4, 4, 4, -1, 0, 0, -1, 2, -1, -1, 2, 1,
+        -1, -1, 3, -1, -1, 1, 1, 1, 1, -1, -1, 2, -1, -1, 2, 0, -1, -1, 2, -1,
+        -1, 2, 3, 3, -1, -1, 3, -1, -1, 3, 3, -1, -1, 3, -1, -1, 0, 0, 0, 0, -1,
+        2, -1, -1, 2, 1, -1, -1, -1, 4, 2, 1, -1, -1, 2, -1, -1, 2, 1, -1, -1,
+        -1, 3, 3, 3, 3, -1, -1, 0, -1, -1, 1, 5, -1, -1, 3, -1, -1, 3, 0, -1, 0,
+        -1, -1, -1, 4, 4, 4, -1, 1, -1, 0, 3, -1, -1, 3, -1, -1, 1, -1, 3, 3, 3,
+        -1, -1, 0, -1, -1, -1, 1, 1, 1, 1, -1, 2, -1, -1, 2, 0, -1, -1, -1, 0,
+        3, -1, 3, -1, -1, 0, 3, -1, -1, 0, -1, -1, 3, 3, 5, 0, -1, -1, 4, -1,
+        -1, 5, 1, -1, -1, 0, -1, -1, 3, 3, 4, -1, -1, 3, -1, -1, 0, 3, -1, -1,
+        -1, 3, -1, 4, 4, 4, 4, -1, -1, 0, -1, 3, -1, -1, 0, 0, 0, -1, -1, 2, -1,
+        -1, 3, 4, -1, -1, 2, -1, -1, 0, 2, 2, 2, -1, -1, 3, -1, -1, 3, 1, -1,
+        -1, 4, -1, -1, 3, 2, 4, -1, -1, 4, -1, -1, 4, 4, -1, -1, 2, -1, -1, 4,
+        4, 4, 4, -1, 3, 1, -1, -1, 3, -1, -1, 3, 2, 5, -1, -1, 1, -1, -1, 3, 5,
+        -1, -1, 3, -1, -1, 3, 5, 2, 1, -1, -1, 0, -1, -1, 5, 1, -1, -1, 5, -1,
+        -1, 3, 2, 2, -1, -1, 1, -1, -1, 3, 1, -1, -1, -1, 2, 2, 2, 2, -1, 1, -1,
+        -1, 1, 3, -1, -1, 1, -1, -1, 1, 3, 4, -1, -1, 2, -1, -1, 1, 2, -1, -1,
+        3, -1, -1, 3, 3, 2, 4, -1, -1, -1, 5, 1, -1, -1, 1, -1, -1, 1, 2, -1, 4,
+        -1, -1, -1, 4, 4, 4, -1, 2, 3, 1, -1, -1, 3, -1, -1, 1, 0, -1, -1, 0,
+        -1, -1, 2, 3, 1, 1, -1, -1, 0, -1, -1, 3, 5, -1, -1, 3, -1, -1, 1, 1, 0,
+        -1, -1, 0, -1, -1, 1, 0, -1, -1, 0, -1, -1, 1, 1, 1, 1, -1, 5, -1, -1,
+        3, -1, 2, -1, -1, 3, 3, 1, -1, -1, 4, -1, -1, 3, 1, -1, -1, -1, 3, 3, 1,
+        2, -1, -1, 0, -1, -1, 2, 1, -1, -1, 3, -1, -1, 3, 2, 0, -1, -1, 0, -1,
+        -1, -1,
+    };
+    model.threshold = {
+        89, 77, 65, 56, 0.0, 86, 0.0, 107, 0.0, 0.0, 100, 131, 100, 0.0, 0.0,
+        73, 0.0, 0.0, 81, 94, 0.0, 0.0, 131, 0.0, 0.0, 86, 103, 71, 98, 0.0,
+        0.0, 35, 0.0, 0.0, 63, 42, 0.0, 0.0, 165, 0.0, 0.0, 68, 121, 0.0, 0.0,
+        131, 98, 0.0, 0.0, 165, 0.0, 0.0, 73, 91, 81, 68, 77, 0.0, 0.0,
+        30.9999981, 0.0, 0.0, 30.9999981, 166, 0.0, 0.0, 71, 0.0, 0.0, 113, 139,
+        103, 0.0, 0.0, 21.9999981, 0.0, 0.0, 62, 115, 0.0, 0.0, 56, 0.0, 0.0,
+        83, 38, 33, 255, 0.0, 0.0, 38, 0.0, 0.0, 115, 131, 0.0, 0.0, 139, 0.0,
+        0.0, 24.9999981, 12.999999, 139, 0.0, 0.0, 123, 0.0, 0.0, 103, 75, 0.0,
+        0.0, 139, 0.0, 0.0, 14.999999, 21.9999981, 77, 75, 68, 0.0, 27.9999981,
+        0.0, 0.0, 33, 30.9999981, 0.0, 0.0, 0.0, 98, 81, 27.9999981, 0.0, 0.0,
+        12.999999, 0.0, 0.0, 105, 255, 0.0, 0.0, 109, 0.0, 0.0, 186, 45, 86,
+        27.9999981, 0.0, 0.0, 108, 0.0, 0.0, 42, 25.9999981, 0.0, 0.0, 0.0, 35,
+        110, 33, 0.0, 0.0, 255, 0.0, 0.0, 115, 46, 0.0, 0.0, 46, 0.0, 0.0,
+        26.9999981, 46, 35, 75, 0.0, 123, 0.0, 0.0, 21.9999981, 38, 0.0, 0.0,
+        120, 0.0, 0.0, 100, 98, 91, 0.0, 0.0, 21.9999981, 0.0, 0.0, 25.9999981,
+        56, 0.0, 0.0, 139, 0.0, 0.0, 89, 65, 56, 27.9999981, 0.0, 0.0, 100, 0.0,
+        0.0, 98, 81, 0.0, 0.0, 124, 0.0, 0.0, 100, 98, 91, 0.0, 0.0, 36, 0.0,
+        0.0, 120, 115, 0.0, 0.0, 126, 0.0, 0.0, 89, 65, 57, 0.0, 100, 75, 0.0,
+        87, 0.0, 0.0, 98, 122, 0.0, 0.0, 86, 0.0, 0.0, 104, 94, 79, 74, 0.0,
+        0.0, 56, 0.0, 0.0, 70, 92, 0.0, 0.0, 83, 0.0, 0.0, 98, 81, 65, 0.0, 0.0,
+        98, 0.0, 0.0, 70, 65, 0.0, 0.0, 98, 0.0, 0.0, 92, 63, 61, 56, 0.0, 53,
+        0.0, 0.0, 94, 68, 0.0, 0.0, 0.0, 139, 63, 76, 0.0, 0.0, 68, 0.0, 0.0,
+        53, 68, 0.0, 0.0, 0.0, 98, 70, 65, 61, 0.0, 0.0, 96, 0.0, 0.0, 91, 93,
+        0.0, 0.0, 77, 0.0, 0.0, 103, 106, 0.0, 132, 0.0, 0.0, 0.0, 115, 103, 77,
+        0.0, 110, 0.0, 83, 35, 0.0, 0.0, 51, 0.0, 0.0, 104, 0.0, 60, 38, 35,
+        0.0, 0.0, 103, 0.0, 0.0, 0.0, 87, 72, 68, 57, 0.0, 43, 0.0, 0.0, 53,
+        21.9999981, 0.0, 0.0, 0.0, 21.9999981, 35, 0.0, 38, 0.0, 0.0,
+        29.9999981, 38, 0.0, 0.0, 35, 0.0, 0.0, 35, 29.9999981, 93, 35, 0.0,
+        0.0, 139, 0.0, 0.0, 107, 101, 0.0, 0.0, 49, 0.0, 0.0, 60, 38, 139, 0.0,
+        0.0, 56, 0.0, 0.0, 61, 68, 0.0, 0.0, 0.0, 131, 0.0, 65, 52, 42,
+        28.9999981, 0.0, 0.0, 73, 0.0, 165, 0.0, 0.0, 86, 71, 67, 0.0, 0.0, 94,
+        0.0, 0.0, 165, 57, 0.0, 0.0, 132, 0.0, 0.0, 61, 60, 56, 53, 0.0, 0.0,
+        150, 0.0, 0.0, 165, 46, 0.0, 0.0, 77, 0.0, 0.0, 165, 60, 103, 0.0, 0.0,
+        77, 0.0, 0.0, 89, 77, 0.0, 0.0, 151, 0.0, 0.0, 238, 209, 139, 115, 0.0,
+        12.999999, 57, 0.0, 0.0, 15.999999, 0.0, 0.0, 12.999999, 94, 75, 0.0,
+        0.0, 82, 0.0, 0.0, 15.999999, 75, 0.0, 0.0, 17.9999981, 0.0, 0.0,
+        12.999999, 93, 70, 33, 0.0, 0.0, 8.99999905, 0.0, 0.0, 100, 46, 0.0,
+        0.0, 121, 0.0, 0.0, 15.999999, 90, 76, 0.0, 0.0, 49, 0.0, 0.0,
+        17.9999981, 82, 0.0, 0.0, 0.0, 83, 72, 68, 60, 0.0, 33, 0.0, 0.0,
+        30.9999981, 9.99999905, 0.0, 0.0, 33, 0.0, 0.0, 33, 12.999999, 255, 0.0,
+        0.0, 74, 0.0, 0.0, 38, 78, 0.0, 0.0, 15.999999, 0.0, 0.0, 15.999999,
+        12.999999, 87, 255, 0.0, 0.0, 0.0, 93, 42, 0.0, 0.0, 52, 0.0, 0.0, 57,
+        90, 0.0, 255, 0.0, 0.0, 0.0, 139, 115, 89, 0.0, 180, 38, 104, 0.0, 0.0,
+        41, 0.0, 0.0, 177, 110, 0.0, 0.0, 115, 0.0, 0.0, 180, 29.9999981, 114,
+        94, 0.0, 0.0, 83, 0.0, 0.0, 35, 83, 0.0, 0.0, 38, 0.0, 0.0, 177, 167,
+        92, 0.0, 0.0, 96, 0.0, 0.0, 189, 96, 0.0, 0.0, 127, 0.0, 0.0, 97, 77,
+        68, 57, 0.0, 90, 0.0, 0.0, 20.9999981, 0.0, 63, 0.0, 0.0, 35,
+        24.9999981, 94, 0.0, 0.0, 166, 0.0, 0.0, 38, 85, 0.0, 0.0, 0.0, 35,
+        17.9999981, 133, 140, 0.0, 0.0, 78, 0.0, 0.0, 101, 104, 0.0, 0.0,
+        20.9999981, 0.0, 0.0, 38, 133, 42, 0.0, 0.0, 69, 0.0, 0.0, 0.0,
+    };
+    model.yes = {
+        1, 2, 3, 4, 4, 6, 6, 8, 8, 9, 11, 12, 13, 13, 14, 16, 16, 17, 19, 20,
+        20, 21, 23, 23, 24, 26, 27, 28, 29, 29, 30, 32, 32, 33, 35, 36, 36, 37,
+        39, 39, 40, 42, 43, 43, 44, 46, 47, 47, 48, 50, 50, 51, 53, 54, 55, 56,
+        57, 57, 58, 60, 60, 61, 63, 64, 64, 65, 67, 67, 68, 70, 71, 72, 72, 73,
+        75, 75, 76, 78, 79, 79, 80, 82, 82, 83, 85, 86, 87, 88, 88, 89, 91, 91,
+        92, 94, 95, 95, 96, 98, 98, 99, 101, 102, 103, 103, 104, 106, 106, 107,
+        109, 110, 110, 111, 113, 113, 114, 116, 117, 118, 119, 120, 120, 122,
+        122, 123, 125, 126, 126, 127, 128, 130, 131, 132, 132, 133, 135, 135,
+        136, 138, 139, 139, 140, 142, 142, 143, 145, 146, 147, 148, 148, 149,
+        151, 151, 152, 154, 155, 155, 156, 157, 159, 160, 161, 161, 162, 164,
+        164, 165, 167, 168, 168, 169, 171, 171, 172, 174, 175, 176, 177, 177,
+        179, 179, 180, 182, 183, 183, 184, 186, 186, 187, 189, 190, 191, 191,
+        192, 194, 194, 195, 197, 198, 198, 199, 201, 201, 202, 204, 205, 206,
+        207, 207, 208, 210, 210, 211, 213, 214, 214, 215, 217, 217, 218, 220,
+        221, 222, 222, 223, 225, 225, 226, 228, 229, 229, 230, 232, 232, 233,
+        235, 236, 237, 237, 239, 240, 240, 242, 242, 243, 245, 246, 246, 247,
+        249, 249, 250, 252, 253, 254, 255, 255, 256, 258, 258, 259, 261, 262,
+        262, 263, 265, 265, 266, 268, 269, 270, 270, 271, 273, 273, 274, 276,
+        277, 277, 278, 280, 280, 281, 283, 284, 285, 286, 286, 288, 288, 289,
+        291, 292, 292, 293, 294, 296, 297, 298, 298, 299, 301, 301, 302, 304,
+        305, 305, 306, 307, 309, 310, 311, 312, 312, 313, 315, 315, 316, 318,
+        319, 319, 320, 322, 322, 323, 325, 326, 326, 328, 328, 329, 330, 332,
+        333, 334, 334, 336, 336, 338, 339, 339, 340, 342, 342, 343, 345, 345,
+        347, 348, 349, 349, 350, 352, 352, 353, 354, 356, 357, 358, 359, 359,
+        361, 361, 362, 364, 365, 365, 366, 367, 369, 370, 370, 372, 372, 373,
+        375, 376, 376, 377, 379, 379, 380, 382, 383, 384, 385, 385, 386, 388,
+        388, 389, 391, 392, 392, 393, 395, 395, 396, 398, 399, 400, 400, 401,
+        403, 403, 404, 406, 407, 407, 408, 409, 411, 411, 413, 414, 415, 416,
+        416, 417, 419, 419, 421, 421, 422, 424, 425, 426, 426, 427, 429, 429,
+        430, 432, 433, 433, 434, 436, 436, 437, 439, 440, 441, 442, 442, 443,
+        445, 445, 446, 448, 449, 449, 450, 452, 452, 453, 455, 456, 457, 457,
+        458, 460, 460, 461, 463, 464, 464, 465, 467, 467, 468, 470, 471, 472,
+        473, 473, 475, 476, 476, 477, 479, 479, 480, 482, 483, 484, 484, 485,
+        487, 487, 488, 490, 491, 491, 492, 494, 494, 495, 497, 498, 499, 500,
+        500, 501, 503, 503, 504, 506, 507, 507, 508, 510, 510, 511, 513, 514,
+        515, 515, 516, 518, 518, 519, 521, 522, 522, 523, 524, 526, 527, 528,
+        529, 529, 531, 531, 532, 534, 535, 535, 536, 538, 538, 539, 541, 542,
+        543, 543, 544, 546, 546, 547, 549, 550, 550, 551, 553, 553, 554, 556,
+        557, 558, 559, 559, 560, 561, 563, 564, 564, 565, 567, 567, 568, 570,
+        571, 571, 573, 573, 574, 575, 577, 578, 579, 579, 581, 582, 583, 583,
+        584, 586, 586, 587, 589, 590, 590, 591, 593, 593, 594, 596, 597, 598,
+        599, 599, 600, 602, 602, 603, 605, 606, 606, 607, 609, 609, 610, 612,
+        613, 614, 614, 615, 617, 617, 618, 620, 621, 621, 622, 624, 624, 625,
+        627, 628, 629, 630, 630, 632, 632, 633, 635, 635, 637, 637, 638, 640,
+        641, 642, 642, 643, 645, 645, 646, 648, 649, 649, 650, 651, 653, 654,
+        655, 656, 656, 657, 659, 659, 660, 662, 663, 663, 664, 666, 666, 667,
+        669, 670, 671, 671, 672, 674, 674, 675, 676,
+    };
+    model.no = {
+        52, 25, 10, 5, 4, 7, 6, 9, 8, 9, 18, 15, 14, 13, 14, 17, 16, 17, 22, 21,
+        20, 21, 24, 23, 24, 41, 34, 31, 30, 29, 30, 33, 32, 33, 38, 37, 36, 37,
+        40, 39, 40, 45, 44, 43, 44, 49, 48, 47, 48, 51, 50, 51, 84, 69, 62, 59,
+        58, 57, 58, 61, 60, 61, 66, 65, 64, 65, 68, 67, 68, 77, 74, 73, 72, 73,
+        76, 75, 76, 81, 80, 79, 80, 83, 82, 83, 100, 93, 90, 89, 88, 89, 92, 91,
+        92, 97, 96, 95, 96, 99, 98, 99, 108, 105, 104, 103, 104, 107, 106, 107,
+        112, 111, 110, 111, 114, 113, 114, 173, 144, 129, 124, 121, 120, 123,
+        122, 123, 128, 127, 126, 127, 128, 137, 134, 133, 132, 133, 136, 135,
+        136, 141, 140, 139, 140, 143, 142, 143, 158, 153, 150, 149, 148, 149,
+        152, 151, 152, 157, 156, 155, 156, 157, 166, 163, 162, 161, 162, 165,
+        164, 165, 170, 169, 168, 169, 172, 171, 172, 203, 188, 181, 178, 177,
+        180, 179, 180, 185, 184, 183, 184, 187, 186, 187, 196, 193, 192, 191,
+        192, 195, 194, 195, 200, 199, 198, 199, 202, 201, 202, 219, 212, 209,
+        208, 207, 208, 211, 210, 211, 216, 215, 214, 215, 218, 217, 218, 227,
+        224, 223, 222, 223, 226, 225, 226, 231, 230, 229, 230, 233, 232, 233,
+        282, 251, 238, 237, 244, 241, 240, 243, 242, 243, 248, 247, 246, 247,
+        250, 249, 250, 267, 260, 257, 256, 255, 256, 259, 258, 259, 264, 263,
+        262, 263, 266, 265, 266, 275, 272, 271, 270, 271, 274, 273, 274, 279,
+        278, 277, 278, 281, 280, 281, 308, 295, 290, 287, 286, 289, 288, 289,
+        294, 293, 292, 293, 294, 303, 300, 299, 298, 299, 302, 301, 302, 307,
+        306, 305, 306, 307, 324, 317, 314, 313, 312, 313, 316, 315, 316, 321,
+        320, 319, 320, 323, 322, 323, 330, 327, 326, 329, 328, 329, 330, 355,
+        344, 335, 334, 337, 336, 341, 340, 339, 340, 343, 342, 343, 346, 345,
+        354, 351, 350, 349, 350, 353, 352, 353, 354, 381, 368, 363, 360, 359,
+        362, 361, 362, 367, 366, 365, 366, 367, 374, 371, 370, 373, 372, 373,
+        378, 377, 376, 377, 380, 379, 380, 397, 390, 387, 386, 385, 386, 389,
+        388, 389, 394, 393, 392, 393, 396, 395, 396, 405, 402, 401, 400, 401,
+        404, 403, 404, 409, 408, 407, 408, 409, 412, 411, 438, 423, 418, 417,
+        416, 417, 420, 419, 422, 421, 422, 431, 428, 427, 426, 427, 430, 429,
+        430, 435, 434, 433, 434, 437, 436, 437, 454, 447, 444, 443, 442, 443,
+        446, 445, 446, 451, 450, 449, 450, 453, 452, 453, 462, 459, 458, 457,
+        458, 461, 460, 461, 466, 465, 464, 465, 468, 467, 468, 525, 496, 481,
+        474, 473, 478, 477, 476, 477, 480, 479, 480, 489, 486, 485, 484, 485,
+        488, 487, 488, 493, 492, 491, 492, 495, 494, 495, 512, 505, 502, 501,
+        500, 501, 504, 503, 504, 509, 508, 507, 508, 511, 510, 511, 520, 517,
+        516, 515, 516, 519, 518, 519, 524, 523, 522, 523, 524, 555, 540, 533,
+        530, 529, 532, 531, 532, 537, 536, 535, 536, 539, 538, 539, 548, 545,
+        544, 543, 544, 547, 546, 547, 552, 551, 550, 551, 554, 553, 554, 569,
+        562, 561, 560, 559, 560, 561, 566, 565, 564, 565, 568, 567, 568, 575,
+        572, 571, 574, 573, 574, 575, 626, 595, 580, 579, 588, 585, 584, 583,
+        584, 587, 586, 587, 592, 591, 590, 591, 594, 593, 594, 611, 604, 601,
+        600, 599, 600, 603, 602, 603, 608, 607, 606, 607, 610, 609, 610, 619,
+        616, 615, 614, 615, 618, 617, 618, 623, 622, 621, 622, 625, 624, 625,
+        652, 639, 634, 631, 630, 633, 632, 633, 636, 635, 638, 637, 638, 647,
+        644, 643, 642, 643, 646, 645, 646, 651, 650, 649, 650, 651, 668, 661,
+        658, 657, 656, 657, 660, 659, 660, 665, 664, 663, 664, 667, 666, 667,
+        676, 673, 672, 671, 672, 675, 674, 675, 676,
+    };
+    model.leaf_value = {
+        0.0, 0.0, 0.0, 0.0, 3.49960184, 0.0, 3.4959147, 0.0, 3.32815909,
+        2.69475603, 0.0, 0.0, 0.0, 3.4926405, 3.22867203, 0.0, 3.33794546,
+        0.389211565, 0.0, 0.0, 2.40142345, 3.46214771, 0.0, 1.86348915,
+        -0.140684754, 0.0, 0.0, 0.0, 0.0, 3.49614906, 3.04971099, 0.0,
+        3.43287659, 3.16379547, 0.0, 0.0, 3.37774253, 2.55345678, 0.0,
+        -0.361031502, 2.56575871, 0.0, 0.0, 0.867768586, 3.42946339, 0.0, 0.0,
+        0.225463316, 2.68123388, 0.0, -0.563750505, 1.28096116, 0.0, 0.0, 0.0,
+        0.0, 0.0, 3.49779344, 3.28236723, 0.0, 0.715658247, 3.29014397, 0.0,
+        0.0, 2.19953489, -0.0987451971, 0.0, 3.1298697, 1.53734279, 0.0, 0.0,
+        0.0, 2.82586432, 0.426091373, 0.0, 3.05988002, -0.318359137, 0.0, 0.0,
+        2.54308724, 3.44986153, 0.0, 1.11481011, -0.451112747, 0.0, 0.0, 0.0,
+        0.0, 1.71912479, 0.0900175124, 0.0, 2.02720094, 3.29135895, 0.0, 0.0,
+        2.60763144, -0.445486993, 0.0, 0.225672752, -0.563145697, 0.0, 0.0, 0.0,
+        2.25513983, -0.493417442, 0.0, 2.42387414, 0.325648218, 0.0, 0.0,
+        3.10674024, -0.401397794, 0.0, -0.46095112, -0.571830988, 0.0, 0.0, 0.0,
+        0.0, 0.0, -0.583202362, 0.0, -0.497278422, -0.567822158, 0.0, 0.0,
+        -0.383664697, -0.116424128, -0.514614701, 0.0, 0.0, 0.0, 0.427795351,
+        -0.145720899, 0.0, -0.552026272, 2.50800776, 0.0, 0.0, -0.432818055,
+        1.28096116, 0.0, -0.327807695, -0.578149021, 0.0, 0.0, 0.0, 0.0,
+        1.5164113, -0.266642243, 0.0, 1.84640062, -0.40794301, 0.0, 0.0,
+        -0.0482758731, 3.35381198, -0.45161289, 0.0, 0.0, 0.0, 3.1766336,
+        0.459326565, 0.0, -0.51557833, 2.29891515, 0.0, 0.0, 3.28707266,
+        3.49147773, 0.0, -0.520787716, 2.75109148, 0.0, 0.0, 0.0, 0.0,
+        -0.58279413, 0.0, -0.461922735, -0.571644187, 0.0, 0.0, 0.858431339,
+        -0.101057187, 0.0, -0.25098142, -0.567869246, 0.0, 0.0, 0.0,
+        -0.334851921, 0.391521901, 0.0, 2.41726613, 1.1404779, 0.0, 0.0,
+        -0.250671446, 2.55248618, 0.0, 1.99238729, 3.44516134, 0.0, 0.0, 0.0,
+        0.0, 0.12844035, -0.58319211, 0.0, -0.582205355, -0.490535945, 0.0, 0.0,
+        -0.582670331, -0.561660469, 0.0, -0.121900283, -0.567767024, 0.0, 0.0,
+        0.0, -0.582525969, -0.556647301, 0.0, 0.0186115038, -0.51610595, 0.0,
+        0.0, 1.59235919, 3.18345952, 0.0, 0.456211776, -0.579357624, 0.0, 0.0,
+        0.0, -0.583164394, 0.0, 0.0, -0.583244026, 0.0, -0.520251036,
+        -0.575747669, 0.0, 0.0, -0.308209151, 2.49983382, 0.0, -0.577789843,
+        -0.406711608, 0.0, 0.0, 0.0, 0.0, -0.583247304, -0.5630669, 0.0,
+        0.326530576, -0.537932873, 0.0, 0.0, -0.127319038, 1.84019434, 0.0,
+        -0.115298919, -0.58255744, 0.0, 0.0, 0.0, -0.45874235, 0.976999402, 0.0,
+        2.8763988, -0.0469595455, 0.0, 0.0, -0.582465649, -0.264483631, 0.0,
+        1.90963483, -0.496384561, 0.0, 0.0, 0.0, 0.0, -0.583165348, 0.0,
+        -0.517482698, -0.583080411, 0.0, 0.0, -0.577924013, 1.24900126,
+        -0.580608368, 0.0, 0.0, 0.0, -0.360133737, 3.08629942, 0.0,
+        -0.223485678, -0.574868739, 0.0, 0.0, -0.583260298, 3.43608737,
+        -0.583281517, 0.0, 0.0, 0.0, 0.0, -0.583202839, 0.11602208, 0.0,
+        -0.368421048, 1.69968045, 0.0, 0.0, 2.19402981, 0.615384579, 0.0,
+        1.7251184, 3.46813011, 0.0, 0.0, -0.538770795, 0.0, 1.07318604,
+        -0.523515821, -0.583033085, 0.0, 0.0, 0.0, -0.58330977, 0.0, -0.5827474,
+        0.0, 0.0, -0.47369054, -0.0884090587, 0.0, -0.516673028, -0.583197653,
+        0.0, -0.581771314, 0.0, 0.0, 0.0, -0.553703845, 0.269086987, 0.0,
+        0.855934322, 2.38528538, -0.583250701, 0.0, 0.0, 0.0, 0.0, -0.583320916,
+        0.0, -0.365806669, -0.582179368, 0.0, 0.0, 3.37674665, -0.448394656,
+        -0.582288027, 0.0, 0.0, -0.579916298, 0.0, 2.27790952, 3.47171974, 0.0,
+        0.0, -0.568473458, 3.1182158, 0.0, -0.175223827, -0.574759841, 0.0, 0.0,
+        0.0, 0.0, -0.495384604, 0.310249269, 0.0, -0.535905898, -0.580519497,
+        0.0, 0.0, -0.0279131737, 1.20394969, 0.0, -0.520078182, -0.0760808438,
+        0.0, 0.0, 0.0, 1.42733181, 2.8387742, 0.0, 3.48289037, 1.42818785, 0.0,
+        0.0, -0.470072985, 0.462809891, -0.583248496, 0.0, -0.583283484, 0.0,
+        0.0, 0.0, 0.0, -0.583257616, -0.565537095, 0.0, -0.563451469, 0.0,
+        -0.26946941, -0.542298555, 0.0, 0.0, 0.0, -0.541443765, -0.373454779,
+        0.0, -0.0716555044, -0.515439391, 0.0, 0.0, 0.603377938, 1.52173901,
+        0.0, -0.355329961, -0.564136982, 0.0, 0.0, 0.0, 0.0, -0.582983077,
+        -0.405076146, 0.0, 1.02752292, -0.24000001, 0.0, 0.0, 2.86761022,
+        0.165680453, 0.0, -0.453942508, 0.363890409, 0.0, 0.0, 0.0,
+        -0.482950032, 1.9427036, 0.0, 2.90617418, 3.4910984, 0.0, 0.0,
+        -0.152389973, 0.657218754, 0.0, 1.9856863, -0.178913742, 0.0, 0.0, 0.0,
+        0.0, -0.583284318, 0.0, 0.0, -0.31049189, 1.55891025, 0.0, -0.347932369,
+        -0.583117008, 0.0, 0.0, 0.0, -0.480864257, 0.645782769, 0.0, 2.87951851,
+        0.668341637, 0.0, 0.0, -0.511247873, -0.00954677351, 0.0, -0.551531374,
+        -0.583208978, 0.0, 0.0, 0.0, 0.0, -0.567133009, -0.181347162, 0.0,
+        0.876357913, 0.415206224, 0.0, 0.0, 1.97208881, 2.8709228, 0.0,
+        3.18052864, 3.44952035, 0.0, 0.0, 0.0, -0.490974724, 0.178285182, 0.0,
+        2.10204077, 1.30091751, 0.0, 0.0, -0.534561396, 0.12844035,
+        -0.583289444, 0.0, 0.0, 0.0, 0.0, -0.582992256, 0.0, -0.243354753,
+        -0.558632433, 0.0, 0.0, -0.443902433, 2.21742034, 0.0, 0.172163188,
+        -0.550011635, 0.0, 0.0, 0.0, 1.60792065, 2.89019012, 0.0, 1.39630115,
+        2.36108088, 0.0, 0.0, 0.0493597873, 1.90554559, 0.0, 0.00456544803,
+        -0.537104726, 0.0, 0.0, 0.0, 0.0, 2.20272303, 3.20792198, 3.48471045,
+        0.0, 0.0, 1.94418216, 0.39546755, 0.0, 2.80464888, 2.09465647, 0.0, 0.0,
+        -0.537925303, 0.0, -1.65787739e-08, -0.462654471, -0.572535515, 0.0,
+        0.0, 0.0, -0.583312511, 0.0, 0.0, 0.0, -0.577600062, -0.351390749, 0.0,
+        -0.569332719, -0.583019257, 0.0, 0.0, -0.177215204, -0.564322472, 0.0,
+        1.80198014, -0.170895174, 0.0, 0.0, 0.0, 0.0, -0.559915245, 0.420158505,
+        0.0, 2.7745831, 0.0103499088, 0.0, 0.0, -0.582675517, 1.03240216, 0.0,
+        -0.556400657, -0.58298403, 0.0, 0.0, 0.0, 0.12844035, -0.522388041, 0.0,
+        1.84210515, -1.34591129e-08, 0.0, 0.0, 2.48063111, 0.162790671, 0.0,
+        3.30962753, -0.0482758731, 0.0, 0.0, 0.0, 0.0, -0.583264947, 0.0,
+        -0.507383347, -0.582673371, 0.0, -0.58049655, 0.0, -0.578597128,
+        0.0908314586, 0.0, 0.0, 0.0, -0.352426112, 1.47412241, 0.0, 1.76635504,
+        3.1570251, 0.0, 0.0, 1.3034482, -0.208510637, -0.580355704, 0.0, 0.0,
+        0.0, 0.0, 0.368421018, -0.562989295, 0.0, 1.67768586, -0.34710744, 0.0,
+        0.0, 2.29879737, 0.349676192, 0.0, 2.74458766, 3.48367977, 0.0, 0.0,
+        0.0, -0.341931075, 0.0950656161, 0.0, 2.67076898, 0.0314606577,
+        -0.582375526,
+    };
+
+    return model;
+}
+}  // namespace trifinger_object_tracking
@@ -0,0 +1,317 @@
+// Generated by xgb_dump_to_flat_cpp.py from xgb_model_dump.txt.
+// Do not edit manually!
+#include <trifinger_object_tracking/xgboost_batch_classifier.hpp>
+
+namespace trifinger_object_tracking
+{
+XGBoostFlatModel get_compiled_xgb_flat_model()
+{
+    XGBoostFlatModel model;
+    model.num_classes = 7;
+    model.num_features = 6;
+    model.tree_roots = {
+        0, 119, 216, 319, 416, 521, 636,
+    };
+    model.tree_classes = {
+        0, 1, 2, 3, 4, 5, 6,
+    };
+    model.tree_depths = {
+        6, 6, 6, 6, 6, 6, 6,
+    };
+    model.feature = {
+        4, 4, 4, 4, -1, 3, 3, -1, -1, 2, -1, -1, 0, 3, 1, -1, -1, 2, -1, -1, 3,
+        2, -1, -1, 3, -1, -1, 0, 3, 3, 1, -1, -1, 3, -1, -1, 0, 5, -1, -1, 3,
+        -1, -1, 3, 3, -1, 2, -1, -1, 3, 3, -1, -1, 3, -1, -1, 5, 3, 5, 3, 5, -1,
+        -1, 1, -1, -1, 1, 4, -1, -1, 2, -1, -1, 3, 4, 3, -1, -1, 0, -1, -1, 5,
+        3, -1, -1, 5, -1, -1, 5, 3, 1, 1, -1, -1, 3, -1, -1, 4, 3, -1, -1, 4,
+        -1, -1, 3, 4, 1, -1, -1, 3, -1, -1, 4, 3, -1, -1, 4, -1, -1, 2, 3, 3, 3,
+        -1, 1, -1, 1, -1, -1, 5, 1, 0, -1, -1, 4, -1, -1, -1, 0, -1, 0, 3, 4,
+        -1, -1, 4, -1, -1, 0, 3, -1, -1, 3, -1, -1, 2, 0, 3, 3, 3, -1, -1, 1,
+        -1, -1, 3, 4, -1, -1, 3, -1, -1, 3, 1, 4, -1, -1, 5, -1, -1, 3, 4, -1,
+        -1, 0, -1, -1, 4, 4, 1, 4, -1, -1, 4, -1, -1, 3, 3, -1, -1, 2, -1, -1,
+        3, 3, -1, 1, -1, -1, 3, 3, -1, -1, 3, -1, -1, 4, 4, 4, -1, 1, 5, -1, -1,
+        3, 3, -1, -1, 3, -1, -1, 1, 1, 1, 1, -1, -1, 2, -1, -1, 2, 1, -1, -1, 2,
+        -1, -1, 2, 3, 3, -1, -1, 3, -1, -1, 3, -1, 3, -1, -1, 0, 3, 3, 0, -1, 3,
+        -1, -1, 1, 5, -1, -1, 0, -1, -1, 1, 1, 1, -1, -1, 2, -1, -1, 3, 4, -1,
+        -1, 3, -1, -1, 3, 3, 2, 0, -1, -1, 2, -1, -1, 5, 1, -1, -1, -1, 3, 1, 0,
+        -1, -1, 1, -1, -1, 3, 0, -1, -1, 3, -1, -1, 4, 4, 4, -1, 1, 1, -1, 0,
+        -1, -1, 0, 3, -1, -1, 3, -1, -1, 5, 1, 1, 1, -1, -1, 0, -1, -1, 3, 3,
+        -1, -1, -1, 0, 3, -1, 2, -1, -1, 0, 2, -1, -1, -1, 1, 1, 1, 1, -1, 5,
+        -1, -1, 2, 0, -1, -1, 2, -1, -1, 2, 0, 0, -1, -1, 3, -1, -1, 2, 0, -1,
+        -1, -1, 3, 3, 5, 0, -1, -1, -1, 5, 1, -1, -1, 0, -1, -1, 3, 3, 2, -1,
+        -1, 2, -1, -1, 0, 1, -1, -1, -1, 3, 3, 3, -1, 4, 4, -1, 2, -1, -1, 0, 0,
+        -1, -1, 1, -1, -1, 4, 4, 4, -1, 0, -1, -1, 1, -1, 0, -1, -1, 2, 2, 5,
+        -1, -1, 4, -1, -1, 0, 4, -1, -1, 0, -1, -1, 4, 4, 4, 4, 4, -1, -1, 0,
+        -1, -1, 0, 0, -1, -1, 3, -1, -1, 0, 0, 2, -1, -1, 3, -1, -1, 3, 2, -1,
+        -1, 0, -1, -1, 0, 2, 5, -1, 2, -1, -1, 0, 0, -1, -1, 1, -1, -1, 2, 2, 4,
+        -1, -1, 0, -1, -1, 3, 2, -1, -1, 4, -1, -1, 4, 4, 4, 3, 4, 4, -1, -1, 5,
+        -1, -1, -1, 3, 1, 2, -1, -1, 3, -1, -1, 3, 1, -1, -1, 3, -1, -1, 3, 2,
+        5, 2, -1, -1, 1, -1, -1, 2, 4, -1, -1, 2, -1, -1, 3, 2, 2, -1, -1, 1,
+        -1, -1, 3, 5, -1, -1, 3, -1, -1, 2, 2, 2, 2, 2, -1, -1, 3, -1, -1, 1, 3,
+        -1, -1, 1, -1, -1, 1, 5, -1, 1, -1, -1, 3, 2, -1, -1, 1, -1, -1, 3, 2,
+        1, 1, -1, -1, 2, -1, -1, 3, -1, 2, -1, -1, 3, 2, 2, -1, -1, 1, -1, -1,
+        2, -1, 1, -1, -1, 4, 4, 4, -1, 3, 1, 1, -1, -1, 3, -1, -1, 3, 1, -1, -1,
+        -1, 2, 3, 1, 1, -1, -1, 0, -1, -1, 3, 5, -1, -1, -1, 3, 3, -1, 1, -1,
+        -1, 1, 0, -1, -1, 3, -1, -1, 2, 1, 1, 1, 1, -1, -1, 3, -1, -1, 3, 3, -1,
+        -1, -1, 3, 3, 0, -1, -1, 4, -1, -1, 3, 2, -1, -1, -1, 3, -1, -1,
+    };
+    model.threshold = {
+        95, 72, 62, 44, 0.0, 123, 83, 0.0, 0.0, 76, 0.0, 0.0, 97, 96, 82, 0.0,
+        0.0, 74, 0.0, 0.0, 129, 112, 0.0, 0.0, 165, 0.0, 0.0, 86, 133, 100, 76,
+        0.0, 0.0, 111, 0.0, 0.0, 65, 61, 0.0, 0.0, 165, 0.0, 0.0, 65, 43, 0.0,
+        91, 0.0, 0.0, 129, 96, 0.0, 0.0, 165, 0.0, 0.0, 73, 86, 68, 78, 58, 0.0,
+        0.0, 31.9999981, 0.0, 0.0, 31.9999981, 255, 0.0, 0.0, 54, 0.0, 0.0, 113,
+        156, 100, 0.0, 0.0, 9.99999905, 0.0, 0.0, 64, 115, 0.0, 0.0, 68, 0.0,
+        0.0, 84, 38, 35, 31.9999981, 0.0, 0.0, 14.999999, 0.0, 0.0, 124, 133,
+        0.0, 0.0, 156, 0.0, 0.0, 24.9999981, 124, 68, 0.0, 0.0, 14.999999, 0.0,
+        0.0, 108, 75, 0.0, 0.0, 156, 0.0, 0.0, 5.99999905, 78, 75, 68, 0.0,
+        31.9999981, 0.0, 35, 0.0, 0.0, 33, 26.9999981, 9.99999905, 0.0, 0.0,
+        232, 0.0, 0.0, 0.0, 9.99999905, 0.0, 28.9999981, 110, 255, 0.0, 0.0,
+        255, 0.0, 0.0, 37, 108, 0.0, 0.0, 96, 0.0, 0.0, 23.9999981, 45, 83, 78,
+        72, 0.0, 0.0, 31.9999981, 0.0, 0.0, 111, 156, 0.0, 0.0, 116, 0.0, 0.0,
+        96, 43, 156, 0.0, 0.0, 58, 0.0, 0.0, 120, 156, 0.0, 0.0, 56, 0.0, 0.0,
+        95, 62, 35, 57, 0.0, 0.0, 43, 0.0, 0.0, 96, 83, 0.0, 0.0, 45, 0.0, 0.0,
+        96, 90, 0.0, 47, 0.0, 0.0, 120, 102, 0.0, 0.0, 129, 0.0, 0.0, 83, 62,
+        41, 0.0, 76, 68, 0.0, 0.0, 53, 47, 0.0, 0.0, 96, 0.0, 0.0, 101, 82, 76,
+        68, 0.0, 0.0, 74, 0.0, 0.0, 74, 98, 0.0, 0.0, 78, 0.0, 0.0, 98, 96, 86,
+        0.0, 0.0, 100, 0.0, 0.0, 62, 0.0, 96, 0.0, 0.0, 100, 75, 72, 40, 0.0,
+        53, 0.0, 0.0, 80, 73, 0.0, 0.0, 72, 0.0, 0.0, 74, 70, 68, 0.0, 0.0, 37,
+        0.0, 0.0, 96, 95, 0.0, 0.0, 105, 0.0, 0.0, 96, 70, 104, 104, 0.0, 0.0,
+        109, 0.0, 0.0, 206, 98, 0.0, 0.0, 0.0, 100, 104, 107, 0.0, 0.0, 114,
+        0.0, 0.0, 102, 122, 0.0, 0.0, 106, 0.0, 0.0, 124, 108, 83, 0.0, 112, 76,
+        0.0, 65, 0.0, 0.0, 81, 38, 0.0, 0.0, 60, 0.0, 0.0, 190, 101, 91, 58,
+        0.0, 0.0, 56, 0.0, 0.0, 60, 38, 0.0, 0.0, 0.0, 113, 38, 0.0, 121, 0.0,
+        0.0, 116, 174, 0.0, 0.0, 0.0, 74, 70, 61, 58, 0.0, 61, 0.0, 0.0, 51,
+        25.9999981, 0.0, 0.0, 63, 0.0, 0.0, 58, 28.9999981, 25.9999981, 0.0,
+        0.0, 78, 0.0, 0.0, 74, 28.9999981, 0.0, 0.0, 0.0, 33, 28.9999981, 118,
+        56, 0.0, 0.0, 0.0, 107, 101, 0.0, 0.0, 49, 0.0, 0.0, 60, 38, 163, 0.0,
+        0.0, 174, 0.0, 0.0, 49, 78, 0.0, 0.0, 0.0, 133, 129, 125, 0.0, 49, 44,
+        0.0, 81, 0.0, 0.0, 90, 67, 0.0, 0.0, 85, 0.0, 0.0, 56, 53, 50, 0.0, 62,
+        0.0, 0.0, 47, 0.0, 97, 0.0, 0.0, 58, 54, 61, 0.0, 0.0, 57, 0.0, 0.0, 93,
+        72, 0.0, 0.0, 122, 0.0, 0.0, 72, 62, 52, 42, 34, 0.0, 0.0, 69, 0.0, 0.0,
+        69, 56, 0.0, 0.0, 165, 0.0, 0.0, 72, 56, 61, 0.0, 0.0, 165, 0.0, 0.0,
+        165, 74, 0.0, 0.0, 93, 0.0, 0.0, 62, 58, 58, 0.0, 54, 0.0, 0.0, 56, 45,
+        0.0, 0.0, 47, 0.0, 0.0, 58, 54, 108, 0.0, 0.0, 67, 0.0, 0.0, 165, 65,
+        0.0, 0.0, 95, 0.0, 0.0, 255, 201, 124, 14.999999, 108, 72, 0.0, 0.0, 64,
+        0.0, 0.0, 0.0, 14.999999, 43, 65, 0.0, 0.0, 10.999999, 0.0, 0.0,
+        19.9999981, 43, 0.0, 0.0, 165, 0.0, 0.0, 14.999999, 81, 71, 58, 0.0,
+        0.0, 35, 0.0, 0.0, 101, 232, 0.0, 0.0, 119, 0.0, 0.0, 16.9999981, 120,
+        78, 0.0, 0.0, 74, 0.0, 0.0, 19.9999981, 90, 0.0, 0.0, 24.9999981, 0.0,
+        0.0, 74, 67, 63, 58, 48, 0.0, 0.0, 14.999999, 0.0, 0.0, 31.9999981,
+        10.999999, 0.0, 0.0, 35, 0.0, 0.0, 31.9999981, 68, 0.0, 26.9999981, 0.0,
+        0.0, 14.999999, 72, 0.0, 0.0, 35, 0.0, 0.0, 14.999999, 87, 35,
+        31.9999981, 0.0, 0.0, 81, 0.0, 0.0, 10.999999, 0.0, 94, 0.0, 0.0,
+        16.9999981, 87, 78, 0.0, 0.0, 46, 0.0, 0.0, 81, 0.0, 61, 0.0, 0.0, 124,
+        108, 95, 0.0, 38, 95, 76, 0.0, 0.0, 28.9999981, 0.0, 0.0, 41, 128, 0.0,
+        0.0, 0.0, 174, 33, 104, 85, 0.0, 0.0, 69, 0.0, 0.0, 41, 94, 0.0, 0.0,
+        0.0, 24.9999981, 19.9999981, 0.0, 173, 0.0, 0.0, 173, 100, 0.0, 0.0, 33,
+        0.0, 0.0, 203, 88, 78, 70, 58, 0.0, 0.0, 38, 0.0, 0.0, 38, 24.9999981,
+        0.0, 0.0, 0.0, 33, 19.9999981, 28.9999981, 0.0, 0.0, 156, 0.0, 0.0, 38,
+        163, 0.0, 0.0, 0.0, 19.9999981, 0.0, 0.0,
+    };
+    model.yes = {
+        1, 2, 3, 4, 4, 6, 7, 7, 8, 10, 10, 11, 13, 14, 15, 15, 16, 18, 18, 19,
+        21, 22, 22, 23, 25, 25, 26, 28, 29, 30, 31, 31, 32, 34, 34, 35, 37, 38,
+        38, 39, 41, 41, 42, 44, 45, 45, 47, 47, 48, 50, 51, 51, 52, 54, 54, 55,
+        57, 58, 59, 60, 61, 61, 62, 64, 64, 65, 67, 68, 68, 69, 71, 71, 72, 74,
+        75, 76, 76, 77, 79, 79, 80, 82, 83, 83, 84, 86, 86, 87, 89, 90, 91, 92,
+        92, 93, 95, 95, 96, 98, 99, 99, 100, 102, 102, 103, 105, 106, 107, 107,
+        108, 110, 110, 111, 113, 114, 114, 115, 117, 117, 118, 120, 121, 122,
+        123, 123, 125, 125, 127, 127, 128, 130, 131, 132, 132, 133, 135, 135,
+        136, 137, 139, 139, 141, 142, 143, 143, 144, 146, 146, 147, 149, 150,
+        150, 151, 153, 153, 154, 156, 157, 158, 159, 160, 160, 161, 163, 163,
+        164, 166, 167, 167, 168, 170, 170, 171, 173, 174, 175, 175, 176, 178,
+        178, 179, 181, 182, 182, 183, 185, 185, 186, 188, 189, 190, 191, 191,
+        192, 194, 194, 195, 197, 198, 198, 199, 201, 201, 202, 204, 205, 205,
+        207, 207, 208, 210, 211, 211, 212, 214, 214, 215, 217, 218, 219, 219,
+        221, 222, 222, 223, 225, 226, 226, 227, 229, 229, 230, 232, 233, 234,
+        235, 235, 236, 238, 238, 239, 241, 242, 242, 243, 245, 245, 246, 248,
+        249, 250, 250, 251, 253, 253, 254, 256, 256, 258, 258, 259, 261, 262,
+        263, 264, 264, 266, 266, 267, 269, 270, 270, 271, 273, 273, 274, 276,
+        277, 278, 278, 279, 281, 281, 282, 284, 285, 285, 286, 288, 288, 289,
+        291, 292, 293, 294, 294, 295, 297, 297, 298, 300, 301, 301, 302, 303,
+        305, 306, 307, 307, 308, 310, 310, 311, 313, 314, 314, 315, 317, 317,
+        318, 320, 321, 322, 322, 324, 325, 325, 327, 327, 328, 330, 331, 331,
+        332, 334, 334, 335, 337, 338, 339, 340, 340, 341, 343, 343, 344, 346,
+        347, 347, 348, 349, 351, 352, 352, 354, 354, 355, 357, 358, 358, 359,
+        360, 362, 363, 364, 365, 365, 367, 367, 368, 370, 371, 371, 372, 374,
+        374, 375, 377, 378, 379, 379, 380, 382, 382, 383, 385, 386, 386, 387,
+        388, 390, 391, 392, 393, 393, 394, 395, 397, 398, 398, 399, 401, 401,
+        402, 404, 405, 406, 406, 407, 409, 409, 410, 412, 413, 413, 414, 415,
+        417, 418, 419, 419, 421, 422, 422, 424, 424, 425, 427, 428, 428, 429,
+        431, 431, 432, 434, 435, 436, 436, 438, 438, 439, 441, 441, 443, 443,
+        444, 446, 447, 448, 448, 449, 451, 451, 452, 454, 455, 455, 456, 458,
+        458, 459, 461, 462, 463, 464, 465, 465, 466, 468, 468, 469, 471, 472,
+        472, 473, 475, 475, 476, 478, 479, 480, 480, 481, 483, 483, 484, 486,
+        487, 487, 488, 490, 490, 491, 493, 494, 495, 495, 497, 497, 498, 500,
+        501, 501, 502, 504, 504, 505, 507, 508, 509, 509, 510, 512, 512, 513,
+        515, 516, 516, 517, 519, 519, 520, 522, 523, 524, 525, 526, 527, 527,
+        528, 530, 530, 531, 532, 534, 535, 536, 536, 537, 539, 539, 540, 542,
+        543, 543, 544, 546, 546, 547, 549, 550, 551, 552, 552, 553, 555, 555,
+        556, 558, 559, 559, 560, 562, 562, 563, 565, 566, 567, 567, 568, 570,
+        570, 571, 573, 574, 574, 575, 577, 577, 578, 580, 581, 582, 583, 584,
+        584, 585, 587, 587, 588, 590, 591, 591, 592, 594, 594, 595, 597, 598,
+        598, 600, 600, 601, 603, 604, 604, 605, 607, 607, 608, 610, 611, 612,
+        613, 613, 614, 616, 616, 617, 619, 619, 621, 621, 622, 624, 625, 626,
+        626, 627, 629, 629, 630, 632, 632, 634, 634, 635, 637, 638, 639, 639,
+        641, 642, 643, 643, 644, 646, 646, 647, 649, 650, 650, 651, 652, 654,
+        655, 656, 657, 657, 658, 660, 660, 661, 663, 664, 664, 665, 666, 668,
+        669, 669, 671, 671, 672, 674, 675, 675, 676, 678, 678, 679, 681, 682,
+        683, 684, 685, 685, 686, 688, 688, 689, 691, 692, 692, 693, 694, 696,
+        697, 698, 698, 699, 701, 701, 702, 704, 705, 705, 706, 707, 709, 709,
+        710,
+    };
+    model.no = {
+        56, 27, 12, 5, 4, 9, 8, 7, 8, 11, 10, 11, 20, 17, 16, 15, 16, 19, 18,
+        19, 24, 23, 22, 23, 26, 25, 26, 43, 36, 33, 32, 31, 32, 35, 34, 35, 40,
+        39, 38, 39, 42, 41, 42, 49, 46, 45, 48, 47, 48, 53, 52, 51, 52, 55, 54,
+        55, 88, 73, 66, 63, 62, 61, 62, 65, 64, 65, 70, 69, 68, 69, 72, 71, 72,
+        81, 78, 77, 76, 77, 80, 79, 80, 85, 84, 83, 84, 87, 86, 87, 104, 97, 94,
+        93, 92, 93, 96, 95, 96, 101, 100, 99, 100, 103, 102, 103, 112, 109, 108,
+        107, 108, 111, 110, 111, 116, 115, 114, 115, 118, 117, 118, 155, 138,
+        129, 124, 123, 126, 125, 128, 127, 128, 137, 134, 133, 132, 133, 136,
+        135, 136, 137, 140, 139, 148, 145, 144, 143, 144, 147, 146, 147, 152,
+        151, 150, 151, 154, 153, 154, 187, 172, 165, 162, 161, 160, 161, 164,
+        163, 164, 169, 168, 167, 168, 171, 170, 171, 180, 177, 176, 175, 176,
+        179, 178, 179, 184, 183, 182, 183, 186, 185, 186, 203, 196, 193, 192,
+        191, 192, 195, 194, 195, 200, 199, 198, 199, 202, 201, 202, 209, 206,
+        205, 208, 207, 208, 213, 212, 211, 212, 215, 214, 215, 260, 231, 220,
+        219, 224, 223, 222, 223, 228, 227, 226, 227, 230, 229, 230, 247, 240,
+        237, 236, 235, 236, 239, 238, 239, 244, 243, 242, 243, 246, 245, 246,
+        255, 252, 251, 250, 251, 254, 253, 254, 257, 256, 259, 258, 259, 290,
+        275, 268, 265, 264, 267, 266, 267, 272, 271, 270, 271, 274, 273, 274,
+        283, 280, 279, 278, 279, 282, 281, 282, 287, 286, 285, 286, 289, 288,
+        289, 304, 299, 296, 295, 294, 295, 298, 297, 298, 303, 302, 301, 302,
+        303, 312, 309, 308, 307, 308, 311, 310, 311, 316, 315, 314, 315, 318,
+        317, 318, 361, 336, 323, 322, 329, 326, 325, 328, 327, 328, 333, 332,
+        331, 332, 335, 334, 335, 350, 345, 342, 341, 340, 341, 344, 343, 344,
+        349, 348, 347, 348, 349, 356, 353, 352, 355, 354, 355, 360, 359, 358,
+        359, 360, 389, 376, 369, 366, 365, 368, 367, 368, 373, 372, 371, 372,
+        375, 374, 375, 384, 381, 380, 379, 380, 383, 382, 383, 388, 387, 386,
+        387, 388, 403, 396, 395, 394, 393, 394, 395, 400, 399, 398, 399, 402,
+        401, 402, 411, 408, 407, 406, 407, 410, 409, 410, 415, 414, 413, 414,
+        415, 460, 433, 420, 419, 426, 423, 422, 425, 424, 425, 430, 429, 428,
+        429, 432, 431, 432, 445, 440, 437, 436, 439, 438, 439, 442, 441, 444,
+        443, 444, 453, 450, 449, 448, 449, 452, 451, 452, 457, 456, 455, 456,
+        459, 458, 459, 492, 477, 470, 467, 466, 465, 466, 469, 468, 469, 474,
+        473, 472, 473, 476, 475, 476, 485, 482, 481, 480, 481, 484, 483, 484,
+        489, 488, 487, 488, 491, 490, 491, 506, 499, 496, 495, 498, 497, 498,
+        503, 502, 501, 502, 505, 504, 505, 514, 511, 510, 509, 510, 513, 512,
+        513, 518, 517, 516, 517, 520, 519, 520, 579, 548, 533, 532, 529, 528,
+        527, 528, 531, 530, 531, 532, 541, 538, 537, 536, 537, 540, 539, 540,
+        545, 544, 543, 544, 547, 546, 547, 564, 557, 554, 553, 552, 553, 556,
+        555, 556, 561, 560, 559, 560, 563, 562, 563, 572, 569, 568, 567, 568,
+        571, 570, 571, 576, 575, 574, 575, 578, 577, 578, 609, 596, 589, 586,
+        585, 584, 585, 588, 587, 588, 593, 592, 591, 592, 595, 594, 595, 602,
+        599, 598, 601, 600, 601, 606, 605, 604, 605, 608, 607, 608, 623, 618,
+        615, 614, 613, 614, 617, 616, 617, 620, 619, 622, 621, 622, 631, 628,
+        627, 626, 627, 630, 629, 630, 633, 632, 635, 634, 635, 680, 653, 640,
+        639, 648, 645, 644, 643, 644, 647, 646, 647, 652, 651, 650, 651, 652,
+        667, 662, 659, 658, 657, 658, 661, 660, 661, 666, 665, 664, 665, 666,
+        673, 670, 669, 672, 671, 672, 677, 676, 675, 676, 679, 678, 679, 708,
+        695, 690, 687, 686, 685, 686, 689, 688, 689, 694, 693, 692, 693, 694,
+        703, 700, 699, 698, 699, 702, 701, 702, 707, 706, 705, 706, 707, 710,
+        709, 710,
+    };
+    model.leaf_value = {
+        0.0, 0.0, 0.0, 0.0, 3.49958777, 0.0, 0.0, 3.49473572, 3.43639994, 0.0,
+        3.31641483, 2.82041311, 0.0, 0.0, 0.0, 3.49544168, 3.37871146, 0.0,
+        3.18455529, 1.041237, 0.0, 0.0, 2.35607219, 3.42651439, 0.0,
+        -0.19732821, 2.70521855, 0.0, 0.0, 0.0, 0.0, 3.49272919, 3.16762924,
+        0.0, 2.4120481, 3.08397245, 0.0, 0.0, 3.41192746, 1.90644014, 0.0,
+        -0.429553807, 2.1328609, 0.0, 0.0, 3.43602228, 0.0, 1.60458446,
+        2.70330548, 0.0, 0.0, -0.0928667784, 3.02109408, 0.0, -0.555294275,
+        1.45976198, 0.0, 0.0, 0.0, 0.0, 0.0, 3.49710608, 3.25699115, 0.0,
+        1.02514875, 3.27683139, 0.0, 0.0, 1.84551334, 0.246768475, 0.0,
+        1.29989672, 3.19437337, 0.0, 0.0, 0.0, 2.64092159, 0.434197783, 0.0,
+        3.44688749, -0.348675758, 0.0, 0.0, 2.29967809, 3.39522314, 0.0,
+        0.859945595, -0.381161481, 0.0, 0.0, 0.0, 0.0, -0.213556334,
+        0.576160789, 0.0, 1.92416632, 3.154706, 0.0, 0.0, 1.41617453,
+        -0.513225019, 0.0, -0.333623827, -0.579836071, 0.0, 0.0, 0.0,
+        1.36136901, 3.17197108, 0.0, -0.455350935, 0.565160215, 0.0, 0.0,
+        2.43448043, -0.508681893, 0.0, -0.515387893, -0.578871667, 0.0, 0.0,
+        0.0, 0.0, -0.58317101, 0.0, -0.502488077, 0.0, -0.58079797,
+        -0.413422823, 0.0, 0.0, 0.0, -0.536704719, 0.152475223, 0.0, 1.62818325,
+        0.325581372, -0.466234952, 0.0, -0.580034614, 0.0, 0.0, 0.0, 2.44917655,
+        3.36515307, 0.0, -0.554937422, 0.99999994, 0.0, 0.0, 3.31525993,
+        0.21620588, 0.0, 1.61077106, 3.4809339, 0.0, 0.0, 0.0, 0.0, 0.0,
+        -0.582524538, -0.523729622, 0.0, 0.556515038, -0.376981616, 0.0, 0.0,
+        0.41028595, 2.22988296, 0.0, -0.0589251183, -0.536012113, 0.0, 0.0, 0.0,
+        2.12474012, 0.165680453, 0.0, -0.136333123, 0.979190707, 0.0, 0.0,
+        2.94187212, 3.4675703, 0.0, -0.562989295, 1.92660546, 0.0, 0.0, 0.0,
+        0.0, -0.536548018, -0.286191821, 0.0, -0.583254635, -0.580551326, 0.0,
+        0.0, -0.582241356, -0.555650949, 0.0, 0.0750043839, -0.49993059, 0.0,
+        0.0, -0.582483768, 0.0, 0.304347783, -0.571457446, 0.0, 0.0,
+        0.118610188, 2.72903395, 0.0, 0.0361235291, -0.57951051, 0.0, 0.0, 0.0,
+        -0.583159089, 0.0, 0.0, -0.583278835, -0.575871646, 0.0, 0.0,
+        -0.579845786, -0.546450377, 0.0, -0.431144893, -0.569521666, 0.0, 0.0,
+        0.0, 0.0, -0.583006501, -0.560041189, 0.0, -0.421712607, -0.572580814,
+        0.0, 0.0, -0.122916736, 0.893291652, 0.0, -0.402501762, -0.572332084,
+        0.0, 0.0, 0.0, 0.503334045, 2.99210835, 0.0, 0.0603231378, -0.427371293,
+        0.0, -0.581042051, 0.0, 1.64250124, -0.488223255, 0.0, 0.0, 0.0, 0.0,
+        -0.583105862, 0.0, -0.574401796, 0.0264292117, 0.0, 0.0, -0.576012969,
+        0.294601977, 0.0, 2.6519587, 0.547231197, 0.0, 0.0, 0.0, -0.582602441,
+        -0.276679844, 0.0, 3.06830525, -0.23341006, 0.0, 0.0, 1.93951583,
+        3.37526083, 0.0, -0.469172359, 0.0111066857, 0.0, 0.0, 0.0, 0.0,
+        0.11602208, 2.38415837, 0.0, 0.14558056, -0.583145678, 0.0, 0.0,
+        1.78638935, 3.4747231, -0.34710744, 0.0, 0.0, 0.0, -0.00856794696,
+        0.531386793, 0.0, 2.22299814, 0.432294577, 0.0, 0.0, -0.295774639,
+        0.330708623, 0.0, -0.369961172, -0.582876682, 0.0, 0.0, 0.0,
+        -0.583256006, 0.0, 0.0, -0.582918942, 0.0, -0.484598696, -0.580708861,
+        0.0, 0.0, -0.279237568, 1.25685, 0.0, -0.371106416, -0.583256423, 0.0,
+        0.0, 0.0, 0.0, -0.582927644, -0.574911714, 0.0, 0.73597157,
+        -0.577039063, 0.0, 0.0, -0.339910835, 2.25053406, -0.583236635, 0.0,
+        0.0, -0.558542907, 0.0, -0.34710744, 3.30230784, 0.0, 0.0, 1.47706413,
+        -0.475471705, -0.582572103, 0.0, 0.0, 0.0, 0.0, -0.583021581, 0.0,
+        -0.229357809, -0.579545617, 0.0, 0.0, 3.02749252, -0.457718313, 0.0,
+        -0.268847793, -0.579244077, 0.0, 0.0, 0.0, 3.40352321, 1.10526311, 0.0,
+        1.03675663, -0.578029275, 0.0, 0.0, 0.804400921, -0.364928901,
+        -0.577740431, 0.0, 0.0, 0.0, 0.0, -0.569753349, -0.331420362,
+        -0.582656622, 0.0, 0.0, -0.258939594, 0.257482827, 0.0, -0.570566416,
+        -0.390814215, 0.0, 0.0, 0.0, 2.22934723, -0.371531963, 0.0, 3.48989677,
+        -0.34710744, 0.0, 0.0, 1.27272725, -0.290993065, -0.582580686, 0.0, 0.0,
+        0.0, -0.583254576, 0.0, 0.0, -0.583299994, 0.0, -0.450847447,
+        -0.566801608, 0.0, 0.0, -0.558165491, -0.159423053, 0.0, 0.861047745,
+        -0.5090909, 0.0, 0.0, 0.0, -0.58290112, 0.0, -0.264483631, -0.50359714,
+        0.0, -0.522388041, 0.0, 0.0200860668, -0.475471705, 0.0, 0.0, 0.0,
+        -0.578774154, -0.322135299, 0.0, 1.84210515, 0.0920043588, 0.0, 0.0,
+        0.429772884, 1.96971595, 0.0, 2.97576189, 0.928881109, 0.0, 0.0, 0.0,
+        0.0, 0.0, -0.583053648, -0.53736347, 0.0, -0.550915778, -0.305205315,
+        0.0, 0.0, -0.54607439, -0.216123506, 0.0, 1.28310335, -0.354373604, 0.0,
+        0.0, 0.0, -0.579876661, -0.413359135, 0.0, 0.122448958, -0.413359135,
+        0.0, 0.0, 1.98852217, 3.1080575, 0.0, -0.398540139, 0.0179257188, 0.0,
+        0.0, 0.0, -0.579295099, 0.0, -0.380800009, -0.0305676982, 0.0, 0.0,
+        -0.547826052, 0.257537007, 0.0, 2.51999974, 0.279534072, 0.0, 0.0, 0.0,
+        0.265822768, -0.492012769, 0.0, 0.662316442, 2.29090905, 0.0, 0.0,
+        2.78734803, 3.49299192, 0.0, 0.948817432, 3.1836803, 0.0, 0.0, 0.0, 0.0,
+        0.0, 0.0, -0.582745314, -0.313566118, 0.0, -0.42685771, 0.781245947,
+        -0.583258867, 0.0, 0.0, 0.0, -0.47634533, 0.589584827, 0.0, 3.01449442,
+        1.7316606, 0.0, 0.0, -0.5035097, -0.210034147, 0.0, -0.582685173,
+        -0.47432214, 0.0, 0.0, 0.0, 0.0, -0.551257789, -0.119841672, 0.0,
+        1.6996274, 0.432766587, 0.0, 0.0, 1.71760786, 2.81335378, 0.0,
+        3.13498855, 3.42642903, 0.0, 0.0, 0.0, -0.427453429, 0.0384844467, 0.0,
+        2.58629656, 0.101326875, 0.0, 0.0, -0.547287941, -0.321253181, 0.0,
+        -0.568026721, -0.583026588, 0.0, 0.0, 0.0, 0.0, 0.0, -0.582431972,
+        -0.521429658, 0.0, 0.367445171, -0.519831002, 0.0, 0.0, 2.14960623,
+        0.829150736, 0.0, -0.275873125, -0.546122074, 0.0, 0.0, 1.47560167, 0.0,
+        2.97080445, 2.4632833, 0.0, 0.0, 0.190314338, 0.674197316, 0.0,
+        -0.124494754, -0.52788496, 0.0, 0.0, 0.0, 0.0, 3.28206253, 2.73249125,
+        0.0, 0.51155287, 1.92607796, 0.0, 3.49776292, 0.0, 3.11193871,
+        3.38145661, 0.0, 0.0, 0.0, -0.39133653, -0.0975202098, 0.0, 1.43001246,
+        0.0126765491, 0.0, -0.570032537, 0.0, -0.397223055, -0.573846638, 0.0,
+        0.0, 0.0, -0.583244801, 0.0, 0.0, 0.0, -0.581204176, -0.520576894, 0.0,
+        -0.416980475, -0.0839962363, 0.0, 0.0, -0.581268668, 0.624874592,
+        -0.582699418, 0.0, 0.0, 0.0, 0.0, -0.572090685, -0.194003835, 0.0,
+        0.948625326, 0.199559495, 0.0, 0.0, -0.581165671, -0.0242479648,
+        -0.583088279, 0.0, 0.0, -0.513447404, 0.0, 1.02831852, -0.475471705,
+        0.0, 0.0, -0.0830039605, -0.32110092, 0.0, 2.75046062, 0.200573042, 0.0,
+        0.0, 0.0, 0.0, 0.0, -0.583092809, -0.56698209, 0.0, -0.353575051,
+        -0.581590712, 0.0, 0.0, 0.0433002636, 2.05079627, -0.579933643, 0.0,
+        0.0, 0.0, 2.9566288, 0.0779912621, 0.0, 3.07844925, 3.47887301, 0.0,
+        0.0, 0.450614214, 2.98260856, -0.582063615, 0.0, -0.571368754,
+        3.49790883,
+    };
+
+    return model;
+}
+}  // namespace trifinger_object_tracking
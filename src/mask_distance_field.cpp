@@ -0,0 +1,156 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <trifinger_object_tracking/mask_distance_field.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace trifinger_object_tracking
+{
+void MaskDistanceField::compute(const std::vector<cv::Point> &pixels)
+{
+    if (pixels.empty())
+    {
+        reset_region(cv::Rect());
+        return;
+    }
+
+    int min_x = pixels[0].x, max_x = pixels[0].x;
+    int min_y = pixels[0].y, max_y = pixels[0].y;
+    for (const cv::Point &pixel : pixels)
+    {
+        min_x = std::min(min_x, pixel.x);
+        max_x = std::max(max_x, pixel.x);
+        min_y = std::min(min_y, pixel.y);
+        max_y = std::max(max_y, pixel.y);
+    }
+    reset_region(
+        cv::Rect(min_x, min_y, max_x - min_x + 1, max_y - min_y + 1));
+
+    for (const cv::Point &pixel : pixels)
+    {
+        mask_.at<uint8_t>(pixel.y - roi_.y, pixel.x - roi_.x) = 255;
+    }
+
+    compute_transforms();
+}
+
+void MaskDistanceField::compute(const SparseMask &mask)
+{
+    reset_region(mask.get_bounding_box());
+    if (empty())
+    {
+        return;
+    }
+
+    for (const PixelRun &run : mask.get_runs())
+    {
+        uint8_t *row = mask_.ptr<uint8_t>(run.row - roi_.y);
+        std::fill(
+            row + run.col_begin - roi_.x, row + run.col_end - roi_.x, 255);
+    }
+
+    compute_transforms();
+}
+
+void MaskDistanceField::reset_region(const cv::Rect &bounding_box)
+{
+    if (bounding_box.empty())
+    {
+        roi_ = cv::Rect();
+        return;
+    }
+
+    // the margin also ensures that the border of the region is not part of
+    // the mask, so the erosion in compute_transforms() finds the border of
+    // the mask there
+    roi_ = cv::Rect(bounding_box.x - MARGIN,
+                    bounding_box.y - MARGIN,
+                    bounding_box.width + 2 * MARGIN,
+                    bounding_box.height + 2 * MARGIN);
+
+    mask_.create(roi_.size(), CV_8UC1);
+    mask_.setTo(0);
+}
+
+void MaskDistanceField::compute_transforms()
+{
+    // cv::distanceTransform computes the distance to the closest zero pixel.
+    // Use the exact Euclidean distance (also linear in the number of pixels),
+    // the 3x3 approximation underestimates distances along the axes by 5%.
+    cv::bitwise_not(mask_, transform_input_);
+    cv::distanceTransform(
+        transform_input_, mask_distance_, cv::DIST_L2, cv::DIST_MASK_PRECISE);
+
+    // border pixels are pixels of the mask that are removed by an erosion
+    cv::erode(mask_, eroded_mask_, cv::Mat());
+    cv::bitwise_or(transform_input_, eroded_mask_, transform_input_);
+    cv::distanceTransform(transform_input_,
+                          border_distance_,
+                          cv::DIST_L2,
+                          cv::DIST_MASK_PRECISE);
+}
+
+float MaskDistanceField::lookup(const cv::Mat &distances,
+                                const cv::Point2f &point) const
+{
+    const float x = point.x - roi_.x;
+    const float y = point.y - roi_.y;
+    const float clamped_x = std::clamp(x, 0.f, float(roi_.width - 1));
+    const float clamped_y = std::clamp(y, 0.f, float(roi_.height - 1));
+
+    const float distance = distances.at<float>(std::lround(clamped_y),
+                                               std::lround(clamped_x));
+    if (x == clamped_x && y == clamped_y)
+    {
+        return distance;
+    }
+    return distance + std::hypot(x - clamped_x, y - clamped_y);
+}
+
+float MaskDistanceField::compute_quad_cost(
+    const std::array<cv::Point2f, 4> &corners) const
+{
+    float edge_cost = 0;
+    int num_edge_samples = 0;
+    for (size_t i = 0; i < 4; i++)
+    {
+        const cv::Point2f &a = corners[i];
+        const cv::Point2f edge = corners[(i + 1) % 4] - a;
+        const int num_samples = std::clamp(
+            static_cast<int>(std::ceil(cv::norm(edge) / EDGE_SAMPLE_SPACING)),
+            1,
+            MAX_EDGE_SAMPLES);
+
+        // the end point is the start point of the next edge
+        for (int k = 0; k < num_samples; k++)
+        {
+            const float t = static_cast<float>(k) / num_samples;
+            edge_cost += std::sqrt(get_border_distance(a + t * edge));
+        }
+        num_edge_samples += num_samples;
+    }
+
+    // bilinear interpolation of the corners, cell centres of the grid
+    float interior_cost = 0;
+    for (int i = 0; i < INTERIOR_GRID_SIZE; i++)
+    {
+        const float u = (i + 0.5f) / INTERIOR_GRID_SIZE;
+        const cv::Point2f from = corners[0] + u * (corners[1] - corners[0]);
+        const cv::Point2f to = corners[3] + u * (corners[2] - corners[3]);
+        for (int j = 0; j < INTERIOR_GRID_SIZE; j++)
+        {
+            const float v = (j + 0.5f) / INTERIOR_GRID_SIZE;
+            interior_cost +=
+                std::sqrt(get_mask_distance(from + v * (to - from)));
+        }
+    }
+
+    return edge_cost / num_edge_samples +
+           interior_cost / (INTERIOR_GRID_SIZE * INTERIOR_GRID_SIZE);
+}
+
+}  // namespace trifinger_object_tracking
@@ -1,8 +1,11 @@
 #include <float.h>
 #include <math.h>
 
+#include <Eigen/Cholesky>
+#include <algorithm>
+#include <cassert>
 #include <iostream>
-#include <random>
+#include <stdexcept>
 #include <thread>
 #include <trifinger_object_tracking/pose_detector.hpp>
 #include <trifinger_object_tracking/scoped_timer.hpp>
@@ -16,6 +19,120 @@ cv::Mat getPoseMatrix(const cv::Vec3f &rvec, const cv::Vec3f &tvec)
     return cv::Mat(cv::Affine3f(rvec, tvec).matrix);
 }
 
+namespace
+{
+//! Default number of mask pixels used in the cost function of the global
+//! search (the weights of the cost terms are chosen for it).
+constexpr unsigned int NUM_OPTIMIZATION_SAMPLES =
+    PoseSearchParameters().num_samples;
+
+// todo: what is the best value here?
+constexpr float DISTANCE_COST_SCALING = 5 * 1e-2;
+constexpr float INVISIBILITY_COST_SCALING = 1.0;
+constexpr float HEIGHT_COST_SCALING = 10.0;
+
+//! Number of candidate poses that are evaluated together in
+//! PoseDetector::cost_function().
+constexpr size_t COST_BATCH_SIZE = QuadBatch::SIZE;
+
+/**
+ * @brief Signed distance of a point to the border of a quadrilateral.
+ *
+ * Same as cv::pointPolygonTest with measureDist=true but with float corners
+ * and additionally computes the derivative of the distance w.r.t. the
+ * corners.
+ *
+ * @param corners Corners of the quadrilateral.
+ * @param point The point.
+ * @param gradient Output of the derivatives w.r.t. the image coordinates of
+ *     each corner.
+ *
+ * @return Distance of the point to the border, positive if it is inside,
+ *     negative if it is outside.
+ */
+float signed_distance_to_quad(const std::array<cv::Point2f, 4> &corners,
+                              const cv::Point2f &point,
+                              std::array<cv::Vec2f, 4> *gradient)
+{
+    float min_squared_distance = FLT_MAX;
+    unsigned int closest_edge = 0;
+    float closest_edge_position = 0;
+    cv::Point2f closest_difference;
+    bool is_inside = false;
+
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        const cv::Point2f &a = corners[i];
+        const cv::Point2f &b = corners[(i + 1) % 4];
+        const cv::Point2f edge = b - a;
+        const cv::Point2f a_to_point = point - a;
+
+        // closest point on the edge is a + t * edge
+        const float edge_squared_length = edge.dot(edge);
+        const float t =
+            edge_squared_length > 0
+                ? std::clamp(
+                      a_to_point.dot(edge) / edge_squared_length, 0.f, 1.f)
+                : 0.f;
+        const cv::Point2f difference = a_to_point - t * edge;
+        const float squared_distance = difference.dot(difference);
+        if (squared_distance < min_squared_distance)
+        {
+            min_squared_distance = squared_distance;
+            closest_edge = i;
+            closest_edge_position = t;
+            closest_difference = difference;
+        }
+
+        // crossing number test
+        if ((a.y > point.y) != (b.y > point.y) &&
+            point.x < a.x + (point.y - a.y) * edge.x / edge.y)
+        {
+            is_inside = !is_inside;
+        }
+    }
+
+    const float distance = std::sqrt(min_squared_distance);
+    const float sign = is_inside ? 1.f : -1.f;
+
+    gradient->fill(cv::Vec2f(0, 0));
+    if (distance > 0)
+    {
+        // moving the closest point on the border towards the point reduces
+        // the distance
+        const cv::Vec2f direction(closest_difference.x / distance,
+                                  closest_difference.y / distance);
+        (*gradient)[closest_edge] =
+            -sign * (1 - closest_edge_position) * direction;
+        (*gradient)[(closest_edge + 1) % 4] =
+            -sign * closest_edge_position * direction;
+    }
+
+    return sign * distance;
+}
+
+/**
+ * @brief Apply a perturbation to a pose.
+ *
+ * @param step Perturbation (dt, dw) of the pose, applied as t + dt and
+ *     exp(dw) * R (see PoseDetector::project_corners_with_jacobians()).
+ * @param position Position that is updated.
+ * @param orientation Orientation (as rotation vector) that is updated.
+ */
+void apply_pose_perturbation(const Eigen::Matrix<double, 6, 1> &step,
+                             cv::Vec3f *position,
+                             cv::Vec3f *orientation)
+{
+    const cv::Matx33f rotation_step =
+        cv::Affine3f(cv::Vec3f(step(3), step(4), step(5))).rotation();
+    const cv::Affine3f rotation(rotation_step *
+                                cv::Affine3f(*orientation).rotation());
+
+    *orientation = rotation.rvec();
+    *position += cv::Vec3f(step(0), step(1), step(2));
+}
+}  // namespace
+
 PoseDetector::PoseDetector(const CubeModel &cube_model,
                            const std::array<trifinger_cameras::CameraParameters,
                                             N_CAMERAS> &camera_parameters)
@@ -23,36 +140,16 @@ PoseDetector::PoseDetector(const CubeModel &cube_model,
       num_total_pixels_in_image_(camera_parameters[0].image_width *
                                  camera_parameters[0].image_height)
 {
-    // convert camera parameters to cv types
     for (unsigned int i = 0; i < N_CAMERAS; i++)
     {
-        cv::eigen2cv(camera_parameters[i].camera_matrix, camera_matrices_[i]);
-        cv::eigen2cv(camera_parameters[i].distortion_coefficients,
-                     distortion_coeffs_[i]);
-
-        Eigen::Matrix3d rotmat_eigen =
-            camera_parameters[i].tf_world_to_camera.topLeftCorner<3, 3>();
-        cv::Mat rotmat_cv;
-        cv::eigen2cv(rotmat_eigen, rotmat_cv);
-        cv::Rodrigues(rotmat_cv, camera_orientations_[i]);
-
-        Eigen::Vector3d tvec_eigen =
-            camera_parameters[i].tf_world_to_camera.topRightCorner<3, 1>();
-        cv::eigen2cv(tvec_eigen, camera_translations_[i]);
+        camera_projections_[i] = CameraProjection(camera_parameters[i]);
     }
 
-    // unfortunately, there is no real const cv::Mat, so we cannot wrap it
-    // around the const array but need to copy the data
-    corners_in_cube_frame_ = cv::Mat(8, 4, CV_32F);
-    std::memcpy(corners_in_cube_frame_.data,
-                cube_model_.cube_corners,
-                corners_in_cube_frame_.total() * sizeof(float));
-
-    reference_vector_normals_ = cv::Mat(6, 3, CV_32F);
-    std::memcpy(reference_vector_normals_.data,
-                cube_model_.face_normal_vectors,
-                reference_vector_normals_.total() * sizeof(float));
-    reference_vector_normals_ = reference_vector_normals_.t();
+    // the model stores one corner/normal per row
+    corners_in_cube_frame_ =
+        cv::Matx<float, 8, 4>(&cube_model_.cube_corners[0][0]).t();
+    reference_vector_normals_ =
+        cv::Matx<float, 6, 3>(&cube_model_.face_normal_vectors[0][0]).t();
 
     // Setting the bounds for pose estimation
     position_.lower_bound = cv::Vec3f(-0.25, -0.25, 0);
@@ -66,206 +163,415 @@ PoseDetector::PoseDetector(const CubeModel &cube_model,
         (orientation_.upper_bound + orientation_.lower_bound) / 2.0;
 }
 
-PoseDetector::MasksPixels sample_masks_pixels_proportionally(
-    const PoseDetector::MasksPixels &masks_pixels,
-    const unsigned int &num_samples)
+//! Number of pixels of a mask.
+size_t get_num_pixels(const std::vector<cv::Point> &pixels)
+{
+    return pixels.size();
+}
+
+//! Number of pixels of a mask.
+size_t get_num_pixels(const SparseMask &mask)
+{
+    return mask.get_num_pixels();
+}
+
+//! Add the coordinates of the pixels of a mask to sum.
+void add_pixel_coordinates(const std::vector<cv::Point> &pixels,
+                           cv::Point2d *sum)
+{
+    for (const cv::Point &pixel : pixels)
+    {
+        sum->x += pixel.x;
+        sum->y += pixel.y;
+    }
+}
+
+//! Add the coordinates of the pixels of a mask to sum.
+void add_pixel_coordinates(const SparseMask &mask, cv::Point2d *sum)
+{
+    for (const PixelRun &run : mask.get_runs())
+    {
+        const int num_pixels = run.col_end - run.col_begin;
+        // sum of the columns col_begin, ..., col_end - 1
+        sum->x += 0.5 * (run.col_begin + run.col_end - 1) * num_pixels;
+        sum->y += static_cast<double>(run.row) * num_pixels;
+    }
+}
+
+/**
+ * @brief Get the centroid of the pixels of all masks of each camera.
+ *
+ * @tparam Masks PoseDetector::MasksPixels or PoseDetector::SparseMasks.
+ */
+template <typename Masks>
+std::array<std::optional<cv::Point2f>, PoseDetector::N_CAMERAS>
+get_masks_centroids(const Masks &masks)
 {
-    unsigned int num_pixels = 0;
+    std::array<std::optional<cv::Point2f>, PoseDetector::N_CAMERAS> centroids;
     for (unsigned int camera_idx = 0; camera_idx < PoseDetector::N_CAMERAS;
          camera_idx++)
     {
-        for (size_t color_idx = 0; color_idx < masks_pixels[camera_idx].size();
-             color_idx++)
+        cv::Point2d sum(0, 0);
+        size_t num_pixels = 0;
+        for (const auto &mask : masks[camera_idx])
         {
-            num_pixels += masks_pixels[camera_idx][color_idx].size();
+            add_pixel_coordinates(mask, &sum);
+            num_pixels += get_num_pixels(mask);
+        }
+        if (num_pixels > 0)
+        {
+            centroids[camera_idx] =
+                cv::Point2f(sum.x / num_pixels, sum.y / num_pixels);
         }
     }
+    return centroids;
+}
 
-    // todo: we should probably handle the special case when there are no pixels
-    double sampling_ratio = double(num_samples) / double(num_pixels);
-
-    // std::cout << "num_pixels: " << num_pixels
-    //          << " ; sampling_ratio: " << sampling_ratio << std::endl;
-
-    PoseDetector::MasksPixels sampled_masks_pixels;
+/**
+ * @brief Aggregate the pixels of the masks into weighted grid cells.
+ *
+ * The pixels of each mask are replaced by the centroids of the cells of a
+ * grid (see PixelCoordinates::assign_aggregated()).  The cell size is chosen
+ * as the smallest one for which the total number of cells over all masks
+ * does not exceed max_num_points.  The weights are scaled such that they sum
+ * up to the number of pixels, but at most max_num_points, so the cost terms
+ * summed over the points keep the scale they had with a random sample of
+ * that size.
+ *
+ * Other than sampling, this is deterministic and all pixels contribute.
+ *
+ * @tparam Masks PoseDetector::MasksPixels or PoseDetector::SparseMasks.
+ * @param masks The masks.
+ * @param max_num_points Maximum number of points over all masks.
+ * @param masks_coordinates Output of the weighted points (reuses the
+ *     memory).
+ */
+template <typename Masks>
+void aggregate_masks_pixels(const Masks &masks,
+                            unsigned int max_num_points,
+                            PoseDetector::MasksCoordinates *masks_coordinates)
+{
+    size_t num_pixels = 0;
+    size_t num_non_empty_masks = 0;
     for (unsigned int camera_idx = 0; camera_idx < PoseDetector::N_CAMERAS;
          camera_idx++)
     {
-        for (size_t color_idx = 0; color_idx < masks_pixels[camera_idx].size();
-             color_idx++)
+        (*masks_coordinates)[camera_idx].resize(masks[camera_idx].size());
+        for (const auto &mask : masks[camera_idx])
         {
-            unsigned int num_pixels_in_mask =
-                masks_pixels[camera_idx][color_idx].size();
-            unsigned int num_samples_in_mask =
-                sampling_ratio * num_pixels_in_mask;
-
-            std::vector<cv::Point> sampled_pixels(num_samples_in_mask);
+            num_pixels += get_num_pixels(mask);
+            num_non_empty_masks += !mask.empty();
+        }
+    }
 
-            if (num_samples_in_mask > 0)
+    const float weight_scale =
+        std::min(1.0f, static_cast<float>(max_num_points) / num_pixels);
+
+    // a cell of size s contains at most s^2 pixels, so start with the
+    // smallest size that can possibly give few enough cells and increase it
+    // until the cells at the borders of the masks are accounted for, too
+    int cell_size = std::max(
+        1,
+        static_cast<int>(std::ceil(std::sqrt(static_cast<double>(num_pixels) /
+                                             max_num_points))));
+    while (true)
+    {
+        size_t num_points = 0;
+        for (unsigned int camera_idx = 0; camera_idx < PoseDetector::N_CAMERAS;
+             camera_idx++)
+        {
+            for (size_t color_idx = 0; color_idx < masks[camera_idx].size();
+                 color_idx++)
             {
-                std::sample(masks_pixels[camera_idx][color_idx].begin(),
-                            masks_pixels[camera_idx][color_idx].end(),
-                            sampled_pixels.begin(),
-                            num_samples_in_mask,
-                            std::mt19937{std::random_device{}()});
+                PixelCoordinates &coordinates =
+                    (*masks_coordinates)[camera_idx][color_idx];
+                coordinates.assign_aggregated(
+                    masks[camera_idx][color_idx], cell_size, weight_scale);
+                num_points += coordinates.size();
             }
+        }
 
-            sampled_masks_pixels[camera_idx].push_back(sampled_pixels);
+        // every mask needs at least one point
+        if (num_points <= max_num_points || num_points == num_non_empty_masks)
+        {
+            break;
         }
+        // the number of cells is roughly proportional to 1 / cell_size^2
+        cell_size = std::max(
+            cell_size + 1,
+            static_cast<int>(cell_size *
+                             std::sqrt(static_cast<double>(num_points) /
+                                       max_num_points)));
     }
-    return sampled_masks_pixels;
 }
 
-PoseDetector::MasksPixels sample_masks_pixels(
-    const PoseDetector::MasksPixels &masks_pixels,
-    const unsigned int &num_samples_per_mask)
+//! Convert the masks to bit masks (reuses the memory).
+template <typename Masks>
+void to_bit_masks(const Masks &masks, PoseDetector::MasksBits *masks_bits)
 {
-    PoseDetector::MasksPixels sampled_masks_pixels;
     for (unsigned int camera_idx = 0; camera_idx < PoseDetector::N_CAMERAS;
          camera_idx++)
     {
-        for (size_t color_idx = 0; color_idx < masks_pixels[camera_idx].size();
+        (*masks_bits)[camera_idx].resize(masks[camera_idx].size());
+        for (size_t color_idx = 0; color_idx < masks[camera_idx].size();
              color_idx++)
         {
-            std::vector<cv::Point> sampled_pixels(num_samples_per_mask);
-            std::sample(masks_pixels[camera_idx][color_idx].begin(),
-                        masks_pixels[camera_idx][color_idx].end(),
-                        sampled_pixels.begin(),
-                        num_samples_per_mask,
-                        std::mt19937{std::random_device{}()});
-
-            sampled_masks_pixels[camera_idx].push_back(sampled_pixels);
+            (*masks_bits)[camera_idx][color_idx].assign(
+                masks[camera_idx][color_idx]);
         }
     }
+}
+
+//! Compute the distance transforms of the masks (reuses the memory).
+template <typename Masks>
+void to_distance_fields(const Masks &masks,
+                        PoseDetector::MasksDistanceFields *distance_fields,
+                        ThreadPool *thread_pool)
+{
+    auto compute_camera = [&masks, distance_fields](size_t camera_idx) {
+        (*distance_fields)[camera_idx].resize(masks[camera_idx].size());
+        for (size_t color_idx = 0; color_idx < masks[camera_idx].size();
+             color_idx++)
+        {
+            (*distance_fields)[camera_idx][color_idx].compute(
+                masks[camera_idx][color_idx]);
+        }
+    };
 
-    return sampled_masks_pixels;
+    if (thread_pool != nullptr && thread_pool->get_num_threads() > 1)
+    {
+        thread_pool->parallel_for(PoseDetector::N_CAMERAS, compute_camera);
+    }
+    else
+    {
+        for (size_t camera_idx = 0; camera_idx < PoseDetector::N_CAMERAS;
+             camera_idx++)
+        {
+            compute_camera(camera_idx);
+        }
+    }
 }
 
-float PoseDetector::cost_function(
-    const cv::Vec3f &position,
-    const cv::Vec3f &orientation,
+void PoseDetector::cost_function(
+    const arma::mat &candidates,
+    size_t begin,
+    size_t end,
     const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
-    const MasksPixels &masks_pixels,
-    const float distance_cost_scaling,
-    const float invisibility_cost_scaling,
-    const float height_cost_scaling)
+    const MasksCoordinates &masks_coordinates,
+    arma::vec *costs) const
 {
-    float cost = 0.;
-
-    cv::Affine3f cube_pose_world = cv::Affine3f(orientation, position);
+    const size_t num_candidates = end - begin;
+    assert(num_candidates > 0 && num_candidates <= COST_BATCH_SIZE);
 
-    cv::Mat cube_corners_world =
-        (cv::Mat(cube_pose_world.matrix) * corners_in_cube_frame_.t());
+    // the other terms are sums over the weighted pixels, keep the balance
+    const float height_cost_scaling = HEIGHT_COST_SCALING *
+                                      search_parameters_.num_samples /
+                                      NUM_OPTIMIZATION_SAMPLES;
 
-    std::vector<cv::Point3f> cube_corners_world_vec;
-    for (int j = 0; j < 8; j++)
+    std::array<cv::Affine3f, COST_BATCH_SIZE> cube_poses_world;
+    alignas(32) std::array<float, COST_BATCH_SIZE> batch_costs;
+    for (size_t lane = 0; lane < COST_BATCH_SIZE; lane++)
     {
-        cv::Vec3f cube_corner(cube_corners_world.col(j).rowRange(0, 3));
-        // std::cout << "  corner: " << cube_corner << std::endl;
-        cube_corners_world_vec.push_back(cube_corner);
+        // unused lanes are filled with the first candidate, so they do not
+        // produce any non-finite values
+        const size_t row = begin + (lane < num_candidates ? lane : 0);
+        const cv::Vec3f position(
+            candidates(row, 0), candidates(row, 1), candidates(row, 2));
+        const cv::Vec3f orientation(
+            candidates(row, 3), candidates(row, 4), candidates(row, 5));
+        cube_poses_world[lane] = cv::Affine3f(orientation, position);
+
+        // simple height cost (assume that it is more likely that the object
+        // is further down
+        batch_costs[lane] = position[2] * height_cost_scaling;
     }
 
     for (unsigned int camera_idx = 0; camera_idx < N_CAMERAS; camera_idx++)
     {
-        std::vector<cv::Point2f> imgpoints;
-        cv::projectPoints(cube_corners_world_vec,
-                          camera_orientations_[camera_idx],
-                          camera_translations_[camera_idx],
-                          camera_matrices_[camera_idx],
-                          distortion_coeffs_[camera_idx],
-                          imgpoints);
+        // image corners of the faces of the dominant colours for all
+        // candidates and the cost of faces that are not visible
+        std::array<QuadBatch, CubeModel::N_FACES> quads;
+        std::array<float, COST_BATCH_SIZE> invisibility_costs = {};
 
-        cv::Mat face_normals;
-        cv::Mat cube_corners;
-        compute_face_normals_and_corners(
-            camera_idx, cube_pose_world, &face_normals, &cube_corners);
+        for (size_t lane = 0; lane < COST_BATCH_SIZE; lane++)
+        {
+            cv::Matx<float, 3, 6> face_normals;
+            cv::Matx<float, 4, 8> cube_corners;
+            compute_face_normals_and_corners(camera_idx,
+                                             cube_poses_world[lane],
+                                             &face_normals,
+                                             &cube_corners);
+
+            std::array<cv::Point2f, 8> imgpoints;
+            camera_projections_[camera_idx].project_camera_points(cube_corners,
+                                                                  &imgpoints);
+
+            for (size_t color_idx = 0;
+                 color_idx < dominant_colors[camera_idx].size();
+                 color_idx++)
+            {
+                const PixelCoordinates &coordinates =
+                    masks_coordinates[camera_idx][color_idx];
+                if (coordinates.empty())
+                {
+                    continue;
+                }
+
+                const FaceColor color = dominant_colors[camera_idx][color_idx];
+
+                bool face_is_visible;
+                float face_normal_dot_camera_direction;
+                compute_color_visibility(color,
+                                         face_normals,
+                                         cube_corners,
+                                         &face_is_visible,
+                                         &face_normal_dot_camera_direction);
+
+                // if the face of the current color is not pointing towards
+                // the camera, penalize it with a cost base on the dot
+                // product of the face normal and the camera-to-face vector.
+                if (!face_is_visible)
+                {
+                    invisibility_costs[lane] +=
+                        face_normal_dot_camera_direction *
+                        coordinates.total_weight * INVISIBILITY_COST_SCALING;
+                }
+
+                // the corners are rounded to integer pixels, like the
+                // corners used in compute_confidence()
+                auto corner_indices =
+                    cube_model_.get_face_corner_indices(color);
+                for (size_t i = 0; i < 4; i++)
+                {
+                    const cv::Point2f &corner = imgpoints[corner_indices[i]];
+                    quads[color_idx].x[i][lane] = std::nearbyint(corner.x);
+                    quads[color_idx].y[i][lane] = std::nearbyint(corner.y);
+                }
+            }
+        }
 
         for (size_t color_idx = 0;
              color_idx < dominant_colors[camera_idx].size();
              color_idx++)
         {
-            unsigned int num_pixels =
-                masks_pixels[camera_idx][color_idx].size();
-            if (num_pixels == 0)
+            if (masks_coordinates[camera_idx][color_idx].empty())
             {
                 continue;
             }
 
-            FaceColor color = dominant_colors[camera_idx][color_idx];
-
-            bool face_is_visible;
-            float face_normal_dot_camera_direction;
-            compute_color_visibility(color,
-                                     face_normals,
-                                     cube_corners,
-                                     &face_is_visible,
-                                     &face_normal_dot_camera_direction);
+            alignas(32) std::array<float, COST_BATCH_SIZE> distance_costs = {};
+            add_quad_distance_costs(quads[color_idx],
+                                    masks_coordinates[camera_idx][color_idx],
+                                    distance_costs.data());
 
-            float distance_cost = 0;
+            for (size_t lane = 0; lane < COST_BATCH_SIZE; lane++)
             {
-                auto corner_indices =
-                    cube_model_.get_face_corner_indices(color);
+                batch_costs[lane] +=
+                    distance_costs[lane] * DISTANCE_COST_SCALING;
+            }
+        }
+
+        for (size_t lane = 0; lane < COST_BATCH_SIZE; lane++)
+        {
+            batch_costs[lane] += invisibility_costs[lane];
+        }
+    }
 
-                std::vector<cv::Point> corners = {imgpoints[corner_indices[0]],
-                                                  imgpoints[corner_indices[1]],
-                                                  imgpoints[corner_indices[2]],
-                                                  imgpoints[corner_indices[3]]};
+    for (size_t lane = 0; lane < num_candidates; lane++)
+    {
+        (*costs)(begin + lane) = batch_costs[lane];
+    }
+}
+
+void PoseDetector::distance_transform_cost_function(
+    const arma::mat &candidates,
+    size_t begin,
+    size_t end,
+    const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
+    const MasksDistanceFields &masks_distance_fields,
+    arma::vec *costs) const
+{
+    // the other terms are sums over the weighted pixels, keep the balance
+    const float height_cost_scaling = HEIGHT_COST_SCALING *
+                                      search_parameters_.num_samples /
+                                      NUM_OPTIMIZATION_SAMPLES;
+
+    for (size_t row = begin; row < end; row++)
+    {
+        const cv::Vec3f position(
+            candidates(row, 0), candidates(row, 1), candidates(row, 2));
+        const cv::Vec3f orientation(
+            candidates(row, 3), candidates(row, 4), candidates(row, 5));
+        const cv::Affine3f cube_pose_world(orientation, position);
 
-                for (const cv::Point &pixel :
-                     masks_pixels[camera_idx][color_idx])
+        // simple height cost (assume that it is more likely that the object
+        // is further down
+        float cost = position[2] * height_cost_scaling;
+
+        for (unsigned int camera_idx = 0; camera_idx < N_CAMERAS; camera_idx++)
+        {
+            cv::Matx<float, 3, 6> face_normals;
+            cv::Matx<float, 4, 8> cube_corners;
+            compute_face_normals_and_corners(
+                camera_idx, cube_pose_world, &face_normals, &cube_corners);
+
+            std::array<cv::Point2f, 8> imgpoints;
+            camera_projections_[camera_idx].project_camera_points(cube_corners,
+                                                                  &imgpoints);
+
+            for (size_t color_idx = 0;
+                 color_idx < dominant_colors[camera_idx].size();
+                 color_idx++)
+            {
+                // weight the face like in cost_function(), i.e. with the
+                // total weight of the aggregated pixels of the mask
+                const float num_pixels =
+                    aggregated_masks_coordinates_[camera_idx][color_idx]
+                        .total_weight;
+                const MaskDistanceField &distance_field =
+                    masks_distance_fields[camera_idx][color_idx];
+                if (num_pixels == 0 || distance_field.empty())
                 {
-                    double dist = cv::pointPolygonTest(corners, pixel, true);
-
-                    // negative distance means the point is outside
-                    if (dist < 0)
-                    {
-                        distance_cost += pow(-dist, 0.5);
-                    }
-                    else
-                    {
-                        // we would like the borders to be close to some
-                        // pixels. under the assumption that some parts of the
-                        // object boundaries are visible this should help
-                        // resolve ambiguities
-                        distance_cost += 0.05 * pow(dist, 0.5);
-                    }
+                    continue;
                 }
-                distance_cost *= distance_cost_scaling;
-                // std::cout << "cost (visible): " << cost << std::endl;
-            }
 
-            float invisibility_cost = 0.;
-            {
-                // if the face of the current color is not pointing towards
-                // the camera, penalize it with a cost base on the dot
-                // product of the face normal and the camera-to-face vector.
+                const FaceColor color = dominant_colors[camera_idx][color_idx];
 
+                bool face_is_visible;
+                float face_normal_dot_camera_direction;
+                compute_color_visibility(color,
+                                         face_normals,
+                                         cube_corners,
+                                         &face_is_visible,
+                                         &face_normal_dot_camera_direction);
                 if (!face_is_visible)
                 {
-                    invisibility_cost =
-                        face_normal_dot_camera_direction * num_pixels;
+                    cost += face_normal_dot_camera_direction * num_pixels *
+                            INVISIBILITY_COST_SCALING;
                 }
 
-                invisibility_cost *= invisibility_cost_scaling;
-            }
+                auto corner_indices =
+                    cube_model_.get_face_corner_indices(color);
+                std::array<cv::Point2f, 4> corners;
+                for (size_t i = 0; i < 4; i++)
+                {
+                    corners[i] = imgpoints[corner_indices[i]];
+                }
 
-            cost += distance_cost;
-            cost += invisibility_cost;
+                cost += distance_field.compute_quad_cost(corners) *
+                        num_pixels * DISTANCE_COST_SCALING;
+            }
         }
-    }
 
-    // simple height cost (assume that it is more likely that the object is
-    // further down
-    cost += position[2] * height_cost_scaling;
-
-    return cost;
+        (*costs)(row) = cost;
+    }
 }
 
 float PoseDetector::compute_confidence(
     const cv::Vec3f &position,
     const cv::Vec3f &orientation,
     const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
-    const MasksPixels &masks_pixels)
+    const MasksBits &masks_bits)
 {
     // ScopedTimer timer("compute_confidence");
 
@@ -273,16 +579,6 @@ float PoseDetector::compute_confidence(
 
     cv::Affine3f cube_pose_world = cv::Affine3f(orientation, position);
 
-    cv::Mat cube_corners_world =
-        (cv::Mat(cube_pose_world.matrix) * corners_in_cube_frame_.t());
-
-    std::vector<cv::Point3f> cube_corners_world_vec;
-    for (int j = 0; j < 8; j++)
-    {
-        cv::Vec3f cube_corner(cube_corners_world.col(j).rowRange(0, 3));
-        cube_corners_world_vec.push_back(cube_corner);
-    }
-
     unsigned int total_num_pixels = 0;
     double total_filled_visible_face_area = 0.0;
     double total_visible_face_area = 0.0;
@@ -290,19 +586,15 @@ float PoseDetector::compute_confidence(
 
     for (unsigned int camera_idx = 0; camera_idx < N_CAMERAS; camera_idx++)
     {
-        std::vector<cv::Point2f> imgpoints;
-        cv::projectPoints(cube_corners_world_vec,
-                          camera_orientations_[camera_idx],
-                          camera_translations_[camera_idx],
-                          camera_matrices_[camera_idx],
-                          distortion_coeffs_[camera_idx],
-                          imgpoints);
-
-        cv::Mat face_normals;
-        cv::Mat cube_corners;
+        cv::Matx<float, 3, 6> face_normals;
+        cv::Matx<float, 4, 8> cube_corners;
         compute_face_normals_and_corners(
             camera_idx, cube_pose_world, &face_normals, &cube_corners);
 
+        std::array<cv::Point2f, 8> imgpoints;
+        camera_projections_[camera_idx].project_camera_points(cube_corners,
+                                                              &imgpoints);
+
         unsigned int camera_num_pixels = 0;
 
         for (size_t color_idx = 0;
@@ -310,7 +602,7 @@ float PoseDetector::compute_confidence(
              color_idx++)
         {
             unsigned int num_pixels =
-                masks_pixels[camera_idx][color_idx].size();
+                masks_bits[camera_idx][color_idx].get_num_pixels();
             total_num_pixels += num_pixels;
             camera_num_pixels += num_pixels;
 
@@ -331,24 +623,16 @@ float PoseDetector::compute_confidence(
                 auto corner_indices =
                     cube_model_.get_face_corner_indices(color);
 
-                std::vector<cv::Point> corners = {imgpoints[corner_indices[0]],
-                                                  imgpoints[corner_indices[1]],
-                                                  imgpoints[corner_indices[2]],
-                                                  imgpoints[corner_indices[3]]};
+                std::array<cv::Point, 4> corners = {
+                    imgpoints[corner_indices[0]],
+                    imgpoints[corner_indices[1]],
+                    imgpoints[corner_indices[2]],
+                    imgpoints[corner_indices[3]]};
 
-                for (const cv::Point &pixel :
-                     masks_pixels[camera_idx][color_idx])
-                {
-                    double dist = cv::pointPolygonTest(corners, pixel, true);
-
-                    // negative distance means the point is outside
-                    if (dist < 0)
-                    {
-                        num_misclassified_pixels_in_segment++;
-                    }
-                }
-                int num_pixels_in_face =
-                    num_pixels - num_misclassified_pixels_in_segment;
+                int num_pixels_in_face = count_mask_pixels_in_quad(
+                    corners, masks_bits[camera_idx][color_idx]);
+                num_misclassified_pixels_in_segment =
+                    num_pixels - num_pixels_in_face;
                 total_filled_visible_face_area += num_pixels_in_face;
 
                 double face_area = cv::contourArea(corners);
@@ -417,25 +701,27 @@ arma::vec position_and_orientation2pose(const cv::Vec3f &position,
     return pose;
 }
 
+template <typename Masks>
 void PoseDetector::optimize_using_optim(
     const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
-    const std::array<std::vector<cv::Mat>, N_CAMERAS> &masks)
+    const Masks &masks,
+    ThreadPool *thread_pool,
+    TimePoint deadline)
 {
     // ScopedTimer timer("PoseDetector/optim");
 
     constexpr float SEGMENTED_PIXEL_RATIO_THRESHOLD = 0.0004;
 
+    // the prior is only valid for this call
+    const std::optional<PosePrior> prior = prior_;
+    prior_.reset();
+
     segmented_pixels_ratio_ = 0.0;
-    std::array<std::vector<std::vector<cv::Point>>, N_CAMERAS> masks_pixels;
     for (unsigned int camera_idx = 0; camera_idx < N_CAMERAS; camera_idx++)
     {
-        for (const cv::Mat &mask : masks[camera_idx])
+        for (const auto &mask : masks[camera_idx])
         {
-            std::vector<cv::Point> pixels;
-            cv::findNonZero(mask, pixels);
-            masks_pixels[camera_idx].push_back(pixels);
-
-            segmented_pixels_ratio_ += static_cast<float>(pixels.size());
+            segmented_pixels_ratio_ += static_cast<float>(get_num_pixels(mask));
         }
     }
 
@@ -452,23 +738,134 @@ void PoseDetector::optimize_using_optim(
         return;
     }
 
-    // downsample mask for computational efficiency
-    // todo: which is the right way of sampling?
-    // unsigned int num_pixels_per_mask = 15;
-    // MasksPixels sampled_masks_pixels =
-    //     sample_masks_pixels(masks_pixels, num_pixels_per_mask);
-    unsigned int num_samples = 150;
-    MasksPixels sampled_masks_pixels =
-        sample_masks_pixels_proportionally(masks_pixels, num_samples);
+    // aggregate the masks to fewer points for computational efficiency
+    aggregate_masks_pixels(
+        masks, search_parameters_.num_samples, &aggregated_masks_coordinates_);
+    to_bit_masks(masks, &masks_bits_);
+    if (objective_ == Objective::DISTANCE_TRANSFORM)
+    {
+        to_distance_fields(masks, &masks_distance_fields_, thread_pool);
+    }
+
+    // In the tracking mode, start with a small search around the prior or the
+    // previous pose if it is reliable enough.  Only if this fails, fall back
+    // to the global search.
+    if (tracking_enabled_ && (prior || confidence_ >= TRACKING_MIN_CONFIDENCE))
+    {
+        arma::vec center, spread(6);
+        if (prior)
+        {
+            center = position_and_orientation2pose(prior->pose.translation,
+                                                   prior->pose.rotation);
+            for (int i = 0; i < 3; i++)
+            {
+                spread(i) = std::clamp(PRIOR_NUM_STD * prior->position_std[i],
+                                       0.25f * TRACKING_POSITION_SPREAD,
+                                       TRACKING_POSITION_SPREAD);
+                spread(3 + i) =
+                    std::clamp(PRIOR_NUM_STD * prior->orientation_std[i],
+                               0.25f * TRACKING_ORIENTATION_SPREAD,
+                               TRACKING_ORIENTATION_SPREAD);
+            }
+        }
+        else
+        {
+            // scale the spread linearly from 1 at the confidence threshold
+            // down to 0.25 for a perfect confidence
+            const float uncertainty =
+                (1.0f - confidence_) / (1.0f - TRACKING_MIN_CONFIDENCE);
+            const float spread_scale =
+                0.25f + 0.75f * std::min(uncertainty, 1.0f);
+            const float position_spread =
+                spread_scale * TRACKING_POSITION_SPREAD;
+            const float orientation_spread =
+                spread_scale * TRACKING_ORIENTATION_SPREAD;
+
+            center = position_and_orientation2pose(position_.mean,
+                                                   orientation_.mean);
+            spread = {position_spread,
+                      position_spread,
+                      position_spread,
+                      orientation_spread,
+                      orientation_spread,
+                      orientation_spread};
+        }
 
-    // todo: what is the best value here?
-    float distance_cost_scaling = 5 * 1e-2;
-    float invisibility_cost_scaling = 1.0;
-    float height_cost_scaling = 10.0;
+        run_differential_evolution(dominant_colors,
+                                   center - spread,
+                                   center + spread,
+                                   TRACKING_NUM_GENERATIONS,
+                                   TRACKING_POPULATION_SIZE,
+                                   thread_pool,
+                                   deadline);
+        if (refinement_enabled_)
+        {
+            refine_pose(dominant_colors, masks, deadline);
+        }
 
+        confidence_ = compute_confidence(position_.mean,
+                                         orientation_.mean,
+                                         dominant_colors,
+                                         masks_bits_);
+        // without time left, the global search could not do better than the
+        // tracked pose
+        if (confidence_ >= TRACKING_MIN_CONFIDENCE ||
+            std::chrono::steady_clock::now() >= deadline)
+        {
+            return;
+        }
+    }
+
+    arma::vec initial_lb = {-0.2, -0.2, 0, -1, -1, -1};
+    arma::vec initial_ub = {0.2, 0.2, 0.2, 1, 1, 1};
+    if (triangulation_enabled_)
+    {
+        if (auto position = triangulate_centroids(get_masks_centroids(masks)))
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                initial_lb(i) = (*position)[i] - TRIANGULATION_POSITION_SPREAD;
+                initial_ub(i) = (*position)[i] + TRIANGULATION_POSITION_SPREAD;
+            }
+        }
+    }
+    // the refinement takes care of the final precision, so fewer generations
+    // are needed with it
+    const unsigned int num_generations =
+        refinement_enabled_ ? (search_parameters_.num_generations + 1) / 2
+                            : search_parameters_.num_generations;
+    run_differential_evolution(dominant_colors,
+                               initial_lb,
+                               initial_ub,
+                               num_generations,
+                               search_parameters_.population_size,
+                               thread_pool,
+                               deadline);
+    if (refinement_enabled_)
+    {
+        refine_pose(dominant_colors, masks, deadline);
+    }
+
+    confidence_ = compute_confidence(position_.mean,
+                                     orientation_.mean,
+                                     dominant_colors,
+                                     masks_bits_);
+}
+
+void PoseDetector::run_differential_evolution(
+    const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
+    const arma::vec &initial_lb,
+    const arma::vec &initial_ub,
+    unsigned int num_generations,
+    unsigned int population_size,
+    ThreadPool *thread_pool,
+    TimePoint deadline)
+{
     optim::algo_settings_t settings;
-    settings.de_settings.n_gen = 50;
-    settings.de_settings.n_pop = 40;
+    settings.de_settings.n_gen = num_generations;
+    settings.de_settings.n_pop = population_size;
+    settings.de_settings.n_stall_gen = NUM_STALL_GENERATIONS;
+    settings.de_settings.deadline = deadline;
     settings.de_settings.n_pop_best = 1;
     settings.de_settings.mutation_method = 2;
     settings.print_level = 0;
@@ -476,96 +873,345 @@ void PoseDetector::optimize_using_optim(
     settings.vals_bound = true;
     settings.lower_bounds = {-0.35, -0.35, -0.1, -1e4, -1e4, -1e4};
     settings.upper_bounds = {0.35, 0.35, 0.35, 1e4, 1e4, 1e4};
-    settings.de_settings.initial_lb = {-0.2, -0.2, 0, -1, -1, -1};
-    settings.de_settings.initial_ub = {0.2, 0.2, 0.2, 1, 1, 1};
+    // the initial population has to be inside of the bounds (the bounds are
+    // applied via a log-transform of the values)
+    settings.de_settings.initial_lb = initial_lb;
+    settings.de_settings.initial_ub = initial_ub;
+    for (size_t i = 0; i < initial_lb.n_elem; i++)
+    {
+        settings.de_settings.initial_lb(i) =
+            std::max(initial_lb(i), settings.lower_bounds(i));
+        settings.de_settings.initial_ub(i) =
+            std::min(initial_ub(i), settings.upper_bounds(i));
+    }
 
+    // only used for the size of the problem, the initial population is
+    // sampled between initial_lb and initial_ub
     arma::vec pose = {0., 0., 0.1250, 0., 0., 0.};
 
-    // std::cout << "initial_pose: " << pose.t() << std::endl;
-    // std::cout << "settings.lower_bounds " << settings.lower_bounds.t()
-    //           << std::endl;
-    // std::cout << "settings.upper_bounds " << settings.upper_bounds.t()
-    //           << std::endl;
-    // std::cout << "settings.de_settings.initial_lb "
-    //           << settings.de_settings.initial_lb.t() << std::endl;
-    // std::cout << "settings.de_settings.initial_ub "
-    //           << settings.de_settings.initial_ub.t() << std::endl;
-
-    optim::de(pose,
-              [this,
-               &dominant_colors,
-               &sampled_masks_pixels,
-               &distance_cost_scaling,
-               &invisibility_cost_scaling,
-               &height_cost_scaling](
-                  const arma::vec &pose, arma::vec * /*grad_out*/, void *
-                  /*opt_data*/) -> double {
-                  cv::Vec3f position;
-                  cv::Vec3f orientation;
-                  pose2position_and_orientation(pose, &position, &orientation);
-
-                  float cost = this->cost_function(position,
-                                                   orientation,
-                                                   dominant_colors,
-                                                   sampled_masks_pixels,
-                                                   distance_cost_scaling,
-                                                   invisibility_cost_scaling,
-                                                   height_cost_scaling);
-
-                  return cost;
-              },
-              nullptr,
-              settings);
+    // The whole population is evaluated at once, in batches of
+    // COST_BATCH_SIZE candidates.  The cost function only reads members, so
+    // the batches can be evaluated concurrently.
+    struct
+    {
+        const std::array<std::vector<FaceColor>, N_CAMERAS> *dominant_colors;
+        ThreadPool *thread_pool;
+    } context = {&dominant_colors, thread_pool};
+
+    // Only capture two pointers, so the lambda fits into the small buffer of
+    // std::function and optim::de_batch does not need to allocate memory for
+    // it.
+    optim::de_batch(
+        pose,
+        [this, &context](const arma::mat &candidates,
+                         arma::vec &costs,
+                         void * /*opt_data*/) {
+            const size_t num_candidates = candidates.n_rows;
+            const size_t num_batches =
+                (num_candidates + COST_BATCH_SIZE - 1) / COST_BATCH_SIZE;
+
+            auto evaluate_batch = [this, &context, &candidates, &costs,
+                                   num_candidates](size_t batch) {
+                const size_t begin = batch * COST_BATCH_SIZE;
+                const size_t end =
+                    std::min(begin + COST_BATCH_SIZE, num_candidates);
+                if (objective_ == Objective::DISTANCE_TRANSFORM)
+                {
+                    this->distance_transform_cost_function(
+                        candidates,
+                        begin,
+                        end,
+                        *context.dominant_colors,
+                        masks_distance_fields_,
+                        &costs);
+                }
+                else
+                {
+                    this->cost_function(candidates,
+                                        begin,
+                                        end,
+                                        *context.dominant_colors,
+                                        aggregated_masks_coordinates_,
+                                        &costs);
+                }
+            };
+
+            if (context.thread_pool != nullptr &&
+                context.thread_pool->get_num_threads() > 1)
+            {
+                context.thread_pool->parallel_for(num_batches, evaluate_batch);
+            }
+            else
+            {
+                for (size_t batch = 0; batch < num_batches; batch++)
+                {
+                    evaluate_batch(batch);
+                }
+            }
+        },
+        nullptr,
+        settings,
+        de_workspace_);
 
     pose2position_and_orientation(pose, &position_.mean, &orientation_.mean);
+}
+
+double PoseDetector::refinement_cost(
+    const cv::Vec3f &position,
+    const cv::Vec3f &orientation,
+    const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
+    const MasksCoordinates &masks_coordinates,
+    Eigen::Matrix<double, 6, 1> *gradient,
+    Eigen::Matrix<double, 6, 6> *hessian) const
+{
+    // weight of pixels inside of the face relative to pixels outside (same
+    // as in cost_function())
+    constexpr double INSIDE_WEIGHT = 0.05;
+
+    // keep the relative weight of the terms as in cost_function(), which is
+    // evaluated on a smaller sample of the pixels
+    constexpr double SAMPLE_RATIO =
+        static_cast<double>(NUM_OPTIMIZATION_SAMPLES) /
+        REFINEMENT_NUM_SAMPLES;
+
+    double cost = 0;
+    gradient->setZero();
+    hessian->setZero();
+
+    const cv::Affine3f cube_pose_world(orientation, position);
+
+    for (unsigned int camera_idx = 0; camera_idx < N_CAMERAS; camera_idx++)
+    {
+        cv::Matx<float, 3, 6> face_normals;
+        cv::Matx<float, 4, 8> cube_corners;
+        compute_face_normals_and_corners(
+            camera_idx, cube_pose_world, &face_normals, &cube_corners);
+
+        std::array<cv::Point2f, 8> imgpoints;
+        std::array<cv::Matx<float, 2, 6>, 8> jacobians;
+        project_corners_with_jacobians(
+            camera_idx, cube_pose_world, cube_corners, &imgpoints, &jacobians);
+
+        for (size_t color_idx = 0;
+             color_idx < dominant_colors[camera_idx].size();
+             color_idx++)
+        {
+            const PixelCoordinates &pixels =
+                masks_coordinates[camera_idx][color_idx];
+            if (pixels.empty())
+            {
+                continue;
+            }
+
+            FaceColor color = dominant_colors[camera_idx][color_idx];
+
+            // The visibility is not differentiable, so it only contributes
+            // to the cost.  This way, steps that turn a face away from the
+            // camera are rejected.
+            bool face_is_visible;
+            float face_normal_dot_camera_direction;
+            compute_color_visibility(color,
+                                     face_normals,
+                                     cube_corners,
+                                     &face_is_visible,
+                                     &face_normal_dot_camera_direction);
+            if (!face_is_visible)
+            {
+                cost += SAMPLE_RATIO * INVISIBILITY_COST_SCALING *
+                        face_normal_dot_camera_direction * pixels.total_weight;
+            }
+
+            const auto corner_indices =
+                cube_model_.get_face_corner_indices(color);
+            const std::array<cv::Point2f, 4> corners = {
+                imgpoints[corner_indices[0]],
+                imgpoints[corner_indices[1]],
+                imgpoints[corner_indices[2]],
+                imgpoints[corner_indices[3]]};
+
+            for (size_t k = 0; k < pixels.size(); k++)
+            {
+                std::array<cv::Vec2f, 4> distance_gradient;
+                const float distance = signed_distance_to_quad(
+                    corners,
+                    cv::Point2f(pixels.x[k], pixels.y[k]),
+                    &distance_gradient);
+
+                // Smooth variant of the cost of cost_function():  sqrt(d) is
+                // replaced by sqrt(d + 1) - 1, which has a finite derivative
+                // at the border of the face.
+                const double abs_distance = std::abs(distance);
+                const double weight = SAMPLE_RATIO * DISTANCE_COST_SCALING *
+                                      pixels.weight[k] *
+                                      (distance < 0 ? 1.0 : INSIDE_WEIGHT);
+                const double sqrt_term = std::sqrt(abs_distance + 1);
+                cost += weight * (sqrt_term - 1);
+
+                // derivative of the cost w.r.t. abs_distance
+                const double cost_derivative = weight * 0.5 / sqrt_term;
+
+                cv::Matx<float, 1, 6> distance_jacobian =
+                    cv::Matx<float, 1, 6>::zeros();
+                for (unsigned int corner = 0; corner < 4; corner++)
+                {
+                    distance_jacobian += distance_gradient[corner].t() *
+                                         jacobians[corner_indices[corner]];
+                }
+                Eigen::Matrix<double, 6, 1> g;
+                for (int j = 0; j < 6; j++)
+                {
+                    g(j) = distance_jacobian(0, j);
+                }
+
+                // Gauss-Newton approximation of the robust cost around the
+                // current distance (as in iteratively reweighted least
+                // squares)
+                *gradient += (distance < 0 ? -1.0 : 1.0) * cost_derivative * g;
+                *hessian += cost_derivative / std::max(abs_distance, 1.0) * g *
+                            g.transpose();
+            }
+        }
+    }
+
+    cost += position[2] * HEIGHT_COST_SCALING;
+    (*gradient)(2) += HEIGHT_COST_SCALING;
+
+    return cost;
+}
+
+template <typename Masks>
+void PoseDetector::refine_pose(
+    const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
+    const Masks &masks,
+    TimePoint deadline)
+{
+    aggregate_masks_pixels(
+        masks, REFINEMENT_NUM_SAMPLES, &refinement_masks_coordinates_);
+
+    cv::Vec3f position = position_.mean;
+    cv::Vec3f orientation = orientation_.mean;
+    Eigen::Matrix<double, 6, 1> gradient;
+    Eigen::Matrix<double, 6, 6> hessian;
+    double cost = refinement_cost(position,
+                                  orientation,
+                                  dominant_colors,
+                                  refinement_masks_coordinates_,
+                                  &gradient,
+                                  &hessian);
+
+    // Levenberg-Marquardt
+    double damping = 1e-3;
+    for (unsigned int i = 0; i < REFINEMENT_MAX_ITERATIONS &&
+                             std::chrono::steady_clock::now() < deadline;
+         i++)
+    {
+        Eigen::Matrix<double, 6, 6> damped_hessian = hessian;
+        damped_hessian.diagonal() += damping * hessian.diagonal();
+        // avoid a singular matrix if some directions are not constrained
+        damped_hessian.diagonal().array() += 1e-9;
+        const Eigen::Matrix<double, 6, 1> step =
+            damped_hessian.ldlt().solve(-gradient);
+
+        cv::Vec3f new_position = position;
+        cv::Vec3f new_orientation = orientation;
+        apply_pose_perturbation(step, &new_position, &new_orientation);
+
+        Eigen::Matrix<double, 6, 1> new_gradient;
+        Eigen::Matrix<double, 6, 6> new_hessian;
+        const double new_cost = refinement_cost(new_position,
+                                                new_orientation,
+                                                dominant_colors,
+                                                refinement_masks_coordinates_,
+                                                &new_gradient,
+                                                &new_hessian);
+
+        if (new_cost < cost)
+        {
+            position = new_position;
+            orientation = new_orientation;
+            cost = new_cost;
+            gradient = new_gradient;
+            hessian = new_hessian;
+            damping = std::max(damping * 0.1, 1e-7);
+
+            // stop when the steps get small (0.01 mm, 0.001 deg)
+            if (step.head<3>().norm() < 1e-5 && step.tail<3>().norm() < 2e-5)
+            {
+                break;
+            }
+        }
+        else
+        {
+            damping *= 10;
+            if (damping > 1e4)
+            {
+                break;
+            }
+        }
+    }
 
-    confidence_ = compute_confidence(
-        position_.mean, orientation_.mean, dominant_colors, masks_pixels);
+    position_.mean = position;
+    orientation_.mean = orientation;
 }
 
 Pose PoseDetector::find_pose(
     const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
-    const std::array<std::vector<cv::Mat>, N_CAMERAS> &masks)
+    const std::array<std::vector<cv::Mat>, N_CAMERAS> &masks,
+    ThreadPool *thread_pool,
+    TimePoint deadline)
 {
     // ScopedTimer timer("PoseDetector/find_pose");
 
+    for (unsigned int camera_idx = 0; camera_idx < N_CAMERAS; camera_idx++)
+    {
+        masks_pixels_[camera_idx].resize(masks[camera_idx].size());
+        for (size_t i = 0; i < masks[camera_idx].size(); i++)
+        {
+            cv::findNonZero(masks[camera_idx][i],
+                            masks_pixels_[camera_idx][i]);
+        }
+    }
+
     // calculates mean_position and mean_orientation
-    optimize_using_optim(dominant_colors, masks);
+    optimize_using_optim(dominant_colors, masks_pixels_, thread_pool, deadline);
 
     return Pose(position_.mean, orientation_.mean, confidence_);
 }
 
-std::vector<std::vector<cv::Point2f>> PoseDetector::get_projected_points() const
+Pose PoseDetector::find_pose(
+    const std::array<std::vector<FaceColor>, N_CAMERAS> &dominant_colors,
+    const SparseMasks &masks,
+    ThreadPool *thread_pool,
+    TimePoint deadline)
 {
-    std::vector<std::vector<cv::Point2f>> projected_points;
+    // the runs are used directly, without expanding them to pixels
+    optimize_using_optim(dominant_colors, masks, thread_pool, deadline);
 
-    cv::Mat pose = getPoseMatrix(orientation_.mean, position_.mean);
+    return Pose(position_.mean, orientation_.mean, confidence_);
+}
 
-    // FIXME store differently to avoid transposing here
-    cv::Mat proposed_new_cube_pts_w = pose * corners_in_cube_frame_.t();
-    proposed_new_cube_pts_w = proposed_new_cube_pts_w.t();  // 8x4
-    proposed_new_cube_pts_w = proposed_new_cube_pts_w.colRange(
-        0, proposed_new_cube_pts_w.cols - 1);  // 8x3
+std::vector<std::vector<cv::Point2f>> PoseDetector::get_projected_points() const
+{
+    return get_projected_points(Pose(position_.mean, orientation_.mean));
+}
 
-    std::vector<cv::Point3f> _new_pts;
-    for (int i = 0; i < proposed_new_cube_pts_w.rows; i++)
-    {
-        _new_pts.push_back(
-            cv::Point3f(proposed_new_cube_pts_w.at<float>(i, 0),
-                        proposed_new_cube_pts_w.at<float>(i, 1),
-                        proposed_new_cube_pts_w.at<float>(i, 2)));
-    }
+std::vector<std::vector<cv::Point2f>> PoseDetector::get_projected_points(
+    const Pose &object_pose) const
+{
+    std::vector<std::vector<cv::Point2f>> projected_points(N_CAMERAS);
+
+    cv::Affine3f cube_pose_world(object_pose.rotation, object_pose.translation);
 
     for (unsigned int i = 0; i < N_CAMERAS; i++)
-    {  // range (r_vecs)
-        std::vector<cv::Point2f> imgpoints;
-        cv::projectPoints(_new_pts,
-                          camera_orientations_[i],
-                          camera_translations_[i],
-                          camera_matrices_[i],
-                          distortion_coeffs_[i],
-                          imgpoints);
-        projected_points.push_back(imgpoints);
+    {
+        cv::Affine3f cube_pose_camera =
+            camera_projections_[i].get_world_to_camera() * cube_pose_world;
+        cv::Matx<float, 4, 8> corners =
+            cube_pose_camera.matrix * corners_in_cube_frame_;
+
+        std::array<cv::Point2f, 8> imgpoints;
+        camera_projections_[i].project_camera_points(corners, &imgpoints);
+        projected_points[i].assign(imgpoints.begin(), imgpoints.end());
     }
 
     return projected_points;
@@ -576,8 +1222,8 @@ bool PoseDetector::is_face_visible(FaceColor color,
                                    const cv::Affine3f &cube_pose_world,
                                    float *out_dot_product) const
 {
-    cv::Mat face_normals;
-    cv::Mat cube_corners;
+    cv::Matx<float, 3, 6> face_normals;
+    cv::Matx<float, 4, 8> cube_corners;
 
     compute_face_normals_and_corners(
         camera_idx, cube_pose_world, &face_normals, &cube_corners);
@@ -601,27 +1247,71 @@ bool PoseDetector::is_face_visible(FaceColor color,
 void PoseDetector::compute_face_normals_and_corners(
     const unsigned int camera_idx,
     const cv::Affine3f &cube_pose_world,
-    cv::Mat *normals,
-    cv::Mat *corners) const
+    cv::Matx<float, 3, 6> *normals,
+    cv::Matx<float, 4, 8> *corners) const
 {
-    cv::Affine3f camera_pose(camera_orientations_[camera_idx],
-                             camera_translations_[camera_idx]);
-
     // cube pose in camera frame
-    cv::Affine3f cube_pose_camera = camera_pose * cube_pose_world;
+    cv::Affine3f cube_pose_camera =
+        camera_projections_[camera_idx].get_world_to_camera() *
+        cube_pose_world;
 
     // TODO only transform the normal vector and corner that are actually used
     // rotate face normals (3x6) according to given cube pose
-    *normals = cv::Mat(cube_pose_camera.rotation()) * reference_vector_normals_;
+    *normals = cube_pose_camera.rotation() * reference_vector_normals_;
 
     // transform all cube corners according to the cube pose (4x8)
-    *corners = cv::Mat(cube_pose_camera.matrix) * corners_in_cube_frame_.t();
+    *corners = cube_pose_camera.matrix * corners_in_cube_frame_;
+}
+
+void PoseDetector::project_corners_with_jacobians(
+    unsigned int camera_idx,
+    const cv::Affine3f &cube_pose_world,
+    const cv::Matx<float, 4, 8> &cube_corners,
+    std::array<cv::Point2f, 8> *image_points,
+    std::array<cv::Matx<float, 2, 6>, 8> *jacobians) const
+{
+    const CameraProjection &projection = camera_projections_[camera_idx];
+    projection.project_camera_points(cube_corners, image_points);
+
+    const cv::Matx33f camera_rotation =
+        projection.get_world_to_camera().rotation();
+    const cv::Matx33f cube_rotation = cube_pose_world.rotation();
+
+    for (int i = 0; i < 8; i++)
+    {
+        // Derivative of the corner in world frame w.r.t. (dt, dw).  With
+        // c = R * corner, the perturbed corner is exp(dw) * c + t + dt, so
+        // the derivative is [I, -[c]_x].
+        const cv::Vec3f c =
+            cube_rotation * cv::Vec3f(corners_in_cube_frame_(0, i),
+                                      corners_in_cube_frame_(1, i),
+                                      corners_in_cube_frame_(2, i));
+        // clang-format off
+        const float world_jacobian_values[] = {
+            1, 0, 0,     0,  c[2], -c[1],
+            0, 1, 0, -c[2],     0,  c[0],
+            0, 0, 1,  c[1], -c[0],     0};
+        // clang-format on
+        const cv::Matx<float, 3, 6> world_jacobian(world_jacobian_values);
+
+        const cv::Vec3f corner_camera(
+            cube_corners(0, i), cube_corners(1, i), cube_corners(2, i));
+        if (corner_camera[2] == 0)
+        {
+            (*jacobians)[i] = cv::Matx<float, 2, 6>::zeros();
+            continue;
+        }
+
+        (*jacobians)[i] =
+            projection.project_camera_point_jacobian(corner_camera) *
+            camera_rotation * world_jacobian;
+    }
 }
 
 void PoseDetector::compute_color_visibility(
     const FaceColor &color,
-    const cv::Mat &face_normals,
-    const cv::Mat &cube_corners,
+    const cv::Matx<float, 3, 6> &face_normals,
+    const cv::Matx<float, 4, 8> &cube_corners,
     bool *is_visible,
     float *face_normal_dot_camera_direction) const
 {
@@ -631,14 +1321,18 @@ void PoseDetector::compute_color_visibility(
     // cv::Vec3f face_normal = face_normal_vectors.col(normal_idx);
     // =======
     // int normal_idx = cube_model_.map_color_to_normal_index[color];
-    cv::Vec3f face_normal = face_normals.col(normal_idx);
+    cv::Vec3f face_normal(face_normals(0, normal_idx),
+                          face_normals(1, normal_idx),
+                          face_normals(2, normal_idx));
     // >>>>>>> manuel/optimizing_cem
 
     auto corner_indices = cube_model_.get_face_corner_indices(color);
 
     // get an arbitrary corner of that face
     unsigned int corner_idx = corner_indices[0];
-    cv::Vec3f corner = cube_corners.col(corner_idx).rowRange(0, 3);
+    cv::Vec3f corner(cube_corners(0, corner_idx),
+                     cube_corners(1, corner_idx),
+                     cube_corners(2, corner_idx));
 
     // if the angle between the face normal and the camera-to-corner
     // vector is greater than 90 deg, the face is visible
@@ -676,6 +1370,92 @@ PoseDetector::get_visible_faces(unsigned int camera_idx) const
     return get_visible_faces(camera_idx, cube_pose_world);
 }
 
+std::optional<cv::Vec3f> PoseDetector::triangulate_position(
+    const MasksPixels &masks_pixels) const
+{
+    return triangulate_centroids(get_masks_centroids(masks_pixels));
+}
+
+std::optional<cv::Vec3f> PoseDetector::triangulate_position(
+    const SparseMasks &masks) const
+{
+    return triangulate_centroids(get_masks_centroids(masks));
+}
+
+std::optional<cv::Vec3f> PoseDetector::triangulate_centroids(
+    const std::array<std::optional<cv::Point2f>, N_CAMERAS> &centroids) const
+{
+    // The point with the least sum of squared distances to the rays
+    // (c_i + t * d_i) is the solution of
+    //   sum_i (I - d_i d_i^T) x = sum_i (I - d_i d_i^T) c_i
+    std::array<cv::Vec3f, N_CAMERAS> origins, directions;
+    unsigned int num_rays = 0;
+    cv::Matx33f lhs = cv::Matx33f::zeros();
+    cv::Vec3f rhs(0, 0, 0);
+    for (unsigned int camera_idx = 0; camera_idx < N_CAMERAS; camera_idx++)
+    {
+        if (!centroids[camera_idx])
+        {
+            continue;
+        }
+
+        const CameraProjection &projection = camera_projections_[camera_idx];
+        const cv::Vec3f origin = projection.get_camera_position();
+        const cv::Vec3f direction =
+            projection.unproject(centroids[camera_idx].value());
+        const cv::Matx33f projector =
+            cv::Matx33f::eye() - direction * direction.t();
+
+        lhs += projector;
+        rhs += projector * origin;
+        origins[num_rays] = origin;
+        directions[num_rays] = direction;
+        num_rays++;
+    }
+
+    if (num_rays < 2)
+    {
+        return std::nullopt;
+    }
+
+    // only singular if all rays are parallel
+    if (cv::determinant(lhs) < 1e-6f)
+    {
+        return std::nullopt;
+    }
+    const cv::Vec3f position = lhs.solve(rhs, cv::DECOMP_LU);
+
+    for (unsigned int i = 0; i < num_rays; i++)
+    {
+        const cv::Vec3f offset = position - origins[i];
+        const float ray_distance =
+            cv::norm(offset - offset.dot(directions[i]) * directions[i]);
+        if (ray_distance > TRIANGULATION_MAX_RAY_DISTANCE)
+        {
+            return std::nullopt;
+        }
+    }
+
+    return position;
+}
+
+void PoseDetector::set_search_parameters(
+    const PoseSearchParameters &parameters)
+{
+    if (parameters.num_samples == 0 || parameters.num_generations == 0)
+    {
+        throw std::invalid_argument(
+            "Number of samples and generations must be positive.");
+    }
+    // the mutation of the differential evolution needs three other members
+    if (parameters.population_size < 4)
+    {
+        throw std::invalid_argument("Population size must be at least 4.");
+    }
+
+    search_parameters_ = parameters;
+}
+
 void PoseDetector::set_pose(const Pose &pose)
 {
     position_.mean = pose.translation;
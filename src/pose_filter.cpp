@@ -0,0 +1,283 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <trifinger_object_tracking/pose_filter.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace trifinger_object_tracking
+{
+namespace
+{
+typedef Eigen::Matrix<double, 6, 6> Covariance;
+
+double to_seconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+//! Rotation corresponding to a rotation vector.
+Eigen::Quaterniond exp(const Eigen::Vector3d &rotation_vector)
+{
+    const double angle = rotation_vector.norm();
+    if (angle < 1e-12)
+    {
+        return Eigen::Quaterniond::Identity();
+    }
+    return Eigen::Quaterniond(
+        Eigen::AngleAxisd(angle, rotation_vector / angle));
+}
+
+//! Rotation vector of a rotation (with angle in [0, pi]).
+Eigen::Vector3d log(const Eigen::Quaterniond &rotation)
+{
+    const Eigen::AngleAxisd angle_axis(rotation);
+    return angle_axis.angle() * angle_axis.axis();
+}
+
+Covariance initial_covariance(double measurement_std, double velocity_std)
+{
+    Covariance covariance = Covariance::Zero();
+    covariance.topLeftCorner<3, 3>().diagonal().setConstant(
+        measurement_std * measurement_std);
+    covariance.bottomRightCorner<3, 3>().diagonal().setConstant(
+        velocity_std * velocity_std);
+    return covariance;
+}
+
+/**
+ * @brief Propagate the covariance of [value, velocity].
+ *
+ * @param motion_time_step Time for which the velocity is applied.
+ * @param time_step Time for which the process noise is added.
+ * @param acceleration_noise Spectral density of the acceleration.
+ * @param covariance The covariance that is updated.
+ */
+void propagate_covariance(double motion_time_step,
+                          double time_step,
+                          double acceleration_noise,
+                          Covariance *covariance)
+{
+    const Eigen::Matrix3d I = Eigen::Matrix3d::Identity();
+    const double dt = time_step;
+
+    Covariance transition = Covariance::Identity();
+    transition.topRightCorner<3, 3>() = motion_time_step * I;
+
+    Covariance process_noise;
+    process_noise << dt * dt * dt / 3 * I, dt * dt / 2 * I,
+        dt * dt / 2 * I, dt * I;
+    process_noise *= acceleration_noise;
+
+    *covariance =
+        transition * (*covariance) * transition.transpose() + process_noise;
+}
+
+//! Squared Mahalanobis distance of a measurement of the value.
+double squared_mahalanobis_distance(const Eigen::Vector3d &residual,
+                                    const Covariance &covariance,
+                                    double measurement_variance)
+{
+    const Eigen::Matrix3d innovation_covariance =
+        covariance.topLeftCorner<3, 3>() +
+        measurement_variance * Eigen::Matrix3d::Identity();
+    return residual.dot(innovation_covariance.inverse() * residual);
+}
+
+/**
+ * @brief Kalman update with a measurement of the value.
+ *
+ * @param residual Difference of the measurement to the predicted value.
+ * @param measurement_variance Variance of the measurement.
+ * @param covariance The covariance that is updated.
+ *
+ * @return Correction of [value, velocity].
+ */
+Eigen::Matrix<double, 6, 1> correct(const Eigen::Vector3d &residual,
+                                    double measurement_variance,
+                                    Covariance *covariance)
+{
+    const Eigen::Matrix3d innovation_covariance =
+        covariance->topLeftCorner<3, 3>() +
+        measurement_variance * Eigen::Matrix3d::Identity();
+    const Eigen::Matrix<double, 6, 3> gain =
+        covariance->leftCols<3>() * innovation_covariance.inverse();
+
+    *covariance -= gain * covariance->topRows<3>();
+    // counter numerical asymmetry
+    *covariance = 0.5 * (*covariance + covariance->transpose());
+
+    return gain * residual;
+}
+
+Eigen::Vector3d get_std(const Covariance &covariance)
+{
+    return covariance.topLeftCorner<3, 3>().diagonal().cwiseSqrt();
+}
+}  // namespace
+
+const ObjectPose &PoseFilter::update(const ObjectPose &measurement,
+                                     TimePoint time)
+{
+    const bool is_valid = measurement.confidence >= MIN_CONFIDENCE;
+
+    if (!initialised_)
+    {
+        if (is_valid)
+        {
+            initialise(measurement, time);
+        }
+        else
+        {
+            // nothing better is known
+            pose_ = measurement;
+        }
+        return pose_;
+    }
+
+    // after a longer time without measurements, the old state is of no use
+    if (is_valid &&
+        to_seconds(time - measurement_time_) > MAX_PREDICTION_TIME)
+    {
+        initialise(measurement, time);
+        return pose_;
+    }
+
+    state_ = propagate(time);
+    time_ = std::max(time, time_);
+
+    if (is_valid)
+    {
+        const double scale = 1.0 / measurement.confidence;
+        const double position_variance =
+            std::pow(scale * POSITION_MEASUREMENT_STD, 2);
+        const double orientation_variance =
+            std::pow(scale * ORIENTATION_MEASUREMENT_STD, 2);
+
+        const Eigen::Vector3d position_residual =
+            measurement.position - state_.position;
+        const Eigen::Vector3d orientation_residual =
+            log(Eigen::Quaterniond(measurement.orientation) *
+                state_.orientation.conjugate());
+
+        if (squared_mahalanobis_distance(position_residual,
+                                         state_.position_covariance,
+                                         position_variance) >
+                REINITIALISATION_THRESHOLD ||
+            squared_mahalanobis_distance(orientation_residual,
+                                         state_.orientation_covariance,
+                                         orientation_variance) >
+                REINITIALISATION_THRESHOLD)
+        {
+            initialise(measurement, time);
+            return pose_;
+        }
+
+        const Eigen::Matrix<double, 6, 1> position_correction = correct(
+            position_residual, position_variance, &state_.position_covariance);
+        const Eigen::Matrix<double, 6, 1> orientation_correction =
+            correct(orientation_residual,
+                    orientation_variance,
+                    &state_.orientation_covariance);
+
+        state_.position += position_correction.head<3>();
+        state_.velocity += position_correction.tail<3>();
+        state_.orientation =
+            (exp(orientation_correction.head<3>()) * state_.orientation)
+                .normalized();
+        state_.angular_velocity += orientation_correction.tail<3>();
+
+        measurement_time_ = time;
+        pose_.confidence = measurement.confidence;
+    }
+    else
+    {
+        pose_.confidence *= CONFIDENCE_DEGRADATION;
+    }
+
+    pose_.position = state_.position;
+    pose_.orientation = state_.orientation.coeffs();
+
+    return pose_;
+}
+
+std::optional<PoseFilter::Prediction> PoseFilter::predict(TimePoint time) const
+{
+    if (!initialised_ ||
+        to_seconds(time - measurement_time_) > MAX_PREDICTION_TIME)
+    {
+        return std::nullopt;
+    }
+
+    const State state = propagate(time);
+
+    Prediction prediction;
+    prediction.pose.position = state.position;
+    prediction.pose.orientation = state.orientation.coeffs();
+    prediction.pose.confidence = pose_.confidence;
+    prediction.position_std = get_std(state.position_covariance);
+    prediction.orientation_std = get_std(state.orientation_covariance);
+
+    return prediction;
+}
+
+void PoseFilter::reset()
+{
+    initialised_ = false;
+    pose_ = ObjectPose();
+}
+
+void PoseFilter::initialise(const ObjectPose &measurement, TimePoint time)
+{
+    const double scale = 1.0 / measurement.confidence;
+
+    state_.position = measurement.position;
+    state_.velocity.setZero();
+    state_.orientation =
+        Eigen::Quaterniond(measurement.orientation).normalized();
+    state_.angular_velocity.setZero();
+    state_.position_covariance = initial_covariance(
+        scale * POSITION_MEASUREMENT_STD, INITIAL_VELOCITY_STD);
+    state_.orientation_covariance = initial_covariance(
+        scale * ORIENTATION_MEASUREMENT_STD, INITIAL_ANGULAR_VELOCITY_STD);
+
+    time_ = time;
+    measurement_time_ = time;
+    initialised_ = true;
+
+    pose_ = measurement;
+    pose_.orientation = state_.orientation.coeffs();
+}
+
+PoseFilter::State PoseFilter::propagate(TimePoint time) const
+{
+    const double time_step = std::max(0.0, to_seconds(time - time_));
+    // the motion is only extrapolated up to MAX_PREDICTION_TIME after the
+    // last measurement, after that the pose is held (but its uncertainty
+    // still grows)
+    const double motion_time_step = std::clamp(
+        MAX_PREDICTION_TIME - to_seconds(time_ - measurement_time_),
+        0.0,
+        time_step);
+
+    State state = state_;
+    state.position += motion_time_step * state_.velocity;
+    state.orientation =
+        (exp(motion_time_step * state_.angular_velocity) * state_.orientation)
+            .normalized();
+    propagate_covariance(motion_time_step,
+                         time_step,
+                         ACCELERATION_NOISE,
+                         &state.position_covariance);
+    propagate_covariance(motion_time_step,
+                         time_step,
+                         ANGULAR_ACCELERATION_NOISE,
+                         &state.orientation_covariance);
+
+    return state;
+}
+
+}  // namespace trifinger_object_tracking
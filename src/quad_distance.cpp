@@ -0,0 +1,538 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <trifinger_object_tracking/quad_distance.hpp>
+
+#include <float.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define QUAD_DISTANCE_HAS_X86_SIMD
+#endif
+
+namespace trifinger_object_tracking
+{
+namespace
+{
+bool has_avx2()
+{
+#ifdef QUAD_DISTANCE_HAS_X86_SIMD
+    static const bool supported =
+        __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+void add_quad_distance_costs_scalar(const QuadBatch &quads,
+                                    const PixelCoordinates &pixels,
+                                    float *costs)
+{
+    for (size_t lane = 0; lane < QuadBatch::SIZE; lane++)
+    {
+        float cost = 0;
+        for (size_t k = 0; k < pixels.size(); k++)
+        {
+            const float px = pixels.x[k];
+            const float py = pixels.y[k];
+            float min_squared_distance = FLT_MAX;
+            bool is_inside = false;
+
+            for (size_t i = 0; i < 4; i++)
+            {
+                const float ax = quads.x[i][lane];
+                const float ay = quads.y[i][lane];
+                const float bx = quads.x[(i + 1) % 4][lane];
+                const float by = quads.y[(i + 1) % 4][lane];
+                const float edge_x = bx - ax;
+                const float edge_y = by - ay;
+                const float dx = px - ax;
+                const float dy = py - ay;
+
+                // closest point on the edge is a + t * edge (for a degenerate
+                // edge the dot product is zero and so is t)
+                const float t = std::clamp(
+                    (dx * edge_x + dy * edge_y) /
+                        std::max(edge_x * edge_x + edge_y * edge_y, FLT_MIN),
+                    0.f,
+                    1.f);
+                const float rx = dx - t * edge_x;
+                const float ry = dy - t * edge_y;
+                min_squared_distance =
+                    std::min(min_squared_distance, rx * rx + ry * ry);
+
+                // crossing number test
+                if ((ay > py) != (by > py) && px < ax + dy * edge_x / edge_y)
+                {
+                    is_inside = !is_inside;
+                }
+            }
+
+            const float weight = (is_inside ? 0.05f : 1.f) * pixels.weight[k];
+            cost += weight * std::sqrt(std::sqrt(min_squared_distance));
+        }
+        costs[lane] += cost;
+    }
+}
+
+//! Check if a pixel is outside of a convex quadrilateral (see
+//! count_pixels_outside_quad()).
+bool is_outside_quad(const std::array<cv::Point, 4> &corners,
+                     float px,
+                     float py)
+{
+    bool has_negative = false;
+    bool has_positive = false;
+    for (size_t i = 0; i < 4; i++)
+    {
+        const cv::Point &a = corners[i];
+        const cv::Point &b = corners[(i + 1) % 4];
+        // for coordinates below 2048 all products are exact
+        const float cross =
+            float(b.x - a.x) * (py - a.y) - float(b.y - a.y) * (px - a.x);
+        has_negative |= cross < 0;
+        has_positive |= cross > 0;
+    }
+    // inside (or on the border) if the pixel is on the same side of all edges
+    return has_negative && has_positive;
+}
+
+//! floor(a / b) for b != 0
+int64_t floor_div(int64_t a, int64_t b)
+{
+    const int64_t quotient = a / b;
+    // integer division rounds towards zero
+    return (a % b != 0 && (a < 0) != (b < 0)) ? quotient - 1 : quotient;
+}
+
+/**
+ * @brief Get the columns of a row in which the pixels are on the same side of
+ * all edges of a quadrilateral.
+ *
+ * This is the integer version of the half-plane tests of is_outside_quad():
+ * the pixels (x, row) with sign * cross(b - a, (x, row) - a) >= 0 for all
+ * edges (a, b).  As each condition is linear in x, they form one span.
+ *
+ * @param corners Corners of the quadrilateral.
+ * @param row The row.
+ * @param sign +1 or -1 for the two orientations of the quadrilateral.
+ * @param col_begin Output of the first column of the span.
+ * @param col_end Output of the last column of the span.
+ *
+ * @return False if the span is empty.
+ */
+bool get_quad_row_span(const std::array<cv::Point, 4> &corners,
+                       int row,
+                       int sign,
+                       int64_t *col_begin,
+                       int64_t *col_end)
+{
+    *col_begin = std::numeric_limits<int32_t>::min();
+    *col_end = std::numeric_limits<int32_t>::max();
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        const cv::Point &a = corners[i];
+        const cv::Point &b = corners[(i + 1) % 4];
+        const int64_t edge_x = b.x - a.x;
+        const int64_t edge_y = b.y - a.y;
+
+        // sign * cross >= 0  <=>  factor * x <= limit
+        const int64_t factor = sign * edge_y;
+        const int64_t limit = sign * (edge_x * (row - a.y) + edge_y * a.x);
+        if (factor > 0)
+        {
+            *col_end = std::min(*col_end, floor_div(limit, factor));
+        }
+        else if (factor < 0)
+        {
+            // ceil(limit / factor)
+            *col_begin = std::max(*col_begin, -floor_div(-limit, factor));
+        }
+        else if (limit < 0)
+        {
+            return false;
+        }
+    }
+
+    return *col_begin <= *col_end;
+}
+
+size_t count_pixels_outside_quad_scalar(
+    const std::array<cv::Point, 4> &corners, const PixelCoordinates &pixels)
+{
+    size_t num_outside = 0;
+    for (size_t k = 0; k < pixels.size(); k++)
+    {
+        num_outside += is_outside_quad(corners, pixels.x[k], pixels.y[k]);
+    }
+    return num_outside;
+}
+
+#ifdef QUAD_DISTANCE_HAS_X86_SIMD
+__attribute__((target("avx2,fma"))) void add_quad_distance_costs_avx2(
+    const QuadBatch &quads, const PixelCoordinates &pixels, float *costs)
+{
+    static_assert(QuadBatch::SIZE == 8, "AVX2 implementation expects 8 lanes.");
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 min_length = _mm256_set1_ps(FLT_MIN);
+    const __m256 inside_weight = _mm256_set1_ps(0.05f);
+
+    __m256 ax[4], ay[4], edge_x[4], edge_y[4], inv_squared_length[4];
+    for (int i = 0; i < 4; i++)
+    {
+        ax[i] = _mm256_load_ps(quads.x[i]);
+        ay[i] = _mm256_load_ps(quads.y[i]);
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        edge_x[i] = _mm256_sub_ps(ax[(i + 1) % 4], ax[i]);
+        edge_y[i] = _mm256_sub_ps(ay[(i + 1) % 4], ay[i]);
+        const __m256 squared_length = _mm256_fmadd_ps(
+            edge_x[i], edge_x[i], _mm256_mul_ps(edge_y[i], edge_y[i]));
+        inv_squared_length[i] =
+            _mm256_div_ps(one, _mm256_max_ps(squared_length, min_length));
+    }
+
+    __m256 cost = _mm256_setzero_ps();
+    for (size_t k = 0; k < pixels.size(); k++)
+    {
+        const __m256 px = _mm256_broadcast_ss(&pixels.x[k]);
+        const __m256 py = _mm256_broadcast_ss(&pixels.y[k]);
+        const __m256 pixel_weight = _mm256_broadcast_ss(&pixels.weight[k]);
+        __m256 min_squared_distance = _mm256_set1_ps(FLT_MAX);
+        __m256 is_inside = zero;
+
+        for (int i = 0; i < 4; i++)
+        {
+            const __m256 dx = _mm256_sub_ps(px, ax[i]);
+            const __m256 dy = _mm256_sub_ps(py, ay[i]);
+
+            __m256 t = _mm256_mul_ps(
+                _mm256_fmadd_ps(dx, edge_x[i], _mm256_mul_ps(dy, edge_y[i])),
+                inv_squared_length[i]);
+            t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+            const __m256 rx = _mm256_fnmadd_ps(t, edge_x[i], dx);
+            const __m256 ry = _mm256_fnmadd_ps(t, edge_y[i], dy);
+            min_squared_distance = _mm256_min_ps(
+                min_squared_distance,
+                _mm256_fmadd_ps(rx, rx, _mm256_mul_ps(ry, ry)));
+
+            // crossing number test (the division is only used in lanes where
+            // the edge crosses the horizontal line through the pixel, i.e.
+            // edge_y is not zero)
+            const __m256 a_above = _mm256_cmp_ps(ay[i], py, _CMP_GT_OQ);
+            const __m256 b_above =
+                _mm256_cmp_ps(ay[(i + 1) % 4], py, _CMP_GT_OQ);
+            const __m256 crosses_line = _mm256_xor_ps(a_above, b_above);
+            const __m256 safe_edge_y =
+                _mm256_blendv_ps(one, edge_y[i], crosses_line);
+            const __m256 crossing_x = _mm256_fmadd_ps(
+                dy, _mm256_div_ps(edge_x[i], safe_edge_y), ax[i]);
+            const __m256 crosses = _mm256_and_ps(
+                crosses_line, _mm256_cmp_ps(px, crossing_x, _CMP_LT_OQ));
+            is_inside = _mm256_xor_ps(is_inside, crosses);
+        }
+
+        // sqrt(distance) = rsqrt(rsqrt(squared distance)), which is much
+        // cheaper than two exact square roots (this also gives 0 for a
+        // distance of 0, as rsqrt(0) = inf and rsqrt(inf) = 0)
+        const __m256 sqrt_distance =
+            _mm256_rsqrt_ps(_mm256_rsqrt_ps(min_squared_distance));
+        const __m256 weight = _mm256_mul_ps(
+            _mm256_blendv_ps(one, inside_weight, is_inside), pixel_weight);
+        cost = _mm256_fmadd_ps(weight, sqrt_distance, cost);
+    }
+
+    _mm256_storeu_ps(costs, _mm256_add_ps(_mm256_loadu_ps(costs), cost));
+}
+
+__attribute__((target("avx2,fma"))) size_t count_pixels_outside_quad_avx2(
+    const std::array<cv::Point, 4> &corners, const PixelCoordinates &pixels)
+{
+    __m256 ax[4], ay[4], edge_x[4], edge_y[4];
+    for (int i = 0; i < 4; i++)
+    {
+        const cv::Point &a = corners[i];
+        const cv::Point &b = corners[(i + 1) % 4];
+        ax[i] = _mm256_set1_ps(a.x);
+        ay[i] = _mm256_set1_ps(a.y);
+        edge_x[i] = _mm256_set1_ps(b.x - a.x);
+        edge_y[i] = _mm256_set1_ps(b.y - a.y);
+    }
+
+    const __m256 zero = _mm256_setzero_ps();
+    const size_t num_pixels = pixels.size();
+    const size_t num_vectorized = num_pixels - num_pixels % 8;
+
+    size_t num_outside = 0;
+    for (size_t k = 0; k < num_vectorized; k += 8)
+    {
+        const __m256 px = _mm256_loadu_ps(&pixels.x[k]);
+        const __m256 py = _mm256_loadu_ps(&pixels.y[k]);
+
+        __m256 has_negative = zero;
+        __m256 has_positive = zero;
+        for (int i = 0; i < 4; i++)
+        {
+            const __m256 cross = _mm256_fmsub_ps(
+                edge_x[i],
+                _mm256_sub_ps(py, ay[i]),
+                _mm256_mul_ps(edge_y[i], _mm256_sub_ps(px, ax[i])));
+            has_negative = _mm256_or_ps(
+                has_negative, _mm256_cmp_ps(cross, zero, _CMP_LT_OQ));
+            has_positive = _mm256_or_ps(
+                has_positive, _mm256_cmp_ps(cross, zero, _CMP_GT_OQ));
+        }
+
+        const int outside =
+            _mm256_movemask_ps(_mm256_and_ps(has_negative, has_positive));
+        num_outside += __builtin_popcount(outside);
+    }
+
+    for (size_t k = num_vectorized; k < num_pixels; k++)
+    {
+        num_outside += is_outside_quad(corners, pixels.x[k], pixels.y[k]);
+    }
+
+    return num_outside;
+}
+#endif
+
+//! Pixels of one grid cell of PixelCoordinates::assign_aggregated().
+struct AggregationCell
+{
+    int64_t sum_x = 0, sum_y = 0;
+    unsigned int num_pixels = 0;
+};
+
+//! Add a point at the centroid of each non-empty cell.
+void add_cell_centroids(const std::vector<AggregationCell> &cells,
+                        float weight_scale,
+                        PixelCoordinates *coordinates)
+{
+    for (const AggregationCell &cell : cells)
+    {
+        if (cell.num_pixels > 0)
+        {
+            coordinates->x.push_back(static_cast<float>(cell.sum_x) /
+                                     cell.num_pixels);
+            coordinates->y.push_back(static_cast<float>(cell.sum_y) /
+                                     cell.num_pixels);
+            coordinates->weight.push_back(cell.num_pixels * weight_scale);
+        }
+    }
+}
+}  // namespace
+
+void PixelCoordinates::assign(const std::vector<cv::Point> &pixels)
+{
+    x.resize(pixels.size());
+    y.resize(pixels.size());
+    weight.assign(pixels.size(), 1.f);
+    for (size_t i = 0; i < pixels.size(); i++)
+    {
+        x[i] = pixels[i].x;
+        y[i] = pixels[i].y;
+    }
+    total_weight = pixels.size();
+}
+
+void PixelCoordinates::assign_aggregated(const std::vector<cv::Point> &pixels,
+                                         int cell_size,
+                                         float weight_scale)
+{
+    x.clear();
+    y.clear();
+    weight.clear();
+    total_weight = 0;
+    if (pixels.empty())
+    {
+        return;
+    }
+
+    // only the cells within the bounding box of the pixels are allocated
+    int min_col = pixels[0].x / cell_size, max_col = min_col;
+    int min_row = pixels[0].y / cell_size, max_row = min_row;
+    for (const cv::Point &pixel : pixels)
+    {
+        min_col = std::min(min_col, pixel.x / cell_size);
+        max_col = std::max(max_col, pixel.x / cell_size);
+        min_row = std::min(min_row, pixel.y / cell_size);
+        max_row = std::max(max_row, pixel.y / cell_size);
+    }
+    const int num_cols = max_col - min_col + 1;
+
+    std::vector<AggregationCell> cells(static_cast<size_t>(num_cols) *
+                                       (max_row - min_row + 1));
+    for (const cv::Point &pixel : pixels)
+    {
+        AggregationCell &cell =
+            cells[(pixel.y / cell_size - min_row) * num_cols +
+                  pixel.x / cell_size - min_col];
+        cell.sum_x += pixel.x;
+        cell.sum_y += pixel.y;
+        cell.num_pixels++;
+    }
+
+    add_cell_centroids(cells, weight_scale, this);
+    total_weight = pixels.size() * weight_scale;
+}
+
+void PixelCoordinates::assign_aggregated(const SparseMask &mask,
+                                         int cell_size,
+                                         float weight_scale)
+{
+    x.clear();
+    y.clear();
+    weight.clear();
+    total_weight = 0;
+    if (mask.empty())
+    {
+        return;
+    }
+
+    const cv::Rect bounding_box = mask.get_bounding_box();
+    const int min_col = bounding_box.x / cell_size;
+    const int max_col = (bounding_box.x + bounding_box.width - 1) / cell_size;
+    const int min_row = bounding_box.y / cell_size;
+    const int max_row = (bounding_box.y + bounding_box.height - 1) / cell_size;
+    const int num_cols = max_col - min_col + 1;
+
+    std::vector<AggregationCell> cells(static_cast<size_t>(num_cols) *
+                                       (max_row - min_row + 1));
+    for (const PixelRun &run : mask.get_runs())
+    {
+        AggregationCell *row_cells =
+            &cells[(run.row / cell_size - min_row) * num_cols];
+        // split the run at the borders of the cells
+        int begin = run.col_begin;
+        while (begin < run.col_end)
+        {
+            const int col = begin / cell_size;
+            const int end = std::min(run.col_end, (col + 1) * cell_size);
+            const int num_pixels = end - begin;
+
+            AggregationCell &cell = row_cells[col - min_col];
+            // sum of the columns begin, ..., end - 1
+            cell.sum_x += int64_t(begin + end - 1) * num_pixels / 2;
+            cell.sum_y += int64_t(run.row) * num_pixels;
+            cell.num_pixels += num_pixels;
+
+            begin = end;
+        }
+    }
+
+    add_cell_centroids(cells, weight_scale, this);
+    total_weight = mask.get_num_pixels() * weight_scale;
+}
+
+void add_quad_distance_costs(const QuadBatch &quads,
+                             const PixelCoordinates &pixels,
+                             float *costs,
+                             bool use_simd)
+{
+#ifdef QUAD_DISTANCE_HAS_X86_SIMD
+    if (use_simd && has_avx2())
+    {
+        add_quad_distance_costs_avx2(quads, pixels, costs);
+        return;
+    }
+#endif
+    (void)use_simd;
+    add_quad_distance_costs_scalar(quads, pixels, costs);
+}
+
+size_t count_pixels_outside_quad(const std::array<cv::Point, 4> &corners,
+                                 const PixelCoordinates &pixels,
+                                 bool use_simd)
+{
+#ifdef QUAD_DISTANCE_HAS_X86_SIMD
+    if (use_simd && has_avx2())
+    {
+        return count_pixels_outside_quad_avx2(corners, pixels);
+    }
+#endif
+    (void)use_simd;
+    return count_pixels_outside_quad_scalar(corners, pixels);
+}
+
+unsigned int count_mask_pixels_in_quad(const std::array<cv::Point, 4> &corners,
+                                       const BitMask &mask)
+{
+    if (mask.get_num_pixels() == 0)
+    {
+        return 0;
+    }
+
+    // only the overlap of the bounding boxes of quadrilateral and mask needs
+    // to be scanned
+    const cv::Rect &roi = mask.get_roi();
+    int min_x = roi.x, max_x = roi.x + roi.width - 1;
+    int min_y = roi.y, max_y = roi.y + roi.height - 1;
+    {
+        int quad_min_x = corners[0].x, quad_max_x = corners[0].x;
+        int quad_min_y = corners[0].y, quad_max_y = corners[0].y;
+        for (const cv::Point &corner : corners)
+        {
+            quad_min_x = std::min(quad_min_x, corner.x);
+            quad_max_x = std::max(quad_max_x, corner.x);
+            quad_min_y = std::min(quad_min_y, corner.y);
+            quad_max_y = std::max(quad_max_y, corner.y);
+        }
+        min_x = std::max(min_x, quad_min_x);
+        max_x = std::min(max_x, quad_max_x);
+        min_y = std::max(min_y, quad_min_y);
+        max_y = std::min(max_y, quad_max_y);
+    }
+
+    unsigned int count = 0;
+    for (int row = min_y; row <= max_y; row++)
+    {
+        // pixels are inside if they are on the same side of all edges, which
+        // for one of the two orientations gives the interior of the
+        // quadrilateral and for the other one is empty (unless the
+        // quadrilateral is degenerate, in which case the overlap of the spans
+        // must only be counted once)
+        int64_t begin[2], end[2];
+        bool is_set[2];
+        for (int k = 0; k < 2; k++)
+        {
+            is_set[k] = get_quad_row_span(
+                corners, row, k == 0 ? 1 : -1, &begin[k], &end[k]);
+            if (is_set[k])
+            {
+                begin[k] = std::max<int64_t>(begin[k], min_x);
+                end[k] = std::min<int64_t>(end[k], max_x);
+                is_set[k] = begin[k] <= end[k];
+            }
+            if (is_set[k])
+            {
+                count += mask.count_in_row(row, begin[k], end[k]);
+            }
+        }
+        if (is_set[0] && is_set[1])
+        {
+            const int64_t overlap_begin = std::max(begin[0], begin[1]);
+            const int64_t overlap_end = std::min(end[0], end[1]);
+            if (overlap_begin <= overlap_end)
+            {
+                count -= mask.count_in_row(row, overlap_begin, overlap_end);
+            }
+        }
+    }
+
+    return count;
+}
+
+}  // namespace trifinger_object_tracking
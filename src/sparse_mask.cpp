@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <trifinger_object_tracking/sparse_mask.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace trifinger_object_tracking
+{
+SparseMask::SparseMask(const cv::Mat &mask)
+{
+    if (mask.type() != CV_8UC1)
+    {
+        throw std::invalid_argument("Mask needs to be of type CV_8UC1.");
+    }
+
+    for (int r = 0; r < mask.rows; r++)
+    {
+        const uint8_t *row = mask.ptr<uint8_t>(r);
+        int c = 0;
+        while (c < mask.cols)
+        {
+            if (row[c] == 0)
+            {
+                c++;
+                continue;
+            }
+            const int begin = c;
+            while (c < mask.cols && row[c] != 0)
+            {
+                c++;
+            }
+            add_run(r, begin, c);
+        }
+    }
+}
+
+void SparseMask::append(const SparseMask &other)
+{
+    runs_.insert(runs_.end(), other.runs_.begin(), other.runs_.end());
+    num_pixels_ += other.num_pixels_;
+}
+
+cv::Rect SparseMask::get_bounding_box() const
+{
+    if (runs_.empty())
+    {
+        return cv::Rect();
+    }
+
+    int min_x = runs_[0].col_begin, max_x = runs_[0].col_end - 1;
+    int min_y = runs_[0].row, max_y = runs_[0].row;
+    for (const PixelRun &run : runs_)
+    {
+        min_x = std::min(min_x, run.col_begin);
+        max_x = std::max(max_x, run.col_end - 1);
+        min_y = std::min(min_y, run.row);
+        max_y = std::max(max_y, run.row);
+    }
+    return cv::Rect(min_x, min_y, max_x - min_x + 1, max_y - min_y + 1);
+}
+
+void SparseMask::get_pixels(std::vector<cv::Point> *pixels) const
+{
+    pixels->clear();
+    pixels->reserve(num_pixels_);
+    for (const PixelRun &run : runs_)
+    {
+        for (int c = run.col_begin; c < run.col_end; c++)
+        {
+            pixels->emplace_back(c, run.row);
+        }
+    }
+}
+
+cv::Mat SparseMask::to_dense(const cv::Size &size) const
+{
+    cv::Mat mask = cv::Mat::zeros(size, CV_8UC1);
+    for (const PixelRun &run : runs_)
+    {
+        uint8_t *row = mask.ptr<uint8_t>(run.row);
+        std::fill(row + run.col_begin, row + run.col_end, 255);
+    }
+    return mask;
+}
+
+}  // namespace trifinger_object_tracking
@@ -0,0 +1,270 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <trifinger_object_tracking/thread_pool.hpp>
+
+#include <algorithm>
+
+namespace trifinger_object_tracking
+{
+namespace
+{
+//! Pool to which the current thread belongs (nullptr if not a worker).
+thread_local const ThreadPool *current_pool = nullptr;
+//! Queue index of the current thread in current_pool.
+thread_local size_t current_queue_index = 0;
+}  // namespace
+
+ThreadPool::ThreadPool(unsigned int num_threads)
+{
+    if (num_threads == 0)
+    {
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    const size_t num_workers = num_threads - 1;
+    for (size_t i = 0; i < num_workers + 1; i++)
+    {
+        queues_.push_back(std::make_unique<TaskQueue>());
+    }
+    for (size_t i = 0; i < num_workers; i++)
+    {
+        workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(wake_up_mutex_);
+        stop_ = true;
+    }
+    wake_up_.notify_all();
+
+    for (std::thread &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+ThreadPool::TaskQueue::TaskQueue() : buffer_(64)
+{
+}
+
+void ThreadPool::TaskQueue::push_back(const Task &task)
+{
+    if (size_ == buffer_.size())
+    {
+        // move the tasks to the beginning of a buffer of twice the size
+        std::vector<Task> new_buffer(2 * buffer_.size());
+        for (size_t i = 0; i < size_; i++)
+        {
+            new_buffer[i] = buffer_[(begin_ + i) % buffer_.size()];
+        }
+        buffer_.swap(new_buffer);
+        begin_ = 0;
+    }
+    buffer_[(begin_ + size_) % buffer_.size()] = task;
+    size_++;
+}
+
+ThreadPool::Task ThreadPool::TaskQueue::pop_back()
+{
+    size_--;
+    return buffer_[(begin_ + size_) % buffer_.size()];
+}
+
+ThreadPool::Task ThreadPool::TaskQueue::pop_front()
+{
+    const Task task = buffer_[begin_];
+    begin_ = (begin_ + 1) % buffer_.size();
+    size_--;
+    return task;
+}
+
+void ThreadPool::run_tasks(size_t num_tasks,
+                           TaskFunction call,
+                           const void *func)
+{
+    if (num_tasks == 0)
+    {
+        return;
+    }
+
+    if (workers_.empty())
+    {
+        // same behaviour as with workers: run all tasks, then rethrow the
+        // first exception
+        std::exception_ptr error;
+        for (size_t i = 0; i < num_tasks; i++)
+        {
+            try
+            {
+                call(func, i);
+            }
+            catch (...)
+            {
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        return;
+    }
+
+    Call parent(num_tasks);
+    const size_t own_queue = get_own_queue_index();
+
+    // count the tasks before pushing them, so the counter never underflows
+    num_queued_tasks_ += num_tasks;
+
+    // Workers push to their own queue (other workers will steal from it),
+    // other threads distribute the tasks over all queues.
+    if (current_pool == this)
+    {
+        std::lock_guard<std::mutex> lock(queues_[own_queue]->mutex);
+        for (size_t i = 0; i < num_tasks; i++)
+        {
+            queues_[own_queue]->push_back({call, func, i, &parent});
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < num_tasks; i++)
+        {
+            TaskQueue &queue = *queues_[i % queues_.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.push_back({call, func, i, &parent});
+        }
+    }
+    {
+        // lock, so that no worker misses the notification between checking
+        // for tasks and going to sleep
+        std::lock_guard<std::mutex> lock(wake_up_mutex_);
+    }
+    wake_up_.notify_all();
+
+    // help until there are no queued tasks anymore
+    Task task;
+    while (parent.num_remaining > 0 && try_pop_task(own_queue, &task))
+    {
+        run_task(task);
+    }
+
+    // the remaining tasks of this call are being executed by other threads,
+    // wait for them without occupying a core
+    std::unique_lock<std::mutex> lock(parent.mutex);
+    parent.finished_condition.wait(lock, [&parent]() {
+        return parent.finished;
+    });
+
+    // no task refers to parent anymore, so it is safe to leave the scope
+    if (parent.error)
+    {
+        std::rethrow_exception(parent.error);
+    }
+}
+
+void ThreadPool::worker_loop(size_t queue_index)
+{
+    current_pool = this;
+    current_queue_index = queue_index;
+
+    Task task;
+    while (true)
+    {
+        if (try_pop_task(queue_index, &task))
+        {
+            run_task(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_up_mutex_);
+        wake_up_.wait(lock,
+                      [this]() { return stop_ || num_queued_tasks_ > 0; });
+        if (stop_)
+        {
+            return;
+        }
+    }
+}
+
+size_t ThreadPool::get_own_queue_index() const
+{
+    return current_pool == this ? current_queue_index : queues_.size() - 1;
+}
+
+bool ThreadPool::try_pop_task(size_t own_queue_index, Task *task)
+{
+    if (num_queued_tasks_ == 0)
+    {
+        return false;
+    }
+
+    // newest task of the own queue first (best cache locality), then steal
+    // the oldest task of the other queues
+    {
+        TaskQueue &queue = *queues_[own_queue_index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.empty())
+        {
+            *task = queue.pop_back();
+            num_queued_tasks_--;
+            return true;
+        }
+    }
+    for (size_t i = 1; i < queues_.size(); i++)
+    {
+        TaskQueue &queue = *queues_[(own_queue_index + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.empty())
+        {
+            *task = queue.pop_front();
+            num_queued_tasks_--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::run_task(const Task &task)
+{
+    Call &parent = *task.parent;
+
+    // The exception must not escape here:  on a worker it would terminate
+    // the program and on a calling thread, the task may belong to another
+    // call (stolen from another queue).  It is rethrown by the thread that
+    // waits for the call instead.
+    try
+    {
+        task.call(task.func, task.index);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(parent.mutex);
+        if (!parent.error)
+        {
+            parent.error = std::current_exception();
+        }
+    }
+
+    if (--parent.num_remaining == 0)
+    {
+        // parent lives on the stack of the waiting thread, which only
+        // returns once it could lock the mutex after finished is set, so it
+        // is not accessed anymore after the lock is released
+        std::lock_guard<std::mutex> lock(parent.mutex);
+        parent.finished = true;
+        parent.finished_condition.notify_one();
+    }
+}
+
+}  // namespace trifinger_object_tracking
@@ -7,13 +7,38 @@
  */
 #include <trifinger_object_tracking/tricamera_object_tracking_driver.hpp>
 
-#include <cmath>
-#include <thread>
+#include <optional>
+#include <stdexcept>
 
 #include <trifinger_cameras/parse_yml.h>
 
 namespace trifinger_object_tracking
 {
+namespace
+{
+/**
+ * @brief Get the capture time of the frame as time point of the motion
+ *     model.
+ *
+ * The timestamps of the cameras are in seconds.  Only differences of the
+ * times are used by PoseFilter, so the epoch does not matter.
+ */
+PoseFilter::TimePoint get_frame_time(
+    const TriCameraObjectObservation& observation)
+{
+    double timestamp = 0;
+    for (const auto& camera_observation : observation.cameras)
+    {
+        timestamp += camera_observation.timestamp;
+    }
+    timestamp /= observation.cameras.size();
+
+    return PoseFilter::TimePoint(
+        std::chrono::duration_cast<PoseFilter::TimePoint::duration>(
+            std::chrono::duration<double>(timestamp)));
+}
+}  // namespace
+
 // this needs to be declared here...
 constexpr std::chrono::milliseconds TriCameraObjectTrackerDriver::rate;
 
@@ -21,52 +46,228 @@ TriCameraObjectTrackerDriver::TriCameraObjectTrackerDriver(
     const std::string& device_id_1,
     const std::string& device_id_2,
     const std::string& device_id_3,
-    bool downsample_images)
+    bool downsample_images,
+    const TriCameraObjectTrackerOptions& options)
     : cameras_{trifinger_cameras::PylonDriver(device_id_1, downsample_images),
                trifinger_cameras::PylonDriver(device_id_2, downsample_images),
                trifinger_cameras::PylonDriver(device_id_3, downsample_images)},
+      // the detection runs single-threaded, so no workers are needed
       cube_detector_(
-          trifinger_object_tracking::create_trifingerpro_cube_detector()),
+          trifinger_object_tracking::create_trifingerpro_cube_detector(1)),
+      budget_controller_(rate),
       last_update_time_(std::chrono::system_clock::now()),
-      downsample_images_(downsample_images)
+      downsample_images_(downsample_images),
+      options_(options),
+      capture_queue_(QUEUE_CAPACITY),
+      preprocessed_queue_(QUEUE_CAPACITY),
+      output_queue_(QUEUE_CAPACITY)
+{
+    cube_detector_.set_roi_tracking_enabled(options.roi_tracking);
+    cube_detector_.set_pose_tracking_enabled(options.pose_tracking);
+    cube_detector_.set_pose_triangulation_enabled(options.pose_triangulation);
+
+    // start the threads only after everything else is initialised
+    capture_thread_ = std::thread(&TriCameraObjectTrackerDriver::capture_loop,
+                                  this);
+    preprocessing_thread_ =
+        std::thread(&TriCameraObjectTrackerDriver::preprocessing_loop, this);
+    detection_thread_ =
+        std::thread(&TriCameraObjectTrackerDriver::detection_loop, this);
+}
+
+TriCameraObjectTrackerDriver::~TriCameraObjectTrackerDriver()
 {
+    stop_ = true;
+    capture_queue_.close();
+    preprocessed_queue_.close();
+    output_queue_.close();
+    capture_thread_.join();
+    preprocessing_thread_.join();
+    detection_thread_.join();
 }
 
 TriCameraObjectObservation TriCameraObjectTrackerDriver::get_observation()
 {
-    last_update_time_ += this->rate;
-    std::this_thread::sleep_until(last_update_time_);
+    size_t num_discarded = 0;
+    std::optional<TriCameraObjectObservation> observation =
+        output_queue_.pop_latest(&num_discarded);
+    if (!observation)
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        if (error_)
+        {
+            std::rethrow_exception(error_);
+        }
+        throw std::runtime_error("Object tracker driver is stopped.");
+    }
+
+    num_dropped_frames_ += num_discarded;
+    observation->num_dropped_frames = num_dropped_frames_.exchange(0);
+
+    return std::move(observation.value());
+}
 
-    std::array<cv::Mat, N_CAMERAS> images_bgr;
-    TriCameraObjectObservation observation;
+TriCameraObjectTrackerDriver::QueueDepths
+TriCameraObjectTrackerDriver::get_queue_depths() const
+{
+    return {capture_queue_.size(),
+            preprocessed_queue_.size(),
+            output_queue_.size()};
+}
 
-    for (size_t i = 0; i < N_CAMERAS; i++)
+void TriCameraObjectTrackerDriver::capture_loop()
+{
+    try
     {
-        observation.cameras[i] = cameras_[i].get_observation();
+        while (!stop_)
+        {
+            last_update_time_ += this->rate;
+            std::this_thread::sleep_until(last_update_time_);
 
-        cv::cvtColor(
-            observation.cameras[i].image, images_bgr[i], cv::COLOR_BayerBG2BGR);
+            TriCameraObjectObservation observation;
+            for (size_t i = 0; i < N_CAMERAS; i++)
+            {
+                observation.cameras[i] = cameras_[i].get_observation();
+            }
+
+            if (capture_queue_.push(std::move(observation)))
+            {
+                num_dropped_frames_++;
+            }
+        }
+    }
+    catch (...)
+    {
+        set_error(std::current_exception());
     }
 
-    observation.object_pose =
-        cube_detector_.detect_cube_single_thread(images_bgr);
+    // the frames that are already captured are still processed by the
+    // following stages
+    capture_queue_.close();
+}
 
-    constexpr float FILTER_CONFIDENCE_THRESHOLD = 0.75;
-    constexpr float FILTER_CONFIDENCE_DEGRADATION = 0.9;
-    if (previous_pose_.confidence > 0 &&
-        observation.object_pose.confidence < FILTER_CONFIDENCE_THRESHOLD)
+void TriCameraObjectTrackerDriver::preprocessing_loop()
+{
+    try
     {
-        // every time a pose is reused, degrade its confidence a bit
-        previous_pose_.confidence *= FILTER_CONFIDENCE_DEGRADATION;
-        observation.filtered_object_pose = previous_pose_;
+        while (!stop_)
+        {
+            std::optional<TriCameraObjectObservation> observation =
+                capture_queue_.pop();
+            if (!observation)
+            {
+                break;
+            }
+
+            PreprocessedFrame frame;
+            for (size_t i = 0; i < N_CAMERAS; i++)
+            {
+                if (options_.segment_bayer_images)
+                {
+                    frame.images[i] = observation->cameras[i].image;
+                }
+                else
+                {
+                    cv::cvtColor(observation->cameras[i].image,
+                                 frame.images[i],
+                                 cv::COLOR_BayerBG2BGR);
+                }
+            }
+            frame.observation = std::move(observation.value());
+
+            if (preprocessed_queue_.push(std::move(frame)))
+            {
+                num_dropped_frames_++;
+            }
+        }
     }
-    else
+    catch (...)
     {
-        observation.filtered_object_pose = observation.object_pose;
-        previous_pose_ = observation.object_pose;
+        set_error(std::current_exception());
+        // without preprocessing, there is no point in capturing further
+        // frames
+        stop_ = true;
+        capture_queue_.close();
     }
 
-    return observation;
+    // the preprocessed frames are still processed by the detection
+    preprocessed_queue_.close();
+}
+
+void TriCameraObjectTrackerDriver::detection_loop()
+{
+    try
+    {
+        while (!stop_)
+        {
+            std::optional<PreprocessedFrame> frame = preprocessed_queue_.pop();
+            if (!frame)
+            {
+                break;
+            }
+
+            TriCameraObjectObservation& observation = frame->observation;
+            observation.detection_queue_depth = preprocessed_queue_.size();
+
+            cube_detector_.set_pose_search_parameters(
+                budget_controller_.get_parameters());
+            observation.pose_search_parameters =
+                budget_controller_.get_parameters();
+
+            // A new frame is captured every period and the other stages run
+            // in parallel, so to keep up, the detection has to be done within
+            // one period.
+            const std::chrono::microseconds latency_budget = this->rate;
+            const PoseFilter::TimePoint frame_time =
+                get_frame_time(observation);
+            if (options_.segment_bayer_images)
+            {
+                // segment the raw images directly at half resolution
+                observation.object_pose =
+                    cube_detector_.detect_cube_bayer_single_thread(
+                        frame->images, latency_budget, frame_time);
+            }
+            else
+            {
+                observation.object_pose =
+                    cube_detector_.detect_cube_single_thread(
+                        frame->images, latency_budget, frame_time);
+            }
+
+            const CubeDetector::StageDurations& durations =
+                cube_detector_.get_last_stage_durations();
+            budget_controller_.update(durations.segmentation,
+                                      durations.pose_estimation);
+
+            observation.filtered_object_pose =
+                cube_detector_.get_filtered_pose();
+
+            if (output_queue_.push(std::move(observation)))
+            {
+                num_dropped_frames_++;
+            }
+        }
+    }
+    catch (...)
+    {
+        set_error(std::current_exception());
+        // without detection, there is no point in capturing further frames
+        stop_ = true;
+        capture_queue_.close();
+        preprocessed_queue_.close();
+    }
+
+    // the completed observations are still returned by get_observation()
+    output_queue_.close();
+}
+
+void TriCameraObjectTrackerDriver::set_error(std::exception_ptr error)
+{
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    if (!error_)
+    {
+        error_ = error;
+    }
 }
 
 }  // namespace trifinger_object_tracking
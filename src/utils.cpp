@@ -39,4 +39,21 @@ std::array<trifinger_cameras::CameraParameters, 3> load_camera_parameters(
 
     return camera_params;
 }
+
+trifinger_cameras::CameraParameters scale_camera_parameters(
+    const trifinger_cameras::CameraParameters &camera_params, double scale)
+{
+    trifinger_cameras::CameraParameters scaled_params = camera_params;
+
+    scaled_params.image_width = camera_params.image_width * scale;
+    scaled_params.image_height = camera_params.image_height * scale;
+
+    // Pixel centre u of the original image is at u' = scale * (u + 0.5) - 0.5
+    // in the scaled image, so f' = scale * f and c' = scale * (c + 0.5) - 0.5.
+    scaled_params.camera_matrix.topRows<2>() *= scale;
+    scaled_params.camera_matrix(0, 2) += 0.5 * scale - 0.5;
+    scaled_params.camera_matrix(1, 2) += 0.5 * scale - 0.5;
+
+    return scaled_params;
+}
 }  // namespace trifinger_object_tracking
@@ -0,0 +1,428 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <trifinger_object_tracking/xgboost_batch_classifier.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define XGB_HAS_X86_SIMD
+#endif
+
+namespace trifinger_object_tracking
+{
+void XGBoostFlatModel::validate() const
+{
+    const size_t num_nodes = feature.size();
+    if (threshold.size() != num_nodes || yes.size() != num_nodes ||
+        no.size() != num_nodes || leaf_value.size() != num_nodes)
+    {
+        throw std::invalid_argument("Node arrays have different sizes.");
+    }
+    if (tree_classes.size() != tree_roots.size() ||
+        tree_depths.size() != tree_roots.size())
+    {
+        throw std::invalid_argument("Tree arrays have different sizes.");
+    }
+
+    for (size_t i = 0; i < num_nodes; i++)
+    {
+        if (feature[i] >= num_features || feature[i] < -1)
+        {
+            throw std::invalid_argument("Invalid feature index in node " +
+                                        std::to_string(i));
+        }
+        if (yes[i] < 0 || static_cast<size_t>(yes[i]) >= num_nodes ||
+            no[i] < 0 || static_cast<size_t>(no[i]) >= num_nodes)
+        {
+            throw std::invalid_argument("Invalid child index in node " +
+                                        std::to_string(i));
+        }
+        if (feature[i] == -1 &&
+            (yes[i] != static_cast<int32_t>(i) || no[i] != yes[i]))
+        {
+            throw std::invalid_argument("Leaf " + std::to_string(i) +
+                                        " does not point to itself.");
+        }
+    }
+    for (size_t t = 0; t < tree_roots.size(); t++)
+    {
+        if (tree_roots[t] < 0 ||
+            static_cast<size_t>(tree_roots[t]) >= num_nodes ||
+            tree_classes[t] < 0 || tree_classes[t] >= num_classes)
+        {
+            throw std::invalid_argument("Invalid tree " + std::to_string(t));
+        }
+    }
+}
+
+XGBoostBatchClassifier::XGBoostBatchClassifier(const XGBoostFlatModel &model)
+    : num_classes_(model.num_classes),
+      tree_classes_(model.tree_classes)
+{
+    model.validate();
+    if (model.num_features > XGB_NUM_FEATURES ||
+        model.num_classes > XGB_NUM_CLASSES)
+    {
+        throw std::invalid_argument(
+            "Model has too many features or classes for pixel "
+            "classification.");
+    }
+
+    // Reorder the nodes of each tree in breadth-first order, so that the two
+    // children of a split are always next to each other.  The traversal
+    // takes a fixed number of steps per tree, so the depth of each tree is
+    // determined on the way and checked against the model.
+    std::vector<int32_t> old_index;
+    std::vector<int32_t> node_depth;
+    std::vector<int32_t> new_index(model.feature.size(), -1);
+    auto add_node = [&old_index, &node_depth, &new_index](int32_t node,
+                                                           int32_t depth) {
+        if (new_index[node] != -1)
+        {
+            throw std::invalid_argument(
+                "Nodes are shared between trees or form a cycle.");
+        }
+        new_index[node] = old_index.size();
+        old_index.push_back(node);
+        node_depth.push_back(depth);
+    };
+    for (size_t t = 0; t < model.tree_roots.size(); t++)
+    {
+        tree_roots_.push_back(old_index.size());
+        add_node(model.tree_roots[t], 0);
+        // nodes are added in order of their depth, so the last one is the
+        // deepest
+        for (size_t i = tree_roots_.back(); i < old_index.size(); i++)
+        {
+            const int32_t node = old_index[i];
+            if (model.feature[node] >= 0)
+            {
+                add_node(model.yes[node], node_depth[i] + 1);
+                add_node(model.no[node], node_depth[i] + 1);
+            }
+        }
+
+        tree_depths_.push_back(node_depth.back());
+        if (tree_depths_.back() != model.tree_depths[t])
+        {
+            throw std::invalid_argument("Depth of tree " + std::to_string(t) +
+                                        " does not match its nodes.");
+        }
+    }
+
+    const size_t num_nodes = old_index.size();
+    feature_.resize(num_nodes);
+    threshold_.resize(num_nodes);
+    yes_.resize(num_nodes);
+    no_.resize(num_nodes);
+    leaf_value_.resize(num_nodes);
+    cutpoint_.resize(num_nodes);
+    step_feature_.resize(num_nodes);
+    packed_nodes_.resize(num_nodes);
+    leaf_value_float_.resize(num_nodes);
+
+    for (size_t i = 0; i < num_nodes; i++)
+    {
+        const int32_t old = old_index[i];
+        feature_[i] = model.feature[old];
+        threshold_[i] = model.threshold[old];
+        yes_[i] = new_index[model.yes[old]];
+        no_[i] = new_index[model.no[old]];
+        leaf_value_[i] = model.leaf_value[old];
+        leaf_value_float_[i] = static_cast<float>(leaf_value_[i]);
+
+        // For integer features x: x < t <=> x < ceil(t)
+        double cut = std::ceil(threshold_[i]);
+        cut = std::clamp(cut,
+                         double(std::numeric_limits<int32_t>::min()),
+                         double(std::numeric_limits<int32_t>::max()));
+        cutpoint_[i] = static_cast<int32_t>(cut);
+        step_feature_[i] = std::max(feature_[i], 0);
+
+        // Pixel features are in [0, 255], so the cut point can be clamped to
+        // [0, 256].  Leaves always take the "yes" branch to themselves.
+        if (feature_[i] >= 0)
+        {
+            const int32_t packed_cut = std::clamp(cutpoint_[i], 0, 256);
+            packed_nodes_[i] = yes_[i] | (feature_[i] << 20) | (packed_cut << 23);
+        }
+        else
+        {
+            packed_nodes_[i] = static_cast<int32_t>(i) | (256 << 23);
+            cutpoint_[i] = std::numeric_limits<int32_t>::max();
+        }
+    }
+
+    std::vector<int> trees_per_class(num_classes_, 0);
+    for (int32_t c : tree_classes_)
+    {
+        trees_per_class[c]++;
+    }
+    one_tree_per_class_ = std::all_of(trees_per_class.begin(),
+                                      trees_per_class.end(),
+                                      [](int n) { return n <= 1; });
+
+    set_use_simd(true);
+}
+
+void XGBoostBatchClassifier::set_use_simd(bool use_simd)
+{
+#ifdef XGB_HAS_X86_SIMD
+    // packed nodes have 20 bits for the child index and 3 for the feature
+    const bool can_pack = packed_nodes_.size() < (1u << 20) &&
+                          XGB_NUM_FEATURES <= 8;
+    use_simd_ = use_simd && can_pack && __builtin_cpu_supports("avx2");
+#else
+    (void)use_simd;
+    use_simd_ = false;
+#endif
+}
+
+std::shared_ptr<const XGBoostBatchClassifier>
+XGBoostBatchClassifier::get_compiled()
+{
+    // thread-safe initialisation of static local variables is guaranteed
+    static std::shared_ptr<const XGBoostBatchClassifier> classifier =
+        std::make_shared<XGBoostBatchClassifier>(get_compiled_xgb_flat_model());
+    return classifier;
+}
+
+void XGBoostBatchClassifier::classify_pixels(const uint8_t *bgr,
+                                             const uint8_t *hsv,
+                                             int num_pixels,
+                                             uint8_t *labels) const
+{
+    alignas(32) int32_t features[XGB_NUM_FEATURES * BATCH_SIZE] = {};
+    // reused across calls to avoid an allocation per call
+    thread_local std::vector<int32_t> leaves;
+    leaves.resize(tree_roots_.size() * BATCH_SIZE);
+
+    for (int begin = 0; begin < num_pixels; begin += BATCH_SIZE)
+    {
+        const int batch_size = std::min(BATCH_SIZE, num_pixels - begin);
+
+        // transpose to [feature][pixel] (padding of the last batch keeps the
+        // values of the previous batch, they are ignored)
+        for (int lane = 0; lane < batch_size; lane++)
+        {
+            const int p = 3 * (begin + lane);
+            features[0 * BATCH_SIZE + lane] = bgr[p + 0];
+            features[1 * BATCH_SIZE + lane] = bgr[p + 1];
+            features[2 * BATCH_SIZE + lane] = bgr[p + 2];
+            features[3 * BATCH_SIZE + lane] = hsv[p + 0];
+            features[4 * BATCH_SIZE + lane] = hsv[p + 1];
+            features[5 * BATCH_SIZE + lane] = hsv[p + 2];
+        }
+
+        if (use_simd_)
+        {
+            alignas(32) int32_t batch_labels[BATCH_SIZE];
+            classify_batch_avx2(features, leaves.data(), batch_labels);
+
+            for (int lane = 0; lane < batch_size; lane++)
+            {
+                labels[begin + lane] = static_cast<uint8_t>(batch_labels[lane]);
+            }
+        }
+        else
+        {
+            traverse_scalar(features, leaves.data());
+
+            for (int lane = 0; lane < batch_size; lane++)
+            {
+                labels[begin + lane] =
+                    static_cast<uint8_t>(get_label(leaves.data(), lane));
+            }
+        }
+    }
+}
+
+int XGBoostBatchClassifier::classify(
+    const std::array<float, XGB_NUM_FEATURES> &sample) const
+{
+    std::array<float, XGB_NUM_CLASSES> sum;
+    sum.fill(0.0);
+
+    for (size_t t = 0; t < tree_roots_.size(); t++)
+    {
+        int32_t node = tree_roots_[t];
+        while (feature_[node] >= 0)
+        {
+            node = static_cast<double>(sample[feature_[node]]) <
+                           threshold_[node]
+                       ? yes_[node]
+                       : no_[node];
+        }
+        // same rounding as "sum[c] += <double literal>" in the generated code
+        sum[tree_classes_[t]] += leaf_value_[node];
+    }
+
+    return std::max_element(sum.begin(), sum.begin() + num_classes_) -
+           sum.begin();
+}
+
+int XGBoostBatchClassifier::get_label(const int32_t *leaves, int lane) const
+{
+    std::array<float, XGB_NUM_CLASSES> sum;
+    sum.fill(0.0);
+
+    for (size_t t = 0; t < tree_roots_.size(); t++)
+    {
+        sum[tree_classes_[t]] += leaf_value_[leaves[t * BATCH_SIZE + lane]];
+    }
+
+    return std::max_element(sum.begin(), sum.begin() + num_classes_) -
+           sum.begin();
+}
+
+void XGBoostBatchClassifier::traverse_scalar(const int32_t *features,
+                                             int32_t *leaves) const
+{
+    // Branch-free traversal using that the "no" child is next to the "yes"
+    // child.  Leaves have cut point INT32_MAX, so they point to themselves.
+    for (size_t t = 0; t < tree_roots_.size(); t++)
+    {
+        int32_t nodes[BATCH_SIZE];
+        std::fill_n(nodes, BATCH_SIZE, tree_roots_[t]);
+
+        for (int depth = 0; depth < tree_depths_[t]; depth++)
+        {
+            for (int lane = 0; lane < BATCH_SIZE; lane++)
+            {
+                const int32_t node = nodes[lane];
+                const int32_t value =
+                    features[step_feature_[node] * BATCH_SIZE + lane];
+                nodes[lane] = yes_[node] + (value >= cutpoint_[node]);
+            }
+        }
+
+        std::copy_n(nodes, BATCH_SIZE, leaves + t * BATCH_SIZE);
+    }
+}
+
+#ifdef XGB_HAS_X86_SIMD
+__attribute__((target("avx2"))) void
+XGBoostBatchClassifier::classify_batch_avx2(const int32_t *features,
+                                            int32_t *leaves,
+                                            int32_t *labels) const
+{
+    static_assert(BATCH_SIZE == 8, "AVX2 implementation expects 8 lanes.");
+
+    const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i child_mask = _mm256_set1_epi32((1 << 20) - 1);
+    const __m256i feature_mask = _mm256_set1_epi32(7);
+    const __m256i one = _mm256_set1_epi32(1);
+
+    __m256 sums[XGB_NUM_CLASSES];
+    for (int c = 0; c < num_classes_; c++)
+    {
+        sums[c] = _mm256_setzero_ps();
+    }
+
+    // The gathers of one traversal step depend on the previous step, so
+    // several trees are traversed in an interleaved way to hide the latency.
+    constexpr size_t TREE_GROUP_SIZE = 8;
+    __m256i nodes[TREE_GROUP_SIZE];
+
+    for (size_t group_begin = 0; group_begin < tree_roots_.size();
+         group_begin += TREE_GROUP_SIZE)
+    {
+        const size_t group_size =
+            std::min(TREE_GROUP_SIZE, tree_roots_.size() - group_begin);
+
+        int max_depth = 0;
+        for (size_t k = 0; k < group_size; k++)
+        {
+            nodes[k] = _mm256_set1_epi32(tree_roots_[group_begin + k]);
+            max_depth = std::max(max_depth, tree_depths_[group_begin + k]);
+        }
+
+        // leaves point to themselves, so lanes that reach a leaf early
+        // simply stay there
+        for (int depth = 0; depth < max_depth; depth++)
+        {
+            for (size_t k = 0; k < group_size; k++)
+            {
+                __m256i packed =
+                    _mm256_i32gather_epi32(packed_nodes_.data(), nodes[k], 4);
+                __m256i child = _mm256_and_si256(packed, child_mask);
+                __m256i feature = _mm256_and_si256(_mm256_srli_epi32(packed, 20),
+                                                   feature_mask);
+                __m256i cut = _mm256_srli_epi32(packed, 23);
+
+                __m256i feature_idx =
+                    _mm256_add_epi32(_mm256_slli_epi32(feature, 3), lane_ids);
+                __m256i value = _mm256_i32gather_epi32(features, feature_idx, 4);
+
+                // take_yes is -1 if value < cut, else 0, so this gives the
+                // "yes" child or the "no" child next to it
+                __m256i take_yes = _mm256_cmpgt_epi32(cut, value);
+                nodes[k] =
+                    _mm256_add_epi32(child, _mm256_add_epi32(take_yes, one));
+            }
+        }
+
+        for (size_t k = 0; k < group_size; k++)
+        {
+            const size_t t = group_begin + k;
+            if (one_tree_per_class_)
+            {
+                // 0 + leaf is exact, so this gives the same result as the
+                // double-precision sum of the generated code
+                sums[tree_classes_[t]] = _mm256_add_ps(
+                    sums[tree_classes_[t]],
+                    _mm256_i32gather_ps(leaf_value_float_.data(), nodes[k], 4));
+            }
+            else
+            {
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i *>(leaves + t * BATCH_SIZE),
+                    nodes[k]);
+            }
+        }
+    }
+
+    if (one_tree_per_class_)
+    {
+        // argmax, taking the first one in case of ties (like std::max_element)
+        __m256 best = sums[0];
+        __m256i label = _mm256_setzero_si256();
+        for (int c = 1; c < num_classes_; c++)
+        {
+            __m256 greater = _mm256_cmp_ps(sums[c], best, _CMP_GT_OQ);
+            best = _mm256_blendv_ps(best, sums[c], greater);
+            label = _mm256_blendv_epi8(
+                label, _mm256_set1_epi32(c), _mm256_castps_si256(greater));
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i *>(labels), label);
+    }
+    else
+    {
+        for (int lane = 0; lane < BATCH_SIZE; lane++)
+        {
+            labels[lane] = get_label(leaves, lane);
+        }
+    }
+}
+#else
+void XGBoostBatchClassifier::classify_batch_avx2(const int32_t *features,
+                                                 int32_t *leaves,
+                                                 int32_t *labels) const
+{
+    traverse_scalar(features, leaves);
+    for (int lane = 0; lane < BATCH_SIZE; lane++)
+    {
+        labels[lane] = get_label(leaves, lane);
+    }
+}
+#endif
+
+}  // namespace trifinger_object_tracking
@@ -0,0 +1,456 @@
+/**
+ * @file
+ * @copyright 2020, Max Planck Gesellschaft. All rights reserved.
+ * @license BSD 3-clause
+ */
+#include <trifinger_object_tracking/xgboost_model_loader.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace trifinger_object_tracking
+{
+namespace
+{
+//! Node of a tree as given in the dump.
+struct DumpNode
+{
+    bool is_leaf = false;
+    int feature = -1;
+    double threshold = 0.0;
+    int yes = -1;
+    int no = -1;
+    double leaf_value = 0.0;
+};
+
+//! Nodes of one tree by their node id.
+typedef std::map<int, DumpNode> DumpTree;
+
+//! Get the index of a feature called "f<index>".
+int parse_feature_name(const std::string &name)
+{
+    long index = -1;
+    char *end = nullptr;
+    if (name.size() > 1 && name[0] == 'f')
+    {
+        index = std::strtol(&name[1], &end, 10);
+    }
+    if (index < 0 || *end != '\0')
+    {
+        throw std::invalid_argument("Unsupported feature name '" + name +
+                                    "'.  Features have to be called f0, f1, "
+                                    "...");
+    }
+    return static_cast<int>(index);
+}
+
+//! Parse the text format of the dump ("booster[i]:" and one line per node).
+std::vector<DumpTree> parse_text_dump(const std::string &dump)
+{
+    std::vector<DumpTree> trees;
+    std::istringstream stream(dump);
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        const size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos)
+        {
+            continue;
+        }
+        const char *text = line.c_str() + begin;
+
+        if (line.compare(begin, 8, "booster[") == 0)
+        {
+            trees.emplace_back();
+            continue;
+        }
+        if (trees.empty())
+        {
+            throw std::invalid_argument("Expected 'booster[0]:' but got '" +
+                                        line + "'.");
+        }
+
+        int node_id;
+        DumpNode node;
+        if (std::sscanf(text,
+                        "%d:[f%d<%lf] yes=%d,no=%d",
+                        &node_id,
+                        &node.feature,
+                        &node.threshold,
+                        &node.yes,
+                        &node.no) == 5)
+        {
+            node.is_leaf = false;
+        }
+        else if (std::sscanf(text, "%d:leaf=%lf", &node_id, &node.leaf_value) ==
+                 2)
+        {
+            node.is_leaf = true;
+        }
+        else
+        {
+            throw std::invalid_argument("Cannot parse line '" + line + "'.");
+        }
+        trees.back()[node_id] = node;
+    }
+
+    return trees;
+}
+
+/**
+ * @brief Parser for the JSON format of the dump.
+ *
+ * Only implements the subset of JSON needed for the dump (arrays of nested
+ * node objects).  Unknown keys (e.g. "gain", "cover") are skipped.
+ */
+class JsonDumpParser
+{
+public:
+    explicit JsonDumpParser(const std::string &text) : text_(text)
+    {
+    }
+
+    std::vector<DumpTree> parse()
+    {
+        std::vector<DumpTree> trees;
+        expect('[');
+        if (!try_consume(']'))
+        {
+            do
+            {
+                trees.emplace_back();
+                parse_node(&trees.back());
+            } while (try_consume(','));
+            expect(']');
+        }
+        skip_whitespace();
+        if (pos_ != text_.size())
+        {
+            fail("Unexpected data after the end of the dump");
+        }
+        return trees;
+    }
+
+private:
+    const std::string &text_;
+    size_t pos_ = 0;
+
+    [[noreturn]] void fail(const std::string &message) const
+    {
+        throw std::invalid_argument("Invalid JSON dump: " + message +
+                                    " at position " + std::to_string(pos_) +
+                                    ".");
+    }
+
+    void skip_whitespace()
+    {
+        while (pos_ < text_.size() &&
+               std::isspace(static_cast<unsigned char>(text_[pos_])))
+        {
+            pos_++;
+        }
+    }
+
+    bool try_consume(char c)
+    {
+        skip_whitespace();
+        if (pos_ < text_.size() && text_[pos_] == c)
+        {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c)
+    {
+        if (!try_consume(c))
+        {
+            fail(std::string("Expected '") + c + "'");
+        }
+    }
+
+    std::string parse_string()
+    {
+        expect('"');
+        std::string result;
+        while (pos_ < text_.size() && text_[pos_] != '"')
+        {
+            // escaped characters are not expected in the dump, just keep the
+            // escaped character
+            if (text_[pos_] == '\\')
+            {
+                pos_++;
+            }
+            if (pos_ < text_.size())
+            {
+                result += text_[pos_++];
+            }
+        }
+        expect('"');
+        return result;
+    }
+
+    double parse_number()
+    {
+        skip_whitespace();
+        const char *begin = text_.c_str() + pos_;
+        char *end = nullptr;
+        const double value = std::strtod(begin, &end);
+        if (end == begin)
+        {
+            fail("Expected number");
+        }
+        pos_ += end - begin;
+        return value;
+    }
+
+    int parse_int()
+    {
+        const double value = parse_number();
+        if (value != static_cast<int>(value))
+        {
+            fail("Expected integer");
+        }
+        return static_cast<int>(value);
+    }
+
+    void skip_value()
+    {
+        skip_whitespace();
+        if (pos_ >= text_.size())
+        {
+            fail("Unexpected end");
+        }
+
+        const char c = text_[pos_];
+        if (c == '{' || c == '[')
+        {
+            const char close = c == '{' ? '}' : ']';
+            pos_++;
+            if (try_consume(close))
+            {
+                return;
+            }
+            do
+            {
+                if (c == '{')
+                {
+                    parse_string();
+                    expect(':');
+                }
+                skip_value();
+            } while (try_consume(','));
+            expect(close);
+        }
+        else if (c == '"')
+        {
+            parse_string();
+        }
+        else if (std::isalpha(static_cast<unsigned char>(c)))
+        {
+            // true, false, null
+            while (pos_ < text_.size() &&
+                   std::isalpha(static_cast<unsigned char>(text_[pos_])))
+            {
+                pos_++;
+            }
+        }
+        else
+        {
+            parse_number();
+        }
+    }
+
+    //! Parse a node object (including its children) and add it to the tree.
+    void parse_node(DumpTree *tree)
+    {
+        int node_id = -1;
+        DumpNode node;
+        bool has_split = false;
+
+        expect('{');
+        if (!try_consume('}'))
+        {
+            do
+            {
+                const std::string key = parse_string();
+                expect(':');
+                if (key == "nodeid")
+                {
+                    node_id = parse_int();
+                }
+                else if (key == "split")
+                {
+                    skip_whitespace();
+                    // usually the feature name but also accept a plain
+                    // index
+                    if (pos_ < text_.size() && text_[pos_] == '"')
+                    {
+                        node.feature = parse_feature_name(parse_string());
+                    }
+                    else
+                    {
+                        node.feature = parse_int();
+                    }
+                    has_split = true;
+                }
+                else if (key == "split_condition")
+                {
+                    node.threshold = parse_number();
+                }
+                else if (key == "yes")
+                {
+                    node.yes = parse_int();
+                }
+                else if (key == "no")
+                {
+                    node.no = parse_int();
+                }
+                else if (key == "leaf")
+                {
+                    node.leaf_value = parse_number();
+                    node.is_leaf = true;
+                }
+                else if (key == "children")
+                {
+                    expect('[');
+                    do
+                    {
+                        parse_node(tree);
+                    } while (try_consume(','));
+                    expect(']');
+                }
+                else
+                {
+                    skip_value();
+                }
+            } while (try_consume(','));
+            expect('}');
+        }
+
+        if (node_id < 0 || node.is_leaf == has_split)
+        {
+            fail("Incomplete node");
+        }
+        (*tree)[node_id] = node;
+    }
+};
+
+/**
+ * @brief Add the nodes of a tree to the model in depth-first order.
+ *
+ * @return Depth of the subtree (number of splits on the longest path).
+ */
+int add_subtree(const DumpTree &tree,
+                int node_id,
+                std::map<int, int32_t> *index,
+                XGBoostFlatModel *model)
+{
+    auto it = tree.find(node_id);
+    if (it == tree.end())
+    {
+        throw std::invalid_argument("Missing node " + std::to_string(node_id) +
+                                    " in tree " +
+                                    std::to_string(model->tree_roots.size()) +
+                                    ".");
+    }
+    if (index->count(node_id))
+    {
+        throw std::invalid_argument("Node " + std::to_string(node_id) +
+                                    " is referenced more than once.");
+    }
+
+    const DumpNode &node = it->second;
+    const int32_t i = static_cast<int32_t>(model->feature.size());
+    (*index)[node_id] = i;
+
+    model->feature.push_back(node.is_leaf ? -1 : node.feature);
+    model->threshold.push_back(node.is_leaf ? 0.0 : node.threshold);
+    // leaves point to themselves, children of splits are set below
+    model->yes.push_back(i);
+    model->no.push_back(i);
+    model->leaf_value.push_back(node.is_leaf ? node.leaf_value : 0.0);
+
+    if (node.is_leaf)
+    {
+        return 0;
+    }
+
+    const int yes_depth = add_subtree(tree, node.yes, index, model);
+    const int no_depth = add_subtree(tree, node.no, index, model);
+    model->yes[i] = index->at(node.yes);
+    model->no[i] = index->at(node.no);
+
+    return 1 + std::max(yes_depth, no_depth);
+}
+}  // namespace
+
+XGBoostFlatModel parse_xgb_model_dump(const std::string &dump,
+                                      int num_classes,
+                                      int num_features)
+{
+    const size_t first_char = dump.find_first_not_of(" \t\r\n");
+    if (first_char == std::string::npos)
+    {
+        throw std::invalid_argument("Model dump is empty.");
+    }
+
+    const std::vector<DumpTree> trees =
+        dump[first_char] == '[' ? JsonDumpParser(dump).parse()
+                                : parse_text_dump(dump);
+
+    if (num_classes <= 0 || trees.empty() || trees.size() % num_classes != 0)
+    {
+        throw std::invalid_argument(
+            "Number of trees is not a multiple of the number of classes.");
+    }
+
+    XGBoostFlatModel model;
+    model.num_classes = num_classes;
+    model.num_features = num_features;
+    for (const DumpTree &tree : trees)
+    {
+        std::map<int, int32_t> index;
+        const int32_t root = static_cast<int32_t>(model.feature.size());
+        const int depth = add_subtree(tree, 0, &index, &model);
+
+        if (index.size() != tree.size())
+        {
+            throw std::invalid_argument(
+                "Tree " + std::to_string(model.tree_roots.size()) +
+                " has nodes that are not reachable from the root.");
+        }
+
+        model.tree_classes.push_back(model.tree_roots.size() % num_classes);
+        model.tree_roots.push_back(root);
+        model.tree_depths.push_back(depth);
+    }
+
+    model.validate();
+
+    return model;
+}
+
+XGBoostFlatModel load_xgb_model_dump(const std::string &filename,
+                                     int num_classes,
+                                     int num_features)
+{
+    std::ifstream file(filename);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open model dump " + filename);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    return parse_xgb_model_dump(buffer.str(), num_classes, num_features);
+}
+
+}  // namespace trifinger_object_tracking
@@ -3,9 +3,11 @@
  * @brief Python bindings for the object tracker interface.
  * @copyright 2020, Max Planck Gesellschaft.  All rights reserved.
  */
+#include <pybind11/chrono.h>
 #include <pybind11/eigen.h>
 #include <pybind11/embed.h>
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
 
 #include <pybind11_opencv/cvbind.hpp>
@@ -90,23 +92,87 @@ PYBIND11_MODULE(py_object_tracker, m)
              &ObjectTrackerFrontend::has_observations,
              pybind11::call_guard<pybind11::gil_scoped_release>());
 
+    pybind11::enum_<PoseDetector::Objective>(m, "PoseObjective")
+        .value("PIXEL_DISTANCE", PoseDetector::Objective::PIXEL_DISTANCE)
+        .value("DISTANCE_TRANSFORM",
+               PoseDetector::Objective::DISTANCE_TRANSFORM);
+
+    pybind11::class_<PoseSearchParameters>(m, "PoseSearchParameters")
+        .def(pybind11::init<>())
+        .def_readwrite("num_samples", &PoseSearchParameters::num_samples)
+        .def_readwrite("population_size",
+                       &PoseSearchParameters::population_size)
+        .def_readwrite("num_generations",
+                       &PoseSearchParameters::num_generations);
+
     pybind11::class_<CubeDetector>(m, "CubeDetector")
         .def(pybind11::init<
              const std::array<std::string, CubeDetector::N_CAMERAS>>())
         .def("detect_cube_single_thread",
              &CubeDetector::detect_cube_single_thread,
+             "images"_a,
+             "latency_budget"_a = CubeDetector::NO_LATENCY_BUDGET,
+             "frame_time"_a = std::nullopt,
              pybind11::call_guard<pybind11::gil_scoped_release>())
         .def("detect_cube",
              &CubeDetector::detect_cube,
+             "images"_a,
+             "latency_budget"_a = CubeDetector::NO_LATENCY_BUDGET,
+             "frame_time"_a = std::nullopt,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("detect_cube_bayer",
+             &CubeDetector::detect_cube_bayer,
+             "images_bayer"_a,
+             "latency_budget"_a = CubeDetector::NO_LATENCY_BUDGET,
+             "frame_time"_a = std::nullopt,
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("detect_cube_bayer_single_thread",
+             &CubeDetector::detect_cube_bayer_single_thread,
+             "images_bayer"_a,
+             "latency_budget"_a = CubeDetector::NO_LATENCY_BUDGET,
+             "frame_time"_a = std::nullopt,
              pybind11::call_guard<pybind11::gil_scoped_release>())
         .def("create_debug_image",
              &CubeDetector::create_debug_image,
              "fill_faces"_a = false,
-             pybind11::call_guard<pybind11::gil_scoped_release>());
+             pybind11::call_guard<pybind11::gil_scoped_release>())
+        .def("set_roi_tracking_enabled",
+             &CubeDetector::set_roi_tracking_enabled,
+             "enable"_a)
+        .def("set_pose_tracking_enabled",
+             &CubeDetector::set_pose_tracking_enabled,
+             "enable"_a)
+        .def("set_pose_refinement_enabled",
+             &CubeDetector::set_pose_refinement_enabled,
+             "enable"_a)
+        .def("set_pose_triangulation_enabled",
+             &CubeDetector::set_pose_triangulation_enabled,
+             "enable"_a)
+        .def("set_pose_objective",
+             &CubeDetector::set_pose_objective,
+             "objective"_a)
+        .def("set_pose_search_parameters",
+             &CubeDetector::set_pose_search_parameters,
+             "parameters"_a)
+        .def("get_pose_search_parameters",
+             &CubeDetector::get_pose_search_parameters)
+        .def("get_last_stage_durations",
+             [](const CubeDetector &detector) {
+                 const CubeDetector::StageDurations &durations =
+                     detector.get_last_stage_durations();
+                 return std::make_pair(durations.segmentation,
+                                       durations.pose_estimation);
+             })
+        .def("get_filtered_pose", &CubeDetector::get_filtered_pose)
+        .def("reset_tracking", &CubeDetector::reset_tracking)
+        .def("load_color_model",
+             &CubeDetector::load_color_model,
+             "model_dump_file"_a);
 
     m.def("create_trifingerpro_cube_detector",
           &create_trifingerpro_cube_detector,
           "Create a CubeDetector for TriFingerPro robot, automatically loading "
           "the local camera calibration.",
+          "num_threads"_a = 0,
           pybind11::call_guard<pybind11::gil_scoped_release>());
 }
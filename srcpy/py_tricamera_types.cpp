@@ -50,9 +50,47 @@ PYBIND11_MODULE(py_tricamera_types, m)
                        "ObjectPose: Estimated object pose.")
         .def_readwrite("filtered_object_pose",
                        &TriCameraObjectObservation::filtered_object_pose,
-                       "ObjectPose: Filtered estimated object pose.");
+                       "ObjectPose: Filtered estimated object pose.")
+        .def_readwrite(
+            "pose_search_parameters",
+            &TriCameraObjectObservation::pose_search_parameters,
+            "PoseSearchParameters: Budget of the pose search that was used "
+            "for object_pose.")
+        .def_readwrite(
+            "detection_queue_depth",
+            &TriCameraObjectObservation::detection_queue_depth,
+            "int: Number of preprocessed frames that were waiting for the "
+            "detection when the detection of this frame started.")
+        .def_readwrite(
+            "num_dropped_frames",
+            &TriCameraObjectObservation::num_dropped_frames,
+            "int: Number of frames dropped by the pipeline since the "
+            "previous observation.");
 
 #ifdef Pylon_FOUND
+    pybind11::class_<TriCameraObjectTrackerOptions>(
+        m,
+        "TriCameraObjectTrackerOptions",
+        "Options of the object tracking of TriCameraObjectTrackerDriver.")
+        .def(pybind11::init<>())
+        .def_readwrite(
+            "segment_bayer_images",
+            &TriCameraObjectTrackerOptions::segment_bayer_images,
+            "bool: Segment the raw Bayer images at half resolution instead "
+            "of demosaicing them (not validated on real camera images yet).")
+        .def_readwrite("roi_tracking",
+                       &TriCameraObjectTrackerOptions::roi_tracking,
+                       "bool: Segment only the region of the images where "
+                       "the object is predicted.")
+        .def_readwrite("pose_tracking",
+                       &TriCameraObjectTrackerOptions::pose_tracking,
+                       "bool: Start the pose search around the predicted "
+                       "pose.")
+        .def_readwrite("pose_triangulation",
+                       &TriCameraObjectTrackerOptions::pose_triangulation,
+                       "bool: Start the global pose search around the "
+                       "triangulated position of the object.");
+
     pybind11::class_<TriCameraObjectTrackerDriver,
                      std::shared_ptr<TriCameraObjectTrackerDriver>,
                      SensorDriver<TriCameraObjectObservation>>(
@@ -60,12 +98,21 @@ PYBIND11_MODULE(py_tricamera_types, m)
         .def(pybind11::init<const std::string&,
                             const std::string&,
                             const std::string&,
-                            bool>(),
+                            bool,
+                            const TriCameraObjectTrackerOptions&>(),
              pybind11::arg("camera1"),
              pybind11::arg("camera2"),
              pybind11::arg("camera3"),
-             pybind11::arg("downsample_images") = true)
-        .def("get_observation", &TriCameraObjectTrackerDriver::get_observation);
+             pybind11::arg("downsample_images") = true,
+             pybind11::arg("options") = TriCameraObjectTrackerOptions())
+        .def("get_observation", &TriCameraObjectTrackerDriver::get_observation)
+        .def("get_queue_depths",
+             [](const TriCameraObjectTrackerDriver& driver) {
+                 const TriCameraObjectTrackerDriver::QueueDepths depths =
+                     driver.get_queue_depths();
+                 return std::make_tuple(
+                     depths.preprocessing, depths.detection, depths.output);
+             });
 #endif
 
     pybind11::class_<PyBulletTriCameraObjectTrackerDriver,
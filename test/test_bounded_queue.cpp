@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @brief Tests for BoundedQueue
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <trifinger_object_tracking/bounded_queue.hpp>
+
+using namespace trifinger_object_tracking;
+
+TEST(TestBoundedQueue, invalid_capacity)
+{
+    EXPECT_THROW(BoundedQueue<int>(0), std::invalid_argument);
+}
+
+TEST(TestBoundedQueue, fifo)
+{
+    BoundedQueue<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 3u);
+    EXPECT_EQ(queue.size(), 0u);
+
+    EXPECT_FALSE(queue.push(1));
+    EXPECT_FALSE(queue.push(2));
+    EXPECT_EQ(queue.size(), 2u);
+
+    EXPECT_EQ(queue.pop(), 1);
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_EQ(queue.size(), 0u);
+}
+
+TEST(TestBoundedQueue, drop_oldest_when_full)
+{
+    BoundedQueue<int> queue(2);
+    EXPECT_FALSE(queue.push(1));
+    EXPECT_FALSE(queue.push(2));
+    EXPECT_TRUE(queue.push(3));
+    EXPECT_EQ(queue.size(), 2u);
+
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_EQ(queue.pop(), 3);
+}
+
+TEST(TestBoundedQueue, pop_latest)
+{
+    BoundedQueue<int> queue(3);
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+
+    size_t num_discarded = 0;
+    EXPECT_EQ(queue.pop_latest(&num_discarded), 3);
+    EXPECT_EQ(num_discarded, 2u);
+    EXPECT_EQ(queue.size(), 0u);
+
+    queue.push(4);
+    EXPECT_EQ(queue.pop_latest(&num_discarded), 4);
+    EXPECT_EQ(num_discarded, 0u);
+}
+
+TEST(TestBoundedQueue, pop_waits_for_push)
+{
+    BoundedQueue<int> queue(1);
+
+    std::thread producer([&queue] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        queue.push(42);
+    });
+
+    EXPECT_EQ(queue.pop(), 42);
+    producer.join();
+}
+
+TEST(TestBoundedQueue, close_wakes_up_pop)
+{
+    BoundedQueue<int> queue(1);
+
+    std::thread consumer([&queue] {
+        EXPECT_FALSE(queue.pop());
+        EXPECT_FALSE(queue.pop_latest());
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.close();
+    consumer.join();
+
+    // pushing to a closed queue has no effect
+    EXPECT_FALSE(queue.push(1));
+    EXPECT_EQ(queue.size(), 0u);
+}
+
+TEST(TestBoundedQueue, close_keeps_elements)
+{
+    BoundedQueue<int> queue(3);
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+    queue.close();
+
+    // the remaining elements can still be popped, only then the queue
+    // reports that it is closed
+    EXPECT_EQ(queue.size(), 3u);
+    EXPECT_EQ(queue.pop(), 1);
+    size_t num_discarded = 0;
+    EXPECT_EQ(queue.pop_latest(&num_discarded), 3);
+    EXPECT_EQ(num_discarded, 1u);
+    EXPECT_FALSE(queue.pop());
+    EXPECT_FALSE(queue.pop_latest());
+}
@@ -0,0 +1,180 @@
+/**
+ * @file
+ * @brief Tests for CameraProjection
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+#include <ament_index_cpp/get_package_share_directory.hpp>
+
+#include <opencv2/core/eigen.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <trifinger_object_tracking/camera_projection.hpp>
+#include <trifinger_object_tracking/utils.hpp>
+
+using namespace trifinger_object_tracking;
+
+/**
+ * @brief Fixture loading the calibration files of all test data sets.
+ */
+class TestCameraProjection : public ::testing::Test
+{
+protected:
+    std::vector<trifinger_cameras::CameraParameters> camera_parameters_;
+
+    //! Points in the world frame covering the arena.
+    std::vector<cv::Point3f> points_;
+
+    void SetUp() override
+    {
+        std::string package_path = ament_index_cpp::get_package_share_directory(
+            "trifinger_object_tracking");
+
+        for (int object_version : {1, 2, 4})
+        {
+            std::string calib_dir = package_path +
+                                    "/test/images/pose_detection/object_v" +
+                                    std::to_string(object_version) + "/";
+            auto params = load_camera_parameters(
+                {calib_dir + "camera_calib_60.yml",
+                 calib_dir + "camera_calib_180.yml",
+                 calib_dir + "camera_calib_300.yml"});
+            camera_parameters_.insert(
+                camera_parameters_.end(), params.begin(), params.end());
+        }
+
+        for (float x = -0.2; x <= 0.2; x += 0.05)
+        {
+            for (float y = -0.2; y <= 0.2; y += 0.05)
+            {
+                for (float z = 0.0; z <= 0.2; z += 0.05)
+                {
+                    points_.emplace_back(x, y, z);
+                }
+            }
+        }
+    }
+};
+
+TEST_F(TestCameraProjection, equivalent_to_project_points)
+{
+    for (const auto &params : camera_parameters_)
+    {
+        CameraProjection projection(params);
+
+        cv::Mat camera_matrix, distortion_coeffs, rotation_matrix, rvec, tvec;
+        cv::eigen2cv(params.camera_matrix, camera_matrix);
+        cv::eigen2cv(params.distortion_coefficients, distortion_coeffs);
+        Eigen::Matrix3d rotation =
+            params.tf_world_to_camera.topLeftCorner<3, 3>();
+        Eigen::Vector3d translation =
+            params.tf_world_to_camera.topRightCorner<3, 1>();
+        cv::eigen2cv(rotation, rotation_matrix);
+        cv::Rodrigues(rotation_matrix, rvec);
+        cv::eigen2cv(translation, tvec);
+
+        std::vector<cv::Point2f> expected;
+        cv::projectPoints(
+            points_, rvec, tvec, camera_matrix, distortion_coeffs, expected);
+
+        for (size_t i = 0; i < points_.size(); i++)
+        {
+            cv::Point2f actual = projection.project(
+                cv::Vec3f(points_[i].x, points_[i].y, points_[i].z));
+
+            EXPECT_NEAR(actual.x, expected[i].x, 0.01) << points_[i];
+            EXPECT_NEAR(actual.y, expected[i].y, 0.01) << points_[i];
+        }
+    }
+}
+
+TEST_F(TestCameraProjection, project_camera_points)
+{
+    CameraProjection projection(camera_parameters_[0]);
+    const cv::Affine3f world_to_camera = projection.get_world_to_camera();
+
+    cv::Matx<float, 4, 3> points;
+    for (int i = 0; i < 3; i++)
+    {
+        cv::Vec3f point = world_to_camera * cv::Vec3f(points_[i]);
+        points(0, i) = point[0];
+        points(1, i) = point[1];
+        points(2, i) = point[2];
+        points(3, i) = 1;
+    }
+
+    std::array<cv::Point2f, 3> image_points;
+    projection.project_camera_points(points, &image_points);
+
+    for (int i = 0; i < 3; i++)
+    {
+        cv::Point2f expected = projection.project(cv::Vec3f(points_[i]));
+        EXPECT_FLOAT_EQ(image_points[i].x, expected.x);
+        EXPECT_FLOAT_EQ(image_points[i].y, expected.y);
+    }
+}
+
+TEST_F(TestCameraProjection, jacobian)
+{
+    constexpr float STEP = 1e-4;
+
+    for (const auto &params : camera_parameters_)
+    {
+        CameraProjection projection(params);
+
+        for (const cv::Point3f &point_world : points_)
+        {
+            const cv::Vec3f point =
+                projection.get_world_to_camera() * cv::Vec3f(point_world);
+            const cv::Matx<float, 2, 3> jacobian =
+                projection.project_camera_point_jacobian(point);
+
+            // compare with central differences
+            for (int j = 0; j < 3; j++)
+            {
+                cv::Vec3f step(0, 0, 0);
+                step[j] = STEP;
+                cv::Point2f difference =
+                    projection.project_camera_point(point + step) -
+                    projection.project_camera_point(point - step);
+
+                EXPECT_NEAR(jacobian(0, j),
+                            difference.x / (2 * STEP),
+                            0.01 * std::abs(jacobian(0, j)) + 1.0);
+                EXPECT_NEAR(jacobian(1, j),
+                            difference.y / (2 * STEP),
+                            0.01 * std::abs(jacobian(1, j)) + 1.0);
+            }
+        }
+    }
+}
+
+TEST_F(TestCameraProjection, unproject)
+{
+    for (const auto &params : camera_parameters_)
+    {
+        CameraProjection projection(params);
+        const cv::Vec3f camera_position = projection.get_camera_position();
+
+        for (const cv::Point3f &point_world : points_)
+        {
+            const cv::Vec3f point(point_world);
+            const cv::Vec3f direction =
+                projection.unproject(projection.project(point));
+
+            // the point has to lie on the ray
+            const cv::Vec3f offset = point - camera_position;
+            EXPECT_NEAR(cv::norm(direction), 1.0, 1e-5);
+            EXPECT_LT(cv::norm(offset - offset.dot(direction) * direction),
+                      1e-4)
+                << point_world;
+            EXPECT_GT(offset.dot(direction), 0) << point_world;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
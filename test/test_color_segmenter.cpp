@@ -6,11 +6,18 @@
 #include <gtest/gtest.h>
 #include <ament_index_cpp/get_package_share_directory.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
 #include <memory>
 #include <opencv2/opencv.hpp>
 
+#include <trifinger_object_tracking/color_lookup_table.hpp>
 #include <trifinger_object_tracking/color_segmenter.hpp>
 #include <trifinger_object_tracking/cube_model.hpp>
+#include <trifinger_object_tracking/thread_pool.hpp>
+#include <trifinger_object_tracking/xgboost_classifier.h>
 
 using namespace trifinger_object_tracking;
 
@@ -130,6 +137,458 @@ TEST_F(TestColorSegmenter, get_mask)
     }
 }
 
+TEST_F(TestColorSegmenter, get_image)
+{
+    ColorSegmenter color_segmenter(cube_model_);
+
+    cv::Mat image = images_[0].clone();
+    color_segmenter.detect_colors(image);
+
+    // the caller may reuse the buffer of the image
+    image.setTo(cv::Scalar(0, 0, 0));
+
+    cv::Mat expected_image;
+    cv::medianBlur(images_[0], expected_image, 5);
+    cv::Mat difference;
+    cv::absdiff(color_segmenter.get_image(), expected_image, difference);
+    EXPECT_EQ(cv::countNonZero(difference.reshape(1)), 0);
+}
+
+TEST_F(TestColorSegmenter, label_image)
+{
+    ColorSegmenter color_segmenter(cube_model_);
+    ThreadPool thread_pool(4);
+
+    for (size_t i = 0; i < N_IMG; i++)
+    {
+        const cv::Rect full_image(0, 0, images_[i].cols, images_[i].rows);
+        color_segmenter.detect_colors(images_[i], full_image, &thread_pool);
+
+        const cv::Mat &labels = color_segmenter.get_label_image();
+        ASSERT_EQ(labels.size(), images_[i].size());
+        ASSERT_EQ(labels.type(), CV_8UC1);
+
+        // masks, sparse masks and histogram are consistent with the label
+        // image
+        for (uint8_t label = 1; label <= FaceColor::N_COLORS; label++)
+        {
+            const FaceColor color = ColorSegmenter::get_label_color(label);
+            const cv::Mat label_mask = labels == label;
+            const cv::Mat mask = color_segmenter.get_mask(color);
+            const SparseMask &sparse_mask =
+                color_segmenter.get_sparse_mask(color);
+
+            EXPECT_EQ(cv::countNonZero(mask != label_mask), 0)
+                << "color: " << color_names_[color];
+            EXPECT_EQ(
+                cv::countNonZero(sparse_mask.to_dense(labels.size()) != mask),
+                0)
+                << "color: " << color_names_[color];
+            EXPECT_EQ(color_segmenter.get_num_pixels(color),
+                      static_cast<unsigned int>(cv::countNonZero(mask)));
+            EXPECT_EQ(sparse_mask.get_num_pixels(),
+                      color_segmenter.get_num_pixels(color));
+        }
+
+        // dominant colours are the ones with the most pixels
+        std::vector<FaceColor> dominant_colors =
+            color_segmenter.get_dominant_colors();
+        ASSERT_EQ(dominant_colors.size(), 3u);
+        for (FaceColor color : cube_model_.get_colors())
+        {
+            if (std::find(dominant_colors.begin(),
+                          dominant_colors.end(),
+                          color) == dominant_colors.end())
+            {
+                EXPECT_LE(color_segmenter.get_num_pixels(color),
+                          color_segmenter.get_num_pixels(dominant_colors[2]));
+            }
+        }
+    }
+}
+
+TEST_F(TestColorSegmenter, fused_kernel_matches_reference)
+{
+    // map label index of the xgboost model to color
+    constexpr std::array<FaceColor, FaceColor::N_COLORS> map_label_to_color = {
+        FaceColor::BLUE,
+        FaceColor::CYAN,
+        FaceColor::GREEN,
+        FaceColor::MAGENTA,
+        FaceColor::RED,
+        FaceColor::YELLOW,
+    };
+    const cv::Mat open_kernel =
+        cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(3, 3));
+
+    ColorSegmenter color_segmenter(cube_model_);
+
+    for (size_t i = 0; i < N_IMG; i++)
+    {
+        // reference: separate passes over the whole image
+        cv::Mat image_bgr, image_hsv;
+        cv::medianBlur(images_[i], image_bgr, 5);
+        cv::cvtColor(image_bgr, image_hsv, cv::COLOR_BGR2HSV);
+
+        std::array<cv::Mat, FaceColor::N_COLORS> reference_masks;
+        for (auto color : cube_model_.get_colors())
+        {
+            reference_masks[color] = cv::Mat::zeros(
+                image_bgr.rows, image_bgr.cols, CV_8UC1);
+        }
+        for (int r = 0; r < image_bgr.rows; r++)
+        {
+            for (int c = 0; c < image_bgr.cols; c++)
+            {
+                cv::Vec3b bgr = image_bgr.at<cv::Vec3b>(r, c);
+                cv::Vec3b hsv = image_hsv.at<cv::Vec3b>(r, c);
+                std::array<float, XGB_NUM_FEATURES> features = {
+                    static_cast<float>(bgr[0]),
+                    static_cast<float>(bgr[1]),
+                    static_cast<float>(bgr[2]),
+                    static_cast<float>(hsv[0]),
+                    static_cast<float>(hsv[1]),
+                    static_cast<float>(hsv[2])};
+
+                int label = xgb_classify_label(features);
+                if (label > 0)
+                {
+                    reference_masks[map_label_to_color[label - 1]]
+                        .at<uint8_t>(r, c) = 255;
+                }
+            }
+        }
+
+        color_segmenter.detect_colors(images_[i]);
+
+        for (auto color : cube_model_.get_colors())
+        {
+            cv::morphologyEx(reference_masks[color],
+                             reference_masks[color],
+                             cv::MORPH_OPEN,
+                             open_kernel);
+
+            EXPECT_EQ(cv::countNonZero(reference_masks[color] !=
+                                       color_segmenter.get_mask(color)),
+                      0)
+                << "color: " << color_names_[color];
+        }
+    }
+}
+
+TEST_F(TestColorSegmenter, lookup_table_bit_exact)
+{
+    auto lookup_table = ColorLookupTable::get_shared();
+
+    for (size_t i = 0; i < N_IMG; i++)
+    {
+        // same preprocessing as in ColorSegmenter
+        cv::Mat image_bgr, image_hsv;
+        cv::medianBlur(images_[i], image_bgr, 5);
+        cv::cvtColor(image_bgr, image_hsv, cv::COLOR_BGR2HSV);
+
+        int num_mismatches = 0;
+        for (int r = 0; r < image_bgr.rows; r++)
+        {
+            for (int c = 0; c < image_bgr.cols; c++)
+            {
+                cv::Vec3b bgr = image_bgr.at<cv::Vec3b>(r, c);
+                cv::Vec3b hsv = image_hsv.at<cv::Vec3b>(r, c);
+                std::array<float, XGB_NUM_FEATURES> features = {
+                    static_cast<float>(bgr[0]),
+                    static_cast<float>(bgr[1]),
+                    static_cast<float>(bgr[2]),
+                    static_cast<float>(hsv[0]),
+                    static_cast<float>(hsv[1]),
+                    static_cast<float>(hsv[2])};
+
+                if (lookup_table->get_label(bgr[0], bgr[1], bgr[2]) !=
+                    xgb_classify_label(features))
+                {
+                    num_mismatches++;
+                }
+            }
+        }
+        EXPECT_EQ(num_mismatches, 0);
+    }
+
+    // masks of both backends have to be identical
+    ColorSegmenter xgboost_segmenter(cube_model_,
+                                     ColorSegmenter::Backend::XGBOOST);
+    ColorSegmenter lookup_table_segmenter(
+        cube_model_, ColorSegmenter::Backend::LOOKUP_TABLE);
+    for (size_t i = 0; i < N_IMG; i++)
+    {
+        xgboost_segmenter.detect_colors(images_[i]);
+        lookup_table_segmenter.detect_colors(images_[i]);
+
+        for (auto color : cube_model_.get_colors())
+        {
+            EXPECT_EQ(cv::countNonZero(xgboost_segmenter.get_mask(color) !=
+                                       lookup_table_segmenter.get_mask(color)),
+                      0);
+        }
+    }
+}
+
+TEST_F(TestColorSegmenter, lookup_table_cache_file)
+{
+    const std::string cache_file =
+        ::testing::TempDir() + "test_color_lookup_table.bin";
+    std::remove(cache_file.c_str());
+
+    ColorLookupTable loaded_table;
+    ASSERT_FALSE(loaded_table.load(cache_file));
+
+    auto lookup_table = ColorLookupTable::get_shared();
+    lookup_table->save(cache_file);
+
+    ASSERT_TRUE(loaded_table.load(cache_file));
+    std::remove(cache_file.c_str());
+
+    for (int b = 0; b < 256; b += 5)
+    {
+        for (int g = 0; g < 256; g += 5)
+        {
+            for (int r = 0; r < 256; r += 5)
+            {
+                ASSERT_EQ(loaded_table.get_label(b, g, r),
+                          lookup_table->get_label(b, g, r));
+            }
+        }
+    }
+}
+
+TEST_F(TestColorSegmenter, lookup_table_shared_per_cache_file)
+{
+    const std::string cache_file =
+        ::testing::TempDir() + "test_shared_color_lookup_table.bin";
+    std::remove(cache_file.c_str());
+
+    // the cache file is written even if the table already exists for
+    // another cache file
+    auto lookup_table = ColorLookupTable::get_shared();
+    auto cached_lookup_table = ColorLookupTable::get_shared(cache_file);
+    ColorLookupTable loaded_table;
+    EXPECT_TRUE(loaded_table.load(cache_file));
+    std::remove(cache_file.c_str());
+
+    EXPECT_EQ(ColorLookupTable::get_shared(), lookup_table);
+    EXPECT_EQ(ColorLookupTable::get_shared(cache_file), cached_lookup_table);
+    EXPECT_EQ(cached_lookup_table->get_label(0, 0, 0),
+              lookup_table->get_label(0, 0, 0));
+}
+
+TEST_F(TestColorSegmenter, region_of_interest)
+{
+    //! Pixels at the ROI border may differ as blur and denoising do not use
+    //! pixels outside of the ROI.
+    constexpr int BORDER = 3;
+
+    ColorSegmenter full_segmenter(cube_model_);
+    ColorSegmenter roi_segmenter(cube_model_);
+
+    for (size_t i = 0; i < N_IMG; i++)
+    {
+        full_segmenter.detect_colors(images_[i]);
+
+        // ROI around the ground truth masks of the object
+        cv::Mat object_mask = cv::Mat::zeros(images_[i].size(), CV_8UC1);
+        for (auto color : cube_model_.get_colors())
+        {
+            object_mask |= masks_[i][color];
+        }
+        const cv::Rect image_rect(0, 0, images_[i].cols, images_[i].rows);
+        const cv::Rect roi =
+            (cv::boundingRect(object_mask) - cv::Point(20, 20) +
+             cv::Size(40, 40)) &
+            image_rect;
+        const cv::Rect inner_roi(roi.x + BORDER,
+                                 roi.y + BORDER,
+                                 roi.width - 2 * BORDER,
+                                 roi.height - 2 * BORDER);
+
+        roi_segmenter.detect_colors(images_[i], roi);
+        ASSERT_EQ(roi_segmenter.get_roi(), roi);
+
+        for (auto color : cube_model_.get_colors())
+        {
+            cv::Mat roi_mask = roi_segmenter.get_mask(color);
+            cv::Mat full_mask = full_segmenter.get_mask(color);
+
+            EXPECT_EQ(cv::countNonZero(roi_mask(inner_roi) !=
+                                       full_mask(inner_roi)),
+                      0)
+                << "color: " << color_names_[color];
+
+            // outside of the ROI everything is background
+            cv::Mat outside = roi_mask.clone();
+            outside(roi).setTo(0);
+            EXPECT_EQ(cv::countNonZero(outside), 0);
+        }
+
+        // the object is completely inside the ROI
+        for (auto color : roi_segmenter.get_dominant_colors())
+        {
+            EXPECT_EQ(roi_segmenter.get_num_roi_border_pixels(color), 0u);
+        }
+    }
+
+    // a small ROI in the middle of the object cuts it off
+    ColorSegmenter small_roi_segmenter(cube_model_);
+    full_segmenter.detect_colors(images_[0]);
+    cv::Mat mask = full_segmenter.get_mask(
+        full_segmenter.get_dominant_colors()[0]);
+    cv::Rect object_bbox = cv::boundingRect(mask);
+    cv::Rect small_roi(object_bbox.x + object_bbox.width / 4,
+                       object_bbox.y + object_bbox.height / 4,
+                       object_bbox.width / 2,
+                       object_bbox.height / 2);
+    small_roi_segmenter.detect_colors(images_[0], small_roi);
+    unsigned int num_border_pixels = 0;
+    for (auto color : small_roi_segmenter.get_dominant_colors())
+    {
+        num_border_pixels +=
+            small_roi_segmenter.get_num_roi_border_pixels(color);
+    }
+    EXPECT_GT(num_border_pixels, 0u);
+
+    // after a full-frame segmentation, the segmenter is reset completely
+    small_roi_segmenter.detect_colors(images_[0]);
+    for (auto color : cube_model_.get_colors())
+    {
+        EXPECT_EQ(cv::countNonZero(small_roi_segmenter.get_mask(color) !=
+                                   full_segmenter.get_mask(color)),
+                  0);
+        EXPECT_EQ(small_roi_segmenter.get_num_roi_border_pixels(color), 0u);
+    }
+}
+
+TEST_F(TestColorSegmenter, parallel_bands)
+{
+    ColorSegmenter serial_segmenter(cube_model_);
+    ColorSegmenter parallel_segmenter(cube_model_);
+    ThreadPool thread_pool(4);
+
+    for (size_t i = 0; i < N_IMG; i++)
+    {
+        const cv::Rect full_image(0, 0, images_[i].cols, images_[i].rows);
+        serial_segmenter.detect_colors(images_[i]);
+        parallel_segmenter.detect_colors(images_[i], full_image, &thread_pool);
+
+        ASSERT_EQ(parallel_segmenter.get_dominant_colors(),
+                  serial_segmenter.get_dominant_colors());
+        for (auto color : cube_model_.get_colors())
+        {
+            EXPECT_EQ(cv::countNonZero(parallel_segmenter.get_mask(color) !=
+                                       serial_segmenter.get_mask(color)),
+                      0)
+                << "color: " << color_names_[color];
+        }
+    }
+}
+
+TEST_F(TestColorSegmenter, bayer_half_resolution)
+{
+    ColorSegmenter bgr_segmenter(cube_model_);
+    ColorSegmenter bayer_segmenter(cube_model_);
+
+    for (size_t i = 0; i < N_IMG; i++)
+    {
+        // create a Bayer image (quads "R G / G B") at twice the resolution,
+        // so that each quad corresponds to one pixel of the test image
+        const cv::Mat &image = images_[i];
+        cv::Mat image_bayer(2 * image.rows, 2 * image.cols, CV_8UC1);
+        for (int r = 0; r < image.rows; r++)
+        {
+            for (int c = 0; c < image.cols; c++)
+            {
+                cv::Vec3b bgr = image.at<cv::Vec3b>(r, c);
+                image_bayer.at<uint8_t>(2 * r, 2 * c) = bgr[2];
+                image_bayer.at<uint8_t>(2 * r, 2 * c + 1) = bgr[1];
+                image_bayer.at<uint8_t>(2 * r + 1, 2 * c) = bgr[1];
+                image_bayer.at<uint8_t>(2 * r + 1, 2 * c + 1) = bgr[0];
+            }
+        }
+
+        bgr_segmenter.detect_colors(image);
+        bayer_segmenter.detect_colors_bayer(
+            image_bayer, cv::Rect(0, 0, image.cols, image.rows));
+
+        ASSERT_EQ(bayer_segmenter.get_dominant_colors(),
+                  bgr_segmenter.get_dominant_colors());
+        for (auto color : cube_model_.get_colors())
+        {
+            cv::Mat bayer_mask = bayer_segmenter.get_mask(color);
+            ASSERT_EQ(bayer_mask.size(), image.size());
+            EXPECT_EQ(cv::countNonZero(bayer_mask !=
+                                       bgr_segmenter.get_mask(color)),
+                      0)
+                << "color: " << color_names_[color];
+        }
+    }
+
+    ASSERT_THROW(bayer_segmenter.detect_colors_bayer(images_[0],
+                                                     cv::Rect(0, 0, 10, 10)),
+                 std::invalid_argument);
+}
+
+TEST_F(TestColorSegmenter, coarse_to_fine)
+{
+    //! Minimum ratio of pixels that have to be the same as in full-resolution
+    //! segmentation.
+    constexpr float MIN_AGREEMENT = 0.999;
+    constexpr int N_REPETITIONS = 10;
+
+    auto measure_seconds = [](ColorSegmenter *segmenter, const cv::Mat &image) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < N_REPETITIONS; i++)
+        {
+            segmenter->detect_colors(image);
+        }
+        std::chrono::duration<double> duration =
+            std::chrono::steady_clock::now() - start;
+        return duration.count();
+    };
+
+    ColorSegmenter full_segmenter(cube_model_);
+
+    for (unsigned int scale : {4, 8})
+    {
+        ColorSegmenter coarse_segmenter(
+            cube_model_, ColorSegmenter::Backend::XGBOOST, "", scale);
+
+        for (size_t i = 0; i < N_IMG; i++)
+        {
+            full_segmenter.detect_colors(images_[i]);
+            coarse_segmenter.detect_colors(images_[i]);
+
+            cv::Mat disagreement = cv::Mat::zeros(images_[i].size(), CV_8UC1);
+            for (auto color : cube_model_.get_colors())
+            {
+                disagreement |= full_segmenter.get_mask(color) !=
+                                coarse_segmenter.get_mask(color);
+            }
+            float agreement =
+                1.0 - static_cast<float>(cv::countNonZero(disagreement)) /
+                          images_[i].total();
+
+            double time_full = measure_seconds(&full_segmenter, images_[i]);
+            double time_coarse = measure_seconds(&coarse_segmenter, images_[i]);
+
+            std::cout << "Coarse-to-fine 1/" << scale << ", image " << i
+                      << ": agreement " << agreement * 100 << " %, speedup "
+                      << time_full / time_coarse << std::endl;
+
+            EXPECT_GT(agreement, MIN_AGREEMENT);
+        }
+    }
+
+    ASSERT_THROW(ColorSegmenter segmenter(
+                     cube_model_, ColorSegmenter::Backend::XGBOOST, "", 0),
+                 std::invalid_argument);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @brief Tests for ComputeBudgetController
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+
+#include <trifinger_object_tracking/compute_budget_controller.hpp>
+
+using namespace trifinger_object_tracking;
+using std::chrono::microseconds;
+
+namespace
+{
+/**
+ * @brief Simulate frames with a pose search duration proportional to the
+ * effort and return the total duration of the last frame.
+ */
+microseconds simulate(ComputeBudgetController *controller,
+                      microseconds fixed_duration,
+                      microseconds full_effort_duration,
+                      int num_frames)
+{
+    microseconds frame_duration(0);
+    for (int i = 0; i < num_frames; i++)
+    {
+        const microseconds pose_search_duration(static_cast<long>(
+            full_effort_duration.count() * controller->get_effort()));
+        controller->update(fixed_duration, pose_search_duration);
+        frame_duration = fixed_duration + pose_search_duration;
+    }
+    return frame_duration;
+}
+}  // namespace
+
+TEST(TestComputeBudgetController, invalid_period)
+{
+    EXPECT_THROW(ComputeBudgetController(microseconds(0)),
+                 std::invalid_argument);
+    EXPECT_THROW(ComputeBudgetController(microseconds(-1)),
+                 std::invalid_argument);
+}
+
+TEST(TestComputeBudgetController, starts_at_max_parameters)
+{
+    PoseSearchParameters max_parameters;
+    max_parameters.num_samples = 200;
+    ComputeBudgetController controller(microseconds(100000), max_parameters);
+
+    EXPECT_EQ(controller.get_parameters().num_samples, 200u);
+    EXPECT_EQ(controller.get_parameters().population_size,
+              max_parameters.population_size);
+    EXPECT_EQ(controller.get_parameters().num_generations,
+              max_parameters.num_generations);
+    EXPECT_DOUBLE_EQ(controller.get_effort(), 1.0);
+}
+
+TEST(TestComputeBudgetController, keeps_max_parameters_if_fast_enough)
+{
+    ComputeBudgetController controller(microseconds(100000));
+    simulate(&controller, microseconds(10000), microseconds(40000), 50);
+
+    EXPECT_DOUBLE_EQ(controller.get_effort(), 1.0);
+}
+
+TEST(TestComputeBudgetController, converges_to_target_utilisation)
+{
+    const microseconds period(100000);
+    ComputeBudgetController controller(period);
+
+    // full effort would take twice the period
+    const microseconds frame_duration = simulate(
+        &controller, microseconds(20000), microseconds(180000), 100);
+
+    EXPECT_LT(frame_duration, period);
+    EXPECT_NEAR(frame_duration.count(),
+                ComputeBudgetController::TARGET_UTILISATION * period.count(),
+                0.1 * period.count());
+    EXPECT_LT(controller.get_effort(), 1.0);
+    EXPECT_GE(controller.get_parameters().num_samples,
+              ComputeBudgetController::MIN_NUM_SAMPLES);
+    EXPECT_GE(controller.get_parameters().population_size,
+              ComputeBudgetController::MIN_POPULATION_SIZE);
+    EXPECT_GE(controller.get_parameters().num_generations,
+              ComputeBudgetController::MIN_NUM_GENERATIONS);
+}
+
+TEST(TestComputeBudgetController, recovers_after_load_drops)
+{
+    ComputeBudgetController controller(microseconds(100000));
+
+    simulate(&controller, microseconds(20000), microseconds(400000), 100);
+    const double reduced_effort = controller.get_effort();
+    ASSERT_LT(reduced_effort, 0.5);
+
+    simulate(&controller, microseconds(20000), microseconds(40000), 100);
+    EXPECT_DOUBLE_EQ(controller.get_effort(), 1.0);
+}
+
+TEST(TestComputeBudgetController, effort_limited_if_budget_exhausted)
+{
+    ComputeBudgetController controller(microseconds(100000));
+
+    // the fixed part alone exceeds the period
+    simulate(&controller, microseconds(150000), microseconds(40000), 50);
+
+    EXPECT_NEAR(controller.get_effort(),
+                ComputeBudgetController::MIN_EFFORT,
+                0.1 * ComputeBudgetController::MIN_EFFORT);
+}
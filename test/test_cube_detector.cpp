@@ -0,0 +1,198 @@
+/**
+ * @file
+ * @brief Tests for CubeDetector
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+#include <ament_index_cpp/get_package_share_directory.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <opencv2/opencv.hpp>
+
+#include <trifinger_object_tracking/cube_detector.hpp>
+
+using namespace trifinger_object_tracking;
+
+// Replace the global operator new/delete to count the heap allocations.  Note
+// that this only covers allocations done with operator new (this includes
+// the data of cv::Mat, which is allocated via new UMatData, and all standard
+// containers) but not the ones done directly with malloc (e.g. the matrices
+// of Armadillo and temporary buffers inside of OpenCV).  The population
+// matrices of the differential evolution are kept in a workspace of the
+// PoseDetector, their reuse is tested in test_optim_de.
+namespace
+{
+std::atomic<bool> g_count_allocations{false};
+std::atomic<size_t> g_num_allocations{0};
+
+void *allocate(size_t size)
+{
+    if (g_count_allocations)
+    {
+        g_num_allocations++;
+    }
+    // malloc(0) may return nullptr, which is not valid for operator new
+    void *ptr = std::malloc(size > 0 ? size : 1);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *allocate_aligned(size_t size, std::align_val_t alignment)
+{
+    if (g_count_allocations)
+    {
+        g_num_allocations++;
+    }
+    const size_t align = static_cast<size_t>(alignment);
+    // size has to be a multiple of the alignment for aligned_alloc
+    const size_t aligned_size = (std::max(size, size_t(1)) + align - 1) /
+                                align * align;
+    void *ptr = std::aligned_alloc(align, aligned_size);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+/**
+ * @brief Count the heap allocations done (in any thread) while calling func.
+ */
+template <typename Func>
+size_t count_allocations(const Func &func)
+{
+    g_num_allocations = 0;
+    g_count_allocations = true;
+    func();
+    g_count_allocations = false;
+    return g_num_allocations;
+}
+}  // namespace
+
+void *operator new(size_t size)
+{
+    return allocate(size);
+}
+void *operator new[](size_t size)
+{
+    return allocate(size);
+}
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return allocate(size);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return nullptr;
+    }
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    return allocate_aligned(size, alignment);
+}
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+    return allocate_aligned(size, alignment);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+/**
+ * @brief Fixture loading the images and calibration of the pose tests.
+ */
+class TestCubeDetector : public ::testing::Test
+{
+protected:
+    std::array<cv::Mat, CubeDetector::N_CAMERAS> images_;
+    std::array<std::string, CubeDetector::N_CAMERAS> camera_param_files_;
+
+    void SetUp() override
+    {
+        std::string package_path = ament_index_cpp::get_package_share_directory(
+            "trifinger_object_tracking");
+        std::string test_image_dir = package_path +
+                                     "/test/images/pose_detection/object_v" +
+                                     std::to_string(OBJECT_VERSION) + "/";
+
+        std::array<std::string, CubeDetector::N_CAMERAS> camera_ids = {
+            "60", "180", "300"};
+        for (size_t i = 0; i < CubeDetector::N_CAMERAS; i++)
+        {
+            images_[i] =
+                cv::imread(test_image_dir + "camera" + camera_ids[i] + ".png");
+            ASSERT_FALSE(images_[i].empty());
+
+            camera_param_files_[i] =
+                test_image_dir + "camera_calib_" + camera_ids[i] + ".yml";
+        }
+    }
+};
+
+TEST_F(TestCubeDetector, no_allocations_in_steady_state)
+{
+    for (unsigned int num_threads : {1, 4})
+    {
+        CubeDetector detector(camera_param_files_,
+                              ColorSegmenter::Backend::XGBOOST,
+                              num_threads);
+
+        // the buffers are allocated in the first calls
+        for (int i = 0; i < 3; i++)
+        {
+            detector.detect_cube(images_);
+        }
+
+        for (int i = 0; i < 5; i++)
+        {
+            size_t num_allocations = count_allocations(
+                [&detector, this]() { detector.detect_cube(images_); });
+
+            EXPECT_EQ(0u, num_allocations)
+                << "num_threads: " << num_threads << ", call: " << i;
+        }
+    }
+}
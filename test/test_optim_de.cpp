@@ -0,0 +1,133 @@
+/**
+ * @file
+ * @brief Tests for the batch objective of the bundled optim::de
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+// ignore all warnings of optim (this is a third-party library)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+#define OPTIM_ENABLE_ARMA_WRAPPERS
+#define OPTIM_DONT_USE_OPENMP
+#include <optim/optim.hpp>
+
+#pragma GCC diagnostic pop
+
+namespace
+{
+//! Objective with several local minima.
+double objective(const arma::vec &x)
+{
+    return arma::accu(arma::square(x - 0.3)) + std::sin(5 * x(0));
+}
+
+optim::algo_settings_t get_settings()
+{
+    optim::algo_settings_t settings;
+    settings.de_settings.n_gen = 50;
+    settings.de_settings.n_pop = 40;
+    settings.de_settings.n_pop_best = 1;
+    settings.de_settings.mutation_method = 2;
+    settings.print_level = 0;
+
+    settings.vals_bound = true;
+    settings.lower_bounds = arma::vec(6, arma::fill::ones) * -1.0;
+    settings.upper_bounds = arma::vec(6, arma::fill::ones);
+    settings.de_settings.initial_lb = arma::vec(6, arma::fill::ones) * -0.5;
+    settings.de_settings.initial_ub = arma::vec(6, arma::fill::ones) * 0.5;
+
+    return settings;
+}
+}  // namespace
+
+TEST(TestOptimDE, de_batch_matches_de)
+{
+    // with the same seed, evaluating the population as a whole has to give
+    // exactly the same result as evaluating one candidate at a time
+    optim::algo_settings_t settings = get_settings();
+    arma::vec x(6, arma::fill::zeros);
+    arma::arma_rng::set_seed(42);
+    ASSERT_TRUE(optim::de(
+        x,
+        [](const arma::vec &vals, arma::vec * /*grad*/, void * /*data*/) {
+            return objective(vals);
+        },
+        nullptr,
+        settings));
+
+    optim::algo_settings_t batch_settings = get_settings();
+    arma::vec batch_x(6, arma::fill::zeros);
+    size_t num_calls = 0;
+    arma::arma_rng::set_seed(42);
+    ASSERT_TRUE(optim::de_batch(
+        batch_x,
+        [&num_calls](const arma::mat &candidates,
+                     arma::vec &costs,
+                     void * /*data*/) {
+            num_calls++;
+            for (size_t i = 0; i < candidates.n_rows; i++)
+            {
+                costs(i) = objective(candidates.row(i).t());
+            }
+        },
+        nullptr,
+        batch_settings));
+
+    ASSERT_EQ(batch_x.n_elem, x.n_elem);
+    for (size_t i = 0; i < x.n_elem; i++)
+    {
+        EXPECT_EQ(batch_x(i), x(i));
+    }
+    EXPECT_DOUBLE_EQ(batch_settings.opt_fn_value, settings.opt_fn_value);
+
+    // one call for the initial population and one per generation (the loop
+    // runs at most n_gen + 1 generations)
+    EXPECT_LE(num_calls, settings.de_settings.n_gen + 2);
+}
+
+TEST(TestOptimDE, de_batch_reuses_workspace)
+{
+    auto batch_objective = [](const arma::mat &candidates,
+                              arma::vec &costs,
+                              void * /*data*/) {
+        for (size_t i = 0; i < candidates.n_rows; i++)
+        {
+            costs(i) = objective(candidates.row(i).t());
+        }
+    };
+
+    optim::algo_settings_t settings = get_settings();
+    arma::vec x(6, arma::fill::zeros);
+    arma::arma_rng::set_seed(42);
+    ASSERT_TRUE(optim::de_batch(x, batch_objective, nullptr, settings));
+
+    // the result does not depend on the workspace and its memory is only
+    // allocated in the first call
+    optim::de_workspace_t workspace;
+    const double *population = nullptr;
+    for (int i = 0; i < 3; i++)
+    {
+        optim::algo_settings_t workspace_settings = get_settings();
+        arma::vec workspace_x(6, arma::fill::zeros);
+        arma::arma_rng::set_seed(42);
+        ASSERT_TRUE(optim::de_batch(workspace_x,
+                                    batch_objective,
+                                    nullptr,
+                                    workspace_settings,
+                                    workspace));
+
+        EXPECT_TRUE(arma::all(workspace_x == x)) << "call: " << i;
+        EXPECT_EQ(workspace_settings.opt_fn_value, settings.opt_fn_value);
+
+        ASSERT_EQ(workspace.X.n_rows, settings.de_settings.n_pop);
+        if (i == 0)
+        {
+            population = workspace.X.memptr();
+        }
+        EXPECT_EQ(workspace.X.memptr(), population) << "call: " << i;
+    }
+}
@@ -6,6 +6,8 @@
 #include <gtest/gtest.h>
 #include <ament_index_cpp/get_package_share_directory.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <opencv2/opencv.hpp>
 
 #include <trifinger_object_tracking/cube_model.hpp>
@@ -74,6 +76,78 @@ protected:
              test_image_dir + "camera_calib_180.yml",
              test_image_dir + "camera_calib_300.yml"});
     }
+
+    //! Candidate poses in two batches, the second one only partially filled.
+    static arma::mat get_candidates()
+    {
+        const size_t num_candidates = 13;
+        arma::mat candidates(num_candidates, 6);
+        for (size_t i = 0; i < num_candidates; i++)
+        {
+            candidates(i, 0) = -0.05 + 0.008 * i;
+            candidates(i, 1) = 0.03 - 0.005 * i;
+            candidates(i, 2) = 0.02 + 0.002 * i;
+            candidates(i, 3) = 0.1 * i;
+            candidates(i, 4) = -0.2 + 0.05 * i;
+            candidates(i, 5) = 0.3;
+        }
+        return candidates;
+    }
+
+    PoseDetector::MasksPixels get_masks_pixels() const
+    {
+        PoseDetector::MasksPixels masks_pixels;
+        for (size_t i = 0; i < PoseDetector::N_CAMERAS; i++)
+        {
+            for (const cv::Mat &mask : masks_[i])
+            {
+                masks_pixels[i].emplace_back();
+                cv::findNonZero(mask, masks_pixels[i].back());
+            }
+        }
+        return masks_pixels;
+    }
+
+    //! Compute the costs with PoseDetector::cost_function() in batches of
+    //! batch_size candidates.
+    arma::vec cost_function(const PoseDetector &pose_detector,
+                            const arma::mat &candidates,
+                            const PoseDetector::MasksCoordinates &coordinates,
+                            size_t batch_size) const
+    {
+        arma::vec costs(candidates.n_rows, arma::fill::zeros);
+        for (size_t begin = 0; begin < candidates.n_rows; begin += batch_size)
+        {
+            const size_t end = std::min(begin + batch_size,
+                                        static_cast<size_t>(candidates.n_rows));
+            pose_detector.cost_function(
+                candidates, begin, end, dominant_colors_, coordinates, &costs);
+        }
+        return costs;
+    }
+
+    //! Same as cost_function() but with
+    //! PoseDetector::distance_transform_cost_function().
+    arma::vec distance_transform_cost_function(
+        const PoseDetector &pose_detector,
+        const arma::mat &candidates,
+        const PoseDetector::MasksDistanceFields &distance_fields,
+        size_t batch_size) const
+    {
+        arma::vec costs(candidates.n_rows, arma::fill::zeros);
+        for (size_t begin = 0; begin < candidates.n_rows; begin += batch_size)
+        {
+            const size_t end = std::min(begin + batch_size,
+                                        static_cast<size_t>(candidates.n_rows));
+            pose_detector.distance_transform_cost_function(candidates,
+                                                           begin,
+                                                           end,
+                                                           dominant_colors_,
+                                                           distance_fields,
+                                                           &costs);
+        }
+        return costs;
+    }
 };
 
 TEST_F(TestPoseDetector, find_pose)
@@ -112,6 +186,360 @@ TEST_F(TestPoseDetector, find_pose)
     EXPECT_GT(pose.confidence, 0.8);
 }
 
+TEST_F(TestPoseDetector, find_pose_half_resolution)
+{
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+    Pose pose = pose_detector.find_pose(dominant_colors_, masks_);
+
+    // same with downscaled masks and scaled camera parameters
+    std::array<trifinger_cameras::CameraParameters, PoseDetector::N_CAMERAS>
+        half_resolution_parameters;
+    std::array<std::vector<cv::Mat>, PoseDetector::N_CAMERAS>
+        half_resolution_masks;
+    for (size_t i = 0; i < PoseDetector::N_CAMERAS; i++)
+    {
+        half_resolution_parameters[i] =
+            scale_camera_parameters(camera_parameters_[i], 0.5);
+        ASSERT_EQ(half_resolution_parameters[i].image_width,
+                  camera_parameters_[i].image_width / 2);
+
+        for (const cv::Mat &mask : masks_[i])
+        {
+            cv::Mat half_mask;
+            cv::resize(mask, half_mask, cv::Size(), 0.5, 0.5, cv::INTER_AREA);
+            half_resolution_masks[i].push_back(half_mask > 127);
+        }
+    }
+    PoseDetector half_resolution_pose_detector(cube_model_,
+                                               half_resolution_parameters);
+    Pose half_pose = half_resolution_pose_detector.find_pose(
+        dominant_colors_, half_resolution_masks);
+
+    EXPECT_NEAR(half_pose.translation[0], pose.translation[0], 0.005);
+    EXPECT_NEAR(half_pose.translation[1], pose.translation[1], 0.005);
+    EXPECT_NEAR(half_pose.translation[2], pose.translation[2], 0.005);
+    EXPECT_GT(half_pose.confidence, 0.8);
+}
+
+TEST_F(TestPoseDetector, sparse_mask)
+{
+    for (size_t i = 0; i < PoseDetector::N_CAMERAS; i++)
+    {
+        for (const cv::Mat &mask : masks_[i])
+        {
+            SparseMask sparse_mask(mask);
+
+            std::vector<cv::Point> expected_pixels, pixels;
+            cv::findNonZero(mask, expected_pixels);
+            sparse_mask.get_pixels(&pixels);
+
+            EXPECT_EQ(sparse_mask.get_num_pixels(), expected_pixels.size());
+            EXPECT_EQ(pixels, expected_pixels);
+            EXPECT_EQ(cv::countNonZero(sparse_mask.to_dense(mask.size()) !=
+                                       (mask > 0)),
+                      0);
+        }
+    }
+}
+
+TEST_F(TestPoseDetector, find_pose_sparse_masks)
+{
+    std::array<std::vector<SparseMask>, PoseDetector::N_CAMERAS> sparse_masks;
+    for (size_t i = 0; i < PoseDetector::N_CAMERAS; i++)
+    {
+        for (const cv::Mat &mask : masks_[i])
+        {
+            sparse_masks[i].emplace_back(mask);
+        }
+    }
+
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+    Pose pose = pose_detector.find_pose(dominant_colors_, masks_);
+    Pose sparse_pose = pose_detector.find_pose(dominant_colors_, sparse_masks);
+
+    // the optimisation is randomised, so results are not exactly equal
+    EXPECT_NEAR(sparse_pose.translation[0], pose.translation[0], 0.005);
+    EXPECT_NEAR(sparse_pose.translation[1], pose.translation[1], 0.005);
+    EXPECT_NEAR(sparse_pose.translation[2], pose.translation[2], 0.005);
+    EXPECT_GT(sparse_pose.confidence, 0.8);
+}
+
+TEST_F(TestPoseDetector, find_pose_tracking)
+{
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+    Pose pose = pose_detector.find_pose(dominant_colors_, masks_);
+    ASSERT_GE(pose.confidence, PoseDetector::TRACKING_MIN_CONFIDENCE);
+
+    // starting from the previous pose, the same pose should be found
+    pose_detector.set_tracking_enabled(true);
+    Pose tracked_pose = pose_detector.find_pose(dominant_colors_, masks_);
+
+    EXPECT_NEAR(tracked_pose.translation[0], pose.translation[0], 0.005);
+    EXPECT_NEAR(tracked_pose.translation[1], pose.translation[1], 0.005);
+    EXPECT_NEAR(tracked_pose.translation[2], pose.translation[2], 0.005);
+    EXPECT_GT(tracked_pose.confidence, 0.8);
+}
+
+TEST_F(TestPoseDetector, find_pose_tracking_fallback)
+{
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+    Pose pose = pose_detector.find_pose(dominant_colors_, masks_);
+
+    // a wrong previous pose with high confidence should be detected based on
+    // the confidence of the tracked pose and trigger the global search
+    pose_detector.set_tracking_enabled(true);
+    pose_detector.set_pose(Pose(cv::Vec3f(0.15, 0.15, 0.1),
+                                cv::Vec3f(0.5, 0.0, 0.0),
+                                1.0));
+    Pose tracked_pose = pose_detector.find_pose(dominant_colors_, masks_);
+
+    EXPECT_NEAR(tracked_pose.translation[0], pose.translation[0], 0.005);
+    EXPECT_NEAR(tracked_pose.translation[1], pose.translation[1], 0.005);
+    EXPECT_NEAR(tracked_pose.translation[2], pose.translation[2], 0.005);
+    EXPECT_GT(tracked_pose.confidence, 0.8);
+}
+
+TEST_F(TestPoseDetector, find_pose_prior)
+{
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+    Pose pose = pose_detector.find_pose(dominant_colors_, masks_);
+    ASSERT_GE(pose.confidence, PoseDetector::TRACKING_MIN_CONFIDENCE);
+
+    // a prior that is slightly off should be used instead of the previous
+    // pose (which is reset here) and lead to the same pose
+    pose_detector.reset_tracking();
+    pose_detector.set_tracking_enabled(true);
+    pose_detector.set_prior({Pose(pose.translation + cv::Vec3f(0.005, 0, 0),
+                                  pose.rotation,
+                                  1.0),
+                             cv::Vec3f::all(0.003),
+                             cv::Vec3f::all(0.02)});
+    Pose tracked_pose = pose_detector.find_pose(dominant_colors_, masks_);
+
+    EXPECT_NEAR(tracked_pose.translation[0], pose.translation[0], 0.005);
+    EXPECT_NEAR(tracked_pose.translation[1], pose.translation[1], 0.005);
+    EXPECT_NEAR(tracked_pose.translation[2], pose.translation[2], 0.005);
+    EXPECT_GT(tracked_pose.confidence, 0.8);
+}
+
+TEST_F(TestPoseDetector, triangulate_position)
+{
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+
+    // masks consisting of the projection of a single point
+    const cv::Vec3f point(0.05, -0.03, 0.04);
+    PoseDetector::MasksPixels masks_pixels;
+    for (size_t i = 0; i < PoseDetector::N_CAMERAS; i++)
+    {
+        const cv::Point2f image_point =
+            CameraProjection(camera_parameters_[i]).project(point);
+        masks_pixels[i] = {{cv::Point(std::round(image_point.x),
+                                      std::round(image_point.y))}};
+    }
+
+    auto position = pose_detector.triangulate_position(masks_pixels);
+    ASSERT_TRUE(position);
+    EXPECT_NEAR((*position)[0], point[0], 0.002);
+    EXPECT_NEAR((*position)[1], point[1], 0.002);
+    EXPECT_NEAR((*position)[2], point[2], 0.002);
+
+    // a single camera is not enough
+    masks_pixels[1].clear();
+    masks_pixels[2].clear();
+    EXPECT_FALSE(pose_detector.triangulate_position(masks_pixels));
+}
+
+TEST_F(TestPoseDetector, triangulate_position_from_masks)
+{
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+    Pose pose = pose_detector.find_pose(dominant_colors_, masks_);
+
+    PoseDetector::MasksPixels masks_pixels;
+    for (size_t i = 0; i < PoseDetector::N_CAMERAS; i++)
+    {
+        for (const cv::Mat &mask : masks_[i])
+        {
+            masks_pixels[i].emplace_back();
+            cv::findNonZero(mask, masks_pixels[i].back());
+        }
+    }
+
+    // the centroids of the masks are close to the projected centre
+    auto position = pose_detector.triangulate_position(masks_pixels);
+    ASSERT_TRUE(position);
+    EXPECT_NEAR((*position)[0], pose.translation[0], 0.015);
+    EXPECT_NEAR((*position)[1], pose.translation[1], 0.015);
+    EXPECT_NEAR((*position)[2], pose.translation[2], 0.015);
+
+    // the run-length encoded masks give the same centroids
+    PoseDetector::SparseMasks sparse_masks;
+    for (size_t i = 0; i < PoseDetector::N_CAMERAS; i++)
+    {
+        for (const cv::Mat &mask : masks_[i])
+        {
+            sparse_masks[i].emplace_back(mask);
+        }
+    }
+    auto sparse_position = pose_detector.triangulate_position(sparse_masks);
+    ASSERT_TRUE(sparse_position);
+    EXPECT_NEAR((*sparse_position)[0], (*position)[0], 1e-5);
+    EXPECT_NEAR((*sparse_position)[1], (*position)[1], 1e-5);
+    EXPECT_NEAR((*sparse_position)[2], (*position)[2], 1e-5);
+}
+
+TEST_F(TestPoseDetector, find_pose_triangulation)
+{
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+    Pose pose = pose_detector.find_pose(dominant_colors_, masks_);
+
+    PoseDetector triangulation_pose_detector(cube_model_, camera_parameters_);
+    triangulation_pose_detector.set_triangulation_enabled(true);
+    Pose triangulation_pose =
+        triangulation_pose_detector.find_pose(dominant_colors_, masks_);
+
+    EXPECT_NEAR(triangulation_pose.translation[0], pose.translation[0], 0.005);
+    EXPECT_NEAR(triangulation_pose.translation[1], pose.translation[1], 0.005);
+    EXPECT_NEAR(triangulation_pose.translation[2], pose.translation[2], 0.005);
+    EXPECT_GT(triangulation_pose.confidence, 0.8);
+}
+
+TEST_F(TestPoseDetector, find_pose_refinement)
+{
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+    Pose pose = pose_detector.find_pose(dominant_colors_, masks_);
+
+    PoseDetector refining_pose_detector(cube_model_, camera_parameters_);
+    refining_pose_detector.set_refinement_enabled(true);
+    Pose refined_pose =
+        refining_pose_detector.find_pose(dominant_colors_, masks_);
+
+    EXPECT_NEAR(refined_pose.translation[0], pose.translation[0], 0.005);
+    EXPECT_NEAR(refined_pose.translation[1], pose.translation[1], 0.005);
+    EXPECT_NEAR(refined_pose.translation[2], pose.translation[2], 0.005);
+    EXPECT_GE(refined_pose.confidence, pose.confidence - 0.05);
+    EXPECT_GT(refined_pose.confidence, 0.8);
+}
+
+TEST_F(TestPoseDetector, find_pose_distance_transform)
+{
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+    Pose pose = pose_detector.find_pose(dominant_colors_, masks_);
+
+    PoseDetector dt_pose_detector(cube_model_, camera_parameters_);
+    dt_pose_detector.set_objective(PoseDetector::Objective::DISTANCE_TRANSFORM);
+    ThreadPool thread_pool(4);
+    Pose dt_pose =
+        dt_pose_detector.find_pose(dominant_colors_, masks_, &thread_pool);
+
+    EXPECT_NEAR(dt_pose.translation[0], pose.translation[0], 0.005);
+    EXPECT_NEAR(dt_pose.translation[1], pose.translation[1], 0.005);
+    EXPECT_NEAR(dt_pose.translation[2], pose.translation[2], 0.005);
+    EXPECT_GT(dt_pose.confidence, 0.8);
+}
+
+TEST_F(TestPoseDetector, find_pose_deadline)
+{
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+
+    auto start = std::chrono::steady_clock::now();
+    Pose pose = pose_detector.find_pose(dominant_colors_, masks_);
+    auto full_duration = std::chrono::steady_clock::now() - start;
+
+    // with a deadline that has already passed, only the initial population
+    // and one generation are evaluated, but there is still a valid result
+    start = std::chrono::steady_clock::now();
+    Pose early_pose = pose_detector.find_pose(
+        dominant_colors_, masks_, nullptr, std::chrono::steady_clock::now());
+    auto early_duration = std::chrono::steady_clock::now() - start;
+
+    EXPECT_LT(early_duration, full_duration);
+    EXPECT_GE(early_pose.confidence, 0.0);
+    EXPECT_LE(early_pose.confidence, 1.0);
+    EXPECT_EQ(early_pose.confidence, pose_detector.get_confidence());
+
+    // a generous deadline does not change the result
+    Pose deadline_pose = pose_detector.find_pose(
+        dominant_colors_,
+        masks_,
+        nullptr,
+        std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    EXPECT_NEAR(deadline_pose.translation[0], pose.translation[0], 0.005);
+    EXPECT_NEAR(deadline_pose.translation[1], pose.translation[1], 0.005);
+    EXPECT_NEAR(deadline_pose.translation[2], pose.translation[2], 0.005);
+    EXPECT_GT(deadline_pose.confidence, 0.8);
+}
+
+TEST_F(TestPoseDetector, find_pose_thread_pool)
+{
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+    Pose pose = pose_detector.find_pose(dominant_colors_, masks_);
+
+    ThreadPool thread_pool(4);
+    Pose parallel_pose =
+        pose_detector.find_pose(dominant_colors_, masks_, &thread_pool);
+
+    // the optimisation is randomised, so results are not exactly equal
+    EXPECT_NEAR(parallel_pose.translation[0], pose.translation[0], 0.005);
+    EXPECT_NEAR(parallel_pose.translation[1], pose.translation[1], 0.005);
+    EXPECT_NEAR(parallel_pose.translation[2], pose.translation[2], 0.005);
+    EXPECT_GT(parallel_pose.confidence, 0.8);
+}
+
+TEST_F(TestPoseDetector, batched_cost_matches_single_candidate)
+{
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+    const arma::mat candidates = get_candidates();
+    const PoseDetector::MasksPixels masks_pixels = get_masks_pixels();
+
+    PoseDetector::MasksCoordinates masks_coordinates;
+    for (size_t i = 0; i < PoseDetector::N_CAMERAS; i++)
+    {
+        masks_coordinates[i].resize(masks_pixels[i].size());
+        for (size_t j = 0; j < masks_pixels[i].size(); j++)
+        {
+            masks_coordinates[i][j].assign(masks_pixels[i][j]);
+        }
+    }
+
+    // the lanes of a batch are independent of each other, so evaluating all
+    // candidates of a batch at once gives the same costs as evaluating them
+    // one at a time
+    arma::vec batch_costs = cost_function(
+        pose_detector, candidates, masks_coordinates, QuadBatch::SIZE);
+    arma::vec single_costs =
+        cost_function(pose_detector, candidates, masks_coordinates, 1);
+    for (size_t i = 0; i < candidates.n_rows; i++)
+    {
+        EXPECT_FLOAT_EQ(batch_costs(i), single_costs(i)) << "candidate " << i;
+    }
+}
+
+TEST_F(TestPoseDetector, batched_distance_transform_cost_matches_single)
+{
+    PoseDetector pose_detector(cube_model_, camera_parameters_);
+    const arma::mat candidates = get_candidates();
+    const PoseDetector::MasksPixels masks_pixels = get_masks_pixels();
+
+    PoseDetector::MasksDistanceFields distance_fields;
+    for (size_t i = 0; i < PoseDetector::N_CAMERAS; i++)
+    {
+        distance_fields[i].resize(masks_pixels[i].size());
+        for (size_t j = 0; j < masks_pixels[i].size(); j++)
+        {
+            distance_fields[i][j].compute(masks_pixels[i][j]);
+        }
+    }
+
+    arma::vec batch_costs = distance_transform_cost_function(
+        pose_detector, candidates, distance_fields, QuadBatch::SIZE);
+    arma::vec single_costs = distance_transform_cost_function(
+        pose_detector, candidates, distance_fields, 1);
+    for (size_t i = 0; i < candidates.n_rows; i++)
+    {
+        EXPECT_FLOAT_EQ(batch_costs(i), single_costs(i)) << "candidate " << i;
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @brief Tests for PoseFilter
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include <trifinger_object_tracking/pose_filter.hpp>
+
+using namespace trifinger_object_tracking;
+
+namespace
+{
+constexpr double PERIOD_S = 0.1;
+
+PoseFilter::TimePoint get_time(int frame)
+{
+    return PoseFilter::TimePoint(std::chrono::duration_cast<
+                                 std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(frame * PERIOD_S)));
+}
+
+ObjectPose make_pose(const Eigen::Vector3d &position,
+                     double yaw,
+                     double confidence)
+{
+    ObjectPose pose;
+    pose.position = position;
+    pose.orientation =
+        Eigen::Quaterniond(Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()))
+            .coeffs();
+    pose.confidence = confidence;
+    return pose;
+}
+
+double get_yaw(const ObjectPose &pose)
+{
+    const Eigen::Quaterniond orientation(pose.orientation);
+    return Eigen::AngleAxisd(orientation).angle() *
+           Eigen::AngleAxisd(orientation).axis()[2];
+}
+}  // namespace
+
+TEST(TestPoseFilter, no_prediction_without_measurement)
+{
+    PoseFilter filter;
+    EXPECT_FALSE(filter.predict(get_time(0)));
+
+    // low-confidence measurements are passed through but not used
+    const ObjectPose pose =
+        filter.update(make_pose(Eigen::Vector3d(0, 0, 0.03), 0, 0.2),
+                      get_time(0));
+    EXPECT_DOUBLE_EQ(pose.confidence, 0.2);
+    EXPECT_FALSE(filter.predict(get_time(1)));
+}
+
+TEST(TestPoseFilter, constant_velocity)
+{
+    const Eigen::Vector3d velocity(0.05, -0.02, 0);
+    const double angular_velocity = 0.5;
+
+    PoseFilter filter;
+    for (int i = 0; i < 30; i++)
+    {
+        filter.update(make_pose(Eigen::Vector3d(0, 0, 0.03) +
+                                    i * PERIOD_S * velocity,
+                                i * PERIOD_S * angular_velocity,
+                                0.9),
+                      get_time(i));
+    }
+
+    // the prediction for the next frame should follow the motion
+    auto prediction = filter.predict(get_time(30));
+    ASSERT_TRUE(prediction);
+    const Eigen::Vector3d expected_position =
+        Eigen::Vector3d(0, 0, 0.03) + 30 * PERIOD_S * velocity;
+    EXPECT_LT((prediction->pose.position - expected_position).norm(), 0.001);
+    EXPECT_NEAR(get_yaw(prediction->pose),
+                30 * PERIOD_S * angular_velocity,
+                0.01);
+    EXPECT_DOUBLE_EQ(prediction->pose.confidence, 0.9);
+
+    // the uncertainty should have converged to a small value
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_LT(prediction->position_std[i], 0.01);
+        EXPECT_LT(prediction->orientation_std[i], 0.1);
+    }
+}
+
+TEST(TestPoseFilter, reduces_noise)
+{
+    std::mt19937 generator(42);
+    std::normal_distribution<double> noise(0, 0.002);
+
+    const Eigen::Vector3d position(0.05, 0.02, 0.03);
+    PoseFilter filter;
+    double raw_error = 0, filtered_error = 0;
+    for (int i = 0; i < 100; i++)
+    {
+        const ObjectPose measurement = make_pose(
+            position + Eigen::Vector3d(noise(generator), noise(generator), 0),
+            0,
+            1.0);
+        const ObjectPose filtered = filter.update(measurement, get_time(i));
+
+        if (i >= 20)
+        {
+            raw_error += (measurement.position - position).norm();
+            filtered_error += (filtered.position - position).norm();
+        }
+    }
+
+    EXPECT_LT(filtered_error, 0.8 * raw_error);
+}
+
+TEST(TestPoseFilter, hold_and_lose_pose)
+{
+    PoseFilter filter;
+    const ObjectPose measurement =
+        make_pose(Eigen::Vector3d(0.1, 0, 0.03), 1.0, 0.9);
+    filter.update(measurement, get_time(0));
+
+    // without usable measurements, the pose is held with degrading confidence
+    const ObjectPose invalid = make_pose(Eigen::Vector3d(0, 0, 0), 0, 0.1);
+    ObjectPose pose = filter.update(invalid, get_time(1));
+    EXPECT_LT((pose.position - measurement.position).norm(), 1e-9);
+    EXPECT_NEAR(
+        pose.confidence, 0.9 * PoseFilter::CONFIDENCE_DEGRADATION, 1e-9);
+    pose = filter.update(invalid, get_time(2));
+    EXPECT_NEAR(pose.confidence,
+                0.9 * std::pow(PoseFilter::CONFIDENCE_DEGRADATION, 2),
+                1e-9);
+
+    // the uncertainty grows while no measurements are received
+    auto prediction = filter.predict(get_time(3));
+    ASSERT_TRUE(prediction);
+    EXPECT_GT(prediction->position_std[0],
+              PoseFilter::POSITION_MEASUREMENT_STD);
+
+    // after MAX_PREDICTION_TIME, the object is not tracked anymore
+    const int lost_frame = static_cast<int>(std::ceil(
+                               PoseFilter::MAX_PREDICTION_TIME / PERIOD_S)) +
+                           1;
+    EXPECT_FALSE(filter.predict(get_time(lost_frame)));
+
+    filter.reset();
+    EXPECT_FALSE(filter.predict(get_time(1)));
+}
+
+TEST(TestPoseFilter, reinitialise_on_jump)
+{
+    PoseFilter filter;
+    for (int i = 0; i < 10; i++)
+    {
+        filter.update(make_pose(Eigen::Vector3d(0, 0, 0.03), 0, 0.9),
+                      get_time(i));
+    }
+
+    // a confident measurement far off the prediction is taken over directly
+    const ObjectPose measurement =
+        make_pose(Eigen::Vector3d(0.1, 0.05, 0.03), 2.0, 0.9);
+    const ObjectPose pose = filter.update(measurement, get_time(10));
+    EXPECT_LT((pose.position - measurement.position).norm(), 1e-9);
+    EXPECT_NEAR(get_yaw(pose), 2.0, 1e-9);
+}
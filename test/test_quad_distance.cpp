@@ -0,0 +1,380 @@
+/**
+ * @file
+ * @brief Tests for the quadrilateral distance kernels
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <opencv2/opencv.hpp>
+#include <random>
+
+#include <trifinger_object_tracking/mask_distance_field.hpp>
+#include <trifinger_object_tracking/quad_distance.hpp>
+#include <trifinger_object_tracking/sparse_mask.hpp>
+
+using namespace trifinger_object_tracking;
+
+namespace
+{
+//! Random convex quadrilateral (rotated rectangle) with integer corners.
+std::array<cv::Point, 4> random_quad(std::mt19937 *rng)
+{
+    std::uniform_real_distribution<float> center(50, 150);
+    std::uniform_real_distribution<float> half_size(3, 40);
+    std::uniform_real_distribution<float> angle(0, 2 * M_PI);
+
+    const cv::RotatedRect rect(
+        cv::Point2f(center(*rng), center(*rng)),
+        cv::Size2f(2 * half_size(*rng), 2 * half_size(*rng)),
+        angle(*rng) * 180 / M_PI);
+    cv::Point2f corners[4];
+    rect.points(corners);
+
+    std::array<cv::Point, 4> quad;
+    for (int i = 0; i < 4; i++)
+    {
+        quad[i] = cv::Point(std::round(corners[i].x), std::round(corners[i].y));
+    }
+    return quad;
+}
+
+//! All pixels of a region around the quadrilaterals.
+std::vector<cv::Point> grid_pixels()
+{
+    std::vector<cv::Point> pixels;
+    for (int y = 0; y < 200; y += 3)
+    {
+        for (int x = 0; x < 200; x += 3)
+        {
+            pixels.emplace_back(x, y);
+        }
+    }
+    // odd number of pixels, so the remainder of the SIMD loops is tested
+    pixels.emplace_back(100, 101);
+    return pixels;
+}
+}  // namespace
+
+TEST(TestQuadDistance, pixel_coordinates)
+{
+    const std::vector<cv::Point> pixels = {{1, 2}, {3, 4}, {5, 6}};
+    PixelCoordinates coordinates;
+    coordinates.assign(pixels);
+
+    ASSERT_EQ(3u, coordinates.size());
+    for (size_t i = 0; i < pixels.size(); i++)
+    {
+        EXPECT_EQ(pixels[i].x, coordinates.x[i]);
+        EXPECT_EQ(pixels[i].y, coordinates.y[i]);
+        EXPECT_EQ(1.f, coordinates.weight[i]);
+    }
+    EXPECT_EQ(3.f, coordinates.total_weight);
+
+    coordinates.assign({});
+    EXPECT_TRUE(coordinates.empty());
+    EXPECT_EQ(0.f, coordinates.total_weight);
+}
+
+TEST(TestQuadDistance, pixel_coordinates_aggregated)
+{
+    // cells of size 4: {(1, 2), (3, 1)}, {(5, 2)}, {(2, 9), (1, 10)}
+    const std::vector<cv::Point> pixels = {
+        {2, 9}, {5, 2}, {1, 2}, {1, 10}, {3, 1}};
+    PixelCoordinates coordinates;
+    coordinates.assign_aggregated(pixels, 4, 0.5);
+
+    ASSERT_EQ(3u, coordinates.size());
+    EXPECT_FLOAT_EQ(2.f, coordinates.x[0]);
+    EXPECT_FLOAT_EQ(1.5f, coordinates.y[0]);
+    EXPECT_FLOAT_EQ(1.f, coordinates.weight[0]);
+    EXPECT_FLOAT_EQ(5.f, coordinates.x[1]);
+    EXPECT_FLOAT_EQ(2.f, coordinates.y[1]);
+    EXPECT_FLOAT_EQ(0.5f, coordinates.weight[1]);
+    EXPECT_FLOAT_EQ(1.5f, coordinates.x[2]);
+    EXPECT_FLOAT_EQ(9.5f, coordinates.y[2]);
+    EXPECT_FLOAT_EQ(1.f, coordinates.weight[2]);
+    EXPECT_FLOAT_EQ(2.5f, coordinates.total_weight);
+
+    // with cells of one pixel, all pixels are kept
+    const std::vector<cv::Point> grid = grid_pixels();
+    coordinates.assign_aggregated(grid, 1, 1.0);
+    EXPECT_EQ(grid.size(), coordinates.size());
+    EXPECT_FLOAT_EQ(grid.size(), coordinates.total_weight);
+
+    coordinates.assign_aggregated({}, 4, 1.0);
+    EXPECT_TRUE(coordinates.empty());
+    EXPECT_EQ(0.f, coordinates.total_weight);
+}
+
+TEST(TestQuadDistance, add_quad_distance_costs)
+{
+    std::mt19937 rng(42);
+    const std::vector<cv::Point> pixels = grid_pixels();
+    PixelCoordinates coordinates;
+    coordinates.assign(pixels);
+    for (size_t k = 0; k < pixels.size(); k++)
+    {
+        coordinates.weight[k] = 0.5 + (k % 3);
+    }
+
+    for (int trial = 0; trial < 10; trial++)
+    {
+        QuadBatch quads;
+        std::array<std::array<cv::Point, 4>, QuadBatch::SIZE> lane_quads;
+        for (size_t lane = 0; lane < QuadBatch::SIZE; lane++)
+        {
+            lane_quads[lane] = random_quad(&rng);
+            for (int i = 0; i < 4; i++)
+            {
+                quads.x[i][lane] = lane_quads[lane][i].x;
+                quads.y[i][lane] = lane_quads[lane][i].y;
+            }
+        }
+
+        for (bool use_simd : {false, true})
+        {
+            std::array<float, QuadBatch::SIZE> costs;
+            costs.fill(1.0);
+            add_quad_distance_costs(quads, coordinates, costs.data(), use_simd);
+
+            for (size_t lane = 0; lane < QuadBatch::SIZE; lane++)
+            {
+                double expected = 1.0;
+                for (size_t k = 0; k < pixels.size(); k++)
+                {
+                    double dist =
+                        cv::pointPolygonTest(lane_quads[lane], pixels[k], true);
+                    expected += coordinates.weight[k] *
+                                (dist < 0 ? std::sqrt(-dist)
+                                          : 0.05 * std::sqrt(dist));
+                }
+
+                EXPECT_NEAR(expected, costs[lane], 1e-3 * expected)
+                    << "use_simd: " << use_simd << ", lane: " << lane;
+            }
+        }
+    }
+}
+
+TEST(TestQuadDistance, count_pixels_outside_quad)
+{
+    std::mt19937 rng(42);
+    const std::vector<cv::Point> pixels = grid_pixels();
+    PixelCoordinates coordinates;
+    coordinates.assign(pixels);
+
+    for (int trial = 0; trial < 50; trial++)
+    {
+        const std::array<cv::Point, 4> quad = random_quad(&rng);
+
+        size_t expected = 0;
+        for (const cv::Point &pixel : pixels)
+        {
+            expected += cv::pointPolygonTest(quad, pixel, false) < 0;
+        }
+
+        for (bool use_simd : {false, true})
+        {
+            EXPECT_EQ(expected,
+                      count_pixels_outside_quad(quad, coordinates, use_simd))
+                << "use_simd: " << use_simd;
+        }
+    }
+}
+
+TEST(TestQuadDistance, bit_mask_count_in_row)
+{
+    std::vector<cv::Point> pixels;
+    for (int x = 5; x < 300; x += 2)
+    {
+        pixels.emplace_back(x, 7);
+    }
+    pixels.emplace_back(20, 9);
+
+    BitMask mask;
+    mask.assign(pixels);
+    EXPECT_EQ(pixels.size(), mask.get_num_pixels());
+    EXPECT_EQ(cv::Rect(5, 7, 295, 3), mask.get_roi());
+
+    for (int begin = -10; begin < 320; begin += 3)
+    {
+        for (int end = begin - 5; end < 330; end += 7)
+        {
+            unsigned int expected = 0;
+            for (const cv::Point &pixel : pixels)
+            {
+                expected +=
+                    pixel.y == 7 && pixel.x >= begin && pixel.x <= end;
+            }
+            EXPECT_EQ(expected, mask.count_in_row(7, begin, end))
+                << "begin: " << begin << ", end: " << end;
+        }
+    }
+    EXPECT_EQ(0u, mask.count_in_row(8, 0, 300));
+    EXPECT_EQ(1u, mask.count_in_row(9, 0, 300));
+    EXPECT_EQ(0u, mask.count_in_row(6, 0, 300));
+}
+
+TEST(TestQuadDistance, count_mask_pixels_in_quad)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> coordinate(0, 199);
+
+    for (int trial = 0; trial < 50; trial++)
+    {
+        // random mask with a dense blob and some noise
+        std::vector<cv::Point> pixels;
+        const cv::Rect blob(coordinate(rng) / 2, coordinate(rng) / 2, 60, 80);
+        for (int y = blob.y; y < blob.y + blob.height; y++)
+        {
+            for (int x = blob.x; x < blob.x + blob.width; x++)
+            {
+                if ((x * 7 + y * 3) % 5 != 0)
+                {
+                    pixels.emplace_back(x, y);
+                }
+            }
+        }
+        for (int i = 0; i < 100; i++)
+        {
+            // distinct x-coordinates, so no pixel is added twice
+            const cv::Point pixel((37 * i) % 200, coordinate(rng));
+            if (!blob.contains(pixel))
+            {
+                pixels.push_back(pixel);
+            }
+        }
+        BitMask mask;
+        mask.assign(pixels);
+
+        const std::array<cv::Point, 4> quad = random_quad(&rng);
+
+        unsigned int expected = 0;
+        for (const cv::Point &pixel : pixels)
+        {
+            expected += cv::pointPolygonTest(quad, pixel, false) >= 0;
+        }
+
+        EXPECT_EQ(expected, count_mask_pixels_in_quad(quad, mask));
+    }
+}
+
+TEST(TestQuadDistance, mask_distance_field)
+{
+    // filled rectangle
+    const cv::Rect rect(40, 60, 50, 30);
+    std::vector<cv::Point> pixels;
+    for (int y = rect.y; y < rect.y + rect.height; y++)
+    {
+        for (int x = rect.x; x < rect.x + rect.width; x++)
+        {
+            pixels.emplace_back(x, y);
+        }
+    }
+
+    MaskDistanceField field;
+    field.compute(pixels);
+    ASSERT_FALSE(field.empty());
+
+    // inside, on the border and outside of the covered region (the
+    // distance transform is an approximation, so allow some tolerance)
+    EXPECT_FLOAT_EQ(0.0, field.get_mask_distance(cv::Point2f(50, 70)));
+    EXPECT_NEAR(10.0, field.get_border_distance(cv::Point2f(50, 75)), 0.5);
+    EXPECT_FLOAT_EQ(0.0, field.get_border_distance(cv::Point2f(40, 70)));
+    EXPECT_NEAR(5.0, field.get_mask_distance(cv::Point2f(35, 70)), 0.5);
+    EXPECT_NEAR(5.0, field.get_border_distance(cv::Point2f(35, 70)), 0.5);
+    EXPECT_NEAR(100.0, field.get_mask_distance(cv::Point2f(189, 70)), 0.5);
+
+    // the cost is minimal for the quadrilateral matching the mask and grows
+    // with shifting and scaling
+    auto quad_cost = [&field](float x, float y, float width, float height) {
+        return field.compute_quad_cost({cv::Point2f(x, y),
+                                        cv::Point2f(x + width, y),
+                                        cv::Point2f(x + width, y + height),
+                                        cv::Point2f(x, y + height)});
+    };
+    const float best_cost = quad_cost(40, 60, 49, 29);
+    EXPECT_LT(best_cost, 0.1);
+    EXPECT_LT(best_cost, quad_cost(43, 60, 49, 29));
+    EXPECT_LT(quad_cost(43, 60, 49, 29), quad_cost(50, 60, 49, 29));
+    EXPECT_LT(best_cost, quad_cost(30, 50, 69, 49));
+    EXPECT_LT(best_cost, quad_cost(50, 70, 29, 9));
+    EXPECT_LT(quad_cost(60, 60, 49, 29), quad_cost(200, 200, 49, 29));
+
+    field.compute({});
+    EXPECT_TRUE(field.empty());
+}
+
+TEST(TestQuadDistance, sparse_mask_matches_pixels)
+{
+    // two quadrilaterals, so that rows contain several runs, and runs cross
+    // the borders of the aggregation cells and of the bit mask words
+    std::mt19937 rng(42);
+    cv::Mat mask = cv::Mat::zeros(200, 200, CV_8UC1);
+    for (int i = 0; i < 2; i++)
+    {
+        const std::array<cv::Point, 4> quad = random_quad(&rng);
+        cv::fillConvexPoly(mask, quad.data(), 4, cv::Scalar(255));
+    }
+    const SparseMask sparse_mask(mask);
+    std::vector<cv::Point> pixels;
+    cv::findNonZero(mask, pixels);
+    ASSERT_FALSE(pixels.empty());
+
+    for (int cell_size : {1, 3, 4, 16})
+    {
+        PixelCoordinates expected, coordinates;
+        expected.assign_aggregated(pixels, cell_size, 0.5);
+        coordinates.assign_aggregated(sparse_mask, cell_size, 0.5);
+
+        ASSERT_EQ(expected.size(), coordinates.size()) << cell_size;
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_FLOAT_EQ(expected.x[i], coordinates.x[i]) << cell_size;
+            EXPECT_FLOAT_EQ(expected.y[i], coordinates.y[i]) << cell_size;
+            EXPECT_FLOAT_EQ(expected.weight[i], coordinates.weight[i])
+                << cell_size;
+        }
+        EXPECT_FLOAT_EQ(expected.total_weight, coordinates.total_weight);
+    }
+
+    BitMask expected_bits, bits;
+    expected_bits.assign(pixels);
+    bits.assign(sparse_mask);
+    EXPECT_EQ(expected_bits.get_roi(), bits.get_roi());
+    EXPECT_EQ(expected_bits.get_num_pixels(), bits.get_num_pixels());
+    for (int y = 0; y < mask.rows; y++)
+    {
+        EXPECT_EQ(expected_bits.count_in_row(y, 0, mask.cols - 1),
+                  bits.count_in_row(y, 0, mask.cols - 1))
+            << "row: " << y;
+    }
+
+    MaskDistanceField expected_field, field;
+    expected_field.compute(pixels);
+    field.compute(sparse_mask);
+    for (const cv::Point &pixel : grid_pixels())
+    {
+        EXPECT_EQ(expected_field.get_mask_distance(pixel),
+                  field.get_mask_distance(pixel));
+        EXPECT_EQ(expected_field.get_border_distance(pixel),
+                  field.get_border_distance(pixel));
+    }
+
+    // empty mask
+    const SparseMask empty_mask;
+    PixelCoordinates coordinates;
+    coordinates.assign_aggregated(empty_mask, 4, 1.0);
+    EXPECT_TRUE(coordinates.empty());
+    bits.assign(empty_mask);
+    EXPECT_EQ(0u, bits.get_num_pixels());
+    field.compute(empty_mask);
+    EXPECT_TRUE(field.empty());
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,169 @@
+/**
+ * @file
+ * @brief Tests for ThreadPool
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <trifinger_object_tracking/thread_pool.hpp>
+
+using namespace trifinger_object_tracking;
+
+TEST(TestThreadPool, all_tasks_executed_once)
+{
+    for (unsigned int num_threads : {1, 2, 4, 8})
+    {
+        ThreadPool pool(num_threads);
+        ASSERT_EQ(pool.get_num_threads(), num_threads);
+
+        for (size_t num_tasks : {0, 1, 3, 100, 1000})
+        {
+            std::vector<std::atomic<int>> calls(num_tasks);
+            pool.parallel_for(num_tasks, [&calls](size_t i) { calls[i]++; });
+
+            for (size_t i = 0; i < num_tasks; i++)
+            {
+                EXPECT_EQ(calls[i], 1) << "task " << i;
+            }
+        }
+    }
+}
+
+TEST(TestThreadPool, nested)
+{
+    constexpr size_t N_OUTER = 3;
+    constexpr size_t N_INNER = 16;
+
+    ThreadPool pool(4);
+
+    for (int repetition = 0; repetition < 100; repetition++)
+    {
+        std::vector<std::atomic<int>> calls(N_OUTER * N_INNER);
+        pool.parallel_for(N_OUTER, [&pool, &calls](size_t i) {
+            pool.parallel_for(N_INNER, [&calls, i](size_t j) {
+                calls[i * N_INNER + j]++;
+            });
+        });
+
+        for (size_t i = 0; i < calls.size(); i++)
+        {
+            ASSERT_EQ(calls[i], 1) << "task " << i;
+        }
+    }
+}
+
+TEST(TestThreadPool, exception_rethrown_on_caller)
+{
+    for (unsigned int num_threads : {1, 4})
+    {
+        ThreadPool pool(num_threads);
+
+        for (int repetition = 0; repetition < 100; repetition++)
+        {
+            std::vector<std::atomic<int>> calls(100);
+            auto task = [&calls](size_t i) {
+                calls[i]++;
+                if (i % 10 == 3)
+                {
+                    throw std::invalid_argument("task failed");
+                }
+            };
+            EXPECT_THROW(pool.parallel_for(calls.size(), task),
+                         std::invalid_argument);
+
+            // the other tasks are still executed
+            for (size_t i = 0; i < calls.size(); i++)
+            {
+                ASSERT_EQ(calls[i], 1) << "task " << i;
+            }
+        }
+
+        // the pool is still usable afterwards
+        std::atomic<int> num_calls(0);
+        pool.parallel_for(10, [&num_calls](size_t) { num_calls++; });
+        EXPECT_EQ(num_calls, 10);
+    }
+}
+
+TEST(TestThreadPool, nested_exception_stays_in_its_call)
+{
+    ThreadPool pool(4);
+
+    for (int repetition = 0; repetition < 100; repetition++)
+    {
+        // only the inner calls of outer task 0 throw, the exception has to
+        // reach the parallel_for() of that task, not one of the others
+        std::atomic<int> num_caught(0);
+        pool.parallel_for(3, [&pool, &num_caught](size_t i) {
+            try
+            {
+                pool.parallel_for(16, [i](size_t j) {
+                    if (i == 0 && j == 5)
+                    {
+                        throw std::runtime_error("inner task failed");
+                    }
+                });
+            }
+            catch (const std::runtime_error &)
+            {
+                EXPECT_EQ(i, 0u);
+                num_caught++;
+            }
+        });
+        ASSERT_EQ(num_caught, 1);
+    }
+}
+
+namespace
+{
+//! CPU time used by the current thread in seconds.
+double get_thread_cpu_time()
+{
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return time.tv_sec + 1e-9 * time.tv_nsec;
+}
+}  // namespace
+
+TEST(TestThreadPool, caller_sleeps_while_waiting)
+{
+    ThreadPool pool(2);
+    const std::thread::id caller_id = std::this_thread::get_id();
+
+    // the caller's task waits until the worker has taken the other task,
+    // which takes long
+    std::atomic<bool> worker_started{false};
+    const double start = get_thread_cpu_time();
+    pool.parallel_for(2, [caller_id, &worker_started](size_t) {
+        if (std::this_thread::get_id() != caller_id)
+        {
+            worker_started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+        else
+        {
+            while (!worker_started)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    EXPECT_LT(get_thread_cpu_time() - start, 0.05);
+}
+
+TEST(TestThreadPool, default_number_of_threads)
+{
+    ThreadPool pool;
+    EXPECT_EQ(pool.get_num_threads(),
+              std::max(std::thread::hardware_concurrency(), 1u));
+}
@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @brief Tests for the serialisation of TriCameraObjectObservation
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/array.hpp>
+#include <serialization_utils/cereal_cvmat.hpp>
+
+#include <trifinger_object_tracking/tricamera_object_observation.hpp>
+
+using namespace trifinger_object_tracking;
+
+namespace
+{
+/**
+ * @brief TriCameraObjectObservation as it was serialised before the pose
+ * search parameters and pipeline statistics were added, i.e. the format of
+ * existing log files.
+ */
+struct BaselineObservation
+{
+    std::array<trifinger_cameras::CameraObservation, 3> cameras;
+    ObjectPose object_pose;
+    ObjectPose filtered_object_pose;
+
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(cameras, object_pose, filtered_object_pose);
+    }
+};
+
+BaselineObservation create_baseline_observation()
+{
+    BaselineObservation observation;
+    for (size_t i = 0; i < observation.cameras.size(); i++)
+    {
+        observation.cameras[i].image =
+            cv::Mat(4, 6, CV_8UC1, cv::Scalar(10 * i + 1));
+        observation.cameras[i].timestamp = 1600000000.5 + i;
+    }
+    observation.object_pose.position << 0.1, -0.2, 0.0325;
+    observation.object_pose.orientation << 0.0, 0.0, 0.6, 0.8;
+    observation.object_pose.confidence = 0.9;
+    observation.filtered_object_pose.position << 0.11, -0.19, 0.0325;
+    observation.filtered_object_pose.orientation << 0.0, 0.0, 0.0, 1.0;
+    observation.filtered_object_pose.confidence = 0.8;
+
+    return observation;
+}
+
+template <typename T>
+std::string serialize(const T& object)
+{
+    std::stringstream stream;
+    {
+        cereal::BinaryOutputArchive archive(stream);
+        archive(object);
+    }
+    return stream.str();
+}
+
+void expect_pose_eq(const ObjectPose& actual, const ObjectPose& expected)
+{
+    EXPECT_EQ(actual.position, expected.position);
+    EXPECT_EQ(actual.orientation, expected.orientation);
+    EXPECT_EQ(actual.confidence, expected.confidence);
+}
+}  // namespace
+
+TEST(TestTriCameraObjectObservation, load_baseline_format)
+{
+    const BaselineObservation baseline = create_baseline_observation();
+    std::stringstream stream(serialize(baseline));
+
+    TriCameraObjectObservation observation;
+    {
+        cereal::BinaryInputArchive archive(stream);
+        archive(observation);
+    }
+
+    // the whole archive is consumed
+    EXPECT_EQ(stream.peek(), std::stringstream::traits_type::eof());
+
+    for (size_t i = 0; i < observation.cameras.size(); i++)
+    {
+        EXPECT_EQ(observation.cameras[i].timestamp,
+                  baseline.cameras[i].timestamp);
+        EXPECT_EQ(cv::countNonZero(observation.cameras[i].image !=
+                                   baseline.cameras[i].image),
+                  0);
+    }
+    expect_pose_eq(observation.object_pose, baseline.object_pose);
+    expect_pose_eq(observation.filtered_object_pose,
+                   baseline.filtered_object_pose);
+}
+
+TEST(TestTriCameraObjectObservation, save_baseline_format)
+{
+    const BaselineObservation baseline = create_baseline_observation();
+
+    TriCameraObjectObservation observation;
+    observation.cameras = baseline.cameras;
+    observation.object_pose = baseline.object_pose;
+    observation.filtered_object_pose = baseline.filtered_object_pose;
+    // runtime-only fields, not part of the log format
+    observation.pose_search_parameters.num_samples = 123;
+    observation.detection_queue_depth = 1;
+    observation.num_dropped_frames = 2;
+
+    EXPECT_EQ(serialize(observation), serialize(baseline));
+}
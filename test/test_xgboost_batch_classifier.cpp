@@ -0,0 +1,291 @@
+/**
+ * @file
+ * @brief Tests for XGBoostBatchClassifier
+ * @copyright Copyright (c) 2020, Max Planck Gesellschaft.
+ */
+#include <gtest/gtest.h>
+#include <ament_index_cpp/get_package_share_directory.hpp>
+
+#include <opencv2/opencv.hpp>
+#include <random>
+
+#include <trifinger_object_tracking/xgboost_batch_classifier.hpp>
+#include <trifinger_object_tracking/xgboost_classifier.h>
+#include <trifinger_object_tracking/xgboost_model_loader.hpp>
+
+using namespace trifinger_object_tracking;
+
+namespace
+{
+//! Classify all pixels of the image with the generated code.
+std::vector<uint8_t> classify_per_pixel(const cv::Mat &image_bgr,
+                                        const cv::Mat &image_hsv)
+{
+    std::vector<uint8_t> labels;
+    labels.reserve(image_bgr.total());
+
+    std::array<float, XGB_NUM_FEATURES> features;
+    for (int r = 0; r < image_bgr.rows; r++)
+    {
+        for (int c = 0; c < image_bgr.cols; c++)
+        {
+            const cv::Vec3b &bgr = image_bgr.at<cv::Vec3b>(r, c);
+            const cv::Vec3b &hsv = image_hsv.at<cv::Vec3b>(r, c);
+            for (int i = 0; i < 3; i++)
+            {
+                features[i] = static_cast<float>(bgr[i]);
+                features[3 + i] = static_cast<float>(hsv[i]);
+            }
+            labels.push_back(
+                static_cast<uint8_t>(xgb_classify_label(features)));
+        }
+    }
+
+    return labels;
+}
+
+//! Classify all pixels of the image with the batch classifier.
+std::vector<uint8_t> classify_batch(const XGBoostBatchClassifier &classifier,
+                                    const cv::Mat &image_bgr,
+                                    const cv::Mat &image_hsv)
+{
+    std::vector<uint8_t> labels(image_bgr.total());
+    // classify row-wise, so the handling of incomplete batches is tested
+    for (int r = 0; r < image_bgr.rows; r++)
+    {
+        classifier.classify_pixels(image_bgr.ptr<uint8_t>(r),
+                                   image_hsv.ptr<uint8_t>(r),
+                                   image_bgr.cols,
+                                   &labels[r * image_bgr.cols]);
+    }
+    return labels;
+}
+}  // namespace
+
+/**
+ * @brief Fixture loading the segmentation test images.
+ */
+class TestXGBoostBatchClassifier : public ::testing::Test
+{
+protected:
+    std::vector<cv::Mat> images_bgr_, images_hsv_;
+
+    void SetUp() override
+    {
+        std::string package_path = ament_index_cpp::get_package_share_directory(
+            "trifinger_object_tracking");
+        std::string test_image_dir = package_path +
+                                     "/test/images/segmentation/object_v" +
+                                     std::to_string(OBJECT_VERSION) + "/";
+
+        for (std::string filename : {"01_image.png", "02_image.png"})
+        {
+            cv::Mat image = cv::imread(test_image_dir + filename);
+            ASSERT_FALSE(image.empty());
+
+            // same preprocessing as in ColorSegmenter
+            cv::Mat image_hsv;
+            cv::medianBlur(image, image, 5);
+            cv::cvtColor(image, image_hsv, cv::COLOR_BGR2HSV);
+
+            images_bgr_.push_back(image);
+            images_hsv_.push_back(image_hsv);
+        }
+    }
+};
+
+TEST(XGBoostFlatModel, compiled_model_is_valid)
+{
+    XGBoostFlatModel model = get_compiled_xgb_flat_model();
+    ASSERT_NO_THROW(model.validate());
+    ASSERT_EQ(model.num_classes, XGB_NUM_CLASSES);
+    ASSERT_EQ(model.num_features, XGB_NUM_FEATURES);
+}
+
+TEST(XGBoostFlatModel, invalid_model)
+{
+    XGBoostFlatModel model = get_compiled_xgb_flat_model();
+    model.yes[model.tree_roots[0]] = static_cast<int32_t>(model.yes.size());
+    ASSERT_THROW(model.validate(), std::invalid_argument);
+    ASSERT_THROW(XGBoostBatchClassifier classifier(model),
+                 std::invalid_argument);
+}
+
+//! The traversal takes tree_depths steps, so a wrong depth would silently
+//! give wrong labels.
+TEST(XGBoostFlatModel, wrong_tree_depth)
+{
+    XGBoostFlatModel model = get_compiled_xgb_flat_model();
+    ASSERT_GT(model.tree_depths[0], 0);
+
+    model.tree_depths[0] -= 1;
+    ASSERT_THROW(XGBoostBatchClassifier classifier(model),
+                 std::invalid_argument);
+
+    model.tree_depths[0] += 2;
+    ASSERT_THROW(XGBoostBatchClassifier classifier(model),
+                 std::invalid_argument);
+}
+
+//! Compare with the generated code on random samples (including non-integer
+//! features for the single-sample interface).
+TEST(XGBoostBatchClassifierRandom, same_as_generated_code)
+{
+    XGBoostBatchClassifier classifier(get_compiled_xgb_flat_model());
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> uniform_int(0, 255);
+    std::uniform_real_distribution<float> uniform_real(0, 255);
+
+    constexpr int N_SAMPLES = 10000;
+    std::vector<uint8_t> bgr(3 * N_SAMPLES), hsv(3 * N_SAMPLES);
+    std::vector<uint8_t> expected(N_SAMPLES);
+    std::array<float, XGB_NUM_FEATURES> features;
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            bgr[3 * i + j] = uniform_int(rng);
+            hsv[3 * i + j] = uniform_int(rng);
+            features[j] = bgr[3 * i + j];
+            features[3 + j] = hsv[3 * i + j];
+        }
+        expected[i] = xgb_classify_label(features);
+        ASSERT_EQ(classifier.classify(features), expected[i]);
+
+        for (float &feature : features)
+        {
+            feature = uniform_real(rng);
+        }
+        int expected_label = xgb_classify_label(features);
+        ASSERT_EQ(classifier.classify(features), expected_label);
+    }
+
+    for (bool use_simd : {false, true})
+    {
+        classifier.set_use_simd(use_simd);
+        std::vector<uint8_t> labels(N_SAMPLES);
+        classifier.classify_pixels(
+            bgr.data(), hsv.data(), N_SAMPLES, labels.data());
+        ASSERT_EQ(labels, expected) << "use_simd: " << use_simd;
+    }
+}
+
+TEST_F(TestXGBoostBatchClassifier, same_as_generated_code)
+{
+    XGBoostBatchClassifier classifier(get_compiled_xgb_flat_model());
+
+    for (size_t i = 0; i < images_bgr_.size(); i++)
+    {
+        std::vector<uint8_t> expected =
+            classify_per_pixel(images_bgr_[i], images_hsv_[i]);
+
+        classifier.set_use_simd(false);
+        ASSERT_EQ(classify_batch(classifier, images_bgr_[i], images_hsv_[i]),
+                  expected);
+
+        classifier.set_use_simd(true);
+        ASSERT_EQ(classify_batch(classifier, images_bgr_[i], images_hsv_[i]),
+                  expected);
+    }
+}
+
+//! The dump of the compiled-in model is installed with the package.  Loading
+//! it needs to result in exactly the same model.
+TEST_F(TestXGBoostBatchClassifier, load_model_dump)
+{
+    std::string package_path = ament_index_cpp::get_package_share_directory(
+        "trifinger_object_tracking");
+    XGBoostFlatModel loaded =
+        load_xgb_model_dump(package_path + "/models/xgb_model_dump.txt");
+    XGBoostFlatModel compiled = get_compiled_xgb_flat_model();
+
+    EXPECT_EQ(loaded.num_classes, compiled.num_classes);
+    EXPECT_EQ(loaded.num_features, compiled.num_features);
+    EXPECT_EQ(loaded.tree_roots, compiled.tree_roots);
+    EXPECT_EQ(loaded.tree_classes, compiled.tree_classes);
+    EXPECT_EQ(loaded.tree_depths, compiled.tree_depths);
+    EXPECT_EQ(loaded.feature, compiled.feature);
+    EXPECT_EQ(loaded.threshold, compiled.threshold);
+    EXPECT_EQ(loaded.yes, compiled.yes);
+    EXPECT_EQ(loaded.no, compiled.no);
+    EXPECT_EQ(loaded.leaf_value, compiled.leaf_value);
+
+    XGBoostBatchClassifier classifier(loaded);
+    for (size_t i = 0; i < images_bgr_.size(); i++)
+    {
+        ASSERT_EQ(classify_batch(classifier, images_bgr_[i], images_hsv_[i]),
+                  classify_per_pixel(images_bgr_[i], images_hsv_[i]));
+    }
+}
+
+TEST(XGBoostModelLoader, text_and_json_dump)
+{
+    // same two trees (with two classes) in both formats
+    const std::string text_dump =
+        "booster[0]:\n"
+        "0:[f1<100] yes=1,no=2,missing=1\n"
+        "\t1:leaf=0.5\n"
+        "\t2:[f0<20.5] yes=3,no=4,missing=3\n"
+        "\t\t3:leaf=-0.25\n"
+        "\t\t4:leaf=1.5\n"
+        "booster[1]:\n"
+        "0:leaf=0.125\n";
+    const std::string json_dump = R"([
+  { "nodeid": 0, "depth": 0, "split": "f1", "split_condition": 100,
+    "yes": 1, "no": 2, "missing": 1, "gain": 12.5, "children": [
+      { "nodeid": 1, "leaf": 0.5 },
+      { "nodeid": 2, "depth": 1, "split": "f0", "split_condition": 20.5,
+        "yes": 3, "no": 4, "missing": 3, "children": [
+          { "nodeid": 3, "leaf": -0.25, "cover": 3 },
+          { "nodeid": 4, "leaf": 1.5 }
+      ]}
+  ]},
+  { "nodeid": 0, "leaf": 0.125 }
+])";
+
+    for (const std::string &dump : {text_dump, json_dump})
+    {
+        XGBoostFlatModel model = parse_xgb_model_dump(dump, 2, 2);
+        EXPECT_EQ(model.tree_roots, std::vector<int32_t>({0, 5}));
+        EXPECT_EQ(model.tree_classes, std::vector<int32_t>({0, 1}));
+        EXPECT_EQ(model.tree_depths, std::vector<int32_t>({2, 0}));
+        EXPECT_EQ(model.feature, std::vector<int32_t>({1, -1, 0, -1, -1, -1}));
+        EXPECT_EQ(model.threshold,
+                  std::vector<double>({100, 0, 20.5, 0, 0, 0}));
+        EXPECT_EQ(model.yes, std::vector<int32_t>({1, 1, 3, 3, 4, 5}));
+        EXPECT_EQ(model.no, std::vector<int32_t>({2, 1, 4, 3, 4, 5}));
+        EXPECT_EQ(model.leaf_value,
+                  std::vector<double>({0, 0.5, 0, -0.25, 1.5, 0.125}));
+    }
+}
+
+TEST(XGBoostModelLoader, invalid_dump)
+{
+    // missing node
+    EXPECT_THROW(parse_xgb_model_dump("booster[0]:\n"
+                                      "0:[f1<3] yes=1,no=2\n"
+                                      "1:leaf=1\n",
+                                      1),
+                 std::invalid_argument);
+    // number of trees does not match number of classes
+    EXPECT_THROW(parse_xgb_model_dump("booster[0]:\n0:leaf=1\n", 2),
+                 std::invalid_argument);
+    // feature index out of range
+    EXPECT_THROW(parse_xgb_model_dump("booster[0]:\n"
+                                      "0:[f9<3] yes=1,no=2\n"
+                                      "1:leaf=1\n"
+                                      "2:leaf=2\n",
+                                      1,
+                                      6),
+                 std::invalid_argument);
+    // named features are not supported
+    EXPECT_THROW(parse_xgb_model_dump(R"([{"nodeid": 0, "split": "hue",
+        "split_condition": 1, "yes": 1, "no": 2, "children": [
+        {"nodeid": 1, "leaf": 1}, {"nodeid": 2, "leaf": 2}]}])",
+                                      1),
+                 std::invalid_argument);
+    EXPECT_THROW(parse_xgb_model_dump("", 1), std::invalid_argument);
+    EXPECT_THROW(load_xgb_model_dump("/nonexistent/dump.txt"),
+                 std::runtime_error);
+}